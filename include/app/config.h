@@ -30,6 +30,11 @@ typedef struct {
     
     // Analysis settings
     int column_analysis_sample_lines;
+    int worker_threads;                // Threads for parallel scans (0 = one per CPU)
+    int sort_memory_mb;                // Memory a sort may use before spilling to disk
+    int sort_collation;                // Order text by LC_COLLATE (1) or case-folded bytes (0)
+    int trigram_index;                 // Index files for search, saved as <file>.trigrams (1 = on)
+    int approx_distinct_threshold;     // Estimated distinct values above which F is approximate (0 = never)
     
     // Encoding settings (detection only, no conversion)
     char *force_encoding;              // Force specific encoding (NULL = auto-detect)
@@ -2,6 +2,7 @@
 #define ANALYSIS_H
 
 #include <stddef.h>
+#include <stdbool.h>
 #include "field_desc.h"
 #include "error_context.h"
 #include "config.h"
@@ -9,6 +10,7 @@
 #include "parsed_data.h"
 #include "display_state.h"
 #include "memory/in_memory_table.h"
+#include "memory/arena.h"
 
 // Forward declarations
 struct DSVViewer;
@@ -31,7 +33,10 @@ void cleanup_column_analysis(ColumnAnalysis *analysis);
 
 /**
  * @brief Gets the display width for a specific column, calculating it if necessary.
- * This function implements lazy evaluation for column widths.
+ *
+ * The first call measures every column at once from the first lines of the
+ * file, which is enough for the first paint; start_column_width_analysis()
+ * then refines the widths from a sample of the whole file.
  *
  * @param viewer The main application viewer instance.
  * @param column_index The index of the column to get the width for.
@@ -39,6 +44,27 @@ void cleanup_column_analysis(ColumnAnalysis *analysis);
  */
 int analysis_get_column_width(struct DSVViewer *viewer, int column_index);
 
+/**
+ * @brief Measures all column widths in the background, from
+ *        column_analysis_sample_lines rows spread evenly over the file.
+ *
+ * Each sampled row is parsed once for all columns. Widths only grow, so the
+ * columns of the first paint never shrink. Call after the first paint and
+ * install the result with poll_column_width_analysis().
+ */
+void start_column_width_analysis(struct DSVViewer *viewer);
+
+/**
+ * @brief Installs the background widths once they are ready.
+ * @return true if they were installed and the screen needs a redraw.
+ */
+bool poll_column_width_analysis(struct DSVViewer *viewer);
+
+/**
+ * @brief Cancels and joins the background measurement, if any.
+ */
+void stop_column_width_analysis(struct DSVViewer *viewer);
+
 /**
  * @brief Analyze CSV data to determine optimal column display widths.
  * Samples file content to calculate column widths, respecting min/max limits.
@@ -58,16 +84,76 @@ DSVResult analyze_column_widths(const FileData *file_data, const ParsedData *par
  * @brief Perform frequency analysis on a specific column of a view.
  *
  * This function analyzes the values in the given column, counts the occurrences
- * of each unique value, and returns the results as a new in-memory table.
+ * of each unique value, and returns them sorted for display, most frequent
+ * first. The result backs a frequency view directly through
+ * create_frequency_data_source() and can be cached to reopen one.
  *
  * @param viewer The main application viewer instance.
  * @param view The data view to analyze.
  * @param column_index The index of the column to analyze.
- * @param out_index A pointer that will be populated with the generated ValueIndex.
- * @return An InMemoryTable containing the frequency counts, or NULL on failure.
- *         The caller is responsible for freeing this table.
+ * @return The analysis, or NULL on failure. The caller owns one reference and
+ *         releases it with free_value_index().
+ */
+struct ValueIndex* perform_frequency_analysis(struct DSVViewer *viewer, const struct View *view, int column_index);
+
+// --- Approximate Frequency Analysis ---
+
+// One value of an approximate frequency analysis.
+typedef struct {
+    char *value;
+    size_t length;
+    size_t count;    // Upper bound on the occurrences
+    size_t error;    // The true count is at least count - error
+} ApproxFrequencyItem;
+
+// A column's estimated distinct count and most frequent values.
+typedef struct ApproxFrequency {
+    size_t rows;                  // Non-empty cells counted
+    double distinct_estimate;
+    double distinct_error;        // Relative standard error of distinct_estimate
+    ApproxFrequencyItem *items;   // Most frequent first
+    size_t item_count;
+    size_t value_width;           // Length of the longest value
+    size_t max_count;             // Largest count of any value
+    Arena arena;                  // Items and values
+} ApproxFrequency;
+
+/**
+ * @brief Estimates a column's distinct count from at most 65536 rows sampled
+ *        across the view, without a full pass.
+ *
+ * Good enough to choose between exact and approximate frequency analysis;
+ * values are assumed to be spread evenly, so skewed columns read low.
+ *
+ * @return The estimate, or 0 if the sample has no values.
+ */
+double estimate_distinct_values(struct DSVViewer *viewer, const struct View *view, int column_index);
+
+/**
+ * @brief Estimates a column's distinct count (HyperLogLog) and its most
+ *        frequent values (Space-Saving) in one parallel pass, in memory that
+ *        does not grow with the column.
+ *
+ * @param viewer The main application viewer instance.
+ * @param view The data view to analyze.
+ * @param column_index The index of the column to analyze.
+ * @return The estimate, or NULL on failure or if the column is empty. Free it
+ *         with free_approximate_frequency().
+ */
+ApproxFrequency* perform_approximate_frequency_analysis(struct DSVViewer *viewer, const struct View *view, int column_index);
+
+void free_approximate_frequency(ApproxFrequency *approx);
+
+/**
+ * @brief Counts the values reported by an approximate analysis exactly.
+ *
+ * One more pass over the column, skipping every value not in 'approx'.
+ *
+ * @return A ValueIndex of those values, sorted for display and with their row
+ *         lists, or NULL on failure. The caller owns one reference.
  */
-InMemoryTable* perform_frequency_analysis(struct DSVViewer *viewer, const struct View *view, int column_index, struct ValueIndex **out_index);
+struct ValueIndex* refine_frequency_analysis(struct DSVViewer *viewer, const struct View *view, int column_index,
+                                             const ApproxFrequency *approx);
 
 const char* get_column_name(struct DSVViewer *viewer, int column_index, char* buffer, size_t buffer_size);
 
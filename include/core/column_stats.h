@@ -0,0 +1,64 @@
+#ifndef COLUMN_STATS_H
+#define COLUMN_STATS_H
+
+#include <stddef.h>
+#include "memory/in_memory_table.h"
+
+struct View;
+struct KllSketch;
+
+// Summary statistics of one column of a view.
+typedef struct ColumnStats {
+    size_t count;               // Non-empty cells
+    size_t nulls;               // Empty cells
+    size_t numeric_count;       // Cells holding a finite number
+    double distinct_estimate;   // Distinct non-empty values (HyperLogLog)
+    double distinct_error;      // Relative standard error of distinct_estimate
+    double min, max;            // Over the numeric cells
+    double sum, mean;
+    double stddev;              // Sample standard deviation, 0 below two numbers
+    double median, p90, p99;    // Approximate percentiles of the numeric cells
+    struct KllSketch *quantiles; // Quantile sketch of the numeric cells (owned)
+    char *min_text;             // Smallest value in byte order, NULL if no values
+    char *max_text;             // Largest value in byte order, NULL if no values
+    size_t min_length;          // Shortest non-empty value, in characters
+    size_t max_length;          // Longest value, in characters
+} ColumnStats;
+
+/**
+ * @brief Computes a column's statistics over the view's visible rows in one
+ *        parallel pass.
+ *
+ * Numbers are extracted block by block into a typed array, which is then
+ * reduced with SIMD (sum, min, max, and squared deviations for the variance).
+ * Block results are combined with the pairwise variance update, so the
+ * standard deviation stays accurate on long columns. The same blocks feed a
+ * KLL sketch per chunk for the percentiles.
+ *
+ * @param max_field_len Largest rendered value considered, in bytes.
+ * @return The statistics, or NULL on failure. Free with free_column_stats().
+ */
+ColumnStats* compute_column_stats(const struct View *view, int column_index, size_t max_field_len);
+
+void free_column_stats(ColumnStats *stats);
+
+/**
+ * @brief Builds a histogram of the numeric cells as a "From" / "To" / "Count"
+ *        / "Bar" table, with 'bins' equal-width bins between min and max.
+ *
+ * Counts are read from the quantile sketch, so they are estimates within its
+ * rank error (see kll_rank_error) but always add up to numeric_count.
+ *
+ * @return The table, or NULL if the column has no numbers or on failure.
+ */
+InMemoryTable* column_stats_histogram(const ColumnStats *stats, size_t bins);
+
+/**
+ * @brief Returns a column's statistics from the view's cache, computing them
+ *        on first use.
+ *
+ * @return The cached statistics (owned by the view), or NULL on failure.
+ */
+const ColumnStats* view_column_stats(struct View *view, size_t column_index, size_t max_field_len);
+
+#endif // COLUMN_STATS_H
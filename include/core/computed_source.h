@@ -0,0 +1,43 @@
+#ifndef COMPUTED_SOURCE_H
+#define COMPUTED_SOURCE_H
+
+#include "core/data_source.h"
+#include "core/expression.h"
+#include "config.h"
+
+/**
+ * @brief Creates a data source that appends one computed column to another.
+ *
+ * Columns of the inner source are passed through unchanged; the computed
+ * column comes last. Its cells are evaluated on demand and kept in a small
+ * LRU cache sized for the visible window. When a consumer announces a full
+ * column scan through data_source_prepare_column, the whole column is
+ * evaluated in parallel batches and kept materialized from then on.
+ *
+ * @param inner The source to extend.
+ * @param owns_inner If true, the inner source is destroyed with this one.
+ * @param name Header of the computed column (copied).
+ * @param expr Compiled expression; ownership passes to the new source.
+ * @param config Width sampling settings; NULL uses the defaults.
+ * @return The new DataSource, or NULL on failure (nothing is taken over).
+ */
+DataSource* create_computed_data_source(DataSource *inner, bool owns_inner, const char *name,
+                                        CompiledExpression *expr, const DSVConfig *config);
+
+/**
+ * @brief Parses a "name = expression" (or bare expression) definition and
+ *        wraps 'inner' in a computed source for it.
+ *
+ * @param inner The source to extend.
+ * @param owns_inner If true, the inner source is destroyed with this one.
+ * @param definition The column definition typed by the user.
+ * @param config Width sampling settings; NULL uses the defaults.
+ * @param out Receives the new data source on success.
+ * @param error Buffer for a human-readable message on failure.
+ * @param error_size Size of the error buffer.
+ * @return DSV_OK, DSV_ERROR_PARSE, DSV_ERROR_MEMORY or DSV_ERROR_INVALID_ARGS.
+ */
+DSVResult add_computed_column(DataSource *inner, bool owns_inner, const char *definition,
+                              const DSVConfig *config, DataSource **out, char *error, size_t error_size);
+
+#endif // COMPUTED_SOURCE_H
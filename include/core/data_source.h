@@ -3,6 +3,7 @@
 
 #include "core/field_desc.h"
 #include <stddef.h>
+#include <stdbool.h>
 
 // Forward declarations to avoid circular dependencies.
 struct DataSource;
@@ -14,9 +15,27 @@ struct DSVViewer;
  */
 typedef enum {
     DATA_SOURCE_FILE,
-    DATA_SOURCE_MEMORY
+    DATA_SOURCE_MEMORY,
+    DATA_SOURCE_COMPUTED
 } DataSourceType;
 
+/**
+ * @brief Receives one matching cell from a row search. Returns false to stop.
+ */
+typedef bool (*RowMatchFn)(void *user, size_t row, size_t col);
+
+/**
+ * @brief What a row search looks for. Every matching cell contains 'literal'
+ *        (which is not empty), in any case if 'ignore_case' is set;
+ *        'matches', if set, makes the final decision on a cell's rendered text.
+ */
+typedef struct {
+    const char *literal;
+    bool ignore_case;
+    bool (*matches)(void *arg, const char *text);
+    void *arg;
+} CellQuery;
+
 /**
  * @brief A struct of function pointers that define the interface for a data source.
  *
@@ -30,6 +49,27 @@ typedef struct {
     FieldDesc (*get_header)(void *context, size_t col);
     int (*get_column_width)(void *context, size_t col);
     void (*destroy)(void *context);
+
+    // Optional cursor support. A cursor carries its own parse scratch and row
+    // cache, so several threads may read one source concurrently as long as
+    // each uses its own cursor. Sources leave these NULL if get_cell is the
+    // only access path.
+    void* (*create_cursor)(void *context);
+    FieldDesc (*cursor_get_cell)(void *context, void *cursor, size_t row, size_t col);
+    void (*destroy_cursor)(void *context, void *cursor);
+
+    // Optional hint that a consumer is about to read every row of a column
+    // (sorting, frequency analysis). Lazily computed sources use it to
+    // materialize the column in bulk instead of evaluating cell by cell.
+    void (*prepare_column)(void *context, size_t col);
+
+    // Optional fast path for searching rows [first_row, first_row +
+    // row_count): reports every cell that satisfies 'query', in row then
+    // column order. Must be safe to call concurrently on disjoint ranges.
+    // Returns false, before reporting anything, if it cannot handle this
+    // query, in which case callers read the cells themselves.
+    bool (*search_rows)(void *context, const CellQuery *query, size_t first_row, size_t row_count,
+                        RowMatchFn on_match, void *user);
 } DataSourceOps;
 
 /**
@@ -45,6 +85,17 @@ typedef struct DataSource {
     DataSourceType type;
 } DataSource;
 
+/**
+ * @brief A per-consumer read handle onto a DataSource.
+ *
+ * FieldDescs returned through a cursor stay valid until the next read through
+ * the same cursor. The DataSource must outlive all of its cursors.
+ */
+typedef struct DataSourceCursor {
+    DataSource *source;
+    void *state;   // Source-specific scratch, NULL if the source has no cursor ops
+} DataSourceCursor;
+
 /**
  * @brief Creates a new data source backed by a file.
  *
@@ -53,6 +104,16 @@ typedef struct DataSource {
  */
 DataSource* create_file_data_source(struct DSVViewer *viewer);
 
+/**
+ * @brief Waits for a file source's trigram index to be loaded or built.
+ *
+ * With the trigram_index option set, a file source indexes its rows on a
+ * background thread and searches use the index once it is ready.
+ *
+ * @return true if the source has an index.
+ */
+bool file_data_source_wait_for_index(DataSource *data_source);
+
 /**
  * @brief Creates a new data source backed by an in-memory table.
  *
@@ -68,4 +129,47 @@ DataSource* create_memory_data_source(struct InMemoryTable *table);
  */
 void destroy_data_source(DataSource *data_source);
 
+/**
+ * @brief Tells a source that every row of 'col' is about to be read.
+ *
+ * A no-op for sources that do not implement prepare_column.
+ */
+void data_source_prepare_column(DataSource *data_source, size_t col);
+
+/**
+ * @brief Runs a source's search_rows fast path.
+ *
+ * @return false if the source has no fast path for this term; nothing was
+ *         reported then.
+ */
+bool data_source_search_rows(DataSource *data_source, const CellQuery *query, size_t first_row, size_t row_count,
+                             RowMatchFn on_match, void *user);
+
+/**
+ * @brief Reports whether a source can be read concurrently through cursors.
+ *
+ * Parallel consumers must fall back to a single thread when this is false.
+ */
+bool data_source_supports_cursors(const DataSource *data_source);
+
+/**
+ * @brief Opens a cursor on a data source.
+ *
+ * For sources without cursor support the cursor simply forwards to get_cell,
+ * which is only safe from one thread at a time.
+ *
+ * @return A new cursor, or NULL on allocation failure.
+ */
+DataSourceCursor* data_source_open_cursor(DataSource *data_source);
+
+/**
+ * @brief Reads a cell through a cursor.
+ */
+FieldDesc data_source_cursor_get_cell(DataSourceCursor *cursor, size_t row, size_t col);
+
+/**
+ * @brief Closes a cursor and frees its scratch state.
+ */
+void data_source_close_cursor(DataSourceCursor *cursor);
+
 #endif // DATA_SOURCE_H 
\ No newline at end of file
@@ -0,0 +1,104 @@
+#ifndef EXPRESSION_H
+#define EXPRESSION_H
+
+#include <stddef.h>
+#include "core/data_source.h"
+#include "error_context.h"
+
+// Rows evaluated per instruction dispatch by the batch interpreter.
+#define EXPR_BATCH_SIZE 256
+
+/**
+ * @brief The dynamic type of a value produced by an expression.
+ */
+typedef enum {
+    EXPR_VALUE_NULL,     // Missing or invalid (e.g. text used in arithmetic)
+    EXPR_VALUE_NUMBER,
+    EXPR_VALUE_STRING
+} ExprValueType;
+
+/**
+ * @brief A single expression value. Strings are not NUL-terminated and point
+ *        into evaluator-owned memory that is reused by the next batch.
+ */
+typedef struct {
+    ExprValueType type;
+    double number;
+    const char *str;
+    size_t length;
+} ExprValue;
+
+/**
+ * @brief An expression compiled to bytecode for a particular column layout.
+ *
+ * Supported syntax:
+ *  - numbers (`1.5`), strings in single quotes (`'abc'`)
+ *  - column references by header name (`price`), backquoted name
+ *    (`` `unit price` ``) or 1-based position (`$3`)
+ *  - `+ - * / %`, unary minus and parentheses
+ *  - functions `len(s)`, `substr(s, start[, count])` (0-based), `abs(n)`,
+ *    `lower(s)` and `upper(s)`
+ */
+typedef struct CompiledExpression CompiledExpression;
+
+/**
+ * @brief Evaluation state for one thread: value stack and string scratch.
+ */
+typedef struct ExprEvaluator ExprEvaluator;
+
+/**
+ * @brief Parses and compiles an expression against a data source's headers.
+ *
+ * @param text The expression source.
+ * @param source Data source used to resolve column names.
+ * @param out Receives the compiled expression on success.
+ * @param error Buffer for a human-readable message on failure (may be NULL).
+ * @param error_size Size of the error buffer.
+ * @return DSV_OK, DSV_ERROR_PARSE for invalid expressions, or DSV_ERROR_MEMORY.
+ */
+DSVResult expression_compile(const char *text, DataSource *source, CompiledExpression **out,
+                             char *error, size_t error_size);
+
+/**
+ * @brief Frees a compiled expression.
+ */
+void expression_free(CompiledExpression *expr);
+
+/**
+ * @brief Returns true if the expression reads the given column.
+ */
+bool expression_uses_column(const CompiledExpression *expr, size_t col);
+
+/**
+ * @brief Creates an evaluator that reads input columns through 'cursor'.
+ *
+ * The cursor is borrowed and must outlive the evaluator.
+ */
+ExprEvaluator* expr_evaluator_create(const CompiledExpression *expr, DataSourceCursor *cursor);
+
+/**
+ * @brief Evaluates the expression for up to EXPR_BATCH_SIZE rows at once.
+ *
+ * Each instruction is applied to the whole batch before the next one runs,
+ * so interpreter overhead is paid per batch rather than per row.
+ *
+ * @param evaluator The evaluator to use.
+ * @param rows Data source rows to evaluate.
+ * @param count Number of rows (at most EXPR_BATCH_SIZE).
+ * @return 'count' results, valid until the next call on this evaluator.
+ */
+const ExprValue* expr_evaluate_batch(ExprEvaluator *evaluator, const size_t *rows, size_t count);
+
+/**
+ * @brief Formats a value as display text.
+ *
+ * @return The length of the formatted text (NULL formats as an empty string).
+ */
+size_t expr_format_value(const ExprValue *value, char *buffer, size_t buffer_size);
+
+/**
+ * @brief Frees an evaluator. The cursor it reads from is not closed.
+ */
+void expr_evaluator_free(ExprEvaluator *evaluator);
+
+#endif // EXPRESSION_H
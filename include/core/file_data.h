@@ -2,6 +2,7 @@
 #define FILE_DATA_H
 
 #include <stddef.h>
+#include <time.h>
 #include "encoding.h"
 
 // A component to hold file related data.
@@ -10,6 +11,8 @@ typedef struct {
     size_t length;
     int fd;
     FileEncoding detected_encoding;
+    char *path;          // Path the file was opened from
+    time_t modified;     // Modification time when it was opened
 } FileData;
 
 #endif // FILE_DATA_H 
\ No newline at end of file
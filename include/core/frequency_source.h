@@ -0,0 +1,32 @@
+#ifndef FREQUENCY_SOURCE_H
+#define FREQUENCY_SOURCE_H
+
+#include "core/data_source.h"
+#include "core/value_index.h"
+#include "core/analysis.h"
+
+/**
+ * @brief Creates a "Value" / "Count" data source over a frequency analysis,
+ *        one row per distinct value in the index's display order.
+ *
+ * Value cells point straight into the index and counts are formatted on
+ * demand, so opening a frequency view on an analyzed column costs nothing
+ * per value.
+ *
+ * @param index A sorted analysis (see perform_frequency_analysis); the source
+ *              takes its own reference.
+ * @return The new DataSource, or NULL on failure.
+ */
+DataSource* create_frequency_data_source(ValueIndex *index);
+
+/**
+ * @brief Creates a "Value" / "Count" / "Error" data source over an
+ *        approximate analysis. Counts are upper bounds; the true count of a
+ *        value is at least its count minus its error.
+ *
+ * @param approx The analysis; it is borrowed and must outlive the source.
+ * @return The new DataSource, or NULL on failure.
+ */
+DataSource* create_approximate_frequency_data_source(const ApproxFrequency *approx);
+
+#endif // FREQUENCY_SOURCE_H
@@ -0,0 +1,54 @@
+#ifndef JOIN_H
+#define JOIN_H
+
+#include <stddef.h>
+#include "core/data_source.h"
+#include "error_context.h"
+
+// Forward declarations
+struct DSVViewer;
+struct View;
+
+/**
+ * @brief Inner-joins two data sources on one key column each.
+ *
+ * A hash table is built on the smaller side's keys (in parallel, one
+ * partition per task, entries and key copies arena-allocated) and the larger
+ * side is streamed against it in parallel chunks. The result only stores
+ * pairs of row ids; cells are read from the two inputs on demand. Columns of
+ * the left source come first, followed by the columns of the right source.
+ * Rows come out in the order of the larger (probing) side.
+ *
+ * Keys are compared as exact rendered text; rows with an empty key never match.
+ *
+ * @param left The left input. Not owned; it must outlive the result.
+ * @param left_view Restricts the left side to this view's visible rows
+ *                  (NULL joins every row of 'left').
+ * @param left_key Key column in 'left'.
+ * @param right The right input. Not owned; it must outlive the result.
+ * @param right_key Key column in 'right'.
+ * @param out Receives the joined data source.
+ * @return DSV_OK, DSV_ERROR_INVALID_ARGS or DSV_ERROR_MEMORY.
+ */
+DSVResult hash_join_data_sources(DataSource *left, const struct View *left_view, size_t left_key,
+                                 DataSource *right, size_t right_key, DataSource **out);
+
+/**
+ * @brief Loads another file and joins the visible rows of a view with it.
+ *
+ * @param viewer The viewer that owns 'view' (its configuration is reused).
+ * @param view The view providing the left side.
+ * @param left_key Key column in the view.
+ * @param filename The file to join with. It is kept open by the result.
+ * @param right_key_name Key column header in the other file, or NULL to use
+ *                       the header of 'left_key'.
+ * @param out Receives the joined data source.
+ * @param error Buffer for a human-readable message on failure.
+ * @param error_size Size of the error buffer.
+ * @return DSV_OK or an error code describing the failure.
+ */
+DSVResult join_view_with_file(struct DSVViewer *viewer, const struct View *view, size_t left_key,
+                              const char *filename, const char *right_key_name,
+                              DataSource **out, char *error, size_t error_size);
+
+#endif // JOIN_H
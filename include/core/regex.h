@@ -0,0 +1,75 @@
+#ifndef REGEX_H
+#define REGEX_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "error_context.h"
+
+/**
+ * @brief A regular expression compiled to an NFA, matched through a lazily
+ *        built DFA.
+ *
+ * Supported syntax (byte oriented):
+ *  - literals, `.`, classes `[a-z_]` and `[^...]`
+ *  - escapes `\d \w \s` (and `\D \W \S`), `\t \n \r`, and `\` before any
+ *    other character to match it literally
+ *  - grouping `( )`, alternation `|`
+ *  - quantifiers `* + ?` and `{n}`, `{n,}`, `{n,m}`
+ *  - anchors `^` and `$`, which match at the start and end of a cell
+ */
+typedef struct CompiledRegex CompiledRegex;
+
+/**
+ * @brief Matching state for one thread: the DFA states built so far.
+ */
+typedef struct RegexMatcher RegexMatcher;
+
+// Options for regex_compile
+typedef enum {
+    REGEX_DEFAULT = 0,
+    REGEX_IGNORE_CASE = 1 << 0   // ASCII letters match either case
+} RegexFlags;
+
+/**
+ * @brief Parses and compiles a pattern.
+ *
+ * @param pattern The pattern source.
+ * @param flags RegexFlags.
+ * @param out Receives the compiled regex on success.
+ * @param error Buffer for a human-readable message on failure (may be NULL).
+ * @param error_size Size of the error buffer.
+ * @return DSV_OK, DSV_ERROR_PARSE for invalid patterns, or DSV_ERROR_MEMORY.
+ */
+DSVResult regex_compile(const char *pattern, int flags, CompiledRegex **out, char *error, size_t error_size);
+
+/**
+ * @brief Frees a compiled regex.
+ */
+void regex_free(CompiledRegex *regex);
+
+/**
+ * @brief Returns the longest literal that every match contains, or "" if the
+ *        pattern has none. Text without it cannot match, so it serves as a
+ *        cheap prefilter. Patterns compiled with REGEX_IGNORE_CASE contain it
+ *        in any case.
+ */
+const char* regex_required_literal(const CompiledRegex *regex);
+
+/**
+ * @brief Creates a matcher. Each thread needs its own.
+ *
+ * @return The matcher, or NULL on allocation failure.
+ */
+RegexMatcher* regex_matcher_create(const CompiledRegex *regex);
+
+/**
+ * @brief Frees a matcher.
+ */
+void regex_matcher_free(RegexMatcher *matcher);
+
+/**
+ * @brief Returns true if the pattern matches anywhere in 'text'.
+ */
+bool regex_matcher_search(RegexMatcher *matcher, const char *text, size_t length);
+
+#endif // REGEX_H
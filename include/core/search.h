@@ -3,6 +3,7 @@
 
 #include "ui/view_state.h"
 #include "app/app_init.h"
+#include "ui/view_manager.h"
 #include <stdbool.h>
 
 // Enum to indicate the result of a search operation
@@ -12,20 +13,114 @@ typedef enum {
     SEARCH_WRAPPED_AND_FOUND
 } SearchResult;
 
+// How a search term is interpreted
+typedef enum {
+    SEARCH_LITERAL = 0,
+    SEARCH_REGEX = 1 << 0,       // The term is a regular expression (see regex.h)
+    SEARCH_IGNORE_CASE = 1 << 1  // Letters match in either case
+} SearchFlags;
+
 /**
  * @brief Searches the dataset for the given term, starting from the current
  *        cursor position.
  *
- * If a match is found, the view's cursor will be updated to the location
- * of the match.
+ * The first search for a term scans the whole view in parallel and keeps a
+ * hit list of every matching (display row, column) in display order; later
+ * calls for the same term step through that list. If a match is found, the
+ * view's cursor will be updated to the location of the match.
  *
  * @param viewer The main application viewer instance.
  * @param view The view to search within.
  * @param search_term The string to search for.
+ * @param flags SearchFlags controlling how the term is matched.
  * @param start_from_cursor If true, starts from the current cell. If false,
  *                          starts from the cell after the cursor (for "find next").
  * @return A SearchResult indicating the outcome.
  */
-SearchResult search_view(DSVViewer *viewer, View *view, const char* search_term, bool start_from_cursor);
+SearchResult search_view(DSVViewer *viewer, View *view, const char* search_term, int flags, bool start_from_cursor);
+
+/**
+ * @brief Moves the cursor to the match before the current cell (for
+ *        "find previous"), wrapping around to the last match.
+ *
+ * @param viewer The main application viewer instance.
+ * @param view The view to search within.
+ * @param search_term The string to search for.
+ * @param flags SearchFlags controlling how the term is matched.
+ * @return A SearchResult indicating the outcome.
+ */
+SearchResult search_view_previous(DSVViewer *viewer, View *view, const char* search_term, int flags);
+
+/**
+ * @brief Reports which match the cursor was last moved to.
+ *
+ * @param view The view that was searched.
+ * @param index Receives the 0-based position of the match in the hit list.
+ * @param count Receives the number of matches.
+ * @return false if the view has no current match.
+ */
+bool search_view_match_position(const View *view, size_t *index, size_t *count);
+
+/**
+ * @brief Finds the rows of a view that have a cell matching the term.
+ *
+ * The visible set is scanned in parallel and matching rows are emitted
+ * straight into ranges of data source rows, in source order, ready to back
+ * a new filtered view. Unfiltered file views are scanned in their raw bytes.
+ *
+ * @param view The view whose rows to filter.
+ * @param search_term The string (or pattern) to match.
+ * @param flags SearchFlags controlling how the term is matched.
+ * @param column Column to look in, or -1 for any column.
+ * @param ranges Receives the malloc'd ranges (NULL if no row matches).
+ * @param range_count Receives the number of ranges.
+ * @param row_count Receives the number of matching rows.
+ * @param error Buffer for a message if the term is not a valid pattern.
+ * @param error_size Size of the error buffer.
+ * @return DSV_OK, DSV_ERROR_PARSE for invalid patterns, DSV_ERROR_INVALID_ARGS,
+ *         or DSV_ERROR_MEMORY.
+ */
+DSVResult search_filter_rows(View *view, const char *search_term, int flags, int column,
+                             RowRange **ranges, size_t *range_count, size_t *row_count,
+                             char *error, size_t error_size);
+
+/**
+ * @brief Starts counting the matches of 'search_term' on a background thread,
+ *        cancelling any scan still running for an earlier term.
+ *
+ * Meant to be called on every keystroke while a term is typed. When the new
+ * term contains the previous one (and is not a regex), only the cells that
+ * matched before are checked again, so typing a long term costs one full
+ * scan followed by ever smaller ones. The finished hit list is installed by
+ * search_incremental_poll and reused by search_view.
+ *
+ * @return True if a scan was started.
+ */
+bool search_incremental_update(View *view, const char *search_term, int flags);
+
+/**
+ * @brief Installs the result of a finished background scan, if any. Call
+ *        this periodically from the UI loop.
+ *
+ * @return True if a scan finished.
+ */
+bool search_incremental_poll(View *view);
+
+/**
+ * @brief Stops the view's background scan, if any.
+ */
+void search_incremental_cancel(View *view);
+
+/**
+ * @brief Reports how many matches the view's hit list holds for a term.
+ *
+ * @return false if the view has no hit list for this term and these flags.
+ */
+bool search_view_match_count(const View *view, const char *search_term, int flags, size_t *count);
+
+/**
+ * @brief Stops any background scan and frees the view's search hit list.
+ */
+void search_clear(View *view);
 
-#endif // SEARCH_H 
\ No newline at end of file
+#endif // SEARCH_H
@@ -0,0 +1,142 @@
+#ifndef SKETCH_H
+#define SKETCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Fixed-memory summaries of a stream of values, for columns too large to
+// count exactly. Both are fed 64-bit hashes (see hash_bytes) and can be
+// built per chunk and merged.
+
+#define HLL_PRECISION 14                       // log2 of the register count
+#define HLL_REGISTERS (1 << HLL_PRECISION)
+
+/**
+ * @brief A HyperLogLog distinct-count estimator (16 KB, ~0.8% standard error).
+ */
+typedef struct {
+    uint8_t registers[HLL_REGISTERS];
+} HyperLogLog;
+
+void hll_init(HyperLogLog *hll);
+void hll_add(HyperLogLog *hll, uint64_t hash);
+
+/**
+ * @brief Folds 'from' into 'into'; the result estimates the union.
+ */
+void hll_merge(HyperLogLog *into, const HyperLogLog *from);
+
+/**
+ * @brief Returns the estimated number of distinct hashes added.
+ */
+double hll_estimate(const HyperLogLog *hll);
+
+/**
+ * @brief Returns the relative standard error of hll_estimate.
+ */
+double hll_relative_error(void);
+
+/**
+ * @brief A Space-Saving heavy-hitters summary.
+ *
+ * Keeps 'capacity' counters. A value without a counter takes over the
+ * smallest one, inheriting its count as error, so every count is an upper
+ * bound that overshoots by at most its error, and any value occurring more
+ * than total / capacity times is guaranteed to hold a counter.
+ */
+typedef struct SpaceSaving SpaceSaving;
+
+// One counter, as reported by space_saving_items.
+typedef struct {
+    const char *value;      // Owned by the summary, NUL-terminated
+    size_t length;
+    size_t count;           // Upper bound on the occurrences
+    size_t error;           // The true count is at least count - error
+} SpaceSavingItem;
+
+/**
+ * @brief Creates an empty summary.
+ * @return The summary, or NULL on allocation failure.
+ */
+SpaceSaving* space_saving_create(size_t capacity);
+void space_saving_free(SpaceSaving *summary);
+
+/**
+ * @brief Counts one occurrence of a value.
+ * @return false on allocation failure.
+ */
+bool space_saving_add(SpaceSaving *summary, uint64_t hash, const char *value, size_t length);
+
+/**
+ * @brief Folds 'from' into 'into', keeping into's capacity. A value missing
+ *        from a full summary is charged that summary's smallest count, in
+ *        both its count and its error, so the bounds still hold.
+ * @return false on allocation failure.
+ */
+bool space_saving_merge(SpaceSaving *into, const SpaceSaving *from);
+
+/**
+ * @brief Returns the number of occurrences counted.
+ */
+size_t space_saving_total(const SpaceSaving *summary);
+
+/**
+ * @brief Lists up to 'max' counters, largest count first. The items point
+ *        into the summary and stay valid until it next changes.
+ * @return The number of items written.
+ */
+size_t space_saving_items(const SpaceSaving *summary, SpaceSavingItem *items, size_t max);
+
+/**
+ * @brief A KLL quantile sketch over doubles.
+ *
+ * Values go into a stack of compactors: when a level fills up, it is sorted
+ * and every other value (from a random start) moves up a level with twice
+ * the weight. Upper levels are widest, so memory stays at a few thousand
+ * values however many are added, and any quantile is answered within about
+ * 1.3% of rank (kll_rank_error).
+ */
+typedef struct KllSketch KllSketch;
+
+/**
+ * @brief Creates an empty sketch.
+ * @return The sketch, or NULL on allocation failure.
+ */
+KllSketch* kll_create(void);
+void kll_free(KllSketch *sketch);
+
+/**
+ * @brief Adds one value.
+ * @return false on allocation failure.
+ */
+bool kll_add(KllSketch *sketch, double value);
+
+/**
+ * @brief Folds 'from' into 'into'; the result summarizes both streams.
+ * @return false on allocation failure.
+ */
+bool kll_merge(KllSketch *into, const KllSketch *from);
+
+/**
+ * @brief Returns the number of values added.
+ */
+size_t kll_count(const KllSketch *sketch);
+
+/**
+ * @brief Returns the value at 'fraction' (0 to 1) of the sorted stream, or 0
+ *        for an empty sketch.
+ */
+double kll_quantile(const KllSketch *sketch, double fraction);
+
+/**
+ * @brief Returns the fraction of values less than or equal to 'value'.
+ */
+double kll_rank(const KllSketch *sketch, double value);
+
+/**
+ * @brief Returns the typical rank error of kll_quantile and kll_rank.
+ */
+double kll_rank_error(void);
+
+#endif // SKETCH_H
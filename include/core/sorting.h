@@ -17,13 +17,70 @@ struct DSVViewer;
 void sort_view(View *view);
 
 /**
- * @brief Checks if a column in a view is already sorted.
+ * @brief Adds a column to the view's composite sort, or cycles its direction.
+ *
+ * A column not yet in the sort spec is appended as ASC; an ASC key becomes
+ * DESC and a DESC key is removed. The view is re-sorted by all keys at once.
+ *
+ * @param view The view to sort.
+ * @param column The column to add or cycle.
+ * @return False if the spec already holds MAX_SORT_KEYS columns.
+ */
+bool sort_view_toggle_key(View *view, int column);
+
+/**
+ * @brief Frees every sort permutation cached for a view.
+ *
+ * Sorting keeps the ascending permutation of recent sort specs so flipping
+ * direction or returning to an earlier sort only reorders a cached array.
+ * Call this whenever the view's visible rows change. A sort still running in
+ * the background is waited for and discarded.
+ *
+ * @param view The view whose cache to drop.
+ */
+void sort_cache_clear(View *view);
+
+/**
+ * @brief Installs a finished background sort, if the view has one.
+ *
+ * Sorting a very large view orders only the first screen or so of rows
+ * before returning; the complete order is computed on a background thread.
+ * Call this periodically from the UI loop.
  *
  * @param view The view to check.
- * @param column_index The index of the column to check.
- * @param direction The direction to check for (SORT_ASC or SORT_DESC).
- * @return True if the column is sorted, false otherwise.
+ * @return True if a background sort finished and was installed.
+ */
+bool sort_view_poll(View *view);
+
+/**
+ * @brief Blocks until a background sort of the view has finished and is installed.
+ * @param view The view to wait for (no-op if it has no pending sort).
+ */
+void sort_view_wait(View *view);
+
+/**
+ * @brief Returns how many displayed rows are already in their sorted position.
+ *
+ * Equals visible_row_count unless a background sort is still running.
+ */
+size_t sort_view_ready_rows(const View *view);
+
+/**
+ * @brief Sets how much memory a sort may use before it spills sorted runs to
+ *        temporary files and merges them from disk.
+ *
+ * @param bytes The budget in bytes; 0 restores the default.
+ */
+void sort_set_memory_budget(size_t bytes);
+
+/**
+ * @brief Chooses how text columns are ordered: case-folded bytes (the
+ *        default) or the current LC_COLLATE locale.
+ *
+ * Collation keys are computed once per row with strxfrm, so locale-aware
+ * sorts compare binary keys just like byte-ordered ones. Set this before
+ * sorting; permutations already cached keep the order they were built with.
  */
-bool is_column_sorted(View *view, int column_index, SortDirection direction);
+void sort_set_locale_collation(bool enabled);
 
 #endif // SORTING_H
\ No newline at end of file
@@ -0,0 +1,102 @@
+#ifndef TRIGRAM_INDEX_H
+#define TRIGRAM_INDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "error_context.h"
+
+/**
+ * @brief An inverted index from the 3-byte sequences of a file's rows to the
+ *        blocks of rows they occur in.
+ *
+ * Rows are grouped into fixed-size blocks and every trigram keeps a sorted,
+ * delta-varint encoded list of the blocks containing it, with a skip entry
+ * every few postings so lists can be entered at any block. Trigrams are
+ * recorded with ASCII letters folded to lower case and never span a
+ * delimiter, quote or line break, so one index serves case-sensitive and
+ * case-insensitive searches for literals that read the same in the file as on
+ * screen.
+ */
+typedef struct TrigramIndex TrigramIndex;
+
+// Appended to a data file's path to name its saved index.
+#define TRIGRAM_INDEX_SUFFIX ".trigrams"
+
+/**
+ * @brief The candidate blocks of one search term: those holding every
+ *        trigram of the term.
+ */
+typedef struct TrigramQuery TrigramQuery;
+
+// The rows an index is built over.
+typedef struct {
+    const char *data;            // Raw file bytes
+    size_t length;
+    const size_t *row_offsets;   // Byte offset where each row starts
+    size_t row_count;
+    char delimiter;
+    int64_t source_modified;     // Modification time, checked when loading
+    size_t block_rows;           // Rows per block, 0 for the default
+} TrigramIndexInput;
+
+/**
+ * @brief Builds an index over the input's rows.
+ *
+ * @param input The rows to index.
+ * @param cancel Checked every few blocks; the build is abandoned once it is
+ *               non-zero (may be NULL).
+ * @return The index, or NULL if the build was cancelled or ran out of memory.
+ */
+TrigramIndex* trigram_index_build(const TrigramIndexInput *input, const int *cancel);
+
+/**
+ * @brief Writes an index to 'path', through a temporary file renamed into
+ *        place so a reader never sees a partial index.
+ *
+ * @return DSV_OK, or DSV_ERROR_FILE_IO.
+ */
+DSVResult trigram_index_save(const TrigramIndex *index, const char *path);
+
+/**
+ * @brief Maps an index saved by trigram_index_save.
+ *
+ * @return The index, or NULL if there is none or it was built for a different
+ *         version of the file (size, modification time, row count, delimiter
+ *         or block size differ).
+ */
+TrigramIndex* trigram_index_load(const char *path, const TrigramIndexInput *input);
+
+/**
+ * @brief Frees an index (or unmaps a loaded one).
+ */
+void trigram_index_free(TrigramIndex *index);
+
+/**
+ * @brief Returns the number of rows per block.
+ */
+size_t trigram_index_block_rows(const TrigramIndex *index);
+
+/**
+ * @brief Prepares the posting lists of a term's trigrams for intersection.
+ *
+ * Trigrams holding a delimiter, quote or line break are left out, as are
+ * trigrams with non-ASCII bytes when ignoring case.
+ *
+ * @return The query, or NULL if the term has no usable trigram (or on
+ *         allocation failure); every block is then a candidate.
+ */
+TrigramQuery* trigram_query_create(const TrigramIndex *index, const char *term, size_t length, bool ignore_case);
+
+/**
+ * @brief Returns the first candidate block at or after 'block', or SIZE_MAX
+ *        if there is none. Calls must ask for non-decreasing blocks.
+ */
+size_t trigram_query_next_block(TrigramQuery *query, size_t block);
+
+/**
+ * @brief Frees a query.
+ */
+void trigram_query_free(TrigramQuery *query);
+
+#endif // TRIGRAM_INDEX_H
@@ -2,10 +2,11 @@
 #define VALUE_INDEX_H
 
 #include <stddef.h>
+#include "memory/arena.h"
 
 // Represents the list of rows where a specific value was found.
 typedef struct {
-    size_t *indices;    // Dynamically allocated array of row indices
+    size_t *indices;    // Array of row indices, in the order the rows were displayed
     size_t count;       // Number of row indices
 } RowIndexArray;
 
@@ -13,21 +14,50 @@ typedef struct {
 // This is a simplified hash map from a string value to a RowIndexArray.
 typedef struct ValueIndexEntry {
     char *value;
+    size_t length;
     RowIndexArray rows;
     struct ValueIndexEntry *next;
 } ValueIndexEntry;
 
-typedef struct {
+// The result of a frequency analysis. It is shared by the analyzed view's
+// cache and the frequency views opened from it, so it is reference counted.
+// Entries, values and row arrays all live in the index's arena.
+typedef struct ValueIndex {
     ValueIndexEntry **buckets;
     size_t size;
     size_t count;
+    ValueIndexEntry **sorted;   // Entries in display order, most frequent first (NULL until set)
+    size_t value_width;         // Length of the longest value
+    size_t max_count;           // Largest row count of any value
+    int refcount;
+    Arena arena;
 } ValueIndex;
 
 // --- Function Declarations ---
 
 ValueIndex* create_value_index(size_t size);
+
+/**
+ * @brief Takes another reference to an index.
+ * @return The index, for convenience.
+ */
+ValueIndex* value_index_retain(ValueIndex *index);
+
+/**
+ * @brief Drops a reference to an index, freeing it with the last one.
+ */
 void free_value_index(ValueIndex *index);
+
 const RowIndexArray* get_from_value_index(const ValueIndex *index, const char *value);
-void add_to_value_index(ValueIndex *index, const char *value, size_t *row_indices, size_t count);
 
-#endif // VALUE_INDEX_H 
\ No newline at end of file
+/**
+ * @brief Adds a value with room for 'count' row indices, which the caller
+ *        fills in through the returned entry's rows.indices.
+ *
+ * @return The new entry, or NULL on allocation failure.
+ */
+ValueIndexEntry* value_index_add_entry(ValueIndex *index, const char *value, size_t length, size_t count);
+
+ValueIndexEntry* add_to_value_index(ValueIndex *index, const char *value, size_t *row_indices, size_t count);
+
+#endif // VALUE_INDEX_H
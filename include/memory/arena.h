@@ -0,0 +1,51 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+/**
+ * @brief A bump allocator made of a chain of blocks.
+ *
+ * Allocations never move once made, so pointers into an arena stay valid
+ * until the arena is reset or freed. Individual allocations cannot be freed.
+ * An arena is not thread-safe; parallel workers each use their own.
+ */
+typedef struct ArenaBlock ArenaBlock;
+
+typedef struct {
+    ArenaBlock *head;        // Block currently being filled
+    size_t block_size;       // Minimum size of newly allocated blocks
+    size_t total_allocated;  // Bytes handed out since the last reset
+} Arena;
+
+/**
+ * @brief Initializes an empty arena. No memory is allocated until first use.
+ *
+ * @param arena The arena to initialize.
+ * @param block_size Preferred block size in bytes (0 selects a default).
+ */
+void arena_init(Arena *arena, size_t block_size);
+
+/**
+ * @brief Allocates 'size' bytes aligned for any scalar type.
+ *
+ * @return A pointer into the arena, or NULL on allocation failure.
+ */
+void* arena_alloc(Arena *arena, size_t size);
+
+/**
+ * @brief Copies 'length' bytes into the arena and NUL-terminates them.
+ */
+char* arena_strndup(Arena *arena, const char *str, size_t length);
+
+/**
+ * @brief Discards every allocation but keeps one block for reuse.
+ */
+void arena_reset(Arena *arena);
+
+/**
+ * @brief Releases all memory owned by the arena.
+ */
+void arena_free(Arena *arena);
+
+#endif // ARENA_H
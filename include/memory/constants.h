@@ -31,6 +31,11 @@
 #define DEFAULT_COLUMN_ANALYSIS_LINES 1000
 #define DEFAULT_CACHE_THRESHOLD_LINES 500
 #define DEFAULT_CACHE_THRESHOLD_COLS 50
+#define DEFAULT_WORKER_THREADS 0 // 0 = one per online CPU
+#define DEFAULT_SORT_MEMORY_MB 4096 // Larger sorts spill runs to temporary files
+#define DEFAULT_SORT_COLLATION 0 // 1 = order text by the locale instead of bytes
+#define DEFAULT_TRIGRAM_INDEX 0 // 1 = build or load a trigram index for search
+#define DEFAULT_APPROX_DISTINCT_THRESHOLD 1000000 // Larger columns get approximate frequency analysis
 
 // Hash Constants (FNV-1a)
 #define FNV_OFFSET_BASIS 0x811c9dc5
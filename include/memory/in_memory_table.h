@@ -2,25 +2,78 @@
 #define IN_MEMORY_TABLE_H
 
 #include <stddef.h>
+#include <stdint.h>
+
+// Large enough for any formatted int64 or "%.15g" double plus the terminator.
+#define IN_MEMORY_NUMBER_BUFFER_SIZE 32
+
+/**
+ * @brief The physical storage type of an in-memory column.
+ */
+typedef enum {
+    COLUMN_TYPE_STRING,
+    COLUMN_TYPE_INT64,
+    COLUMN_TYPE_DOUBLE
+} ColumnType;
+
+/**
+ * @brief A single column of an in-memory table.
+ *
+ * String columns pack every cell into one growing arena (each cell is
+ * NUL-terminated) and keep an offset and a length per row, so a column costs a
+ * handful of allocations no matter how many rows it holds. Numeric columns
+ * store native values and are only formatted when displayed.
+ */
+typedef struct {
+    ColumnType type;
+
+    // COLUMN_TYPE_STRING storage
+    char *arena;              // Packed, NUL-terminated cell contents
+    size_t arena_size;        // Bytes used in the arena
+    size_t arena_capacity;    // Bytes allocated for the arena
+    size_t *offsets;          // Arena offset of each row's cell
+    uint32_t *lengths;        // Byte length of each row's cell
+
+    // Numeric storage
+    int64_t *i64;             // COLUMN_TYPE_INT64 values
+    double *f64;              // COLUMN_TYPE_DOUBLE values
+
+    size_t max_length;        // Longest rendered cell appended so far
+} InMemoryColumn;
+
+/**
+ * @brief A single value used when appending typed rows.
+ *
+ * Which member is read depends on the type of the target column.
+ */
+typedef union {
+    struct {
+        const char *ptr;
+        size_t len;
+    } str;
+    int64_t i64;
+    double f64;
+} InMemoryValue;
 
 /**
  * @brief A generic structure for holding tabular data in memory.
  *
  * This struct is designed to be self-contained and independent of the UI or
- * any other application component. It stores a header, a 2D array of strings
- * for the data, and the dimensions of the table.
+ * any other application component. Data is stored column-major: each column
+ * owns its own arena or numeric array, so building and freeing a table is
+ * O(columns) in allocations rather than O(cells).
  */
 typedef struct InMemoryTable {
-    char *title;          // Optional title for the data table.
-    char **headers;       // Array of strings for column headers.
-    char ***data;         // 2D array of strings for row data.
-    size_t row_count;     // Number of data rows currently stored.
-    size_t col_count;     // Number of columns.
-    size_t capacity;      // Allocated row capacity.
+    char *title;              // Optional title for the data table.
+    char **headers;           // Array of strings for column headers.
+    InMemoryColumn *columns;  // Column storage, col_count entries.
+    size_t row_count;         // Number of data rows currently stored.
+    size_t col_count;         // Number of columns.
+    size_t capacity;          // Allocated row capacity of every column.
 } InMemoryTable;
 
 /**
- * @brief Creates a new, empty in-memory table.
+ * @brief Creates a new, empty in-memory table whose columns all hold strings.
  *
  * @param title The title of the table. Can be NULL.
  * @param col_count The number of columns the table will have.
@@ -29,10 +82,22 @@ typedef struct InMemoryTable {
  */
 InMemoryTable* create_in_memory_table(const char *title, size_t col_count, const char **headers);
 
+/**
+ * @brief Creates a new, empty in-memory table with typed columns.
+ *
+ * @param title The title of the table. Can be NULL.
+ * @param col_count The number of columns the table will have.
+ * @param headers An array of strings for the column headers. The contents are copied.
+ * @param types The storage type of each column. NULL means all strings.
+ * @return A pointer to the newly created InMemoryTable, or NULL on failure.
+ */
+InMemoryTable* create_typed_in_memory_table(const char *title, size_t col_count, const char **headers, const ColumnType *types);
+
 /**
  * @brief Adds a new row to the in-memory table.
  *
  * The table will automatically resize its internal storage if necessary.
+ * Cells of numeric columns are parsed from their string form.
  *
  * @param table The table to add the row to.
  * @param row_data An array of strings representing the data for the new row.
@@ -40,13 +105,41 @@ InMemoryTable* create_in_memory_table(const char *title, size_t col_count, const
  */
 int add_in_memory_table_row(InMemoryTable *table, const char **row_data);
 
+/**
+ * @brief Adds a new row of native values to the in-memory table.
+ *
+ * @param table The table to add the row to.
+ * @param values One value per column, interpreted according to the column type.
+ * @return 0 on success, -1 on failure.
+ */
+int add_in_memory_table_row_values(InMemoryTable *table, const InMemoryValue *values);
+
+/**
+ * @brief Returns a pointer to a string cell and its length. O(1).
+ *
+ * @return The NUL-terminated cell, or NULL if out of range or not a string column.
+ */
+const char* in_memory_table_get_string(const InMemoryTable *table, size_t row, size_t col, size_t *out_length);
+
+/**
+ * @brief Formats any cell as text into the caller's buffer.
+ *
+ * @return The length of the formatted text.
+ */
+size_t in_memory_table_format_cell(const InMemoryTable *table, size_t row, size_t col, char *buffer, size_t buffer_size);
+
+/**
+ * @brief Returns the display width of a column (header included). O(1).
+ */
+size_t in_memory_table_column_width(const InMemoryTable *table, size_t col);
+
 /**
  * @brief Frees all memory associated with an in-memory table.
  *
- * This includes the title, headers, and all row data.
+ * This includes the title, headers, and all column storage. O(columns).
  *
  * @param table The table to free.
  */
 void free_in_memory_table(InMemoryTable *table);
 
-#endif // IN_MEMORY_TABLE_H 
\ No newline at end of file
+#endif // IN_MEMORY_TABLE_H
@@ -5,6 +5,7 @@
 #include <wchar.h>
 #include <locale.h>
 #include <stdbool.h>
+#include <pthread.h>
 
 // Forward declaration
 struct DSVViewer;
@@ -49,6 +50,12 @@ typedef struct {
     const char* separator;
     int *col_widths;
     size_t num_cols;
+
+    // Background width measurement (see start_column_width_analysis)
+    pthread_t width_thread;
+    bool width_thread_running;  // Started and not yet joined
+    int width_cancel;
+    int *sampled_widths;        // Published by the thread when done
     WorkBuffers buffers;
     int needs_redraw;
     char copy_status[256];
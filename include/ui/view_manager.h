@@ -22,6 +22,14 @@ typedef enum {
     SORT_DESC
 } SortDirection;
 
+#define MAX_SORT_KEYS 8
+
+// One column of a (possibly composite) sort specification
+typedef struct {
+    int column;
+    SortDirection direction;
+} SortKeySpec;
+
 typedef struct View {
     char name[64];
     DataSource *data_source;      // NEW: Data source for this view
@@ -37,7 +45,15 @@ typedef struct View {
     int sort_column;              // Column index for sorting, -1 if not sorted
     int last_sorted_column;       // New field to track the last column sorted
     SortDirection sort_direction; // Direction of the sort
+    SortKeySpec sort_keys[MAX_SORT_KEYS]; // Full sort spec; sort_keys[0] mirrors sort_column/sort_direction
+    size_t sort_key_count;        // Number of keys in sort_keys, 0 if not sorted
+    struct SortCache *sort_cache; // Sorted permutations kept for re-use (see sorting.h)
+    struct PendingSort *pending_sort; // Sort finishing in the background, NULL if none
     size_t *row_order_map;        // Maps displayed row to an index in the visible set
+    size_t row_order_map_mapped;  // Entries if row_order_map is file-backed (mmap), else 0
+    size_t order_version;         // Bumped whenever the display order changes
+    struct SearchHits *search_hits; // Matches of the last search (see search.h)
+    struct PendingSearch *pending_search; // Incremental search running in the background, NULL if none
     
     // Parent-child relationship for linked views
     struct View *parent;            // Pointer to the parent view (NULL if this is a main view)
@@ -45,10 +61,13 @@ typedef struct View {
                                   // this is the column index in the parent view that was analyzed.
     
     ValueIndex *value_index;      // Holds the value-to-row-list mapping for analysis views
+    struct ApproxFrequency *approx_frequency; // Estimate behind an approximate frequency view (owned)
     
     // Cache for analysis results
     ValueIndex **analysis_cache;  // Array of pointers to ValueIndex, one per column
     size_t analysis_cache_size;   // Size of the analysis_cache array
+    struct ColumnStats **column_stats; // Statistics per column, computed on demand (see column_stats.h)
+    size_t column_stats_size;     // Size of the column_stats array
 
     // Reverse map for fast row lookups
     size_t *reverse_row_map;       // Maps actual data source row index to display index
@@ -88,6 +107,20 @@ void close_current_view(ViewManager *manager, ViewState *state);
 View* create_view_from_selection(ViewManager *manager, ViewState *state, 
                                  size_t *selected_rows, size_t count,
                                  DataSource *parent_data_source);
+
+/**
+ * @brief Creates a view showing the given ranges of the parent's data source
+ *        rows and makes it current.
+ *
+ * @param ranges Ascending, non-overlapping ranges. The view takes ownership
+ *               of the array on success.
+ * @param num_ranges Number of ranges.
+ * @param count Total number of rows across the ranges.
+ * @return The new view, or NULL if the view limit was reached or memory ran out.
+ */
+View* create_view_from_ranges(ViewManager *manager, ViewState *state,
+                              RowRange *ranges, size_t num_ranges, size_t count,
+                              DataSource *parent_data_source);
 void reset_view_state_for_new_view(ViewState *state, View *new_view);
 bool add_view_to_manager(ViewManager *manager, View *view);
 
@@ -101,6 +134,33 @@ bool add_view_to_manager(ViewManager *manager, View *view);
  */
 size_t view_get_actual_row_index(const View *view, size_t display_row);
 
+/**
+ * @brief Walks the visible set of a view in order without re-scanning the
+ *        range list for every row. Safe to use from several threads at once,
+ *        each with its own iterator.
+ */
+typedef struct {
+    const View *view;
+    size_t range_index;   // Range holding the next row (ranged views only)
+    size_t next_row;      // Next data source row to return
+    size_t remaining;     // Visible rows left to return
+} ViewRowIterator;
+
+/**
+ * @brief Positions an iterator at a visible-set index.
+ *
+ * @param it The iterator to initialize.
+ * @param view The view to walk.
+ * @param visible_index First visible-set index to return (unsorted order).
+ * @param count Maximum number of rows to return.
+ */
+void view_row_iterator_init(ViewRowIterator *it, const View *view, size_t visible_index, size_t count);
+
+/**
+ * @brief Returns the next data source row, or SIZE_MAX when exhausted.
+ */
+size_t view_row_iterator_next(ViewRowIterator *it);
+
 /**
  * @brief Gets the actual data source row index for a given displayed row,
  *        accounting for both filtering (ranges) and sorting.
@@ -140,4 +200,12 @@ void update_parent_selection_from_child(View *child_view);
  */
 void view_build_reverse_map(View *view);
 
+/**
+ * @brief Releases a view's row_order_map, whether it lives on the heap or
+ *        in a file-backed mapping left by an external sort.
+ *
+ * @param view The view whose row order map to free.
+ */
+void view_free_row_order_map(View *view);
+
 #endif // VIEW_MANAGER_H 
\ No newline at end of file
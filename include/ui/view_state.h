@@ -22,13 +22,16 @@ typedef enum {
     PANEL_TABLE_VIEW,
     PANEL_HELP,
     PANEL_FREQ_ANALYSIS,
-    // Future: PANEL_COLUMN_STATS, PANEL_ROW_DETAILS
+    PANEL_COLUMN_STATS,  // Statistics of the cursor column over the table
+    // Future: PANEL_ROW_DETAILS
 } PanelType;
 
 // Different modes for user input
 typedef enum {
     INPUT_MODE_NORMAL,   // Navigating the table
     INPUT_MODE_SEARCH,   // Typing a search query
+    INPUT_MODE_EXPRESSION, // Typing a computed column definition
+    INPUT_MODE_JOIN,     // Typing the file (and key column) to join with
     // Future: INPUT_MODE_COMMAND
 } InputMode;
 
@@ -37,7 +40,9 @@ typedef struct {
     PanelType current_panel;
     InputMode input_mode;
     char search_term[256];
-    char search_message[256];
+    int search_flags;         // SearchFlags for search_term (see search.h)
+    char search_message[352];  // Fits the whole search_term plus the match counts
+    char prompt_input[256];   // Text typed at the expression or join prompt
     bool needs_redraw;
     struct View *current_view; // The view whose data is being displayed
     
@@ -0,0 +1,37 @@
+#ifndef BYTE_SEARCH_H
+#define BYTE_SEARCH_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * @brief Finds the first occurrence of a byte string in a buffer.
+ *
+ * Like memmem, but candidate positions are found 16 bytes at a time by
+ * comparing the needle's first and last bytes with SIMD, so scanning large
+ * buffers for rare terms runs close to memory bandwidth.
+ *
+ * @return A pointer to the first match, or NULL if there is none.
+ */
+const char* find_bytes(const char *haystack, size_t haystack_length, const char *needle, size_t needle_length);
+
+/**
+ * @brief Like find_bytes, but letters match regardless of case.
+ *
+ * ASCII needles are matched by folding 16 haystack bytes at a time with SIMD,
+ * which costs little more than the case-sensitive scan. Needles with non-ASCII
+ * bytes are decoded as UTF-8 and matched with simple one-to-one case folding
+ * (Latin-1, Latin Extended-A, Greek and Cyrillic) by a scalar scan.
+ *
+ * @return A pointer to the first match, or NULL if there is none.
+ */
+const char* find_bytes_ignore_case(const char *haystack, size_t haystack_length,
+                                   const char *needle, size_t needle_length);
+
+/**
+ * @brief Returns true if the NUL-terminated 'text' contains 'term', ignoring
+ *        case if asked to.
+ */
+bool text_contains(const char *text, const char *term, bool ignore_case);
+
+#endif // BYTE_SEARCH_H
@@ -0,0 +1,47 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <stddef.h>
+#include "error_context.h"
+
+// A unit of work executed by parallel_for. 'task_index' is in [0, task_count).
+typedef void (*ParallelTaskFn)(void *arg, size_t task_index);
+
+/**
+ * @brief Sets the maximum number of worker threads used by parallel_for.
+ * @param workers Worker count; 0 (or negative) means one per online CPU.
+ */
+void parallel_set_max_workers(int workers);
+
+/**
+ * @brief Returns the number of workers parallel_for will use at most.
+ */
+size_t parallel_worker_count(void);
+
+/**
+ * @brief Splits 'items' into a number of chunks suitable for parallel_for.
+ *
+ * Produces a few chunks per worker so uneven chunks balance out, but never
+ * chunks smaller than 'min_items_per_chunk'.
+ *
+ * @return The chunk count (at least 1 when items > 0, 0 when items == 0).
+ */
+size_t parallel_chunk_count(size_t items, size_t min_items_per_chunk);
+
+/**
+ * @brief Returns the half-open item range [*begin, *end) of chunk 'chunk'.
+ */
+void parallel_chunk_bounds(size_t items, size_t chunks, size_t chunk, size_t *begin, size_t *end);
+
+/**
+ * @brief Runs fn(arg, i) for every i in [0, task_count) on a pool of threads.
+ *
+ * The calling thread participates; tasks are handed out dynamically. If
+ * threads cannot be created the remaining tasks run on the calling thread, so
+ * all tasks always complete before this function returns.
+ *
+ * @return DSV_OK, or DSV_ERROR_INVALID_ARGS if fn is NULL.
+ */
+DSVResult parallel_for(size_t task_count, ParallelTaskFn fn, void *arg);
+
+#endif // PARALLEL_H
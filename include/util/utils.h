@@ -24,6 +24,7 @@ void* safe_realloc(void *ptr, size_t size, const char *context);
 
 // Hashing
 uint32_t fnv1a_hash(const char *str);
+uint64_t hash_bytes(const char *data, size_t length); // 64-bit, reads 8 bytes at a time
 bool is_string_numeric(const char *s);
 
 #endif // UTILS_H 
\ No newline at end of file
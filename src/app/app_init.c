@@ -9,6 +9,8 @@
 #include "buffer_pool.h"
 #include "view_manager.h"
 #include "core/data_source.h"
+#include "core/sorting.h"
+#include "parallel.h"
 
 #include <string.h>
 #include <stdio.h>
@@ -19,6 +21,9 @@
 
 static DSVResult init_viewer_components(struct DSVViewer *viewer, const DSVConfig *config) {
     viewer->config = config;
+    parallel_set_max_workers(config->worker_threads);
+    sort_set_memory_budget((size_t)config->sort_memory_mb << 20);
+    sort_set_locale_collation(config->sort_collation != 0);
 
     viewer->display_state = calloc(1, sizeof(DisplayState));
     if (!viewer->display_state) {
@@ -77,8 +82,12 @@ static void cleanup_viewer_resources(struct DSVViewer *viewer) {
 void cleanup_viewer(DSVViewer *viewer) {
     if (!viewer) return;
 
-    destroy_data_source(viewer->main_data_source);
+    // The width thread reads the file, so it stops before anything is freed.
+    stop_column_width_analysis(viewer);
+
+    // Views may wrap the main data source, so they go first.
     cleanup_view_manager(viewer->view_manager);
+    destroy_data_source(viewer->main_data_source);
     cleanup_file_data(viewer); // from file_io.h
     cleanup_cache_system(viewer); // from cache.h
     cleanup_viewer_resources(viewer);
@@ -214,7 +223,9 @@ void init_view_state(ViewState *state) {
     state->current_panel = PANEL_TABLE_VIEW;
     state->input_mode = INPUT_MODE_NORMAL;
     state->search_term[0] = '\0';
+    state->search_flags = 0;
     state->search_message[0] = '\0';
+    state->prompt_input[0] = '\0';
     state->needs_redraw = true;
     // Selection state is now handled per-View, not in ViewState
     state->current_view = NULL;
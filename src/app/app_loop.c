@@ -5,9 +5,36 @@
 #include "parsed_data.h"
 #include "view_manager.h"
 #include "core/data_source.h"
+#include "core/sorting.h"
+#include "core/search.h"
+#include "core/analysis.h"
 #include <ncurses.h>
 #include <stdbool.h>
 
+// How often the screen is refreshed while a sort, search or width measurement finishes in the background
+#define BACKGROUND_POLL_INTERVAL_MS 100
+
+// Installs a finished background sort, or waits for it if the user has
+// scrolled past the rows that are already in order.
+static void update_pending_sort(ViewState *state) {
+    View *view = state->current_view;
+    if (!view || !view->pending_sort) return;
+
+    if (sort_view_poll(view)) {
+        state->needs_redraw = true;
+    } else if (view->start_row + (size_t)LINES > sort_view_ready_rows(view)) {
+        sort_view_wait(view);
+        state->needs_redraw = true;
+    }
+}
+
+// Shows the match count once a search-as-you-type scan finishes.
+static void update_pending_search(ViewState *state) {
+    if (search_incremental_poll(state->current_view)) {
+        state->needs_redraw = true;
+    }
+}
+
 void run_viewer(DSVViewer *viewer) {
     // The global viewer state is already initialized by init_viewer.
     
@@ -44,9 +71,15 @@ void run_viewer(DSVViewer *viewer) {
     viewer->view_manager->current = main_view;
     viewer->view_manager->view_count = 1;
 
+    bool painted = false;
     while (1) {
         ViewState *current_state = &viewer->view_state;
         current_state->current_view = viewer->view_manager->current;
+        update_pending_sort(current_state);
+        update_pending_search(current_state);
+        if (poll_column_width_analysis(viewer)) {
+            current_state->needs_redraw = true;
+        }
 
         // Only redraw when needed
         if (current_state->needs_redraw) {
@@ -54,6 +87,18 @@ void run_viewer(DSVViewer *viewer) {
             current_state->needs_redraw = false;
         }
 
+        // The first paint is measured from the head of the file; the rest of
+        // it is sampled in the background.
+        if (!painted) {
+            start_column_width_analysis(viewer);
+            painted = true;
+        }
+
+        // Wake up periodically while a sort or search is finishing in the background
+        View *current_view = current_state->current_view;
+        bool pending = current_view && (current_view->pending_sort || current_view->pending_search);
+        pending = pending || viewer->display_state->width_thread_running;
+        timeout(pending ? BACKGROUND_POLL_INTERVAL_MS : -1);
         int ch = getch();
         
         // Handle mouse events and other special cases that can cause busy loops
@@ -36,6 +36,11 @@ void config_init_defaults(DSVConfig *config) {
     
     // Analysis
     config->column_analysis_sample_lines = DEFAULT_COLUMN_ANALYSIS_LINES;
+    config->worker_threads = DEFAULT_WORKER_THREADS;
+    config->sort_memory_mb = DEFAULT_SORT_MEMORY_MB;
+    config->sort_collation = DEFAULT_SORT_COLLATION;
+    config->trigram_index = DEFAULT_TRIGRAM_INDEX;
+    config->approx_distinct_threshold = DEFAULT_APPROX_DISTINCT_THRESHOLD;
     
     // Encoding settings
     config->force_encoding = NULL;               // Auto-detect by default
@@ -138,6 +143,11 @@ DSVResult config_load_from_file(DSVConfig *config, const char *filename) {
         else SET_CONFIG_INT(default_chars_per_line)
         // Analysis
         else SET_CONFIG_INT(column_analysis_sample_lines)
+        else SET_CONFIG_INT(worker_threads)
+        else SET_CONFIG_INT(sort_memory_mb)
+        else SET_CONFIG_INT(sort_collation)
+        else SET_CONFIG_INT(trigram_index)
+        else SET_CONFIG_INT(approx_distinct_threshold)
         // Encoding
         else SET_CONFIG_INT(encoding_detection_sample_size)
         else SET_CONFIG_INT(auto_detect_encoding)
@@ -206,6 +216,17 @@ DSVResult config_validate(const DSVConfig *config) {
 
     // Analysis
     VALIDATE_POSITIVE_INT(column_analysis_sample_lines)
+    if (config->worker_threads < 0) {
+        LOG_ERROR("Invalid config: 'worker_threads' cannot be negative.");
+        return DSV_ERROR;
+    }
+    VALIDATE_POSITIVE_INT(sort_memory_mb)
+    // sort_collation is a 0/1 flag, so no validation needed
+    // trigram_index is a 0/1 flag, so no validation needed
+    if (config->approx_distinct_threshold < 0) {
+        LOG_ERROR("Invalid config: 'approx_distinct_threshold' cannot be negative.");
+        return DSV_ERROR;
+    }
     
     // Encoding
     VALIDATE_POSITIVE_INT(encoding_detection_sample_size)
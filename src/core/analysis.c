@@ -8,14 +8,22 @@
 #include "constants.h"
 #include "utils.h"
 #include "cache.h"
+#include <math.h>
 #include <stdlib.h>
 #include <string.h>
 #include <wchar.h>
 #include <sys/stat.h>
 #include <stdint.h>
+#include <pthread.h>
 #include "logging.h"
 #include "util/utils.h"
 #include "core/value_index.h"
+#include "util/parallel.h"
+#include "memory/arena.h"
+#include "core/sketch.h"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 // --- Public API Functions ---
 
@@ -24,56 +32,74 @@ void cleanup_column_analysis(ColumnAnalysis *analysis) {
     SAFE_FREE(analysis->col_widths);
 }
 
-// Calculate the width for a single column by sampling the file data
-static int calculate_single_column_width(DSVViewer *viewer, int column_index) {
+// --- Column Widths ---
+
+#define FIRST_PAINT_WIDTH_LINES 100   // Lines measured before the first paint
+
+// Widens 'widths' to fit 'sample' lines spread evenly over [first, first + span),
+// parsing each line once for all columns. Returns false if cancelled.
+static bool measure_column_widths(const DSVViewer *viewer, size_t first, size_t span, size_t sample,
+                                  FieldDesc *fields, int *widths, const int *cancel) {
     const FileData *file_data = viewer->file_data;
     const ParsedData *parsed_data = viewer->parsed_data;
     const DSVConfig *config = viewer->config;
-
-    // Handle empty files or invalid column index
-    if (parsed_data->num_lines == 0 || column_index < 0 || (size_t)column_index >= viewer->display_state->num_cols) {
-        return config->min_column_width;
+    size_t num_cols = viewer->display_state->num_cols;
+    char temp_buffer[config->max_field_len];
+
+    if (sample > span) sample = span;
+    for (size_t i = 0; i < sample; i++) {
+        if (cancel && __atomic_load_n(cancel, __ATOMIC_RELAXED)) return false;
+        size_t line = first + (size_t)((uint64_t)i * span / sample);
+        size_t num_fields = parse_line(file_data->data, file_data->length, parsed_data->delimiter,
+                                       parsed_data->line_offsets[line], fields, config->max_cols);
+        if (num_fields > num_cols) num_fields = num_cols;
+
+        for (size_t col = 0; col < num_fields; col++) {
+            // Rendering never lengthens a field, so short ones can be skipped.
+            if (widths[col] >= config->max_column_width || fields[col].length <= (size_t)widths[col]) continue;
+            render_field(&fields[col], temp_buffer, sizeof(temp_buffer));
+            int width = (int)strlen(temp_buffer);
+            if (width > widths[col]) widths[col] = width;
+        }
     }
+    return true;
+}
 
-    size_t sample_lines = parsed_data->num_lines > (size_t)config->column_analysis_sample_lines 
-                         ? (size_t)config->column_analysis_sample_lines : parsed_data->num_lines;
-    
-    int max_width = 0;
-    
-    // Reuse the existing fields buffer instead of allocating new one
-    FieldDesc* analysis_fields = parsed_data->fields;
-    if (!analysis_fields) {
-        return config->min_column_width;
-    }
-    
-    // Get header width
-    if (parsed_data->has_header) {
-        char temp_buffer[config->max_field_len];
-        render_field(&parsed_data->header_fields[column_index], temp_buffer, config->max_field_len);
-        max_width = strlen(temp_buffer);
-    }
-
-    for (size_t i = 0; i < sample_lines; i++) {
-        size_t num_fields = parse_line(file_data->data, file_data->length, parsed_data->delimiter, parsed_data->line_offsets[i], analysis_fields, config->max_cols);
-
-        if ((size_t)column_index < num_fields) {
-            if (max_width >= config->max_column_width) break;
-            
-            char temp_buffer[config->max_field_len];
-            render_field(&analysis_fields[column_index], temp_buffer, config->max_field_len);
-            int width = strlen(temp_buffer);
-            
-            if (width > max_width) {
-                max_width = width;
-            }
+// Header widths are the starting point of every measurement.
+static void header_column_widths(const DSVViewer *viewer, int *widths) {
+    const ParsedData *parsed_data = viewer->parsed_data;
+    size_t num_cols = viewer->display_state->num_cols;
+    char temp_buffer[viewer->config->max_field_len];
+    for (size_t col = 0; col < num_cols; col++) {
+        widths[col] = 0;
+        if (parsed_data->has_header && col < parsed_data->num_header_fields) {
+            render_field(&parsed_data->header_fields[col], temp_buffer, sizeof(temp_buffer));
+            widths[col] = (int)strlen(temp_buffer);
         }
     }
+}
 
-    // Clamp width to configured min/max
-    if (max_width > config->max_column_width) max_width = config->max_column_width;
-    if (max_width < config->min_column_width) max_width = config->min_column_width;
-    
-    return max_width;
+static void clamp_column_widths(const DSVConfig *config, int *widths, size_t num_cols) {
+    for (size_t col = 0; col < num_cols; col++) {
+        if (widths[col] > config->max_column_width) widths[col] = config->max_column_width;
+        if (widths[col] < config->min_column_width) widths[col] = config->min_column_width;
+    }
+}
+
+// Fills in every column's width from the first lines of the file.
+static void measure_first_paint_widths(DSVViewer *viewer) {
+    const ParsedData *parsed_data = viewer->parsed_data;
+    int *widths = viewer->display_state->col_widths;
+    header_column_widths(viewer, widths);
+
+    // Reuse the existing fields buffer instead of allocating new one
+    size_t first = parsed_data->has_header ? 1 : 0;
+    size_t lines = parsed_data->num_lines > first ? parsed_data->num_lines - first : 0;
+    if (lines > FIRST_PAINT_WIDTH_LINES) lines = FIRST_PAINT_WIDTH_LINES;
+    if (parsed_data->fields && lines > 0) {
+        measure_column_widths(viewer, first, lines, lines, parsed_data->fields, widths, NULL);
+    }
+    clamp_column_widths(viewer->config, widths, viewer->display_state->num_cols);
 }
 
 int analysis_get_column_width(struct DSVViewer *viewer, int column_index) {
@@ -81,37 +107,108 @@ int analysis_get_column_width(struct DSVViewer *viewer, int column_index) {
         return 0; // Or a default width
     }
 
-    // If width is not calculated yet (is sentinel value), calculate and cache it
+    // If width is not calculated yet (is sentinel value), calculate all of them
     if (viewer->display_state->col_widths[column_index] == -1) {
-        int width = calculate_single_column_width(viewer, column_index);
-        viewer->display_state->col_widths[column_index] = width;
+        measure_first_paint_widths(viewer);
     }
 
     return viewer->display_state->col_widths[column_index];
-} 
-
-// --- Frequency Analysis ---
+}
 
-// Represents a single unique value and its frequency count, used for sorting internally.
 typedef struct {
-    const char *value;  // Points to string owned by hash table entries
-    int count;
-} FreqValueCount;
+    DSVViewer *viewer;
+    int *widths;
+} WidthJob;
+
+static void* column_width_worker(void *arg) {
+    WidthJob *job = arg;
+    DSVViewer *viewer = job->viewer;
+    DisplayState *display_state = viewer->display_state;
+    const ParsedData *parsed_data = viewer->parsed_data;
+    size_t first = parsed_data->has_header ? 1 : 0;
+
+    // The main thread keeps using the parser's fields buffer.
+    FieldDesc *fields = malloc(viewer->config->max_cols * sizeof(FieldDesc));
+    bool done = fields && measure_column_widths(viewer, first, parsed_data->num_lines - first,
+                                                (size_t)viewer->config->column_analysis_sample_lines,
+                                                fields, job->widths, &display_state->width_cancel);
+    free(fields);
+    if (done) {
+        clamp_column_widths(viewer->config, job->widths, display_state->num_cols);
+        __atomic_store_n(&display_state->sampled_widths, job->widths, __ATOMIC_RELEASE);
+    } else {
+        free(job->widths);
+    }
+    free(job);
+    return NULL;
+}
+
+void start_column_width_analysis(struct DSVViewer *viewer) {
+    DisplayState *display_state = viewer->display_state;
+    const ParsedData *parsed_data = viewer->parsed_data;
+    size_t first = parsed_data->has_header ? 1 : 0;
+    if (!display_state->col_widths || display_state->width_thread_running || parsed_data->num_lines <= first) return;
+    // The first lines alone already cover a small file.
+    if (parsed_data->num_lines - first <= FIRST_PAINT_WIDTH_LINES) return;
+
+    if (display_state->col_widths[0] == -1) measure_first_paint_widths(viewer);
+    WidthJob *job = malloc(sizeof(WidthJob));
+    int *widths = malloc(display_state->num_cols * sizeof(int));
+    if (!job || !widths) {
+        free(job);
+        free(widths);
+        return;
+    }
+    memcpy(widths, display_state->col_widths, display_state->num_cols * sizeof(int));
+    *job = (WidthJob){ viewer, widths };
+
+    display_state->width_cancel = 0;
+    if (pthread_create(&display_state->width_thread, NULL, column_width_worker, job) != 0) {
+        LOG_WARN("Could not start the column width thread; measuring in the foreground");
+        column_width_worker(job);
+        poll_column_width_analysis(viewer);
+        return;
+    }
+    display_state->width_thread_running = true;
+}
+
+bool poll_column_width_analysis(struct DSVViewer *viewer) {
+    DisplayState *display_state = viewer->display_state;
+    int *widths = __atomic_load_n(&display_state->sampled_widths, __ATOMIC_ACQUIRE);
+    if (!widths) return false;
+
+    if (display_state->width_thread_running) {
+        pthread_join(display_state->width_thread, NULL);
+        display_state->width_thread_running = false;
+    }
+    memcpy(display_state->col_widths, widths, display_state->num_cols * sizeof(int));
+    free(widths);
+    display_state->sampled_widths = NULL;
+    return true;
+}
+
+void stop_column_width_analysis(struct DSVViewer *viewer) {
+    DisplayState *display_state = viewer->display_state;
+    if (!display_state) return;
+    if (display_state->width_thread_running) {
+        __atomic_store_n(&display_state->width_cancel, 1, __ATOMIC_RELAXED);
+        pthread_join(display_state->width_thread, NULL);
+        display_state->width_thread_running = false;
+    }
+    SAFE_FREE(display_state->sampled_widths);
+}
+
+// --- Frequency Analysis ---
 
 // Context for the frequency analysis qsort_r
 typedef struct {
     bool is_value_numeric;
 } FreqSortContext;
 
-#ifdef __APPLE__
-// macOS comparator for frequency analysis sort
-static int compare_freq_counts(void *context, const void *a, const void *b) {
-    FreqSortContext *ctx = (FreqSortContext *)context;
-    const FreqValueCount *itemA = (const FreqValueCount *)a;
-    const FreqValueCount *itemB = (const FreqValueCount *)b;
-
-    if (itemA->count != itemB->count) {
-        return itemB->count - itemA->count;
+// Orders by count, then by value, both descending.
+static int compare_freq_items(const FreqSortContext *ctx, const ValueIndexEntry *itemA, const ValueIndexEntry *itemB) {
+    if (itemA->rows.count != itemB->rows.count) {
+        return itemA->rows.count < itemB->rows.count ? 1 : -1;
     }
 
     if (ctx->is_value_numeric) {
@@ -124,53 +221,68 @@ static int compare_freq_counts(void *context, const void *a, const void *b) {
         return strcmp(itemB->value, itemA->value);
     }
 }
+
+#ifdef __APPLE__
+// macOS comparator for frequency analysis sort
+static int compare_freq_counts(void *context, const void *a, const void *b) {
+    return compare_freq_items((const FreqSortContext *)context, *(ValueIndexEntry *const *)a, *(ValueIndexEntry *const *)b);
+}
 #else
 // Linux comparator for frequency analysis sort
 static int compare_freq_counts(const void *a, const void *b, void *context) {
-    FreqSortContext *ctx = (FreqSortContext *)context;
-    const FreqValueCount *itemA = (const FreqValueCount *)a;
-    const FreqValueCount *itemB = (const FreqValueCount *)b;
-
-    if (itemA->count != itemB->count) {
-        return itemB->count - itemA->count;
-    }
-
-    if (ctx->is_value_numeric) {
-        long long val_a = strtoll(itemA->value, NULL, 10);
-        long long val_b = strtoll(itemB->value, NULL, 10);
-        if (val_a < val_b) return 1;
-        if (val_a > val_b) return -1;
-        return 0;
-    } else {
-        return strcmp(itemB->value, itemA->value);
-    }
+    return compare_freq_items((const FreqSortContext *)context, *(ValueIndexEntry *const *)a, *(ValueIndexEntry *const *)b);
 }
 #endif
 
 
-#define INITIAL_FREQ_TABLE_SIZE 1024
-
-// An entry in the frequency analysis hash table (internal to this C file)
-typedef struct FreqAnalysisEntry {
-    const char* value;  // OWNED: malloc'd string, must be freed when entry is destroyed
-    int count;
-    size_t *row_indices;         // Dynamically allocated array of row indices
-    size_t row_indices_count;    // Number of row indices stored
-    size_t row_indices_capacity; // Allocated capacity of the array
-    struct FreqAnalysisEntry* next;
+#define INITIAL_FREQ_TABLE_SIZE 1024   // Slots; a power of two
+#define FREQ_GROUP_SIZE 16             // Control bytes probed at once
+#define FREQ_SLOT_EMPTY 0x80
+#define MAX_POSTING_BLOCK_ROWS 1024
+#define MIN_ROWS_PER_FREQ_CHUNK 4096
+#define MAX_FREQ_PARTITIONS 64
+#define APPROX_TOP_VALUES 1000         // Values an approximate analysis reports
+#define APPROX_COUNTERS_PER_VALUE 4    // Space-Saving counters kept per reported value
+#define DISTINCT_SAMPLE_ROWS 65536      // Rows sampled by estimate_distinct_values
+
+// A run of row indices for one value. Blocks double in size up to a cap, so
+// values seen once cost one small arena allocation.
+typedef struct FreqPostingBlock {
+    struct FreqPostingBlock *next;
+    uint32_t count;
+    uint32_t capacity;
+    size_t rows[];
+} FreqPostingBlock;
+
+// One distinct value (internal to this C file)
+typedef struct {
+    uint64_t hash;              // hash_bytes(value, length)
+    const char *value;          // Interned in an arena, NUL-terminated
+    size_t length;
+    size_t count;
+    FreqPostingBlock *head;     // Rows in the order they were added
+    FreqPostingBlock *tail;
 } FreqAnalysisEntry;
 
-// The hash table for frequency analysis (internal to this C file)
+// The hash table for frequency analysis (internal to this C file).
+//
+// Open addressing over groups of FREQ_GROUP_SIZE slots, in the style of
+// Swiss tables: each slot has a control byte holding 7 bits of the hash (or
+// FREQ_SLOT_EMPTY), and a probe compares a whole group of control bytes at
+// once, so full comparisons only happen on likely matches. Slots hold
+// indices into a dense entry array, which keeps rehashing cheap and makes
+// iteration a linear walk. Values and postings live in the table's arena;
+// values are never removed, so there are no tombstones.
 typedef struct {
-    FreqAnalysisEntry** buckets;
-    int size;
-    int item_count;
-    struct DSVViewer *viewer; // For memory pooling (currently unused)
+    uint8_t *ctrl;              // slot_count control bytes
+    uint32_t *slots;            // Entry index per slot
+    size_t slot_count;          // Power of two, at least FREQ_GROUP_SIZE
+    FreqAnalysisEntry *entries;
+    size_t item_count;
+    size_t entry_capacity;
+    Arena arena;                // Interned values and posting blocks
 } FreqAnalysisHashTable;
 
-// Forward declaration for the comparison function
-static void hash_table_resize(FreqAnalysisHashTable *table);
-
 // Helper to get column name, trying header first
 const char* get_column_name(struct DSVViewer *viewer, int column_index, char* buffer, size_t buffer_size) {
     if (viewer->parsed_data && viewer->parsed_data->has_header && column_index < (int)viewer->parsed_data->num_header_fields) {
@@ -185,303 +297,679 @@ const char* get_column_name(struct DSVViewer *viewer, int column_index, char* bu
 
 // Create and initialize a new hash table for frequency analysis
 // OWNERSHIP: Caller owns the returned table and must call hash_table_destroy()
-// Note: Strings stored in the table must be freed separately with hash_table_free_strings()
-static FreqAnalysisHashTable* hash_table_create(struct DSVViewer *viewer, int size) {
-    if (size <= 0) size = INITIAL_FREQ_TABLE_SIZE;
+static FreqAnalysisHashTable* hash_table_create(size_t slot_count) {
+    if (slot_count < INITIAL_FREQ_TABLE_SIZE) slot_count = INITIAL_FREQ_TABLE_SIZE;
 
     FreqAnalysisHashTable* table = calloc(1, sizeof(FreqAnalysisHashTable));
     if (!table) return NULL;
 
-    table->buckets = calloc(size, sizeof(FreqAnalysisEntry*));
-    if (!table->buckets) {
+    table->ctrl = malloc(slot_count);
+    table->slots = malloc(slot_count * sizeof(uint32_t));
+    if (!table->ctrl || !table->slots) {
+        free(table->ctrl);
+        free(table->slots);
         free(table);
         return NULL;
     }
-    
-    table->size = size;
-    table->item_count = 0;
-    table->viewer = viewer; // Store viewer for string interning
+    memset(table->ctrl, FREQ_SLOT_EMPTY, slot_count);
+    table->slot_count = slot_count;
+    arena_init(&table->arena, 0);
     return table;
 }
 
-// Free all memory associated with the hash table
-// OWNERSHIP: Frees the table structure, the buckets array, all entries,
-// and all strings pointed to by the entries.
+// Free all memory associated with the hash table, including every value and
+// posting block in its arena.
 static void hash_table_destroy(FreqAnalysisHashTable *table) {
     if (!table) return;
-
-    // Free the linked lists of entries in each bucket
-    if (table->buckets) {
-    for (int i = 0; i < table->size; i++) {
-        FreqAnalysisEntry *entry = table->buckets[i];
-        while (entry) {
-            FreqAnalysisEntry *next = entry->next;
-                free((char*)entry->value); // Free the strdup'd string
-            free(entry->row_indices);   // Free the row index array
-            free(entry);
-            entry = next;
-        }
-    }
+    free(table->ctrl);
+    free(table->slots);
+    free(table->entries);
+    arena_free(&table->arena);
+    free(table);
 }
 
-    // Free the buckets array and the table structure itself
-    free(table->buckets);
-    free(table);
+static inline uint8_t freq_tag(uint64_t hash) {
+    return (uint8_t)(hash & 0x7F);
 }
 
-// Resize the hash table when it gets too full
-static void hash_table_resize(FreqAnalysisHashTable *table) {
-    if (!table) return;
-    
-    int new_size = table->size * 2;
-    FreqAnalysisEntry** new_buckets = calloc(new_size, sizeof(FreqAnalysisEntry*));
-    if (!new_buckets) return; // Can't resize, oh well
-    
-    // Rehash all existing entries
-    for (int i = 0; i < table->size; i++) {
-        FreqAnalysisEntry *entry = table->buckets[i];
-        while (entry) {
-            FreqAnalysisEntry *next = entry->next;
-            
-            // Rehash to new location
-            uint32_t hash = fnv1a_hash(entry->value);
-            int new_index = hash % new_size;
-            
-            entry->next = new_buckets[new_index];
-            new_buckets[new_index] = entry;
-            
-            entry = next;
-        }
+// Bit i is set if control byte i of the group equals 'byte'.
+static inline uint32_t group_match(const uint8_t *group, uint8_t byte) {
+#ifdef __SSE2__
+    __m128i ctrl = _mm_loadu_si128((const __m128i *)group);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char)byte)));
+#else
+    uint32_t mask = 0;
+    for (int i = 0; i < FREQ_GROUP_SIZE; i++) {
+        if (group[i] == byte) mask |= 1u << i;
     }
-    
-    // Replace old buckets with new ones
-    free(table->buckets);
-    table->buckets = new_buckets;
-    table->size = new_size;
-}
-
-// Increment the count for a given value, or add it if it's new
-// OWNERSHIP: This function takes ownership of 'value' parameter.
-// - If the value already exists, the passed string is freed
-// - If the value is new, the string is stored in the hash table
-// - If allocation fails, the string is freed to prevent leaks
-static void hash_table_increment(FreqAnalysisHashTable *table, const char *value, size_t row_index) {
-    if (!table || !value) return;
-
-    uint32_t hash = fnv1a_hash(value);
-    int index = hash % table->size;
-
-    // Find existing entry
-    for (FreqAnalysisEntry *entry = table->buckets[index]; entry; entry = entry->next) {
-        if (strcmp(entry->value, value) == 0) {
-            entry->count++;
-            // Add the new row index to the list
-            if (entry->row_indices_count >= entry->row_indices_capacity) {
-                entry->row_indices_capacity = entry->row_indices_capacity > 0 ? entry->row_indices_capacity * 2 : 8;
-                entry->row_indices = realloc(entry->row_indices, entry->row_indices_capacity * sizeof(size_t));
-            }
-            if (entry->row_indices) {
-                entry->row_indices[entry->row_indices_count++] = row_index;
+    return mask;
+#endif
+}
+
+// Finds the slot for 'hash': the one holding a matching entry, or the empty
+// slot where it belongs. A NULL value only looks for the empty slot.
+static size_t hash_table_probe(const FreqAnalysisHashTable *table, uint64_t hash, const char *value, size_t length) {
+    size_t mask = table->slot_count - 1;
+    size_t group = (size_t)(hash >> 7) & mask & ~(size_t)(FREQ_GROUP_SIZE - 1);
+    uint8_t tag = freq_tag(hash);
+    for (;;) {
+        const uint8_t *ctrl = table->ctrl + group;
+        if (value) {
+            for (uint32_t match = group_match(ctrl, tag); match; match &= match - 1) {
+                size_t slot = group + (size_t)__builtin_ctz(match);
+                const FreqAnalysisEntry *entry = &table->entries[table->slots[slot]];
+                if (entry->hash == hash && entry->length == length && memcmp(entry->value, value, length) == 0) {
+                    return slot;
+                }
             }
-            free((char*)value);  // Free the duplicate since we found existing entry
-            return;
         }
+        uint32_t empty = group_match(ctrl, FREQ_SLOT_EMPTY);
+        if (empty) return group + (size_t)__builtin_ctz(empty);
+        group = (group + FREQ_GROUP_SIZE) & mask;
     }
+}
 
-    // Create a new entry
-    FreqAnalysisEntry *new_entry = malloc(sizeof(FreqAnalysisEntry));
-    if (!new_entry) {
-        free((char*)value);  // Free the string on allocation failure
-        LOG_WARN("Failed to allocate memory for frequency entry");
-        return;
+// Doubles the slot array. Entries stay where they are; only their slots move.
+static bool hash_table_grow(FreqAnalysisHashTable *table) {
+    size_t slot_count = table->slot_count * 2;
+    uint8_t *ctrl = malloc(slot_count);
+    uint32_t *slots = malloc(slot_count * sizeof(uint32_t));
+    if (!ctrl || !slots) {
+        free(ctrl);
+        free(slots);
+        return false;
     }
+    memset(ctrl, FREQ_SLOT_EMPTY, slot_count);
+    free(table->ctrl);
+    free(table->slots);
+    table->ctrl = ctrl;
+    table->slots = slots;
+    table->slot_count = slot_count;
+
+    for (size_t i = 0; i < table->item_count; i++) {
+        size_t slot = hash_table_probe(table, table->entries[i].hash, NULL, 0);
+        table->ctrl[slot] = freq_tag(table->entries[i].hash);
+        table->slots[slot] = (uint32_t)i;
+    }
+    return true;
+}
 
-    new_entry->value = value; 
-    new_entry->count = 1;
-    new_entry->next = table->buckets[index];
-    new_entry->row_indices = malloc(8 * sizeof(size_t));
-    if (new_entry->row_indices) {
-        new_entry->row_indices_capacity = 8;
-        new_entry->row_indices[0] = row_index;
-        new_entry->row_indices_count = 1;
-    } else {
-        new_entry->row_indices_capacity = 0;
-        new_entry->row_indices_count = 0;
+// Returns the entry for a value, adding an empty one (with the value interned
+// when 'intern' is set, borrowed otherwise) if it is new.
+static FreqAnalysisEntry* hash_table_find_or_add(FreqAnalysisHashTable *table, uint64_t hash,
+                                                 const char *value, size_t length, bool intern) {
+    size_t slot = hash_table_probe(table, hash, value, length);
+    if (table->ctrl[slot] != FREQ_SLOT_EMPTY) return &table->entries[table->slots[slot]];
+
+    // Keep the load factor under 7/8 so every probe sequence ends quickly.
+    if ((table->item_count + 1) * 8 > table->slot_count * 7) {
+        if (table->item_count >= UINT32_MAX || !hash_table_grow(table)) return NULL;
+        slot = hash_table_probe(table, hash, NULL, 0);
     }
+    if (table->item_count == table->entry_capacity) {
+        size_t capacity = table->entry_capacity ? table->entry_capacity * 2 : 256;
+        FreqAnalysisEntry *entries = realloc(table->entries, capacity * sizeof(FreqAnalysisEntry));
+        if (!entries) return NULL;
+        table->entries = entries;
+        table->entry_capacity = capacity;
+    }
+    const char *stored = intern ? arena_strndup(&table->arena, value, length) : value;
+    if (!stored) return NULL;
+
+    FreqAnalysisEntry *entry = &table->entries[table->item_count];
+    *entry = (FreqAnalysisEntry){ .hash = hash, .value = stored, .length = length };
+    table->ctrl[slot] = freq_tag(hash);
+    table->slots[slot] = (uint32_t)table->item_count++;
+    return entry;
+}
 
-    table->buckets[index] = new_entry;
-    table->item_count++;
-    
-    // Resize if load factor > 0.75
-    if (table->item_count > (table->size * 3) / 4) {
-        hash_table_resize(table);
+// Counts one occurrence of a value found at 'row_index'. The value is copied
+// into the table the first time it is seen.
+static bool hash_table_increment(FreqAnalysisHashTable *table, const char *value, size_t length, size_t row_index) {
+    FreqAnalysisEntry *entry = hash_table_find_or_add(table, hash_bytes(value, length), value, length, true);
+    if (!entry) return false;
+
+    FreqPostingBlock *tail = entry->tail;
+    if (!tail || tail->count == tail->capacity) {
+        uint32_t capacity = tail ? tail->capacity * 2 : 1;
+        if (capacity > MAX_POSTING_BLOCK_ROWS) capacity = MAX_POSTING_BLOCK_ROWS;
+        FreqPostingBlock *block = arena_alloc(&table->arena, sizeof(FreqPostingBlock) + capacity * sizeof(size_t));
+        if (!block) return false;
+        block->next = NULL;
+        block->count = 0;
+        block->capacity = capacity;
+        if (tail) {
+            tail->next = block;
+        } else {
+            entry->head = block;
+        }
+        entry->tail = block;
+        tail = block;
     }
+    tail->rows[tail->count++] = row_index;
+    entry->count++;
+    return true;
 }
 
-/**
- * @brief Perform frequency analysis on a specific column of a view.
- *
- * This function analyzes the values in the given column, counts the occurrences
- * of each unique value, and returns the results as a new in-memory table.
- *
- * MEMORY OWNERSHIP:
- * - Field values are copied (strdup'd) from the data source
- * - The hash table owns all strdup'd strings until cleanup
- * - The returned InMemoryTable creates its own copies of strings
- * - All intermediate allocations are cleaned up before return
- *
- * @param viewer The main application viewer instance.
- * @param view The data view to analyze.
- * @param column_index The index of the column to analyze.
- * @param out_index A pointer to a ValueIndex pointer that will be populated.
- * @return An InMemoryTable containing the frequency counts, or NULL on failure.
- *         The caller is responsible for freeing this table with free_in_memory_table().
- */
-InMemoryTable* perform_frequency_analysis(struct DSVViewer *viewer, const struct View *view, int column_index, struct ValueIndex **out_index) {
-    if (!viewer || !view || !view->data_source || column_index < 0 || !out_index) {
-        return NULL;
+static bool hash_table_contains(const FreqAnalysisHashTable *table, const char *value, size_t length) {
+    return table->ctrl[hash_table_probe(table, hash_bytes(value, length), value, length)] != FREQ_SLOT_EMPTY;
+}
+
+// Adds an entry aggregated by one chunk to 'table'. The value and posting
+// blocks are borrowed from the chunk's arena, which must outlive 'table';
+// a value already present gets the chunk's postings linked onto its own, so
+// merging the chunks in order keeps every row list in display order.
+static bool hash_table_merge_entry(FreqAnalysisHashTable *table, const FreqAnalysisEntry *incoming) {
+    FreqAnalysisEntry *entry = hash_table_find_or_add(table, incoming->hash, incoming->value, incoming->length, false);
+    if (!entry) return false;
+    if (entry->tail) {
+        entry->tail->next = incoming->head;
+    } else {
+        entry->head = incoming->head;
     }
+    entry->tail = incoming->tail;
+    entry->count += incoming->count;
+    return true;
+}
 
-    DataSource *ds = view->data_source;
-    size_t col_count = ds->ops->get_col_count(ds->context);
-    if ((size_t)column_index >= col_count) {
-        return NULL;
+// Copies an entry's postings into 'rows', which has room for all of them.
+static void copy_postings(const FreqAnalysisEntry *entry, size_t *rows) {
+    size_t n = 0;
+    for (const FreqPostingBlock *block = entry->head; block; block = block->next) {
+        memcpy(rows + n, block->rows, block->count * sizeof(size_t));
+        n += block->count;
     }
+}
 
-    FreqAnalysisHashTable *table = hash_table_create(viewer, INITIAL_FREQ_TABLE_SIZE);
-    if (!table) return NULL;
+// Work shared by the frequency analysis workers. Each chunk of display rows
+// is counted into its own table; the chunk entries are then grouped by hash
+// into partitions, and each partition merges its share of every chunk in
+// order. Merged tables borrow values and postings from the chunk tables.
+typedef struct {
+    DataSource *ds;
+    const struct View *view;
+    struct DSVViewer *viewer;
+    int column_index;
+    size_t chunk_count;
+    size_t partition_count;
+    FreqAnalysisHashTable **chunk_tables;
+    uint32_t **chunk_order;       // Per chunk: entry indices grouped by partition
+    size_t **chunk_starts;        // Per chunk: partition_count + 1 group offsets
+    FreqAnalysisHashTable **partition_tables;
+    const FreqAnalysisHashTable *only;  // If set, values missing from it are skipped
+    int failed;
+} FreqJob;
+
+static inline size_t freq_partition_of(const FreqJob *job, uint64_t hash) {
+    // The low bits pick the slot, so partition on the high ones.
+    return (size_t)(hash >> 40) % job->partition_count;
+}
 
-    char *field_buffer = malloc(viewer->config->max_field_len);
-    if (!field_buffer) {
-        hash_table_destroy(table);
-        return NULL;
-    }
+static void count_chunk(void *arg, size_t chunk) {
+    FreqJob *job = (FreqJob *)arg;
+    size_t begin, end;
+    parallel_chunk_bounds(job->view->visible_row_count, job->chunk_count, chunk, &begin, &end);
 
-    bool warning_logged = false;
-    size_t num_rows = view->visible_row_count;
+    size_t max_field_len = job->viewer->config->max_field_len;
+    FreqAnalysisHashTable *table = hash_table_create(INITIAL_FREQ_TABLE_SIZE);
+    DataSourceCursor *cursor = data_source_open_cursor(job->ds);
+    char *field_buffer = malloc(max_field_len);
+    bool ok = table && cursor && field_buffer;
 
-    for (size_t i = 0; i < num_rows; i++) {
-        size_t actual_row_index = view_get_displayed_row_index(view, i);
+    for (size_t i = begin; ok && i < end; i++) {
+        size_t actual_row_index = view_get_displayed_row_index(job->view, i);
         if (actual_row_index == SIZE_MAX) continue; // Should not happen
-        
-        FieldDesc fd = ds->ops->get_cell(ds->context, actual_row_index, column_index);
+
+        FieldDesc fd = data_source_cursor_get_cell(cursor, actual_row_index, job->column_index);
         if (fd.start == NULL || fd.length == 0) {
             continue;
         }
 
-        render_field(&fd, field_buffer, viewer->config->max_field_len);
-        
-        // Just duplicate the string for the hash table
-        char* value_copy = strdup(field_buffer);
-        if (!value_copy) {
-            if (!warning_logged) {
-                LOG_WARN("Out of memory during frequency analysis.");
-                warning_logged = true;
-            }
-            continue;
-        }
-        
-        hash_table_increment(table, value_copy, actual_row_index);
-        // hash_table_increment now owns value_copy - it will free it on error or if duplicate exists
+        render_field(&fd, field_buffer, max_field_len);
+        size_t length = strlen(field_buffer);
+        if (job->only && !hash_table_contains(job->only, field_buffer, length)) continue;
+        ok = hash_table_increment(table, field_buffer, length, actual_row_index);
     }
 
+    if (!ok) {
+        LOG_WARN("Out of memory during frequency analysis.");
+        __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+    }
     free(field_buffer);
+    data_source_close_cursor(cursor);
+    job->chunk_tables[chunk] = table;
+}
+
+// Groups a chunk table's entries by partition with a counting sort.
+static void split_chunk(void *arg, size_t chunk) {
+    FreqJob *job = (FreqJob *)arg;
+    const FreqAnalysisHashTable *table = job->chunk_tables[chunk];
+    size_t *starts = calloc(job->partition_count + 1, sizeof(size_t));
+    uint32_t *order = malloc((table->item_count ? table->item_count : 1) * sizeof(uint32_t));
+    if (!starts || !order) {
+        __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+        free(starts);
+        free(order);
+        return;
+    }
+
+    for (size_t i = 0; i < table->item_count; i++) starts[freq_partition_of(job, table->entries[i].hash) + 1]++;
+    for (size_t p = 0; p < job->partition_count; p++) starts[p + 1] += starts[p];
+    size_t fill[MAX_FREQ_PARTITIONS];
+    memcpy(fill, starts, job->partition_count * sizeof(size_t));
+    for (size_t i = 0; i < table->item_count; i++) {
+        order[fill[freq_partition_of(job, table->entries[i].hash)]++] = (uint32_t)i;
+    }
+    job->chunk_order[chunk] = order;
+    job->chunk_starts[chunk] = starts;
+}
+
+static void merge_partition(void *arg, size_t partition) {
+    FreqJob *job = (FreqJob *)arg;
+
+    // Size the table for the largest chunk's share up front.
+    size_t expected = 0;
+    for (size_t chunk = 0; chunk < job->chunk_count; chunk++) {
+        const size_t *starts = job->chunk_starts[chunk];
+        size_t share = starts[partition + 1] - starts[partition];
+        if (share > expected) expected = share;
+    }
+    size_t slot_count = INITIAL_FREQ_TABLE_SIZE;
+    while (slot_count * 7 < expected * 8 * 2) slot_count *= 2;
+
+    FreqAnalysisHashTable *table = hash_table_create(slot_count);
+    bool ok = table != NULL;
+    for (size_t chunk = 0; ok && chunk < job->chunk_count; chunk++) {
+        const FreqAnalysisHashTable *source = job->chunk_tables[chunk];
+        const size_t *starts = job->chunk_starts[chunk];
+        for (size_t i = starts[partition]; ok && i < starts[partition + 1]; i++) {
+            ok = hash_table_merge_entry(table, &source->entries[job->chunk_order[chunk][i]]);
+        }
+    }
+    if (!ok) __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+    job->partition_tables[partition] = table;
+}
+
+static void free_freq_job(FreqJob *job) {
+    // Merged tables borrow from the chunk tables, so they go first. A single
+    // chunk's table is its own result.
+    for (size_t i = 0; job->chunk_count > 1 && job->partition_tables && i < job->partition_count; i++) {
+        hash_table_destroy(job->partition_tables[i]);
+    }
+    for (size_t i = 0; job->chunk_tables && i < job->chunk_count; i++) {
+        hash_table_destroy(job->chunk_tables[i]);
+        if (job->chunk_order) free(job->chunk_order[i]);
+        if (job->chunk_starts) free(job->chunk_starts[i]);
+    }
+    free(job->chunk_order);
+    free(job->chunk_starts);
+    free(job->chunk_tables);
+    free(job->partition_tables);
+}
+
+// Counts the column over every visible row in parallel, leaving the merged
+// counts in job->partition_tables. Returns false on failure.
+static bool count_column_values(FreqJob *job) {
+    size_t rows = job->view->visible_row_count;
+    job->chunk_count = 1;
+    if (data_source_supports_cursors(job->ds)) {
+        job->chunk_count = parallel_chunk_count(rows, MIN_ROWS_PER_FREQ_CHUNK);
+        if (job->chunk_count == 0) job->chunk_count = 1;
+    }
+    job->partition_count = 1;
+    if (job->chunk_count > 1) {
+        job->partition_count = parallel_worker_count() * 2;
+        if (job->partition_count > MAX_FREQ_PARTITIONS) job->partition_count = MAX_FREQ_PARTITIONS;
+    }
 
-    if (table->item_count == 0) {
-        hash_table_destroy(table);
+    job->chunk_tables = calloc(job->chunk_count, sizeof(FreqAnalysisHashTable *));
+    job->partition_tables = calloc(job->partition_count, sizeof(FreqAnalysisHashTable *));
+    if (!job->chunk_tables || !job->partition_tables) return false;
+    parallel_for(job->chunk_count, count_chunk, job);
+    if (job->failed) return false;
+
+    // A single chunk's table is already the result.
+    if (job->chunk_count == 1) {
+        job->partition_tables[0] = job->chunk_tables[0];
+        return true;
+    }
+
+    job->chunk_order = calloc(job->chunk_count, sizeof(uint32_t *));
+    job->chunk_starts = calloc(job->chunk_count, sizeof(size_t *));
+    if (!job->chunk_order || !job->chunk_starts) return false;
+    parallel_for(job->chunk_count, split_chunk, job);
+    if (job->failed) return false;
+    parallel_for(job->partition_count, merge_partition, job);
+    return !job->failed;
+}
+
+// Counts the column's values (only those in 'only', if set) and returns them
+// as a ValueIndex sorted for display.
+//
+// MEMORY OWNERSHIP:
+// - Field values are interned into the hash tables' arenas while counting
+// - The returned ValueIndex holds its own copy of each value and row list
+// - All intermediate allocations are cleaned up before return
+static ValueIndex* build_value_index(struct DSVViewer *viewer, const struct View *view, int column_index,
+                                     const FreqAnalysisHashTable *only) {
+    if (!viewer || !view || !view->data_source || column_index < 0) {
         return NULL;
     }
 
-    // Create the ValueIndex to return to the caller
-    *out_index = create_value_index(table->item_count * 2);
-    if (!*out_index) {
-        hash_table_destroy(table);
+    DataSource *ds = view->data_source;
+    size_t col_count = ds->ops->get_col_count(ds->context);
+    if ((size_t)column_index >= col_count) {
+        return NULL;
+    }
+
+    // Every row of the column is about to be read.
+    data_source_prepare_column(ds, column_index);
+
+    FreqJob job = { .ds = ds, .view = view, .viewer = viewer, .column_index = column_index, .only = only };
+    if (!count_column_values(&job)) {
+        free_freq_job(&job);
         return NULL;
     }
 
-    FreqValueCount *sorted_items = malloc(table->item_count * sizeof(FreqValueCount));
-    if (!sorted_items) {
-        hash_table_destroy(table);
+    size_t item_count = 0;
+    for (size_t p = 0; p < job.partition_count; p++) item_count += job.partition_tables[p]->item_count;
+    if (item_count == 0) {
+        free_freq_job(&job);
         return NULL;
     }
 
-    int current_item = 0;
-    for (int i = 0; i < table->size; i++) {
-        FreqAnalysisEntry *entry = table->buckets[i];
-        while (entry) {
-            sorted_items[current_item].value = entry->value;
-            sorted_items[current_item].count = entry->count;
-            current_item++;
-            
-            // Add to the public-facing ValueIndex
-            add_to_value_index(*out_index, entry->value, entry->row_indices, entry->row_indices_count);
+    ValueIndex *index = create_value_index(item_count * 2);
+    ValueIndexEntry **sorted = malloc(item_count * sizeof(ValueIndexEntry *));
+    if (!index || !sorted) {
+        free_value_index(index);
+        free(sorted);
+        free_freq_job(&job);
+        return NULL;
+    }
 
-            entry = entry->next;
-            // Don't free the string here - we'll free it after creating the table
+    size_t current_item = 0;
+    for (size_t p = 0; p < job.partition_count; p++) {
+        const FreqAnalysisHashTable *table = job.partition_tables[p];
+        for (size_t i = 0; i < table->item_count; i++) {
+            const FreqAnalysisEntry *entry = &table->entries[i];
+            ValueIndexEntry *indexed = value_index_add_entry(index, entry->value, entry->length, entry->count);
+            if (!indexed) {
+                free_value_index(index);
+                free(sorted);
+                free_freq_job(&job);
+                return NULL;
+            }
+            copy_postings(entry, indexed->rows.indices);
+            sorted[current_item++] = indexed;
         }
     }
+    free_freq_job(&job);
 
     // --- Secondary Sort Logic ---
     // Check if the 'Value' column is numeric to sort it correctly as a tie-breaker
     bool is_value_numeric = true;
-    if (table->item_count > 0) {
-        // Sample up to 50 values to decide
-        size_t sample_size = table->item_count < 50 ? table->item_count : 50;
-        for (size_t i = 0; i < sample_size; i++) {
-            if (!is_string_numeric(sorted_items[i].value)) {
-                is_value_numeric = false;
-                break;
-            }
+    // Sample up to 50 values to decide
+    size_t sample_size = item_count < 50 ? item_count : 50;
+    for (size_t i = 0; i < sample_size; i++) {
+        if (!is_string_numeric(sorted[i]->value)) {
+            is_value_numeric = false;
+            break;
         }
-    } else {
-        is_value_numeric = false;
     }
 
     FreqSortContext sort_ctx = { .is_value_numeric = is_value_numeric };
 
 #ifdef __APPLE__
-    qsort_r(sorted_items, table->item_count, sizeof(FreqValueCount), &sort_ctx, compare_freq_counts);
+    qsort_r(sorted, item_count, sizeof(ValueIndexEntry *), &sort_ctx, compare_freq_counts);
 #else
-    qsort_r(sorted_items, table->item_count, sizeof(FreqValueCount), compare_freq_counts, &sort_ctx);
+    qsort_r(sorted, item_count, sizeof(ValueIndexEntry *), compare_freq_counts, &sort_ctx);
 #endif
-    
-    char col_name_buffer[256];
-    FieldDesc header_fd = ds->ops->get_header(ds->context, column_index);
-    if (header_fd.start) {
-        render_field(&header_fd, col_name_buffer, sizeof(col_name_buffer));
-    } else {
-        snprintf(col_name_buffer, sizeof(col_name_buffer), "Column %d", column_index + 1);
+
+    index->sorted = sorted;
+    return index;
+}
+
+/**
+ * @brief Perform frequency analysis on a specific column of a view.
+ *
+ * This function analyzes the values in the given column, counts the occurrences
+ * of each unique value, and returns them as a ValueIndex sorted for display.
+ *
+ * @param viewer The main application viewer instance.
+ * @param view The data view to analyze.
+ * @param column_index The index of the column to analyze.
+ * @return The analysis, or NULL on failure. The caller owns one reference and
+ *         releases it with free_value_index().
+ */
+struct ValueIndex* perform_frequency_analysis(struct DSVViewer *viewer, const struct View *view, int column_index) {
+    return build_value_index(viewer, view, column_index, NULL);
+}
+
+// --- Approximate Frequency Analysis ---
+
+// Work shared by the approximate analysis workers: each chunk of display rows
+// streams into its own fixed-size sketches, which are merged in chunk order.
+typedef struct {
+    DataSource *ds;
+    const struct View *view;
+    struct DSVViewer *viewer;
+    int column_index;
+    size_t chunk_count;
+    HyperLogLog *chunk_hlls;
+    SpaceSaving **chunk_summaries;
+    int failed;
+} ApproxFreqJob;
+
+static void sketch_chunk(void *arg, size_t chunk) {
+    ApproxFreqJob *job = (ApproxFreqJob *)arg;
+    size_t begin, end;
+    parallel_chunk_bounds(job->view->visible_row_count, job->chunk_count, chunk, &begin, &end);
+
+    size_t max_field_len = job->viewer->config->max_field_len;
+    HyperLogLog *hll = &job->chunk_hlls[chunk];
+    SpaceSaving *summary = space_saving_create(APPROX_TOP_VALUES * APPROX_COUNTERS_PER_VALUE);
+    DataSourceCursor *cursor = data_source_open_cursor(job->ds);
+    char *field_buffer = malloc(max_field_len);
+    bool ok = summary && cursor && field_buffer;
+    hll_init(hll);
+
+    for (size_t i = begin; ok && i < end; i++) {
+        size_t actual_row_index = view_get_displayed_row_index(job->view, i);
+        if (actual_row_index == SIZE_MAX) continue;
+
+        FieldDesc fd = data_source_cursor_get_cell(cursor, actual_row_index, job->column_index);
+        if (fd.start == NULL || fd.length == 0) {
+            continue;
+        }
+
+        render_field(&fd, field_buffer, max_field_len);
+        size_t length = strlen(field_buffer);
+        uint64_t hash = hash_bytes(field_buffer, length);
+        hll_add(hll, hash);
+        ok = space_saving_add(summary, hash, field_buffer, length);
     }
 
-    char table_title_buffer[512];
-    snprintf(table_title_buffer, sizeof(table_title_buffer), "Frequency Analysis: %s", col_name_buffer);
+    if (!ok) {
+        LOG_WARN("Out of memory during approximate frequency analysis.");
+        __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+    }
+    free(field_buffer);
+    data_source_close_cursor(cursor);
+    job->chunk_summaries[chunk] = summary;
+}
 
-    const char *headers[] = {"Value", "Count"};
-    InMemoryTable *result_table = create_in_memory_table(table_title_buffer, 2, headers);
-    if (!result_table) {
-        free(sorted_items);
-        hash_table_destroy(table);
-        return NULL;
+static void free_approx_freq_job(ApproxFreqJob *job) {
+    for (size_t i = 0; job->chunk_summaries && i < job->chunk_count; i++) {
+        space_saving_free(job->chunk_summaries[i]);
     }
+    free(job->chunk_summaries);
+    free(job->chunk_hlls);
+}
 
-    for (int i = 0; i < table->item_count; i++) {
-        char count_str[32];
-        snprintf(count_str, sizeof(count_str), "%d", sorted_items[i].count);
-        const char *row_data[] = {sorted_items[i].value, count_str};
-        if (add_in_memory_table_row(result_table, row_data) != 0) {
-            free(sorted_items);
-            free_in_memory_table(result_table);
-            hash_table_destroy(table);
-            return NULL;
+static int compare_hashes(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+// Hashes one random row from each of 'samples' equal strata of the view (a
+// fixed stride would alias with periodic columns). If each of D values fills
+// N / D of the N cells, a fraction q of the cells is expected to show
+// d = D * (1 - (1 - q)^(N / D)) of them, which is inverted for D.
+double estimate_distinct_values(struct DSVViewer *viewer, const struct View *view, int column_index) {
+    if (!viewer || !view || !view->data_source || column_index < 0 || view->visible_row_count == 0) {
+        return 0.0;
+    }
+    size_t rows = view->visible_row_count;
+    size_t samples = rows < DISTINCT_SAMPLE_ROWS ? rows : DISTINCT_SAMPLE_ROWS;
+    size_t max_field_len = viewer->config->max_field_len;
+    uint64_t *hashes = malloc(samples * sizeof(uint64_t));
+    char *field_buffer = malloc(max_field_len);
+    DataSourceCursor *cursor = data_source_open_cursor(view->data_source);
+    size_t n = 0;
+    uint64_t random = 0x9E3779B97F4A7C15ULL;
+    if (hashes && field_buffer && cursor) {
+        for (size_t i = 0; i < samples; i++) {
+            size_t begin = (size_t)((uint64_t)i * rows / samples);
+            size_t end = (size_t)((uint64_t)(i + 1) * rows / samples);
+            random ^= random << 13;
+            random ^= random >> 7;
+            random ^= random << 17;
+            size_t row = begin + (size_t)(random % (end - begin));
+            size_t actual_row_index = view_get_displayed_row_index(view, row);
+            if (actual_row_index == SIZE_MAX) continue;
+            FieldDesc fd = data_source_cursor_get_cell(cursor, actual_row_index, column_index);
+            if (fd.start == NULL || fd.length == 0) continue;
+            render_field(&fd, field_buffer, max_field_len);
+            hashes[n++] = hash_bytes(field_buffer, strlen(field_buffer));
         }
     }
+    free(field_buffer);
+    data_source_close_cursor(cursor);
+    if (n == 0) {
+        free(hashes);
+        return 0.0;
+    }
+
+    qsort(hashes, n, sizeof(uint64_t), compare_hashes);
+    size_t distinct = 1;
+    for (size_t i = 1; i < n; i++) distinct += hashes[i] != hashes[i - 1];
+    free(hashes);
+
+    // The whole view was read, so the count is exact.
+    if (samples == rows) return (double)distinct;
+    // Non-empty cells in the whole view, scaled from the sample.
+    double population = (double)n * (double)rows / (double)samples;
+    if (distinct == n) return population;
+
+    // d(D) grows with D, so bisect between the sample's count and the population.
+    double log_unsampled = log(1.0 - (double)samples / (double)rows);
+    double low = (double)distinct, high = population;
+    for (int i = 0; i < 64; i++) {
+        double mid = 0.5 * (low + high);
+        if (mid * (1.0 - exp(population / mid * log_unsampled)) < (double)distinct) low = mid;
+        else high = mid;
+    }
+    return 0.5 * (low + high);
+}
 
-    free(sorted_items);
-    
-    // The strings from the hash table have been copied into the result_table.
-    // Now we need to free the hash table and the strings it owns.
-    // The hash_table_destroy function now handles freeing the entries correctly.
-    hash_table_destroy(table);
+// Memory is one HyperLogLog and one Space-Saving summary per chunk, whatever
+// the column's cardinality.
+ApproxFrequency* perform_approximate_frequency_analysis(struct DSVViewer *viewer, const struct View *view, int column_index) {
+    if (!viewer || !view || !view->data_source || column_index < 0) {
+        return NULL;
+    }
 
-    return result_table;
-} 
\ No newline at end of file
+    DataSource *ds = view->data_source;
+    size_t col_count = ds->ops->get_col_count(ds->context);
+    if ((size_t)column_index >= col_count) {
+        return NULL;
+    }
+    data_source_prepare_column(ds, column_index);
+
+    ApproxFreqJob job = { .ds = ds, .view = view, .viewer = viewer, .column_index = column_index };
+    job.chunk_count = 1;
+    if (data_source_supports_cursors(ds)) {
+        job.chunk_count = parallel_chunk_count(view->visible_row_count, MIN_ROWS_PER_FREQ_CHUNK);
+        if (job.chunk_count == 0) job.chunk_count = 1;
+    }
+    job.chunk_hlls = malloc(job.chunk_count * sizeof(HyperLogLog));
+    job.chunk_summaries = calloc(job.chunk_count, sizeof(SpaceSaving *));
+    if (!job.chunk_hlls || !job.chunk_summaries) {
+        free_approx_freq_job(&job);
+        return NULL;
+    }
+    parallel_for(job.chunk_count, sketch_chunk, &job);
+
+    // Merge in chunk order so the result does not depend on scheduling.
+    bool ok = !job.failed;
+    for (size_t chunk = 1; ok && chunk < job.chunk_count; chunk++) {
+        hll_merge(&job.chunk_hlls[0], &job.chunk_hlls[chunk]);
+        ok = space_saving_merge(job.chunk_summaries[0], job.chunk_summaries[chunk]);
+    }
+    SpaceSaving *summary = job.chunk_summaries[0];
+    if (!ok || space_saving_total(summary) == 0) {
+        free_approx_freq_job(&job);
+        return NULL;
+    }
+
+    ApproxFrequency *approx = calloc(1, sizeof(ApproxFrequency));
+    SpaceSavingItem *found = malloc(APPROX_TOP_VALUES * sizeof(SpaceSavingItem));
+    if (!approx || !found) {
+        free(approx);
+        free(found);
+        free_approx_freq_job(&job);
+        return NULL;
+    }
+    arena_init(&approx->arena, 0);
+    approx->rows = space_saving_total(summary);
+    approx->distinct_estimate = hll_estimate(&job.chunk_hlls[0]);
+    approx->distinct_error = hll_relative_error();
+
+    size_t found_count = space_saving_items(summary, found, APPROX_TOP_VALUES);
+    approx->items = arena_alloc(&approx->arena, (found_count ? found_count : 1) * sizeof(ApproxFrequencyItem));
+    ok = approx->items != NULL;
+    for (size_t i = 0; ok && i < found_count; i++) {
+        ApproxFrequencyItem *item = &approx->items[i];
+        item->value = arena_strndup(&approx->arena, found[i].value, found[i].length);
+        item->length = found[i].length;
+        item->count = found[i].count;
+        item->error = found[i].error;
+        ok = item->value != NULL;
+        if (item->length > approx->value_width) approx->value_width = item->length;
+        if (item->count > approx->max_count) approx->max_count = item->count;
+        approx->item_count++;
+    }
+    free(found);
+    free_approx_freq_job(&job);
+    if (!ok) {
+        free_approximate_frequency(approx);
+        return NULL;
+    }
+    return approx;
+}
+
+void free_approximate_frequency(ApproxFrequency *approx) {
+    if (!approx) return;
+    arena_free(&approx->arena);
+    free(approx);
+}
+
+// The reported values go into a table that only filters the exact count, so
+// it borrows them from 'approx'.
+struct ValueIndex* refine_frequency_analysis(struct DSVViewer *viewer, const struct View *view, int column_index,
+                                             const ApproxFrequency *approx) {
+    if (!approx || approx->item_count == 0) return NULL;
+
+    size_t slot_count = INITIAL_FREQ_TABLE_SIZE;
+    while (slot_count * 7 < approx->item_count * 8 * 2) slot_count *= 2;
+    FreqAnalysisHashTable *only = hash_table_create(slot_count);
+    bool ok = only != NULL;
+    for (size_t i = 0; ok && i < approx->item_count; i++) {
+        const ApproxFrequencyItem *item = &approx->items[i];
+        ok = hash_table_find_or_add(only, hash_bytes(item->value, item->length), item->value, item->length, false) != NULL;
+    }
+
+    ValueIndex *index = ok ? build_value_index(viewer, view, column_index, only) : NULL;
+    hash_table_destroy(only);
+    return index;
+}
@@ -0,0 +1,438 @@
+#include "core/column_stats.h"
+#include "core/sketch.h"
+#include "core/data_source.h"
+#include "ui/view_manager.h"
+#include "util/parallel.h"
+#include "util/utils.h"
+#include "util/logging.h"
+#include "util/error_context.h"
+#include "app_init.h"
+#include <ctype.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define MIN_ROWS_PER_STATS_CHUNK 4096
+#define STATS_BLOCK_VALUES 4096   // Numbers extracted before each SIMD reduction
+#define NUMBER_PARSE_BUFFER 64
+
+// --- Number Extraction ---
+
+// Exactly representable powers of ten
+static const double POWERS_OF_TEN[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+// Parses a whole cell (surrounding spaces allowed) as a finite number. Plain
+// decimals whose digits fit in 53 bits are converted with one correctly
+// rounded division; anything else (exponents, long mantissas) goes through
+// strtod.
+static bool parse_number(const char *text, size_t length, double *out) {
+    const char *p = text, *end = text + length;
+    while (p < end && isspace((unsigned char)*p)) p++;
+    while (end > p && isspace((unsigned char)end[-1])) end--;
+    if (p == end) return false;
+
+    const char *s = p;
+    bool negative = false;
+    if (*s == '-' || *s == '+') negative = *s++ == '-';
+    uint64_t mantissa = 0;
+    int digits = 0, fraction_digits = 0;
+    bool seen_dot = false, plain = true;
+    for (; s < end; s++) {
+        if (*s >= '0' && *s <= '9') {
+            if (digits == 19) { plain = false; break; }
+            mantissa = mantissa * 10 + (uint64_t)(*s - '0');
+            digits++;
+            if (seen_dot) fraction_digits++;
+        } else if (*s == '.' && !seen_dot) {
+            seen_dot = true;
+        } else {
+            plain = false;
+            break;
+        }
+    }
+    if (plain) {
+        if (digits == 0) return false;
+        if (mantissa < (1ULL << 53) && fraction_digits <= 22) {
+            double value = (double)mantissa / POWERS_OF_TEN[fraction_digits];
+            *out = negative ? -value : value;
+            return true;
+        }
+    }
+
+    size_t span = (size_t)(end - p);
+    if (span >= NUMBER_PARSE_BUFFER) return false;
+    char buffer[NUMBER_PARSE_BUFFER];
+    memcpy(buffer, p, span);
+    buffer[span] = '\0';
+    char *parsed_end;
+    double value = strtod(buffer, &parsed_end);
+    if (parsed_end != buffer + span) return false;
+    if (value - value != 0.0) return false; // Infinity or NaN
+    *out = value;
+    return true;
+}
+
+// --- SIMD Reductions ---
+
+// Sum, minimum and maximum of a non-empty block.
+static void reduce_block(const double *values, size_t n, double *sum, double *min, double *max) {
+    size_t i = 0;
+    double total = 0.0, low = values[0], high = values[0];
+#ifdef __SSE2__
+    size_t vector_end = n & ~(size_t)3;
+    if (vector_end > 0) {
+        __m128d sum0 = _mm_setzero_pd(), sum1 = _mm_setzero_pd();
+        __m128d min_v = _mm_set1_pd(values[0]), max_v = min_v;
+        for (; i < vector_end; i += 4) {
+            __m128d a = _mm_loadu_pd(values + i);
+            __m128d b = _mm_loadu_pd(values + i + 2);
+            sum0 = _mm_add_pd(sum0, a);
+            sum1 = _mm_add_pd(sum1, b);
+            min_v = _mm_min_pd(min_v, _mm_min_pd(a, b));
+            max_v = _mm_max_pd(max_v, _mm_max_pd(a, b));
+        }
+        double lanes[2];
+        _mm_storeu_pd(lanes, _mm_add_pd(sum0, sum1));
+        total = lanes[0] + lanes[1];
+        _mm_storeu_pd(lanes, min_v);
+        low = lanes[0] < lanes[1] ? lanes[0] : lanes[1];
+        _mm_storeu_pd(lanes, max_v);
+        high = lanes[0] > lanes[1] ? lanes[0] : lanes[1];
+    }
+#endif
+    for (; i < n; i++) {
+        total += values[i];
+        if (values[i] < low) low = values[i];
+        if (values[i] > high) high = values[i];
+    }
+    *sum = total;
+    *min = low;
+    *max = high;
+}
+
+// Sum of squared deviations from 'mean'.
+static double squared_deviations(const double *values, size_t n, double mean) {
+    size_t i = 0;
+    double total = 0.0;
+#ifdef __SSE2__
+    size_t vector_end = n & ~(size_t)3;
+    __m128d mean_v = _mm_set1_pd(mean);
+    __m128d sum0 = _mm_setzero_pd(), sum1 = _mm_setzero_pd();
+    for (; i < vector_end; i += 4) {
+        __m128d a = _mm_sub_pd(_mm_loadu_pd(values + i), mean_v);
+        __m128d b = _mm_sub_pd(_mm_loadu_pd(values + i + 2), mean_v);
+        sum0 = _mm_add_pd(sum0, _mm_mul_pd(a, a));
+        sum1 = _mm_add_pd(sum1, _mm_mul_pd(b, b));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(sum0, sum1));
+    total = lanes[0] + lanes[1];
+#endif
+    for (; i < n; i++) {
+        double d = values[i] - mean;
+        total += d * d;
+    }
+    return total;
+}
+
+// --- Parallel Pass ---
+
+// Statistics of one chunk of rows, or of several merged.
+typedef struct {
+    size_t count;
+    size_t nulls;
+    size_t numeric_count;
+    double sum, mean, m2;       // m2: sum of squared deviations from mean
+    double min, max;
+    size_t min_length, max_length;
+    char *min_text, *max_text;
+    size_t min_text_capacity, max_text_capacity;
+    HyperLogLog hll;
+    KllSketch *quantiles;
+} StatsAccumulator;
+
+typedef struct {
+    const View *view;
+    int column_index;
+    size_t max_field_len;
+    size_t chunk_count;
+    StatsAccumulator *chunks;
+    int failed;
+} StatsJob;
+
+// Folds the moments of 'n' numbers into 'acc' (pairwise variance update).
+static void add_moments(StatsAccumulator *acc, size_t n, double sum, double m2, double min, double max) {
+    if (n == 0) return;
+    double mean = sum / (double)n;
+    if (acc->numeric_count == 0) {
+        acc->min = min;
+        acc->max = max;
+        acc->mean = mean;
+        acc->m2 = m2;
+    } else {
+        double total = (double)(acc->numeric_count + n);
+        double delta = mean - acc->mean;
+        acc->mean += delta * (double)n / total;
+        acc->m2 += m2 + delta * delta * (double)acc->numeric_count * (double)n / total;
+        if (min < acc->min) acc->min = min;
+        if (max > acc->max) acc->max = max;
+    }
+    acc->sum += sum;
+    acc->numeric_count += n;
+}
+
+static bool add_block(StatsAccumulator *acc, const double *values, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        if (!kll_add(acc->quantiles, values[i])) return false;
+    }
+    if (n == 0) return true;
+    double sum, min, max;
+    reduce_block(values, n, &sum, &min, &max);
+    add_moments(acc, n, sum, squared_deviations(values, n, sum / (double)n), min, max);
+    return true;
+}
+
+static bool set_text(char **text, size_t *capacity, const char *value, size_t length) {
+    if (length + 1 > *capacity) {
+        char *buffer = realloc(*text, length + 1);
+        if (!buffer) return false;
+        *text = buffer;
+        *capacity = length + 1;
+    }
+    memcpy(*text, value, length + 1);
+    return true;
+}
+
+static size_t utf8_length(const char *text, size_t bytes) {
+    size_t chars = 0;
+    for (size_t i = 0; i < bytes; i++) {
+        if (((unsigned char)text[i] & 0xC0) != 0x80) chars++;
+    }
+    return chars;
+}
+
+// Counts one non-empty value's text statistics. Returns false on
+// allocation failure.
+static bool add_text(StatsAccumulator *acc, const char *value, size_t length) {
+    size_t chars = utf8_length(value, length);
+    if (acc->count == 0 || chars < acc->min_length) acc->min_length = chars;
+    if (chars > acc->max_length) acc->max_length = chars;
+    acc->count++;
+    hll_add(&acc->hll, hash_bytes(value, length));
+
+    if (!acc->min_text || strcmp(value, acc->min_text) < 0) {
+        if (!set_text(&acc->min_text, &acc->min_text_capacity, value, length)) return false;
+    }
+    if (!acc->max_text || strcmp(value, acc->max_text) > 0) {
+        if (!set_text(&acc->max_text, &acc->max_text_capacity, value, length)) return false;
+    }
+    return true;
+}
+
+static void stats_chunk(void *arg, size_t chunk) {
+    StatsJob *job = (StatsJob *)arg;
+    StatsAccumulator *acc = &job->chunks[chunk];
+    hll_init(&acc->hll);
+    size_t begin, end;
+    parallel_chunk_bounds(job->view->visible_row_count, job->chunk_count, chunk, &begin, &end);
+
+    DataSourceCursor *cursor = data_source_open_cursor(job->view->data_source);
+    char *field_buffer = malloc(job->max_field_len);
+    double *values = malloc(STATS_BLOCK_VALUES * sizeof(double));
+    acc->quantiles = kll_create();
+    bool ok = cursor && field_buffer && values && acc->quantiles;
+    size_t pending = 0;
+
+    // Order doesn't matter here, so walk the visible set directly.
+    ViewRowIterator it;
+    view_row_iterator_init(&it, job->view, begin, end - begin);
+    size_t row;
+    while (ok && (row = view_row_iterator_next(&it)) != SIZE_MAX) {
+        FieldDesc fd = data_source_cursor_get_cell(cursor, row, job->column_index);
+        if (fd.start == NULL || fd.length == 0) {
+            acc->nulls++;
+            continue;
+        }
+
+        render_field(&fd, field_buffer, job->max_field_len);
+        size_t length = strlen(field_buffer);
+        ok = add_text(acc, field_buffer, length);
+        if (ok && parse_number(field_buffer, length, &values[pending]) && ++pending == STATS_BLOCK_VALUES) {
+            ok = add_block(acc, values, pending);
+            pending = 0;
+        }
+    }
+    if (ok) ok = add_block(acc, values, pending);
+
+    if (!ok) {
+        LOG_WARN("Out of memory while computing column statistics.");
+        __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+    }
+    free(values);
+    free(field_buffer);
+    data_source_close_cursor(cursor);
+}
+
+// Folds chunk 'from' into 'into', taking over its text buffers when they win.
+// Returns false on allocation failure.
+static bool merge_accumulator(StatsAccumulator *into, StatsAccumulator *from) {
+    add_moments(into, from->numeric_count, from->sum, from->m2, from->min, from->max);
+    if (from->count > 0) {
+        if (into->count == 0 || from->min_length < into->min_length) into->min_length = from->min_length;
+        if (from->max_length > into->max_length) into->max_length = from->max_length;
+    }
+    if (from->min_text && (!into->min_text || strcmp(from->min_text, into->min_text) < 0)) {
+        free(into->min_text);
+        into->min_text = from->min_text;
+        from->min_text = NULL;
+    }
+    if (from->max_text && (!into->max_text || strcmp(from->max_text, into->max_text) > 0)) {
+        free(into->max_text);
+        into->max_text = from->max_text;
+        from->max_text = NULL;
+    }
+    into->count += from->count;
+    into->nulls += from->nulls;
+    hll_merge(&into->hll, &from->hll);
+    return kll_merge(into->quantiles, from->quantiles);
+}
+
+ColumnStats* compute_column_stats(const View *view, int column_index, size_t max_field_len) {
+    if (!view || !view->data_source || column_index < 0 || max_field_len == 0) return NULL;
+    DataSource *ds = view->data_source;
+    if ((size_t)column_index >= ds->ops->get_col_count(ds->context)) return NULL;
+    data_source_prepare_column(ds, column_index);
+
+    StatsJob job = { .view = view, .column_index = column_index, .max_field_len = max_field_len, .chunk_count = 1 };
+    if (data_source_supports_cursors(ds)) {
+        job.chunk_count = parallel_chunk_count(view->visible_row_count, MIN_ROWS_PER_STATS_CHUNK);
+        if (job.chunk_count == 0) job.chunk_count = 1;
+    }
+    job.chunks = calloc(job.chunk_count, sizeof(StatsAccumulator));
+    ColumnStats *stats = calloc(1, sizeof(ColumnStats));
+    if (!job.chunks || !stats) {
+        free(job.chunks);
+        free(stats);
+        return NULL;
+    }
+    parallel_for(job.chunk_count, stats_chunk, &job);
+
+    StatsAccumulator *total = &job.chunks[0];
+    for (size_t chunk = 1; !job.failed && chunk < job.chunk_count; chunk++) {
+        if (!merge_accumulator(total, &job.chunks[chunk])) job.failed = 1;
+    }
+
+    if (!job.failed) {
+        stats->count = total->count;
+        stats->nulls = total->nulls;
+        stats->numeric_count = total->numeric_count;
+        stats->distinct_estimate = total->count > 0 ? hll_estimate(&total->hll) : 0.0;
+        stats->distinct_error = hll_relative_error();
+        stats->min = total->min;
+        stats->max = total->max;
+        stats->sum = total->sum;
+        stats->mean = total->mean;
+        stats->stddev = total->numeric_count > 1 ? sqrt(total->m2 / (double)(total->numeric_count - 1)) : 0.0;
+        stats->min_text = total->min_text;
+        stats->max_text = total->max_text;
+        stats->min_length = total->min_length;
+        stats->max_length = total->max_length;
+        stats->quantiles = total->quantiles;
+        stats->median = kll_quantile(total->quantiles, 0.5);
+        stats->p90 = kll_quantile(total->quantiles, 0.9);
+        stats->p99 = kll_quantile(total->quantiles, 0.99);
+        total->min_text = total->max_text = NULL;
+        total->quantiles = NULL;
+    }
+    for (size_t chunk = 0; chunk < job.chunk_count; chunk++) {
+        free(job.chunks[chunk].min_text);
+        free(job.chunks[chunk].max_text);
+        kll_free(job.chunks[chunk].quantiles);
+    }
+    free(job.chunks);
+    if (job.failed) {
+        free(stats);
+        return NULL;
+    }
+    return stats;
+}
+
+void free_column_stats(ColumnStats *stats) {
+    if (!stats) return;
+    free(stats->min_text);
+    free(stats->max_text);
+    kll_free(stats->quantiles);
+    free(stats);
+}
+
+#define HISTOGRAM_BAR_WIDTH 40
+
+InMemoryTable* column_stats_histogram(const ColumnStats *stats, size_t bins) {
+    if (!stats || !stats->quantiles || stats->numeric_count == 0 || bins == 0) return NULL;
+    if (stats->min == stats->max) bins = 1;
+
+    size_t *counts = calloc(bins, sizeof(size_t));
+    if (!counts) return NULL;
+
+    // Bin counts are differences of rounded cumulative counts, so they add
+    // up exactly; the last bin takes everything up to max.
+    double width = (stats->max - stats->min) / (double)bins;
+    size_t below = 0, largest = 0;
+    for (size_t bin = 0; bin < bins; bin++) {
+        size_t upto = stats->numeric_count;
+        if (bin + 1 < bins) {
+            double rank = kll_rank(stats->quantiles, stats->min + width * (double)(bin + 1));
+            upto = (size_t)(rank * (double)stats->numeric_count + 0.5);
+            if (upto < below) upto = below;
+        }
+        counts[bin] = upto - below;
+        below = upto;
+        if (counts[bin] > largest) largest = counts[bin];
+    }
+
+    const char *headers[] = {"From", "To", "Count", "Bar"};
+    InMemoryTable *table = create_in_memory_table("Histogram", 4, headers);
+    char from[32], to[32], count[32], bar[HISTOGRAM_BAR_WIDTH + 1];
+    for (size_t bin = 0; table && bin < bins; bin++) {
+        double low = stats->min + width * (double)bin;
+        double high = bin + 1 < bins ? stats->min + width * (double)(bin + 1) : stats->max;
+        snprintf(from, sizeof(from), "%.6g", low);
+        snprintf(to, sizeof(to), "%.6g", high);
+        snprintf(count, sizeof(count), "%zu", counts[bin]);
+        size_t length = largest ? (size_t)((double)counts[bin] * HISTOGRAM_BAR_WIDTH / (double)largest + 0.5) : 0;
+        memset(bar, '#', length);
+        bar[length] = '\0';
+        const char *row[] = {from, to, count, bar};
+        if (add_in_memory_table_row(table, row) != DSV_OK) {
+            free_in_memory_table(table);
+            table = NULL;
+        }
+    }
+    free(counts);
+    return table;
+}
+
+const ColumnStats* view_column_stats(View *view, size_t column_index, size_t max_field_len) {
+    if (!view) return NULL;
+    if (column_index >= view->column_stats_size) {
+        // Computed columns can widen the view after the cache was sized.
+        ColumnStats **cache = realloc(view->column_stats, (column_index + 1) * sizeof(ColumnStats *));
+        if (!cache) return NULL;
+        for (size_t i = view->column_stats_size; i <= column_index; i++) cache[i] = NULL;
+        view->column_stats = cache;
+        view->column_stats_size = column_index + 1;
+    }
+    if (!view->column_stats[column_index]) {
+        view->column_stats[column_index] = compute_column_stats(view, (int)column_index, max_field_len);
+    }
+    return view->column_stats[column_index];
+}
@@ -0,0 +1,586 @@
+#include "core/computed_source.h"
+#include "core/parser.h"
+#include "app_init.h"
+#include "memory/constants.h"
+#include "util/parallel.h"
+#include "util/logging.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <ctype.h>
+
+#define COMPUTED_CACHE_CAPACITY 1024  // Evaluated cells kept for the visible window
+#define COMPUTED_CACHE_BUCKETS 2048
+#define MIN_ROWS_PER_EVAL_CHUNK 4096
+#define COMPUTED_NAME_MAX 64
+
+// --- Data Structures ---
+
+// One cached cell. Entries live in a fixed array and are linked both into a
+// hash bucket chain and into the LRU list by index.
+typedef struct {
+    size_t row;
+    char *text;
+    size_t length;
+    size_t capacity;
+    int lru_prev;
+    int lru_next;
+    int hash_next;
+} ComputedCacheEntry;
+
+typedef struct {
+    ComputedCacheEntry *entries;
+    int *buckets;
+    size_t used;
+    int lru_head;   // Most recently used
+    int lru_tail;   // Next to be evicted
+} ComputedCellCache;
+
+// The whole computed column, packed like an InMemoryColumn string arena.
+typedef struct {
+    char *values;
+    size_t *offsets;
+    uint32_t *lengths;
+    size_t row_count;
+} MaterializedColumn;
+
+typedef struct {
+    DataSource *inner;
+    bool owns_inner;
+    size_t inner_cols;
+    char *name;
+    CompiledExpression *expr;
+
+    // UI-thread evaluation state, used by get_cell
+    DataSourceCursor *cursor;
+    ExprEvaluator *evaluator;
+    ComputedCellCache cache;
+
+    MaterializedColumn *materialized; // Set by prepare_column, NULL until then
+    int width;                        // -1 until sampled
+    size_t width_sample_rows;         // Rows the width is estimated from
+    int min_width;
+    int max_width;
+} ComputedSourceContext;
+
+typedef struct {
+    DataSourceCursor *inner;
+    ExprEvaluator *evaluator;
+    char *text;
+    size_t capacity;
+} ComputedCursor;
+
+// --- Forward Declarations ---
+
+static size_t computed_get_row_count(void *context);
+static size_t computed_get_col_count(void *context);
+static FieldDesc computed_get_cell(void *context, size_t row, size_t col);
+static FieldDesc computed_get_header(void *context, size_t col);
+static int computed_get_column_width(void *context, size_t col);
+static void computed_destroy(void *context);
+static void* computed_create_cursor(void *context);
+static FieldDesc computed_cursor_get_cell(void *context, void *cursor, size_t row, size_t col);
+static void computed_destroy_cursor(void *context, void *cursor);
+static void computed_prepare_column(void *context, size_t col);
+
+static const DataSourceOps computed_ops = {
+    .get_row_count = computed_get_row_count,
+    .get_col_count = computed_get_col_count,
+    .get_cell = computed_get_cell,
+    .get_header = computed_get_header,
+    .get_column_width = computed_get_column_width,
+    .destroy = computed_destroy,
+    .create_cursor = computed_create_cursor,
+    .cursor_get_cell = computed_cursor_get_cell,
+    .destroy_cursor = computed_destroy_cursor,
+    .prepare_column = computed_prepare_column,
+};
+
+// Used when the inner source cannot be read concurrently.
+static const DataSourceOps computed_ops_no_cursors = {
+    .get_row_count = computed_get_row_count,
+    .get_col_count = computed_get_col_count,
+    .get_cell = computed_get_cell,
+    .get_header = computed_get_header,
+    .get_column_width = computed_get_column_width,
+    .destroy = computed_destroy,
+    .prepare_column = computed_prepare_column,
+};
+
+// --- Helpers ---
+
+// Formats a value into a growable buffer. Returns the text length, or
+// SIZE_MAX if the buffer could not be grown.
+static size_t format_into(const ExprValue *value, char **buffer, size_t *capacity) {
+    size_t needed = value->type == EXPR_VALUE_STRING ? value->length + 1 : IN_MEMORY_NUMBER_BUFFER_SIZE;
+    if (needed > *capacity) {
+        char *grown = realloc(*buffer, needed);
+        if (!grown) return SIZE_MAX;
+        *buffer = grown;
+        *capacity = needed;
+    }
+    return expr_format_value(value, *buffer, *capacity);
+}
+
+static FieldDesc text_field(const char *text, size_t length) {
+    return (FieldDesc){ .start = text, .length = length, .needs_unescaping = 0 };
+}
+
+static FieldDesc empty_field(void) {
+    return (FieldDesc){ .start = NULL, .length = 0, .needs_unescaping = 0 };
+}
+
+static FieldDesc read_materialized(const MaterializedColumn *column, size_t row) {
+    if (row >= column->row_count) return empty_field();
+    return text_field(column->values + column->offsets[row], column->lengths[row]);
+}
+
+// --- LRU Cell Cache ---
+
+static int init_cell_cache(ComputedCellCache *cache) {
+    cache->entries = calloc(COMPUTED_CACHE_CAPACITY, sizeof(ComputedCacheEntry));
+    cache->buckets = malloc(COMPUTED_CACHE_BUCKETS * sizeof(int));
+    if (!cache->entries || !cache->buckets) return -1;
+    for (size_t i = 0; i < COMPUTED_CACHE_BUCKETS; i++) cache->buckets[i] = -1;
+    cache->used = 0;
+    cache->lru_head = cache->lru_tail = -1;
+    return 0;
+}
+
+static void free_cell_cache(ComputedCellCache *cache) {
+    if (cache->entries) {
+        for (size_t i = 0; i < cache->used; i++) free(cache->entries[i].text);
+    }
+    free(cache->entries);
+    free(cache->buckets);
+}
+
+static size_t cache_bucket(size_t row) {
+    return (row * 0x9E3779B97F4A7C15ULL >> 20) % COMPUTED_CACHE_BUCKETS;
+}
+
+static void lru_unlink(ComputedCellCache *cache, int index) {
+    ComputedCacheEntry *entry = &cache->entries[index];
+    if (entry->lru_prev >= 0) cache->entries[entry->lru_prev].lru_next = entry->lru_next;
+    else cache->lru_head = entry->lru_next;
+    if (entry->lru_next >= 0) cache->entries[entry->lru_next].lru_prev = entry->lru_prev;
+    else cache->lru_tail = entry->lru_prev;
+}
+
+static void lru_push_front(ComputedCellCache *cache, int index) {
+    ComputedCacheEntry *entry = &cache->entries[index];
+    entry->lru_prev = -1;
+    entry->lru_next = cache->lru_head;
+    if (cache->lru_head >= 0) cache->entries[cache->lru_head].lru_prev = index;
+    cache->lru_head = index;
+    if (cache->lru_tail < 0) cache->lru_tail = index;
+}
+
+static ComputedCacheEntry* cache_lookup(ComputedCellCache *cache, size_t row) {
+    for (int i = cache->buckets[cache_bucket(row)]; i >= 0; i = cache->entries[i].hash_next) {
+        if (cache->entries[i].row == row) {
+            if (cache->lru_head != i) {
+                lru_unlink(cache, i);
+                lru_push_front(cache, i);
+            }
+            return &cache->entries[i];
+        }
+    }
+    return NULL;
+}
+
+// Claims an entry for 'row', evicting the least recently used one if full.
+static ComputedCacheEntry* cache_insert(ComputedCellCache *cache, size_t row) {
+    int index;
+    if (cache->used < COMPUTED_CACHE_CAPACITY) {
+        index = (int)cache->used++;
+    } else {
+        index = cache->lru_tail;
+        lru_unlink(cache, index);
+        int *link = &cache->buckets[cache_bucket(cache->entries[index].row)];
+        while (*link != index) link = &cache->entries[*link].hash_next;
+        *link = cache->entries[index].hash_next;
+    }
+
+    ComputedCacheEntry *entry = &cache->entries[index];
+    size_t bucket = cache_bucket(row);
+    entry->row = row;
+    entry->length = 0;
+    entry->hash_next = cache->buckets[bucket];
+    cache->buckets[bucket] = index;
+    lru_push_front(cache, index);
+    return entry;
+}
+
+// --- Constructors ---
+
+DataSource* create_computed_data_source(DataSource *inner, bool owns_inner, const char *name,
+                                        CompiledExpression *expr, const DSVConfig *config) {
+    if (!inner || !name || !expr) return NULL;
+
+    ComputedSourceContext *ctx = calloc(1, sizeof(ComputedSourceContext));
+    DataSource *ds = malloc(sizeof(DataSource));
+    if (!ctx || !ds) {
+        free(ctx);
+        free(ds);
+        return NULL;
+    }
+
+    ctx->inner = inner;
+    ctx->inner_cols = inner->ops->get_col_count(inner->context);
+    ctx->name = strdup(name);
+    ctx->cursor = data_source_open_cursor(inner);
+    ctx->evaluator = ctx->cursor ? expr_evaluator_create(expr, ctx->cursor) : NULL;
+    ctx->width = -1;
+    ctx->width_sample_rows = config ? (size_t)config->column_analysis_sample_lines : DEFAULT_COLUMN_ANALYSIS_LINES;
+    ctx->min_width = config ? config->min_column_width : DEFAULT_MIN_COLUMN_WIDTH;
+    ctx->max_width = config ? config->max_column_width : DEFAULT_MAX_COLUMN_WIDTH;
+    if (!ctx->name || !ctx->evaluator || init_cell_cache(&ctx->cache) != 0) {
+        // The caller keeps ownership of 'inner' and 'expr' on failure.
+        computed_destroy(ctx);
+        free(ds);
+        return NULL;
+    }
+    ctx->expr = expr;
+    ctx->owns_inner = owns_inner;
+
+    ds->context = ctx;
+    ds->ops = data_source_supports_cursors(inner) ? &computed_ops : &computed_ops_no_cursors;
+    ds->type = DATA_SOURCE_COMPUTED;
+    return ds;
+}
+
+static char* trim(char *str) {
+    while (isspace((unsigned char)*str)) str++;
+    char *end = str + strlen(str);
+    while (end > str && isspace((unsigned char)end[-1])) end--;
+    *end = '\0';
+    return str;
+}
+
+DSVResult add_computed_column(DataSource *inner, bool owns_inner, const char *definition,
+                              const DSVConfig *config, DataSource **out, char *error, size_t error_size) {
+    if (error && error_size > 0) error[0] = '\0';
+    if (!inner || !definition || !out) return DSV_ERROR_INVALID_ARGS;
+
+    char *copy = strdup(definition);
+    if (!copy) return DSV_ERROR_MEMORY;
+
+    // "name = expression" names the column; otherwise the expression is the name.
+    char *name = NULL;
+    char *body = copy;
+    char *equals = strchr(copy, '=');
+    if (equals && strcspn(copy, "'`(") > (size_t)(equals - copy)) {
+        *equals = '\0';
+        name = trim(copy);
+        body = equals + 1;
+    }
+    body = trim(body);
+    if (!name || *name == '\0') name = body;
+
+    if (*body == '\0') {
+        if (error) snprintf(error, error_size, "Empty expression");
+        free(copy);
+        return DSV_ERROR_PARSE;
+    }
+
+    char header[COMPUTED_NAME_MAX];
+    snprintf(header, sizeof(header), "%s", name);
+
+    CompiledExpression *expr = NULL;
+    DSVResult result = expression_compile(body, inner, &expr, error, error_size);
+    free(copy);
+    if (result != DSV_OK) return result;
+
+    DataSource *ds = create_computed_data_source(inner, owns_inner, header, expr, config);
+    if (!ds) {
+        expression_free(expr);
+        if (error) snprintf(error, error_size, "Out of memory");
+        return DSV_ERROR_MEMORY;
+    }
+    *out = ds;
+    return DSV_OK;
+}
+
+// --- Ops Implementation ---
+
+static size_t computed_get_row_count(void *context) {
+    ComputedSourceContext *ctx = (ComputedSourceContext *)context;
+    return ctx->inner->ops->get_row_count(ctx->inner->context);
+}
+
+static size_t computed_get_col_count(void *context) {
+    ComputedSourceContext *ctx = (ComputedSourceContext *)context;
+    return ctx->inner_cols + 1;
+}
+
+static FieldDesc computed_get_cell(void *context, size_t row, size_t col) {
+    ComputedSourceContext *ctx = (ComputedSourceContext *)context;
+    if (col < ctx->inner_cols) {
+        return ctx->inner->ops->get_cell(ctx->inner->context, row, col);
+    }
+    if (col > ctx->inner_cols || row >= computed_get_row_count(ctx)) {
+        return empty_field();
+    }
+    if (ctx->materialized) {
+        return read_materialized(ctx->materialized, row);
+    }
+
+    ComputedCacheEntry *entry = cache_lookup(&ctx->cache, row);
+    if (!entry) {
+        const ExprValue *value = expr_evaluate_batch(ctx->evaluator, &row, 1);
+        entry = cache_insert(&ctx->cache, row);
+        size_t length = value ? format_into(value, &entry->text, &entry->capacity) : SIZE_MAX;
+        entry->length = length == SIZE_MAX ? 0 : length;
+        if (!entry->text) return text_field("", 0);
+    }
+    return text_field(entry->text, entry->length);
+}
+
+static FieldDesc computed_get_header(void *context, size_t col) {
+    ComputedSourceContext *ctx = (ComputedSourceContext *)context;
+    if (col < ctx->inner_cols) {
+        return ctx->inner->ops->get_header(ctx->inner->context, col);
+    }
+    if (col == ctx->inner_cols) {
+        return text_field(ctx->name, strlen(ctx->name));
+    }
+    return empty_field();
+}
+
+// Samples rows spread evenly over the source, the same way file column
+// widths are estimated.
+static int sample_computed_width(ComputedSourceContext *ctx) {
+    size_t rows = computed_get_row_count(ctx);
+    size_t sample = rows < ctx->width_sample_rows ? rows : ctx->width_sample_rows;
+    size_t width = strlen(ctx->name);
+    size_t max_width = (size_t)ctx->max_width;
+    size_t batch[EXPR_BATCH_SIZE];
+
+    for (size_t begin = 0; begin < sample && width < max_width; begin += EXPR_BATCH_SIZE) {
+        size_t count = sample - begin < EXPR_BATCH_SIZE ? sample - begin : EXPR_BATCH_SIZE;
+        for (size_t i = 0; i < count; i++) batch[i] = (size_t)((uint64_t)(begin + i) * rows / sample);
+        const ExprValue *values = expr_evaluate_batch(ctx->evaluator, batch, count);
+        if (!values) break;
+        for (size_t i = 0; i < count; i++) {
+            char text[IN_MEMORY_NUMBER_BUFFER_SIZE];
+            size_t length = values[i].type == EXPR_VALUE_STRING ? values[i].length
+                                                                : expr_format_value(&values[i], text, sizeof(text));
+            if (length > width) width = length;
+        }
+    }
+
+    if (width > max_width) width = max_width;
+    if (width < (size_t)ctx->min_width) width = (size_t)ctx->min_width;
+    return (int)width;
+}
+
+static int computed_get_column_width(void *context, size_t col) {
+    ComputedSourceContext *ctx = (ComputedSourceContext *)context;
+    if (col < ctx->inner_cols) {
+        return ctx->inner->ops->get_column_width(ctx->inner->context, col);
+    }
+    if (ctx->width < 0) {
+        ctx->width = sample_computed_width(ctx);
+    }
+    return ctx->width;
+}
+
+static void free_materialized(MaterializedColumn *column) {
+    if (!column) return;
+    free(column->values);
+    free(column->offsets);
+    free(column->lengths);
+    free(column);
+}
+
+static void computed_destroy(void *context) {
+    if (!context) return;
+    ComputedSourceContext *ctx = (ComputedSourceContext *)context;
+    free_cell_cache(&ctx->cache);
+    free_materialized(ctx->materialized);
+    expr_evaluator_free(ctx->evaluator);
+    data_source_close_cursor(ctx->cursor);
+    expression_free(ctx->expr);
+    free(ctx->name);
+    if (ctx->owns_inner) {
+        destroy_data_source(ctx->inner);
+    }
+    free(ctx);
+}
+
+// --- Cursors ---
+
+static void* computed_create_cursor(void *context) {
+    ComputedSourceContext *ctx = (ComputedSourceContext *)context;
+    ComputedCursor *cursor = calloc(1, sizeof(ComputedCursor));
+    if (!cursor) return NULL;
+
+    cursor->inner = data_source_open_cursor(ctx->inner);
+    cursor->evaluator = cursor->inner ? expr_evaluator_create(ctx->expr, cursor->inner) : NULL;
+    if (!cursor->evaluator) {
+        data_source_close_cursor(cursor->inner);
+        free(cursor);
+        return NULL;
+    }
+    return cursor;
+}
+
+static FieldDesc computed_cursor_get_cell(void *context, void *cursor, size_t row, size_t col) {
+    ComputedSourceContext *ctx = (ComputedSourceContext *)context;
+    ComputedCursor *cc = (ComputedCursor *)cursor;
+    if (col < ctx->inner_cols) {
+        return data_source_cursor_get_cell(cc->inner, row, col);
+    }
+    if (col > ctx->inner_cols || row >= computed_get_row_count(ctx)) {
+        return empty_field();
+    }
+    if (ctx->materialized) {
+        return read_materialized(ctx->materialized, row);
+    }
+
+    const ExprValue *value = expr_evaluate_batch(cc->evaluator, &row, 1);
+    size_t length = value ? format_into(value, &cc->text, &cc->capacity) : SIZE_MAX;
+    if (length == SIZE_MAX || !cc->text) return text_field("", 0);
+    return text_field(cc->text, length);
+}
+
+static void computed_destroy_cursor(void *context, void *cursor) {
+    (void)context;
+    ComputedCursor *cc = (ComputedCursor *)cursor;
+    expr_evaluator_free(cc->evaluator);
+    data_source_close_cursor(cc->inner);
+    free(cc->text);
+    free(cc);
+}
+
+// --- Bulk Materialization ---
+
+typedef struct {
+    ComputedSourceContext *ctx;
+    size_t row_count;
+    size_t chunk_count;
+    MaterializedColumn *column;  // offsets are chunk-relative until merged
+    char **chunk_text;
+    size_t *chunk_size;
+    int failed;
+} MaterializeJob;
+
+static void materialize_chunk(void *arg, size_t chunk) {
+    MaterializeJob *job = (MaterializeJob *)arg;
+    size_t begin, end;
+    parallel_chunk_bounds(job->row_count, job->chunk_count, chunk, &begin, &end);
+
+    DataSourceCursor *cursor = data_source_open_cursor(job->ctx->inner);
+    ExprEvaluator *evaluator = cursor ? expr_evaluator_create(job->ctx->expr, cursor) : NULL;
+    char *text = NULL;
+    size_t size = 0, capacity = 0;
+    size_t batch[EXPR_BATCH_SIZE];
+    bool ok = evaluator != NULL;
+
+    for (size_t row = begin; ok && row < end; row += EXPR_BATCH_SIZE) {
+        size_t count = end - row < EXPR_BATCH_SIZE ? end - row : EXPR_BATCH_SIZE;
+        for (size_t i = 0; i < count; i++) batch[i] = row + i;
+
+        const ExprValue *values = expr_evaluate_batch(evaluator, batch, count);
+        if (!values) {
+            ok = false;
+            break;
+        }
+        for (size_t i = 0; i < count; i++) {
+            size_t needed = (values[i].type == EXPR_VALUE_STRING ? values[i].length : IN_MEMORY_NUMBER_BUFFER_SIZE) + 1;
+            if (size + needed > capacity) {
+                size_t grown_capacity = capacity > 0 ? capacity : 4096;
+                while (grown_capacity < size + needed) grown_capacity *= 2;
+                char *grown = realloc(text, grown_capacity);
+                if (!grown) {
+                    ok = false;
+                    break;
+                }
+                text = grown;
+                capacity = grown_capacity;
+            }
+            size_t length = expr_format_value(&values[i], text + size, capacity - size);
+            job->column->offsets[row + i] = size;
+            job->column->lengths[row + i] = (uint32_t)length;
+            size += length + 1;
+        }
+    }
+
+    if (ok) {
+        job->chunk_text[chunk] = text;
+        job->chunk_size[chunk] = size;
+    } else {
+        __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+        free(text);
+    }
+    expr_evaluator_free(evaluator);
+    data_source_close_cursor(cursor);
+}
+
+static void computed_prepare_column(void *context, size_t col) {
+    ComputedSourceContext *ctx = (ComputedSourceContext *)context;
+    if (col < ctx->inner_cols) {
+        data_source_prepare_column(ctx->inner, col);
+        return;
+    }
+    if (col > ctx->inner_cols || ctx->materialized) return;
+
+    // Inputs that are themselves computed get materialized first, so the
+    // workers below only ever read finished columns.
+    for (size_t input = 0; input < ctx->inner_cols; input++) {
+        if (expression_uses_column(ctx->expr, input)) {
+            data_source_prepare_column(ctx->inner, input);
+        }
+    }
+
+    size_t row_count = computed_get_row_count(ctx);
+    MaterializeJob job = { .ctx = ctx, .row_count = row_count, .chunk_count = 1 };
+    if (row_count == 0) return;
+    if (data_source_supports_cursors(ctx->inner)) {
+        job.chunk_count = parallel_chunk_count(row_count, MIN_ROWS_PER_EVAL_CHUNK);
+    }
+
+    job.column = calloc(1, sizeof(MaterializedColumn));
+    job.chunk_text = calloc(job.chunk_count, sizeof(char *));
+    job.chunk_size = calloc(job.chunk_count, sizeof(size_t));
+    if (job.column) {
+        job.column->offsets = malloc(row_count * sizeof(size_t));
+        job.column->lengths = malloc(row_count * sizeof(uint32_t));
+    }
+    if (!job.column || !job.column->offsets || !job.column->lengths || !job.chunk_text || !job.chunk_size) {
+        job.failed = 1;
+    } else {
+        parallel_for(job.chunk_count, materialize_chunk, &job);
+    }
+
+    // Stitch the per-chunk text into one arena and rebase the offsets.
+    size_t total = 0;
+    for (size_t i = 0; !job.failed && i < job.chunk_count; i++) total += job.chunk_size[i];
+    if (!job.failed) {
+        job.column->values = malloc(total > 0 ? total : 1);
+        if (!job.column->values) job.failed = 1;
+    }
+    if (!job.failed) {
+        size_t base = 0;
+        for (size_t chunk = 0; chunk < job.chunk_count; chunk++) {
+            size_t begin, end;
+            parallel_chunk_bounds(row_count, job.chunk_count, chunk, &begin, &end);
+            if (job.chunk_size[chunk] > 0) {
+                memcpy(job.column->values + base, job.chunk_text[chunk], job.chunk_size[chunk]);
+            }
+            for (size_t row = begin; row < end; row++) job.column->offsets[row] += base;
+            base += job.chunk_size[chunk];
+        }
+        job.column->row_count = row_count;
+        ctx->materialized = job.column;
+        job.column = NULL;
+    } else {
+        LOG_WARN("Could not materialize computed column '%s'; evaluating lazily", ctx->name);
+    }
+
+    for (size_t i = 0; job.chunk_text && i < job.chunk_count; i++) free(job.chunk_text[i]);
+    free(job.chunk_text);
+    free(job.chunk_size);
+    free_materialized(job.column);
+}
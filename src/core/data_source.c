@@ -1,22 +1,40 @@
 #include "core/data_source.h"
 #include "core/parser.h"
-#include "app/app_init.h"
+#include "app_init.h"
 #include "core/file_data.h"
 #include "core/parsed_data.h"
 #include "memory/in_memory_table.h"
 #include "util/logging.h"
 #include "memory/constants.h"
+#include "core/analysis.h"
+#include "util/byte_search.h"
+#include "core/trigram_index.h"
 #include <stdlib.h>
+#include <stdio.h>
 #include <string.h>
+#include <pthread.h>
 
 // --- File Data Source ---
 
+// Per-reader parse scratch. The file context owns one for plain get_cell
+// calls; every other reader gets its own through create_cursor.
 typedef struct {
-    struct DSVViewer *viewer;
     size_t cached_line_index;
     FieldDesc *cached_fields;
     size_t field_count;
     size_t max_fields;
+} FileCursor;
+
+typedef struct {
+    struct DSVViewer *viewer;   // Shared, read-only once the file is scanned
+    FileCursor default_cursor;  // Used by get_cell from the UI thread
+
+    // Optional trigram index, published by the indexing thread once it is
+    // loaded or built; searches scan the whole file until then.
+    TrigramIndex *trigram_index;
+    pthread_t index_thread;
+    bool index_thread_running;  // Started and not yet joined
+    int index_cancel;
 } FileDataSourceContext;
 
 static size_t file_get_row_count(void *context);
@@ -25,6 +43,11 @@ static FieldDesc file_get_cell(void *context, size_t row, size_t col);
 static FieldDesc file_get_header(void *context, size_t col);
 static int file_get_column_width(void *context, size_t col);
 static void file_destroy(void *context);
+static void* file_create_cursor(void *context);
+static FieldDesc file_cursor_get_cell(void *context, void *cursor, size_t row, size_t col);
+static void file_destroy_cursor(void *context, void *cursor);
+static bool file_search_rows(void *context, const CellQuery *query, size_t first_row, size_t row_count,
+                             RowMatchFn on_match, void *user);
 
 static const DataSourceOps file_ops = {
     .get_row_count = file_get_row_count,
@@ -33,24 +56,111 @@ static const DataSourceOps file_ops = {
     .get_header = file_get_header,
     .get_column_width = file_get_column_width,
     .destroy = file_destroy,
+    .create_cursor = file_create_cursor,
+    .cursor_get_cell = file_cursor_get_cell,
+    .destroy_cursor = file_destroy_cursor,
+    .search_rows = file_search_rows,
 };
 
-static void ensure_file_line_cached(FileDataSourceContext *ctx, size_t row_index) {
-    if (ctx->cached_line_index == row_index) {
+static int init_file_cursor(FileCursor *cursor, size_t max_fields) {
+    cursor->cached_line_index = (size_t)-1; // -1 indicates no line is cached
+    cursor->field_count = 0;
+    cursor->max_fields = max_fields;
+    cursor->cached_fields = malloc(sizeof(FieldDesc) * max_fields);
+    return cursor->cached_fields ? 0 : -1;
+}
+
+static void ensure_file_line_cached(const FileDataSourceContext *ctx, FileCursor *cursor, size_t row_index) {
+    if (cursor->cached_line_index == row_index) {
         return;
     }
 
-    FileData *fd = ctx->viewer->file_data;
-    ParsedData *pd = ctx->viewer->parsed_data;
+    const FileData *fd = ctx->viewer->file_data;
+    const ParsedData *pd = ctx->viewer->parsed_data;
     if (row_index >= pd->num_lines) {
-        ctx->field_count = 0;
-        ctx->cached_line_index = (size_t)-1;
+        cursor->field_count = 0;
+        cursor->cached_line_index = (size_t)-1;
         return;
     }
 
     size_t line_offset = pd->line_offsets[row_index];
-    ctx->field_count = parse_line(fd->data, fd->length, pd->delimiter, line_offset, ctx->cached_fields, ctx->max_fields);
-    ctx->cached_line_index = row_index;
+    cursor->field_count = parse_line(fd->data, fd->length, pd->delimiter, line_offset, cursor->cached_fields, cursor->max_fields);
+    cursor->cached_line_index = row_index;
+}
+
+static FieldDesc file_read_cell(const FileDataSourceContext *ctx, FileCursor *cursor, size_t row, size_t col) {
+    size_t actual_row = row;
+    if (ctx->viewer->parsed_data->has_header) {
+        actual_row++;
+    }
+
+    ensure_file_line_cached(ctx, cursor, actual_row);
+
+    if (col < cursor->field_count) {
+        return cursor->cached_fields[col];
+    }
+    return (FieldDesc){ .start = NULL, .length = 0, .needs_unescaping = 0 };
+}
+
+// --- File Data Source Trigram Index ---
+
+static void trigram_index_input(const FileDataSourceContext *ctx, TrigramIndexInput *input) {
+    const FileData *fd = ctx->viewer->file_data;
+    const ParsedData *pd = ctx->viewer->parsed_data;
+    size_t header = (pd->has_header && pd->num_lines > 0) ? 1 : 0;
+    *input = (TrigramIndexInput){
+        .data = fd->data,
+        .length = fd->length,
+        .row_offsets = pd->line_offsets + header,
+        .row_count = pd->num_lines - header,
+        .delimiter = pd->delimiter,
+        .source_modified = (int64_t)fd->modified,
+    };
+}
+
+// Loads the index saved next to the file, or builds and saves it when it is
+// missing or stale.
+static void* trigram_index_worker(void *arg) {
+    FileDataSourceContext *ctx = (FileDataSourceContext *)arg;
+    TrigramIndexInput input;
+    trigram_index_input(ctx, &input);
+
+    const char *file_path = ctx->viewer->file_data->path;
+    char path[4096];
+    snprintf(path, sizeof(path), "%s%s", file_path, TRIGRAM_INDEX_SUFFIX);
+
+    TrigramIndex *index = trigram_index_load(path, &input);
+    if (index) {
+        LOG_INFO("Loaded trigram index '%s'", path);
+    } else {
+        index = trigram_index_build(&input, &ctx->index_cancel);
+        if (index) {
+            LOG_INFO("Built trigram index for %zu rows", input.row_count);
+            trigram_index_save(index, path); // Rebuilt next time if this fails
+        }
+    }
+    __atomic_store_n(&ctx->trigram_index, index, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+static void start_trigram_index(FileDataSourceContext *ctx) {
+    const FileData *fd = ctx->viewer->file_data;
+    if (!fd->path || !fd->data || strlen(fd->path) + sizeof(TRIGRAM_INDEX_SUFFIX) > 4096) return;
+    if (pthread_create(&ctx->index_thread, NULL, trigram_index_worker, ctx) != 0) {
+        LOG_WARN("Could not start the trigram index thread; searching without an index");
+        return;
+    }
+    ctx->index_thread_running = true;
+}
+
+bool file_data_source_wait_for_index(DataSource *data_source) {
+    if (!data_source || data_source->type != DATA_SOURCE_FILE) return false;
+    FileDataSourceContext *ctx = (FileDataSourceContext *)data_source->context;
+    if (ctx->index_thread_running) {
+        pthread_join(ctx->index_thread, NULL);
+        ctx->index_thread_running = false;
+    }
+    return ctx->trigram_index != NULL;
 }
 
 // --- Memory Data Source ---
@@ -58,6 +168,9 @@ static void ensure_file_line_cached(FileDataSourceContext *ctx, size_t row_index
 typedef struct {
     struct InMemoryTable *table;
     int *column_widths;
+    // One formatting slot per column so numeric cells of the same row can be
+    // held at the same time, mirroring how file cells point into the mmap.
+    char (*number_buffers)[IN_MEMORY_NUMBER_BUFFER_SIZE];
 } MemoryDataSourceContext;
 
 static size_t mem_get_row_count(void *context);
@@ -66,6 +179,9 @@ static FieldDesc mem_get_cell(void *context, size_t row, size_t col);
 static FieldDesc mem_get_header(void *context, size_t col);
 static int mem_get_column_width(void *context, size_t col);
 static void mem_destroy(void *context);
+static void* mem_create_cursor(void *context);
+static FieldDesc mem_cursor_get_cell(void *context, void *cursor, size_t row, size_t col);
+static void mem_destroy_cursor(void *context, void *cursor);
 
 static const DataSourceOps mem_ops = {
     .get_row_count = mem_get_row_count,
@@ -74,8 +190,12 @@ static const DataSourceOps mem_ops = {
     .get_header = mem_get_header,
     .get_column_width = mem_get_column_width,
     .destroy = mem_destroy,
+    .create_cursor = mem_create_cursor,
+    .cursor_get_cell = mem_cursor_get_cell,
+    .destroy_cursor = mem_destroy_cursor,
 };
 
+// Widths are tracked by the table as rows are appended, so this is O(columns).
 static void calculate_memory_table_widths(MemoryDataSourceContext *ctx) {
     InMemoryTable *table = ctx->table;
     ctx->column_widths = calloc(table->col_count, sizeof(int));
@@ -84,16 +204,7 @@ static void calculate_memory_table_widths(MemoryDataSourceContext *ctx) {
     }
 
     for (size_t col = 0; col < table->col_count; col++) {
-        ctx->column_widths[col] = strlen(table->headers[col]);
-    }
-
-    for (size_t row = 0; row < table->row_count; row++) {
-        for (size_t col = 0; col < table->col_count; col++) {
-            int len = strlen(table->data[row][col]);
-            if (len > ctx->column_widths[col]) {
-                ctx->column_widths[col] = len;
-            }
-        }
+        ctx->column_widths[col] = (int)in_memory_table_column_width(table, col);
     }
 }
 
@@ -104,17 +215,14 @@ DataSource* create_file_data_source(struct DSVViewer *viewer) {
     if (!ctx) return NULL;
 
     ctx->viewer = viewer;
-    ctx->cached_line_index = (size_t)-1; // -1 indicates no line is cached
-    ctx->max_fields = viewer->config->max_cols;
-    ctx->cached_fields = malloc(sizeof(FieldDesc) * ctx->max_fields);
-    if (!ctx->cached_fields) {
+    if (init_file_cursor(&ctx->default_cursor, viewer->config->max_cols) != 0) {
         free(ctx);
         return NULL;
     }
 
     DataSource *ds = malloc(sizeof(DataSource));
     if (!ds) {
-        free(ctx->cached_fields);
+        free(ctx->default_cursor.cached_fields);
         free(ctx);
         return NULL;
     }
@@ -123,6 +231,7 @@ DataSource* create_file_data_source(struct DSVViewer *viewer) {
     ds->ops = &file_ops;
     ds->type = DATA_SOURCE_FILE;
 
+    if (viewer->config->trigram_index) start_trigram_index(ctx);
     return ds;
 }
 
@@ -131,9 +240,16 @@ DataSource* create_memory_data_source(struct InMemoryTable *table) {
     if (!ctx) return NULL;
     ctx->table = table;
     calculate_memory_table_widths(ctx);
+    ctx->number_buffers = calloc(table->col_count, sizeof(*ctx->number_buffers));
+    if (!ctx->number_buffers) {
+        free(ctx->column_widths);
+        free(ctx);
+        return NULL;
+    }
 
     DataSource *ds = malloc(sizeof(DataSource));
     if (!ds) {
+        free(ctx->number_buffers);
         free(ctx->column_widths);
         free(ctx);
         return NULL;
@@ -153,6 +269,60 @@ void destroy_data_source(DataSource *data_source) {
     }
 }
 
+void data_source_prepare_column(DataSource *data_source, size_t col) {
+    if (data_source && data_source->ops && data_source->ops->prepare_column) {
+        data_source->ops->prepare_column(data_source->context, col);
+    }
+}
+
+bool data_source_search_rows(DataSource *data_source, const CellQuery *query, size_t first_row, size_t row_count,
+                             RowMatchFn on_match, void *user) {
+    if (!data_source || !data_source->ops || !data_source->ops->search_rows) return false;
+    return data_source->ops->search_rows(data_source->context, query, first_row, row_count, on_match, user);
+}
+
+// --- Cursors ---
+
+bool data_source_supports_cursors(const DataSource *data_source) {
+    return data_source && data_source->ops &&
+           data_source->ops->create_cursor &&
+           data_source->ops->cursor_get_cell &&
+           data_source->ops->destroy_cursor;
+}
+
+DataSourceCursor* data_source_open_cursor(DataSource *data_source) {
+    if (!data_source || !data_source->ops) return NULL;
+
+    DataSourceCursor *cursor = calloc(1, sizeof(DataSourceCursor));
+    if (!cursor) return NULL;
+    cursor->source = data_source;
+
+    if (data_source_supports_cursors(data_source)) {
+        cursor->state = data_source->ops->create_cursor(data_source->context);
+        if (!cursor->state) {
+            free(cursor);
+            return NULL;
+        }
+    }
+    return cursor;
+}
+
+FieldDesc data_source_cursor_get_cell(DataSourceCursor *cursor, size_t row, size_t col) {
+    DataSource *ds = cursor->source;
+    if (cursor->state) {
+        return ds->ops->cursor_get_cell(ds->context, cursor->state, row, col);
+    }
+    return ds->ops->get_cell(ds->context, row, col);
+}
+
+void data_source_close_cursor(DataSourceCursor *cursor) {
+    if (!cursor) return;
+    if (cursor->state) {
+        cursor->source->ops->destroy_cursor(cursor->source->context, cursor->state);
+    }
+    free(cursor);
+}
+
 // --- File Data Source Ops Implementation ---
 
 static size_t file_get_row_count(void *context) {
@@ -177,17 +347,7 @@ static size_t file_get_col_count(void *context) {
 
 static FieldDesc file_get_cell(void *context, size_t row, size_t col) {
     FileDataSourceContext *ctx = (FileDataSourceContext *)context;
-    size_t actual_row = row;
-    if (ctx->viewer->parsed_data->has_header) {
-        actual_row++;
-    }
-    
-    ensure_file_line_cached(ctx, actual_row);
-
-    if (col < ctx->field_count) {
-        return ctx->cached_fields[col];
-    }
-    return (FieldDesc){ .start = NULL, .length = 0, .needs_unescaping = 0 };
+    return file_read_cell(ctx, &ctx->default_cursor, row, col);
 }
 
 static FieldDesc file_get_header(void *context, size_t col) {
@@ -199,18 +359,173 @@ static FieldDesc file_get_header(void *context, size_t col) {
 }
 
 static int file_get_column_width(void *context, size_t col) {
-    (void)context;
-    (void)col;
-    return DEFAULT_COL_WIDTH; // File source does not pre-calculate widths
+    FileDataSourceContext *ctx = (FileDataSourceContext *)context;
+    // Widths are sampled lazily from the file and cached on the viewer.
+    return analysis_get_column_width(ctx->viewer, (int)col);
 }
 
 static void file_destroy(void *context) {
     if (!context) return;
     FileDataSourceContext *ctx = (FileDataSourceContext *)context;
-    free(ctx->cached_fields);
+    if (ctx->index_thread_running) {
+        __atomic_store_n(&ctx->index_cancel, 1, __ATOMIC_RELAXED);
+        pthread_join(ctx->index_thread, NULL);
+    }
+    trigram_index_free(ctx->trigram_index);
+    free(ctx->default_cursor.cached_fields);
     free(ctx);
 }
 
+static void* file_create_cursor(void *context) {
+    FileDataSourceContext *ctx = (FileDataSourceContext *)context;
+    FileCursor *cursor = malloc(sizeof(FileCursor));
+    if (!cursor) return NULL;
+    if (init_file_cursor(cursor, ctx->default_cursor.max_fields) != 0) {
+        free(cursor);
+        return NULL;
+    }
+    return cursor;
+}
+
+static FieldDesc file_cursor_get_cell(void *context, void *cursor, size_t row, size_t col) {
+    return file_read_cell((const FileDataSourceContext *)context, (FileCursor *)cursor, row, col);
+}
+
+static void file_destroy_cursor(void *context, void *cursor) {
+    (void)context;
+    FileCursor *file_cursor = (FileCursor *)cursor;
+    free(file_cursor->cached_fields);
+    free(file_cursor);
+}
+
+// --- File Data Source Raw Search ---
+
+// Index of the line in [low, high) that contains byte 'offset'.
+static size_t line_containing(const ParsedData *pd, size_t low, size_t high, size_t offset) {
+    while (high - low > 1) {
+        size_t mid = low + (high - low) / 2;
+        if (pd->line_offsets[mid] <= offset) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+// True if the row parsed from 'line' runs on past 'offset' (a quoted field
+// spanning a line break).
+static bool line_reaches(const FileDataSourceContext *ctx, FileCursor *scratch, size_t line, size_t offset) {
+    ensure_file_line_cached(ctx, scratch, line);
+    if (scratch->field_count == 0) return false;
+    const FieldDesc *last = &scratch->cached_fields[scratch->field_count - 1];
+    return (size_t)(last->start - ctx->viewer->file_data->data) + last->length > offset;
+}
+
+static const char* find_text(const char *text, size_t length, const char *term, size_t term_length,
+                             bool ignore_case) {
+    return ignore_case ? find_bytes_ignore_case(text, length, term, term_length)
+                       : find_bytes(text, length, term, term_length);
+}
+
+// Checks every cell of one candidate row the way the cell-by-cell search
+// does, which also settles quoted and escaped fields.
+static bool report_line_matches(const FileDataSourceContext *ctx, FileCursor *scratch, size_t line,
+                                const CellQuery *query, RowMatchFn on_match, void *user) {
+    const ParsedData *pd = ctx->viewer->parsed_data;
+    size_t row = line - (pd->has_header ? 1 : 0);
+    char cell_buffer[4096];
+
+    ensure_file_line_cached(ctx, scratch, line);
+    size_t fields = scratch->field_count < pd->num_header_fields ? scratch->field_count : pd->num_header_fields;
+    for (size_t col = 0; col < fields; col++) {
+        const FieldDesc *field = &scratch->cached_fields[col];
+        if (field->start == NULL || field->length == 0) continue;
+        render_field(field, cell_buffer, sizeof(cell_buffer));
+        if (!text_contains(cell_buffer, query->literal, query->ignore_case)) continue;
+        if (query->matches && !query->matches(query->arg, cell_buffer)) continue;
+        if (!on_match(user, row, col)) return false;
+    }
+    return true;
+}
+
+// Reports the rows with a match in the bytes of lines [line, end_line).
+// Rows before 'line' whose quoted fields run on into it are reported too,
+// back to *reported, the first line not yet reported.
+static bool scan_lines(const FileDataSourceContext *ctx, FileCursor *scratch, const CellQuery *query,
+                       size_t term_length, size_t line, size_t end_line, size_t *reported,
+                       RowMatchFn on_match, void *user) {
+    const FileData *fd = ctx->viewer->file_data;
+    const ParsedData *pd = ctx->viewer->parsed_data;
+    size_t end = end_line < pd->num_lines ? pd->line_offsets[end_line] : fd->length;
+    while (line < end_line) {
+        size_t pos = pd->line_offsets[line];
+        const char *match = find_text(fd->data + pos, end - pos, query->literal, term_length, query->ignore_case);
+        if (!match) break;
+
+        size_t offset = (size_t)(match - fd->data);
+        size_t hit_line = line_containing(pd, line, end_line, offset);
+
+        // Rows whose quoted fields run on into this line contain the match too.
+        size_t from = hit_line;
+        while (from > *reported && line_reaches(ctx, scratch, from - 1, offset)) from--;
+
+        for (size_t l = from; l <= hit_line; l++) {
+            if (!report_line_matches(ctx, scratch, l, query, on_match, user)) return false;
+        }
+        *reported = hit_line + 1;
+        line = hit_line + 1;
+    }
+    return true;
+}
+
+// Scans the mapped bytes of the rows for the query's literal and only parses
+// the rows it occurs in. A literal without quotes, delimiters or line breaks
+// reads the same in the file as on screen, so every rendered occurrence is
+// also a raw one. Once a trigram index is available, only the row blocks
+// holding all of the literal's trigrams are scanned.
+static bool file_search_rows(void *context, const CellQuery *query, size_t first_row, size_t row_count,
+                             RowMatchFn on_match, void *user) {
+    FileDataSourceContext *ctx = (FileDataSourceContext *)context;
+    const ParsedData *pd = ctx->viewer->parsed_data;
+    const char *term = query->literal;
+    size_t term_length = strlen(term);
+    if (term_length == 0 || strchr(term, '"') || strchr(term, pd->delimiter) || strchr(term, '\n')) {
+        return false;
+    }
+
+    FileCursor scratch;
+    if (init_file_cursor(&scratch, ctx->default_cursor.max_fields) != 0) return false;
+
+    size_t header = pd->has_header ? 1 : 0;
+    size_t first_line = first_row + header;
+    size_t end_line = first_line + row_count < pd->num_lines ? first_line + row_count : pd->num_lines;
+    size_t reported = first_line;
+
+    const TrigramIndex *index = __atomic_load_n(&ctx->trigram_index, __ATOMIC_ACQUIRE);
+    TrigramQuery *candidates = index ? trigram_query_create(index, term, term_length, query->ignore_case) : NULL;
+    if (candidates) {
+        size_t block_rows = trigram_index_block_rows(index);
+        size_t end_row = end_line > header ? end_line - header : 0;
+        size_t block = trigram_query_next_block(candidates, first_row / block_rows);
+        while (block != SIZE_MAX && block < (end_row + block_rows - 1) / block_rows) {
+            size_t from = block * block_rows > first_row ? block * block_rows : first_row;
+            size_t to = (block + 1) * block_rows < end_row ? (block + 1) * block_rows : end_row;
+            if (!scan_lines(ctx, &scratch, query, term_length, from + header, to + header, &reported,
+                            on_match, user)) {
+                break;
+            }
+            block = trigram_query_next_block(candidates, block + 1);
+        }
+        trigram_query_free(candidates);
+    } else {
+        scan_lines(ctx, &scratch, query, term_length, first_line, end_line, &reported, on_match, user);
+    }
+
+    free(scratch.cached_fields);
+    return true;
+}
+
 // --- Memory Data Source Ops Implementation ---
 
 static size_t mem_get_row_count(void *context) {
@@ -223,15 +538,25 @@ static size_t mem_get_col_count(void *context) {
     return ctx->table->col_count;
 }
 
-static FieldDesc mem_get_cell(void *context, size_t row, size_t col) {
-    MemoryDataSourceContext *ctx = (MemoryDataSourceContext *)context;
-    if (row < ctx->table->row_count && col < ctx->table->col_count) {
-        const char *cell_data = ctx->table->data[row][col];
-        return (FieldDesc){ .start = cell_data, .length = strlen(cell_data), .needs_unescaping = 0 };
+static FieldDesc mem_read_cell(const InMemoryTable *table, char (*number_buffers)[IN_MEMORY_NUMBER_BUFFER_SIZE], size_t row, size_t col) {
+    if (row < table->row_count && col < table->col_count) {
+        if (table->columns[col].type == COLUMN_TYPE_STRING) {
+            size_t length = 0;
+            const char *cell_data = in_memory_table_get_string(table, row, col, &length);
+            return (FieldDesc){ .start = cell_data, .length = length, .needs_unescaping = 0 };
+        }
+        char *buffer = number_buffers[col];
+        size_t length = in_memory_table_format_cell(table, row, col, buffer, IN_MEMORY_NUMBER_BUFFER_SIZE);
+        return (FieldDesc){ .start = buffer, .length = length, .needs_unescaping = 0 };
     }
     return (FieldDesc){ .start = NULL, .length = 0, .needs_unescaping = 0 };
 }
 
+static FieldDesc mem_get_cell(void *context, size_t row, size_t col) {
+    MemoryDataSourceContext *ctx = (MemoryDataSourceContext *)context;
+    return mem_read_cell(ctx->table, ctx->number_buffers, row, col);
+}
+
 static FieldDesc mem_get_header(void *context, size_t col) {
     MemoryDataSourceContext *ctx = (MemoryDataSourceContext *)context;
     if (col < ctx->table->col_count) {
@@ -256,5 +581,23 @@ static void mem_destroy(void *context) {
     // be cleaned up when the view is closed.
     free_in_memory_table(ctx->table);
     free(ctx->column_widths);
+    free(ctx->number_buffers);
     free(ctx);
-} 
\ No newline at end of file
+}
+
+// String cells are read straight from the table's arenas; a memory cursor only
+// needs its own formatting slots for numeric cells.
+static void* mem_create_cursor(void *context) {
+    MemoryDataSourceContext *ctx = (MemoryDataSourceContext *)context;
+    return calloc(ctx->table->col_count, IN_MEMORY_NUMBER_BUFFER_SIZE);
+}
+
+static FieldDesc mem_cursor_get_cell(void *context, void *cursor, size_t row, size_t col) {
+    MemoryDataSourceContext *ctx = (MemoryDataSourceContext *)context;
+    return mem_read_cell(ctx->table, (char (*)[IN_MEMORY_NUMBER_BUFFER_SIZE])cursor, row, col);
+}
+
+static void mem_destroy_cursor(void *context, void *cursor) {
+    (void)context;
+    free(cursor);
+}
@@ -0,0 +1,625 @@
+#include "core/expression.h"
+#include "core/parser.h"
+#include "memory/arena.h"
+#include "app_init.h"
+#include "logging.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <ctype.h>
+#include <stdarg.h>
+#include <strings.h>
+
+#define MAX_NAME_LEN 256
+#define NUMBER_PARSE_BUFFER 64
+
+// --- Bytecode ---
+
+typedef enum {
+    OP_PUSH_NUMBER,   // arg: index into numbers[]
+    OP_PUSH_STRING,   // arg: index into strings[]
+    OP_LOAD_COLUMN,   // arg: column index
+    OP_ADD,
+    OP_SUB,
+    OP_MUL,
+    OP_DIV,
+    OP_MOD,
+    OP_NEG,
+    OP_LEN,
+    OP_SUBSTR2,       // substr(s, start)
+    OP_SUBSTR3,       // substr(s, start, count)
+    OP_ABS,
+    OP_LOWER,
+    OP_UPPER
+} ExprOp;
+
+typedef struct {
+    ExprOp op;
+    size_t arg;
+} ExprInstruction;
+
+typedef struct {
+    char *text;
+    size_t length;
+} ExprString;
+
+struct CompiledExpression {
+    ExprInstruction *code;
+    size_t code_count;
+    size_t code_capacity;
+
+    double *numbers;
+    size_t number_count;
+    ExprString *strings;
+    size_t string_count;
+
+    size_t max_stack;     // Deepest stack the code can reach
+};
+
+struct ExprEvaluator {
+    const CompiledExpression *expr;
+    DataSourceCursor *cursor;
+    ExprValue *stack;     // max_stack slots of EXPR_BATCH_SIZE values each
+    Arena scratch;        // Cell text and string results of the current batch
+};
+
+// --- Compiler ---
+
+typedef struct {
+    const char *text;
+    const char *pos;
+    DataSource *source;
+    CompiledExpression *expr;
+    size_t depth;          // Stack depth at the current point of the code
+    char *error;
+    size_t error_size;
+    bool failed;
+} ExprCompiler;
+
+static void compile_error(ExprCompiler *c, const char *fmt, ...) {
+    if (c->failed) return; // Keep the first, most specific message
+    c->failed = true;
+    if (!c->error || c->error_size == 0) return;
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(c->error, c->error_size, fmt, args);
+    va_end(args);
+}
+
+static void skip_spaces(ExprCompiler *c) {
+    while (isspace((unsigned char)*c->pos)) c->pos++;
+}
+
+static void emit(ExprCompiler *c, ExprOp op, size_t arg) {
+    if (c->failed) return;
+    CompiledExpression *e = c->expr;
+    if (e->code_count == e->code_capacity) {
+        size_t capacity = e->code_capacity ? e->code_capacity * 2 : 16;
+        ExprInstruction *code = realloc(e->code, capacity * sizeof(ExprInstruction));
+        if (!code) {
+            compile_error(c, "Out of memory");
+            return;
+        }
+        e->code = code;
+        e->code_capacity = capacity;
+    }
+    e->code[e->code_count++] = (ExprInstruction){ .op = op, .arg = arg };
+
+    // Track the stack effect so the evaluator can size its stack up front.
+    switch (op) {
+        case OP_PUSH_NUMBER:
+        case OP_PUSH_STRING:
+        case OP_LOAD_COLUMN:
+            c->depth++;
+            break;
+        case OP_ADD: case OP_SUB: case OP_MUL: case OP_DIV: case OP_MOD:
+        case OP_SUBSTR2:
+            c->depth--;
+            break;
+        case OP_SUBSTR3:
+            c->depth -= 2;
+            break;
+        default:
+            break; // Unary operators leave the depth unchanged
+    }
+    if (c->depth > e->max_stack) e->max_stack = c->depth;
+}
+
+static void emit_number(ExprCompiler *c, double value) {
+    if (c->failed) return;
+    CompiledExpression *e = c->expr;
+    double *numbers = realloc(e->numbers, (e->number_count + 1) * sizeof(double));
+    if (!numbers) {
+        compile_error(c, "Out of memory");
+        return;
+    }
+    e->numbers = numbers;
+    e->numbers[e->number_count] = value;
+    emit(c, OP_PUSH_NUMBER, e->number_count++);
+}
+
+static void emit_string(ExprCompiler *c, const char *start, size_t length) {
+    if (c->failed) return;
+    CompiledExpression *e = c->expr;
+    ExprString *strings = realloc(e->strings, (e->string_count + 1) * sizeof(ExprString));
+    if (!strings) {
+        compile_error(c, "Out of memory");
+        return;
+    }
+    e->strings = strings;
+    char *text = malloc(length + 1);
+    if (!text) {
+        compile_error(c, "Out of memory");
+        return;
+    }
+    // Collapse doubled quotes ('it''s') while copying.
+    size_t out = 0;
+    for (size_t i = 0; i < length; i++) {
+        text[out++] = start[i];
+        if (start[i] == '\'' && i + 1 < length && start[i + 1] == '\'') i++;
+    }
+    text[out] = '\0';
+    e->strings[e->string_count] = (ExprString){ .text = text, .length = out };
+    emit(c, OP_PUSH_STRING, e->string_count++);
+}
+
+// Resolves a header name to a column index, ignoring case.
+static bool resolve_column(ExprCompiler *c, const char *name, size_t *out_col) {
+    DataSource *ds = c->source;
+    size_t col_count = ds->ops->get_col_count(ds->context);
+    char header[MAX_NAME_LEN];
+    for (size_t col = 0; col < col_count; col++) {
+        FieldDesc fd = ds->ops->get_header(ds->context, col);
+        if (!fd.start) continue;
+        render_field(&fd, header, sizeof(header));
+        if (strcasecmp(header, name) == 0) {
+            *out_col = col;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void parse_expression(ExprCompiler *c);
+
+static void expect(ExprCompiler *c, char ch) {
+    skip_spaces(c);
+    if (*c->pos != ch) {
+        compile_error(c, "Expected '%c' at position %zu", ch, (size_t)(c->pos - c->text) + 1);
+        return;
+    }
+    c->pos++;
+}
+
+static void parse_function_call(ExprCompiler *c, const char *name) {
+    size_t argc = 0;
+    skip_spaces(c);
+    if (*c->pos != ')') {
+        for (;;) {
+            parse_expression(c);
+            argc++;
+            skip_spaces(c);
+            if (c->failed || *c->pos != ',') break;
+            c->pos++;
+        }
+    }
+    expect(c, ')');
+    if (c->failed) return;
+
+    if (strcasecmp(name, "len") == 0 && argc == 1) emit(c, OP_LEN, 0);
+    else if (strcasecmp(name, "abs") == 0 && argc == 1) emit(c, OP_ABS, 0);
+    else if (strcasecmp(name, "lower") == 0 && argc == 1) emit(c, OP_LOWER, 0);
+    else if (strcasecmp(name, "upper") == 0 && argc == 1) emit(c, OP_UPPER, 0);
+    else if (strcasecmp(name, "substr") == 0 && argc == 2) emit(c, OP_SUBSTR2, 0);
+    else if (strcasecmp(name, "substr") == 0 && argc == 3) emit(c, OP_SUBSTR3, 0);
+    else compile_error(c, "Unknown function %s/%zu", name, argc);
+}
+
+static void parse_column_name(ExprCompiler *c, const char *name) {
+    size_t col;
+    if (resolve_column(c, name, &col)) {
+        emit(c, OP_LOAD_COLUMN, col);
+    } else {
+        compile_error(c, "Unknown column '%s'", name);
+    }
+}
+
+static void parse_primary(ExprCompiler *c) {
+    skip_spaces(c);
+    const char *start = c->pos;
+    char ch = *c->pos;
+
+    if (ch == '(') {
+        c->pos++;
+        parse_expression(c);
+        expect(c, ')');
+    } else if (isdigit((unsigned char)ch) || (ch == '.' && isdigit((unsigned char)c->pos[1]))) {
+        char *end;
+        double value = strtod(start, &end);
+        c->pos = end;
+        emit_number(c, value);
+    } else if (ch == '\'') {
+        const char *p = ++c->pos;
+        while (*p && !(*p == '\'' && p[1] != '\'')) {
+            p += (*p == '\'') ? 2 : 1;
+        }
+        if (*p != '\'') {
+            compile_error(c, "Unterminated string at position %zu", (size_t)(start - c->text) + 1);
+            return;
+        }
+        emit_string(c, c->pos, (size_t)(p - c->pos));
+        c->pos = p + 1;
+    } else if (ch == '`') {
+        const char *end = strchr(++c->pos, '`');
+        if (!end || (size_t)(end - c->pos) >= MAX_NAME_LEN) {
+            compile_error(c, "Unterminated column name at position %zu", (size_t)(start - c->text) + 1);
+            return;
+        }
+        char name[MAX_NAME_LEN];
+        memcpy(name, c->pos, (size_t)(end - c->pos));
+        name[end - c->pos] = '\0';
+        c->pos = end + 1;
+        parse_column_name(c, name);
+    } else if (ch == '$') {
+        char *end;
+        long position = strtol(c->pos + 1, &end, 10);
+        DataSource *ds = c->source;
+        if (end == c->pos + 1 || position < 1 || (size_t)position > ds->ops->get_col_count(ds->context)) {
+            compile_error(c, "Invalid column position at %zu", (size_t)(start - c->text) + 1);
+            return;
+        }
+        c->pos = end;
+        emit(c, OP_LOAD_COLUMN, (size_t)position - 1);
+    } else if (isalpha((unsigned char)ch) || ch == '_') {
+        while (isalnum((unsigned char)*c->pos) || *c->pos == '_') c->pos++;
+        size_t length = (size_t)(c->pos - start);
+        if (length >= MAX_NAME_LEN) {
+            compile_error(c, "Name too long at position %zu", (size_t)(start - c->text) + 1);
+            return;
+        }
+        char name[MAX_NAME_LEN];
+        memcpy(name, start, length);
+        name[length] = '\0';
+
+        skip_spaces(c);
+        if (*c->pos == '(') {
+            c->pos++;
+            parse_function_call(c, name);
+        } else {
+            parse_column_name(c, name);
+        }
+    } else if (ch == '\0') {
+        compile_error(c, "Unexpected end of expression");
+    } else {
+        compile_error(c, "Unexpected '%c' at position %zu", ch, (size_t)(start - c->text) + 1);
+    }
+}
+
+static void parse_unary(ExprCompiler *c) {
+    skip_spaces(c);
+    if (*c->pos == '-') {
+        c->pos++;
+        parse_unary(c);
+        emit(c, OP_NEG, 0);
+    } else if (*c->pos == '+') {
+        c->pos++;
+        parse_unary(c);
+    } else {
+        parse_primary(c);
+    }
+}
+
+static void parse_term(ExprCompiler *c) {
+    parse_unary(c);
+    for (;;) {
+        skip_spaces(c);
+        char ch = *c->pos;
+        if (c->failed || (ch != '*' && ch != '/' && ch != '%')) return;
+        c->pos++;
+        parse_unary(c);
+        emit(c, ch == '*' ? OP_MUL : ch == '/' ? OP_DIV : OP_MOD, 0);
+    }
+}
+
+static void parse_expression(ExprCompiler *c) {
+    parse_term(c);
+    for (;;) {
+        skip_spaces(c);
+        char ch = *c->pos;
+        if (c->failed || (ch != '+' && ch != '-')) return;
+        c->pos++;
+        parse_term(c);
+        emit(c, ch == '+' ? OP_ADD : OP_SUB, 0);
+    }
+}
+
+DSVResult expression_compile(const char *text, DataSource *source, CompiledExpression **out,
+                             char *error, size_t error_size) {
+    if (error && error_size > 0) error[0] = '\0';
+    if (!text || !source || !out) return DSV_ERROR_INVALID_ARGS;
+
+    CompiledExpression *expr = calloc(1, sizeof(CompiledExpression));
+    if (!expr) return DSV_ERROR_MEMORY;
+
+    ExprCompiler compiler = {
+        .text = text,
+        .pos = text,
+        .source = source,
+        .expr = expr,
+        .depth = 0,
+        .error = error,
+        .error_size = error_size,
+        .failed = false
+    };
+
+    parse_expression(&compiler);
+    skip_spaces(&compiler);
+    if (!compiler.failed && *compiler.pos != '\0') {
+        compile_error(&compiler, "Unexpected '%c' at position %zu", *compiler.pos,
+                      (size_t)(compiler.pos - text) + 1);
+    }
+
+    if (compiler.failed) {
+        expression_free(expr);
+        return DSV_ERROR_PARSE;
+    }
+
+    *out = expr;
+    return DSV_OK;
+}
+
+void expression_free(CompiledExpression *expr) {
+    if (!expr) return;
+    for (size_t i = 0; i < expr->string_count; i++) {
+        free(expr->strings[i].text);
+    }
+    free(expr->strings);
+    free(expr->numbers);
+    free(expr->code);
+    free(expr);
+}
+
+bool expression_uses_column(const CompiledExpression *expr, size_t col) {
+    if (!expr) return false;
+    for (size_t i = 0; i < expr->code_count; i++) {
+        if (expr->code[i].op == OP_LOAD_COLUMN && expr->code[i].arg == col) return true;
+    }
+    return false;
+}
+
+// --- Evaluator ---
+
+ExprEvaluator* expr_evaluator_create(const CompiledExpression *expr, DataSourceCursor *cursor) {
+    if (!expr || !cursor) return NULL;
+
+    ExprEvaluator *evaluator = calloc(1, sizeof(ExprEvaluator));
+    if (!evaluator) return NULL;
+
+    size_t slots = expr->max_stack > 0 ? expr->max_stack : 1;
+    evaluator->stack = malloc(slots * EXPR_BATCH_SIZE * sizeof(ExprValue));
+    if (!evaluator->stack) {
+        free(evaluator);
+        return NULL;
+    }
+    evaluator->expr = expr;
+    evaluator->cursor = cursor;
+    arena_init(&evaluator->scratch, 0);
+    return evaluator;
+}
+
+void expr_evaluator_free(ExprEvaluator *evaluator) {
+    if (!evaluator) return;
+    arena_free(&evaluator->scratch);
+    free(evaluator->stack);
+    free(evaluator);
+}
+
+// Coerces a value to a number. Text must be numeric in its entirety
+// (surrounding whitespace allowed); anything else is not a number.
+static bool value_to_number(const ExprValue *value, double *out) {
+    if (value->type == EXPR_VALUE_NUMBER) {
+        *out = value->number;
+        return true;
+    }
+    if (value->type != EXPR_VALUE_STRING || value->length == 0 || value->length >= NUMBER_PARSE_BUFFER) {
+        return false;
+    }
+    char buffer[NUMBER_PARSE_BUFFER];
+    memcpy(buffer, value->str, value->length);
+    buffer[value->length] = '\0';
+
+    char *end;
+    *out = strtod(buffer, &end);
+    if (end == buffer) return false;
+    while (isspace((unsigned char)*end)) end++;
+    return *end == '\0';
+}
+
+static void set_number(ExprValue *value, double number) {
+    value->type = EXPR_VALUE_NUMBER;
+    value->number = number;
+}
+
+static void set_null(ExprValue *value) {
+    value->type = EXPR_VALUE_NULL;
+}
+
+// Loads one column for every row of the batch.
+static void load_column(ExprEvaluator *ev, ExprValue *dst, size_t col, const size_t *rows, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        FieldDesc fd = data_source_cursor_get_cell(ev->cursor, rows[i], col);
+        if (!fd.start) {
+            set_null(&dst[i]);
+            continue;
+        }
+        char *text = arena_alloc(&ev->scratch, fd.length + 1);
+        if (!text) {
+            set_null(&dst[i]);
+            continue;
+        }
+        render_field(&fd, text, fd.length + 1);
+        dst[i].type = EXPR_VALUE_STRING;
+        dst[i].str = text;
+        dst[i].length = strlen(text);
+    }
+}
+
+static void arithmetic(ExprOp op, ExprValue *lhs, const ExprValue *rhs, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        double a, b;
+        if (!value_to_number(&lhs[i], &a) || !value_to_number(&rhs[i], &b)) {
+            set_null(&lhs[i]);
+            continue;
+        }
+        switch (op) {
+            case OP_ADD: set_number(&lhs[i], a + b); break;
+            case OP_SUB: set_number(&lhs[i], a - b); break;
+            case OP_MUL: set_number(&lhs[i], a * b); break;
+            case OP_DIV:
+                if (b == 0) set_null(&lhs[i]);
+                else set_number(&lhs[i], a / b);
+                break;
+            case OP_MOD:
+                if (b == 0) set_null(&lhs[i]);
+                else set_number(&lhs[i], a - b * (double)(long long)(a / b));
+                break;
+            default:
+                set_null(&lhs[i]);
+                break;
+        }
+    }
+}
+
+static void substring(ExprValue *str, const ExprValue *start, const ExprValue *count, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        double from, length = 0;
+        if (str[i].type != EXPR_VALUE_STRING || !value_to_number(&start[i], &from) ||
+            (count && !value_to_number(&count[i], &length))) {
+            set_null(&str[i]);
+            continue;
+        }
+        size_t offset = from <= 0 ? 0 : (size_t)from;
+        if (offset > str[i].length) offset = str[i].length;
+        size_t available = str[i].length - offset;
+        size_t take = available;
+        if (count) {
+            take = length <= 0 ? 0 : (size_t)length;
+            if (take > available) take = available;
+        }
+        // A substring is a view into the original text; nothing is copied.
+        str[i].str += offset;
+        str[i].length = take;
+    }
+}
+
+static void change_case(ExprEvaluator *ev, ExprValue *values, size_t count, bool upper) {
+    for (size_t i = 0; i < count; i++) {
+        if (values[i].type != EXPR_VALUE_STRING) {
+            set_null(&values[i]);
+            continue;
+        }
+        char *text = arena_alloc(&ev->scratch, values[i].length + 1);
+        if (!text) {
+            set_null(&values[i]);
+            continue;
+        }
+        for (size_t j = 0; j < values[i].length; j++) {
+            unsigned char ch = (unsigned char)values[i].str[j];
+            text[j] = (char)(upper ? toupper(ch) : tolower(ch));
+        }
+        text[values[i].length] = '\0';
+        values[i].str = text;
+    }
+}
+
+const ExprValue* expr_evaluate_batch(ExprEvaluator *ev, const size_t *rows, size_t count) {
+    if (!ev || !rows || count == 0 || count > EXPR_BATCH_SIZE) return NULL;
+
+    const CompiledExpression *expr = ev->expr;
+    arena_reset(&ev->scratch);
+
+    size_t sp = 0; // Number of occupied stack slots
+    #define SLOT(n) (ev->stack + (size_t)(n) * EXPR_BATCH_SIZE)
+
+    for (size_t pc = 0; pc < expr->code_count; pc++) {
+        const ExprInstruction *in = &expr->code[pc];
+        switch (in->op) {
+            case OP_PUSH_NUMBER: {
+                ExprValue *dst = SLOT(sp++);
+                for (size_t i = 0; i < count; i++) set_number(&dst[i], expr->numbers[in->arg]);
+                break;
+            }
+            case OP_PUSH_STRING: {
+                ExprValue *dst = SLOT(sp++);
+                const ExprString *s = &expr->strings[in->arg];
+                for (size_t i = 0; i < count; i++) {
+                    dst[i] = (ExprValue){ .type = EXPR_VALUE_STRING, .str = s->text, .length = s->length };
+                }
+                break;
+            }
+            case OP_LOAD_COLUMN:
+                load_column(ev, SLOT(sp++), in->arg, rows, count);
+                break;
+            case OP_ADD: case OP_SUB: case OP_MUL: case OP_DIV: case OP_MOD:
+                sp--;
+                arithmetic(in->op, SLOT(sp - 1), SLOT(sp), count);
+                break;
+            case OP_NEG:
+            case OP_ABS: {
+                ExprValue *top = SLOT(sp - 1);
+                for (size_t i = 0; i < count; i++) {
+                    double a;
+                    if (!value_to_number(&top[i], &a)) set_null(&top[i]);
+                    else if (in->op == OP_NEG) set_number(&top[i], -a);
+                    else set_number(&top[i], a < 0 ? -a : a);
+                }
+                break;
+            }
+            case OP_LEN: {
+                ExprValue *top = SLOT(sp - 1);
+                for (size_t i = 0; i < count; i++) {
+                    if (top[i].type == EXPR_VALUE_STRING) set_number(&top[i], (double)top[i].length);
+                    else set_null(&top[i]);
+                }
+                break;
+            }
+            case OP_SUBSTR2:
+                sp -= 1;
+                substring(SLOT(sp - 1), SLOT(sp), NULL, count);
+                break;
+            case OP_SUBSTR3:
+                sp -= 2;
+                substring(SLOT(sp - 1), SLOT(sp), SLOT(sp + 1), count);
+                break;
+            case OP_LOWER:
+            case OP_UPPER:
+                change_case(ev, SLOT(sp - 1), count, in->op == OP_UPPER);
+                break;
+        }
+    }
+
+    #undef SLOT
+    return ev->stack;
+}
+
+size_t expr_format_value(const ExprValue *value, char *buffer, size_t buffer_size) {
+    if (!buffer || buffer_size == 0) return 0;
+
+    switch (value->type) {
+        case EXPR_VALUE_NUMBER: {
+            int written = snprintf(buffer, buffer_size, "%.15g", value->number);
+            if (written < 0) break;
+            return (size_t)written < buffer_size ? (size_t)written : buffer_size - 1;
+        }
+        case EXPR_VALUE_STRING: {
+            size_t length = value->length < buffer_size - 1 ? value->length : buffer_size - 1;
+            memcpy(buffer, value->str, length);
+            buffer[length] = '\0';
+            return length;
+        }
+        default:
+            break;
+    }
+    buffer[0] = '\0';
+    return 0;
+}
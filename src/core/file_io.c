@@ -123,6 +123,8 @@ DSVResult load_file_data(struct DSVViewer *viewer, const char *filename) {
         return DSV_ERROR_FILE_IO;
     }
     viewer->file_data->length = st.st_size;
+    viewer->file_data->modified = st.st_mtime;
+    viewer->file_data->path = strdup(filename);
     if (viewer->file_data->length > 0) {
         viewer->file_data->data = mmap(NULL, viewer->file_data->length, PROT_READ, MAP_PRIVATE, viewer->file_data->fd, 0);
         if (viewer->file_data->data == MAP_FAILED) {
@@ -159,6 +161,8 @@ void cleanup_file_data(struct DSVViewer *viewer) {
     if (viewer->file_data->fd != -1) {
         close(viewer->file_data->fd);
     }
+    free(viewer->file_data->path);
+    viewer->file_data->path = NULL;
 }
 
 DSVResult scan_file_data(struct DSVViewer *viewer, const DSVConfig *config) {
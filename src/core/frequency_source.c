@@ -0,0 +1,207 @@
+#include "core/frequency_source.h"
+#include "memory/in_memory_table.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *FREQUENCY_HEADERS[] = {"Value", "Count"};
+#define FREQUENCY_COLUMNS 2
+
+typedef struct {
+    ValueIndex *index;                             // Referenced, not copied
+    char count_buffer[IN_MEMORY_NUMBER_BUFFER_SIZE]; // Used by get_cell from the UI thread
+} FrequencySourceContext;
+
+static FieldDesc frequency_read_cell(const ValueIndex *index, char *count_buffer, size_t row, size_t col) {
+    if (row >= index->count || !index->sorted) {
+        return (FieldDesc){ .start = NULL, .length = 0, .needs_unescaping = 0 };
+    }
+    const ValueIndexEntry *entry = index->sorted[row];
+    if (col == 0) {
+        return (FieldDesc){ .start = entry->value, .length = entry->length, .needs_unescaping = 0 };
+    }
+    if (col == 1) {
+        int length = snprintf(count_buffer, IN_MEMORY_NUMBER_BUFFER_SIZE, "%zu", entry->rows.count);
+        return (FieldDesc){ .start = count_buffer, .length = (size_t)length, .needs_unescaping = 0 };
+    }
+    return (FieldDesc){ .start = NULL, .length = 0, .needs_unescaping = 0 };
+}
+
+static size_t frequency_get_row_count(void *context) {
+    return ((FrequencySourceContext *)context)->index->count;
+}
+
+static size_t frequency_get_col_count(void *context) {
+    (void)context;
+    return FREQUENCY_COLUMNS;
+}
+
+static FieldDesc frequency_get_cell(void *context, size_t row, size_t col) {
+    FrequencySourceContext *ctx = (FrequencySourceContext *)context;
+    return frequency_read_cell(ctx->index, ctx->count_buffer, row, col);
+}
+
+static FieldDesc frequency_get_header(void *context, size_t col) {
+    (void)context;
+    if (col >= FREQUENCY_COLUMNS) return (FieldDesc){ .start = NULL, .length = 0, .needs_unescaping = 0 };
+    return (FieldDesc){ .start = FREQUENCY_HEADERS[col], .length = strlen(FREQUENCY_HEADERS[col]), .needs_unescaping = 0 };
+}
+
+// Widths are known from the analysis, so this is O(1).
+static int frequency_get_column_width(void *context, size_t col) {
+    FrequencySourceContext *ctx = (FrequencySourceContext *)context;
+    if (col >= FREQUENCY_COLUMNS) return 0;
+    size_t data_width = ctx->index->value_width;
+    if (col == 1) {
+        char digits[IN_MEMORY_NUMBER_BUFFER_SIZE];
+        data_width = (size_t)snprintf(digits, sizeof(digits), "%zu", ctx->index->max_count);
+    }
+    size_t header_width = strlen(FREQUENCY_HEADERS[col]);
+    return (int)(header_width > data_width ? header_width : data_width);
+}
+
+static void frequency_destroy(void *context) {
+    if (!context) return;
+    FrequencySourceContext *ctx = (FrequencySourceContext *)context;
+    free_value_index(ctx->index);
+    free(ctx);
+}
+
+// Values are read straight from the index; a cursor only needs its own slot
+// for formatting counts.
+static void* frequency_create_cursor(void *context) {
+    (void)context;
+    return malloc(IN_MEMORY_NUMBER_BUFFER_SIZE);
+}
+
+static FieldDesc frequency_cursor_get_cell(void *context, void *cursor, size_t row, size_t col) {
+    return frequency_read_cell(((FrequencySourceContext *)context)->index, (char *)cursor, row, col);
+}
+
+static void frequency_destroy_cursor(void *context, void *cursor) {
+    (void)context;
+    free(cursor);
+}
+
+static const DataSourceOps frequency_ops = {
+    .get_row_count = frequency_get_row_count,
+    .get_col_count = frequency_get_col_count,
+    .get_cell = frequency_get_cell,
+    .get_header = frequency_get_header,
+    .get_column_width = frequency_get_column_width,
+    .destroy = frequency_destroy,
+    .create_cursor = frequency_create_cursor,
+    .cursor_get_cell = frequency_cursor_get_cell,
+    .destroy_cursor = frequency_destroy_cursor,
+};
+
+DataSource* create_frequency_data_source(ValueIndex *index) {
+    if (!index || !index->sorted) return NULL;
+
+    FrequencySourceContext *ctx = calloc(1, sizeof(FrequencySourceContext));
+    DataSource *ds = malloc(sizeof(DataSource));
+    if (!ctx || !ds) {
+        free(ctx);
+        free(ds);
+        return NULL;
+    }
+    ctx->index = value_index_retain(index);
+
+    ds->context = ctx;
+    ds->ops = &frequency_ops;
+    ds->type = DATA_SOURCE_MEMORY;
+    return ds;
+}
+
+// --- Approximate Frequency Source ---
+
+static const char *APPROX_HEADERS[] = {"Value", "Count", "Error"};
+#define APPROX_COLUMNS 3
+
+typedef struct {
+    const ApproxFrequency *approx;                   // Borrowed from the view
+    char number_buffer[IN_MEMORY_NUMBER_BUFFER_SIZE]; // Used by get_cell from the UI thread
+} ApproxSourceContext;
+
+static FieldDesc approx_read_cell(const ApproxFrequency *approx, char *number_buffer, size_t row, size_t col) {
+    if (row >= approx->item_count || col >= APPROX_COLUMNS) {
+        return (FieldDesc){ .start = NULL, .length = 0, .needs_unescaping = 0 };
+    }
+    const ApproxFrequencyItem *item = &approx->items[row];
+    if (col == 0) {
+        return (FieldDesc){ .start = item->value, .length = item->length, .needs_unescaping = 0 };
+    }
+    int length = snprintf(number_buffer, IN_MEMORY_NUMBER_BUFFER_SIZE, "%zu", col == 1 ? item->count : item->error);
+    return (FieldDesc){ .start = number_buffer, .length = (size_t)length, .needs_unescaping = 0 };
+}
+
+static size_t approx_get_row_count(void *context) {
+    return ((ApproxSourceContext *)context)->approx->item_count;
+}
+
+static size_t approx_get_col_count(void *context) {
+    (void)context;
+    return APPROX_COLUMNS;
+}
+
+static FieldDesc approx_get_cell(void *context, size_t row, size_t col) {
+    ApproxSourceContext *ctx = (ApproxSourceContext *)context;
+    return approx_read_cell(ctx->approx, ctx->number_buffer, row, col);
+}
+
+static FieldDesc approx_get_header(void *context, size_t col) {
+    (void)context;
+    if (col >= APPROX_COLUMNS) return (FieldDesc){ .start = NULL, .length = 0, .needs_unescaping = 0 };
+    return (FieldDesc){ .start = APPROX_HEADERS[col], .length = strlen(APPROX_HEADERS[col]), .needs_unescaping = 0 };
+}
+
+static int approx_get_column_width(void *context, size_t col) {
+    ApproxSourceContext *ctx = (ApproxSourceContext *)context;
+    if (col >= APPROX_COLUMNS) return 0;
+    // Errors never exceed counts, so the largest count bounds both.
+    size_t data_width = ctx->approx->value_width;
+    if (col > 0) {
+        char digits[IN_MEMORY_NUMBER_BUFFER_SIZE];
+        data_width = (size_t)snprintf(digits, sizeof(digits), "%zu", ctx->approx->max_count);
+    }
+    size_t header_width = strlen(APPROX_HEADERS[col]);
+    return (int)(header_width > data_width ? header_width : data_width);
+}
+
+static void approx_destroy(void *context) {
+    free(context);
+}
+
+static FieldDesc approx_cursor_get_cell(void *context, void *cursor, size_t row, size_t col) {
+    return approx_read_cell(((ApproxSourceContext *)context)->approx, (char *)cursor, row, col);
+}
+
+static const DataSourceOps approx_ops = {
+    .get_row_count = approx_get_row_count,
+    .get_col_count = approx_get_col_count,
+    .get_cell = approx_get_cell,
+    .get_header = approx_get_header,
+    .get_column_width = approx_get_column_width,
+    .destroy = approx_destroy,
+    .create_cursor = frequency_create_cursor,
+    .cursor_get_cell = approx_cursor_get_cell,
+    .destroy_cursor = frequency_destroy_cursor,
+};
+
+DataSource* create_approximate_frequency_data_source(const ApproxFrequency *approx) {
+    if (!approx) return NULL;
+
+    ApproxSourceContext *ctx = calloc(1, sizeof(ApproxSourceContext));
+    DataSource *ds = malloc(sizeof(DataSource));
+    if (!ctx || !ds) {
+        free(ctx);
+        free(ds);
+        return NULL;
+    }
+    ctx->approx = approx;
+
+    ds->context = ctx;
+    ds->ops = &approx_ops;
+    ds->type = DATA_SOURCE_MEMORY;
+    return ds;
+}
@@ -0,0 +1,629 @@
+#include "core/join.h"
+#include "core/parser.h"
+#include "ui/view_manager.h"
+#include "app_init.h"
+#include "memory/arena.h"
+#include "util/parallel.h"
+#include "util/utils.h"
+#include "util/logging.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <strings.h>
+
+#define MIN_ROWS_PER_JOIN_CHUNK 4096
+#define MAX_JOIN_PARTITIONS 256
+#define JOIN_KEY_BUFFER_SIZE 4096
+
+// --- Joined Data Source ---
+
+typedef struct {
+    size_t left;
+    size_t right;
+} JoinRowPair;
+
+typedef struct {
+    DataSource *left;
+    DataSource *right;
+    size_t left_cols;
+    size_t right_cols;
+    JoinRowPair *pairs;
+    size_t pair_count;
+
+    // Set when the join opened the right-hand file itself
+    struct DSVViewer *right_viewer;
+} JoinSourceContext;
+
+typedef struct {
+    DataSourceCursor *left;
+    DataSourceCursor *right;
+} JoinCursor;
+
+static size_t join_get_row_count(void *context);
+static size_t join_get_col_count(void *context);
+static FieldDesc join_get_cell(void *context, size_t row, size_t col);
+static FieldDesc join_get_header(void *context, size_t col);
+static int join_get_column_width(void *context, size_t col);
+static void join_destroy(void *context);
+static void* join_create_cursor(void *context);
+static FieldDesc join_cursor_get_cell(void *context, void *cursor, size_t row, size_t col);
+static void join_destroy_cursor(void *context, void *cursor);
+static void join_prepare_column(void *context, size_t col);
+
+static const DataSourceOps join_ops = {
+    .get_row_count = join_get_row_count,
+    .get_col_count = join_get_col_count,
+    .get_cell = join_get_cell,
+    .get_header = join_get_header,
+    .get_column_width = join_get_column_width,
+    .destroy = join_destroy,
+    .create_cursor = join_create_cursor,
+    .cursor_get_cell = join_cursor_get_cell,
+    .destroy_cursor = join_destroy_cursor,
+    .prepare_column = join_prepare_column,
+};
+
+// Used when either input cannot be read concurrently.
+static const DataSourceOps join_ops_no_cursors = {
+    .get_row_count = join_get_row_count,
+    .get_col_count = join_get_col_count,
+    .get_cell = join_get_cell,
+    .get_header = join_get_header,
+    .get_column_width = join_get_column_width,
+    .destroy = join_destroy,
+    .prepare_column = join_prepare_column,
+};
+
+static FieldDesc empty_field(void) {
+    return (FieldDesc){ .start = NULL, .length = 0, .needs_unescaping = 0 };
+}
+
+static size_t join_get_row_count(void *context) {
+    return ((JoinSourceContext *)context)->pair_count;
+}
+
+static size_t join_get_col_count(void *context) {
+    JoinSourceContext *ctx = (JoinSourceContext *)context;
+    return ctx->left_cols + ctx->right_cols;
+}
+
+static FieldDesc join_get_cell(void *context, size_t row, size_t col) {
+    JoinSourceContext *ctx = (JoinSourceContext *)context;
+    if (row >= ctx->pair_count) return empty_field();
+    if (col < ctx->left_cols) {
+        return ctx->left->ops->get_cell(ctx->left->context, ctx->pairs[row].left, col);
+    }
+    if (col < ctx->left_cols + ctx->right_cols) {
+        return ctx->right->ops->get_cell(ctx->right->context, ctx->pairs[row].right, col - ctx->left_cols);
+    }
+    return empty_field();
+}
+
+static FieldDesc join_get_header(void *context, size_t col) {
+    JoinSourceContext *ctx = (JoinSourceContext *)context;
+    if (col < ctx->left_cols) {
+        return ctx->left->ops->get_header(ctx->left->context, col);
+    }
+    if (col < ctx->left_cols + ctx->right_cols) {
+        return ctx->right->ops->get_header(ctx->right->context, col - ctx->left_cols);
+    }
+    return empty_field();
+}
+
+static int join_get_column_width(void *context, size_t col) {
+    JoinSourceContext *ctx = (JoinSourceContext *)context;
+    if (col < ctx->left_cols) {
+        return ctx->left->ops->get_column_width(ctx->left->context, col);
+    }
+    return ctx->right->ops->get_column_width(ctx->right->context, col - ctx->left_cols);
+}
+
+static void join_destroy(void *context) {
+    if (!context) return;
+    JoinSourceContext *ctx = (JoinSourceContext *)context;
+    free(ctx->pairs);
+    if (ctx->right_viewer) {
+        // The right side is the other file's own data source.
+        destroy_data_source(ctx->right);
+        cleanup_viewer(ctx->right_viewer);
+        free(ctx->right_viewer);
+    }
+    free(ctx);
+}
+
+static void* join_create_cursor(void *context) {
+    JoinSourceContext *ctx = (JoinSourceContext *)context;
+    JoinCursor *cursor = malloc(sizeof(JoinCursor));
+    if (!cursor) return NULL;
+    cursor->left = data_source_open_cursor(ctx->left);
+    cursor->right = data_source_open_cursor(ctx->right);
+    if (!cursor->left || !cursor->right) {
+        data_source_close_cursor(cursor->left);
+        data_source_close_cursor(cursor->right);
+        free(cursor);
+        return NULL;
+    }
+    return cursor;
+}
+
+static FieldDesc join_cursor_get_cell(void *context, void *cursor, size_t row, size_t col) {
+    JoinSourceContext *ctx = (JoinSourceContext *)context;
+    JoinCursor *jc = (JoinCursor *)cursor;
+    if (row >= ctx->pair_count) return empty_field();
+    if (col < ctx->left_cols) {
+        return data_source_cursor_get_cell(jc->left, ctx->pairs[row].left, col);
+    }
+    if (col < ctx->left_cols + ctx->right_cols) {
+        return data_source_cursor_get_cell(jc->right, ctx->pairs[row].right, col - ctx->left_cols);
+    }
+    return empty_field();
+}
+
+static void join_destroy_cursor(void *context, void *cursor) {
+    (void)context;
+    JoinCursor *jc = (JoinCursor *)cursor;
+    data_source_close_cursor(jc->left);
+    data_source_close_cursor(jc->right);
+    free(jc);
+}
+
+static void join_prepare_column(void *context, size_t col) {
+    JoinSourceContext *ctx = (JoinSourceContext *)context;
+    if (col < ctx->left_cols) {
+        data_source_prepare_column(ctx->left, col);
+    } else {
+        data_source_prepare_column(ctx->right, col - ctx->left_cols);
+    }
+}
+
+// --- Hash Join ---
+
+// One key of the build side. Entries and key copies live in arenas.
+typedef struct JoinEntry {
+    const char *key;
+    size_t key_length;
+    size_t row;
+    uint32_t hash;
+    struct JoinEntry *next;
+} JoinEntry;
+
+typedef struct {
+    JoinEntry **buckets;
+    size_t mask;
+    Arena arena;
+} JoinPartition;
+
+// One side of the join: its source and the rows that take part.
+typedef struct {
+    DataSource *source;
+    size_t key_col;
+    size_t *rows;        // NULL means rows [0, count)
+    size_t count;
+} JoinSide;
+
+typedef struct {
+    JoinSide build;
+    JoinSide probe;
+    bool build_is_left;
+    size_t chunk_count;
+    size_t partition_bits;
+    size_t partition_count;
+
+    // Build-side scratch, indexed by position in the build side
+    uint32_t *hashes;
+    const char **keys;
+    size_t *key_lengths;
+    Arena *chunk_arenas;            // Key copies, one arena per chunk
+    size_t *partition_counts;       // [chunk][partition] during scatter
+    size_t *partition_starts;       // partition_count + 1 entries
+    size_t *partition_items;        // Build positions grouped by partition
+    JoinPartition *partitions;
+
+    // Probe output, one growable array per chunk
+    JoinRowPair **chunk_pairs;
+    size_t *chunk_pair_counts;
+
+    int failed;
+} HashJoinJob;
+
+static size_t side_row(const JoinSide *side, size_t position) {
+    return side->rows ? side->rows[position] : position;
+}
+
+static size_t partition_of(const HashJoinJob *job, uint32_t hash) {
+    return hash & (job->partition_count - 1);
+}
+
+static void mark_failed(HashJoinJob *job) {
+    __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+}
+
+// Reads and hashes a key. Returns false for empty keys.
+static bool read_key(DataSourceCursor *cursor, const JoinSide *side, size_t position,
+                     char *buffer, size_t *length, uint32_t *hash) {
+    FieldDesc fd = data_source_cursor_get_cell(cursor, side_row(side, position), side->key_col);
+    if (!fd.start || fd.length == 0) return false;
+    render_field(&fd, buffer, JOIN_KEY_BUFFER_SIZE);
+    *length = strlen(buffer);
+    if (*length == 0) return false;
+    *hash = fnv1a_hash(buffer);
+    return true;
+}
+
+// Pass 1: hash every build key, copy it into the chunk's arena and count
+// how many keys of this chunk fall into each partition.
+static void hash_build_chunk(void *arg, size_t chunk) {
+    HashJoinJob *job = (HashJoinJob *)arg;
+    size_t begin, end;
+    parallel_chunk_bounds(job->build.count, job->chunk_count, chunk, &begin, &end);
+
+    size_t *counts = job->partition_counts + chunk * job->partition_count;
+    DataSourceCursor *cursor = data_source_open_cursor(job->build.source);
+    if (!cursor) {
+        mark_failed(job);
+        return;
+    }
+
+    char key[JOIN_KEY_BUFFER_SIZE];
+    for (size_t i = begin; i < end; i++) {
+        size_t length;
+        uint32_t hash;
+        job->keys[i] = NULL;
+        if (!read_key(cursor, &job->build, i, key, &length, &hash)) continue;
+
+        job->keys[i] = arena_strndup(&job->chunk_arenas[chunk], key, length);
+        if (!job->keys[i]) {
+            mark_failed(job);
+            break;
+        }
+        job->key_lengths[i] = length;
+        job->hashes[i] = hash;
+        counts[partition_of(job, hash)]++;
+    }
+    data_source_close_cursor(cursor);
+}
+
+// Pass 2: scatter build positions into their partitions. Each chunk writes
+// into its own precomputed slice, so no synchronization is needed.
+static void scatter_build_chunk(void *arg, size_t chunk) {
+    HashJoinJob *job = (HashJoinJob *)arg;
+    size_t begin, end;
+    parallel_chunk_bounds(job->build.count, job->chunk_count, chunk, &begin, &end);
+
+    size_t *next_slot = job->partition_counts + chunk * job->partition_count;
+    for (size_t i = begin; i < end; i++) {
+        if (!job->keys[i]) continue;
+        job->partition_items[next_slot[partition_of(job, job->hashes[i])]++] = i;
+    }
+}
+
+// Pass 3: build one partition's chained hash table.
+static void build_partition(void *arg, size_t partition) {
+    HashJoinJob *job = (HashJoinJob *)arg;
+    JoinPartition *part = &job->partitions[partition];
+    size_t begin = job->partition_starts[partition];
+    size_t end = job->partition_starts[partition + 1];
+    if (begin == end) return;
+
+    size_t bucket_count = 16;
+    while (bucket_count < (end - begin) * 2) bucket_count *= 2;
+
+    arena_init(&part->arena, 0);
+    part->buckets = arena_alloc(&part->arena, bucket_count * sizeof(JoinEntry *));
+    if (!part->buckets) {
+        mark_failed(job);
+        return;
+    }
+    memset(part->buckets, 0, bucket_count * sizeof(JoinEntry *));
+    part->mask = bucket_count - 1;
+
+    // Insert back to front so every chain lists matches in build order.
+    for (size_t i = end; i-- > begin; ) {
+        size_t position = job->partition_items[i];
+        JoinEntry *entry = arena_alloc(&part->arena, sizeof(JoinEntry));
+        if (!entry) {
+            mark_failed(job);
+            return;
+        }
+        entry->key = job->keys[position];
+        entry->key_length = job->key_lengths[position];
+        entry->row = side_row(&job->build, position);
+        entry->hash = job->hashes[position];
+
+        size_t bucket = (entry->hash >> job->partition_bits) & part->mask;
+        entry->next = part->buckets[bucket];
+        part->buckets[bucket] = entry;
+    }
+}
+
+static bool append_pair(JoinRowPair **pairs, size_t *count, size_t *capacity, JoinRowPair pair) {
+    if (*count == *capacity) {
+        size_t new_capacity = *capacity > 0 ? *capacity * 2 : 1024;
+        JoinRowPair *grown = realloc(*pairs, new_capacity * sizeof(JoinRowPair));
+        if (!grown) return false;
+        *pairs = grown;
+        *capacity = new_capacity;
+    }
+    (*pairs)[(*count)++] = pair;
+    return true;
+}
+
+// Probe: stream a chunk of the probe side through the hash table.
+static void probe_chunk(void *arg, size_t chunk) {
+    HashJoinJob *job = (HashJoinJob *)arg;
+    size_t begin, end;
+    parallel_chunk_bounds(job->probe.count, job->chunk_count, chunk, &begin, &end);
+
+    DataSourceCursor *cursor = data_source_open_cursor(job->probe.source);
+    if (!cursor) {
+        mark_failed(job);
+        return;
+    }
+
+    JoinRowPair *pairs = NULL;
+    size_t count = 0, capacity = 0;
+    char key[JOIN_KEY_BUFFER_SIZE];
+
+    for (size_t i = begin; i < end; i++) {
+        size_t length;
+        uint32_t hash;
+        if (!read_key(cursor, &job->probe, i, key, &length, &hash)) continue;
+
+        const JoinPartition *part = &job->partitions[partition_of(job, hash)];
+        if (!part->buckets) continue;
+
+        size_t probe_row = side_row(&job->probe, i);
+        for (const JoinEntry *entry = part->buckets[(hash >> job->partition_bits) & part->mask]; entry; entry = entry->next) {
+            if (entry->hash != hash || entry->key_length != length || memcmp(entry->key, key, length) != 0) {
+                continue;
+            }
+            JoinRowPair pair = job->build_is_left
+                ? (JoinRowPair){ .left = entry->row, .right = probe_row }
+                : (JoinRowPair){ .left = probe_row, .right = entry->row };
+            if (!append_pair(&pairs, &count, &capacity, pair)) {
+                mark_failed(job);
+                goto done;
+            }
+        }
+    }
+
+done:
+    job->chunk_pairs[chunk] = pairs;
+    job->chunk_pair_counts[chunk] = count;
+    data_source_close_cursor(cursor);
+}
+
+static void free_join_job(HashJoinJob *job) {
+    if (job->chunk_arenas) {
+        for (size_t i = 0; i < job->chunk_count; i++) arena_free(&job->chunk_arenas[i]);
+    }
+    if (job->partitions) {
+        for (size_t i = 0; i < job->partition_count; i++) arena_free(&job->partitions[i].arena);
+    }
+    if (job->chunk_pairs) {
+        for (size_t i = 0; i < job->chunk_count; i++) free(job->chunk_pairs[i]);
+    }
+    free(job->chunk_arenas);
+    free(job->partitions);
+    free(job->chunk_pairs);
+    free(job->chunk_pair_counts);
+    free(job->hashes);
+    free(job->keys);
+    free(job->key_lengths);
+    free(job->partition_counts);
+    free(job->partition_starts);
+    free(job->partition_items);
+}
+
+// Collects the visible rows of a view, or NULL to use every row.
+static DSVResult collect_side_rows(const View *view, JoinSide *side) {
+    side->rows = NULL;
+    side->count = side->source->ops->get_row_count(side->source->context);
+    if (!view) return DSV_OK;
+
+    side->count = view->visible_row_count;
+    if (view->num_ranges == 0) return DSV_OK; // Every row, in order
+
+    side->rows = malloc((side->count > 0 ? side->count : 1) * sizeof(size_t));
+    if (!side->rows) return DSV_ERROR_MEMORY;
+
+    ViewRowIterator it;
+    view_row_iterator_init(&it, view, 0, side->count);
+    size_t row, n = 0;
+    while ((row = view_row_iterator_next(&it)) != SIZE_MAX) side->rows[n++] = row;
+    return DSV_OK;
+}
+
+static size_t choose_partition_bits(size_t build_count) {
+    if (build_count < MIN_ROWS_PER_JOIN_CHUNK) return 0;
+    size_t bits = 0;
+    while ((1u << bits) < parallel_worker_count() * 2 && (1u << bits) < MAX_JOIN_PARTITIONS) bits++;
+    return bits;
+}
+
+DSVResult hash_join_data_sources(DataSource *left, const View *left_view, size_t left_key,
+                                 DataSource *right, size_t right_key, DataSource **out) {
+    if (!left || !right || !out) return DSV_ERROR_INVALID_ARGS;
+    if (left_key >= left->ops->get_col_count(left->context) ||
+        right_key >= right->ops->get_col_count(right->context)) {
+        return DSV_ERROR_INVALID_ARGS;
+    }
+
+    // Keys are read in full by the workers below.
+    data_source_prepare_column(left, left_key);
+    data_source_prepare_column(right, right_key);
+
+    JoinSide left_side = { .source = left, .key_col = left_key };
+    JoinSide right_side = { .source = right, .key_col = right_key };
+    if (collect_side_rows(left_view, &left_side) != DSV_OK ||
+        collect_side_rows(NULL, &right_side) != DSV_OK) {
+        return DSV_ERROR_MEMORY;
+    }
+
+    HashJoinJob job;
+    memset(&job, 0, sizeof(job));
+    job.build_is_left = left_side.count <= right_side.count;
+    job.build = job.build_is_left ? left_side : right_side;
+    job.probe = job.build_is_left ? right_side : left_side;
+
+    bool parallel = data_source_supports_cursors(left) && data_source_supports_cursors(right);
+    size_t larger = job.build.count > job.probe.count ? job.build.count : job.probe.count;
+    job.chunk_count = parallel ? parallel_chunk_count(larger, MIN_ROWS_PER_JOIN_CHUNK) : 1;
+    if (job.chunk_count == 0) job.chunk_count = 1;
+    job.partition_bits = parallel ? choose_partition_bits(job.build.count) : 0;
+    job.partition_count = (size_t)1 << job.partition_bits;
+
+    size_t build_slots = job.build.count > 0 ? job.build.count : 1;
+    job.hashes = malloc(build_slots * sizeof(uint32_t));
+    job.keys = malloc(build_slots * sizeof(char *));
+    job.key_lengths = malloc(build_slots * sizeof(size_t));
+    job.partition_items = malloc(build_slots * sizeof(size_t));
+    job.chunk_arenas = malloc(job.chunk_count * sizeof(Arena));
+    job.partition_counts = calloc(job.chunk_count * job.partition_count, sizeof(size_t));
+    job.partition_starts = calloc(job.partition_count + 1, sizeof(size_t));
+    job.partitions = calloc(job.partition_count, sizeof(JoinPartition));
+    job.chunk_pairs = calloc(job.chunk_count, sizeof(JoinRowPair *));
+    job.chunk_pair_counts = calloc(job.chunk_count, sizeof(size_t));
+    JoinSourceContext *ctx = calloc(1, sizeof(JoinSourceContext));
+    DataSource *ds = malloc(sizeof(DataSource));
+
+    DSVResult result = DSV_ERROR_MEMORY;
+    if (!job.hashes || !job.keys || !job.key_lengths || !job.partition_items || !job.chunk_arenas ||
+        !job.partition_counts || !job.partition_starts || !job.partitions || !job.chunk_pairs ||
+        !job.chunk_pair_counts || !ctx || !ds) {
+        if (job.chunk_arenas) {
+            for (size_t i = 0; i < job.chunk_count; i++) arena_init(&job.chunk_arenas[i], 0);
+        }
+        goto cleanup;
+    }
+    for (size_t i = 0; i < job.chunk_count; i++) arena_init(&job.chunk_arenas[i], 0);
+
+    // --- Build ---
+    parallel_for(job.chunk_count, hash_build_chunk, &job);
+    if (job.failed) goto cleanup;
+
+    // Turn per-chunk counts into write offsets, partition-major.
+    size_t running = 0;
+    for (size_t p = 0; p < job.partition_count; p++) {
+        job.partition_starts[p] = running;
+        for (size_t c = 0; c < job.chunk_count; c++) {
+            size_t count = job.partition_counts[c * job.partition_count + p];
+            job.partition_counts[c * job.partition_count + p] = running;
+            running += count;
+        }
+    }
+    job.partition_starts[job.partition_count] = running;
+
+    parallel_for(job.chunk_count, scatter_build_chunk, &job);
+    parallel_for(job.partition_count, build_partition, &job);
+    if (job.failed) goto cleanup;
+
+    // --- Probe ---
+    parallel_for(job.chunk_count, probe_chunk, &job);
+    if (job.failed) goto cleanup;
+
+    size_t total = 0;
+    for (size_t c = 0; c < job.chunk_count; c++) total += job.chunk_pair_counts[c];
+    ctx->pairs = malloc((total > 0 ? total : 1) * sizeof(JoinRowPair));
+    if (!ctx->pairs) goto cleanup;
+    for (size_t c = 0; c < job.chunk_count; c++) {
+        if (job.chunk_pair_counts[c] == 0) continue;
+        memcpy(ctx->pairs + ctx->pair_count, job.chunk_pairs[c], job.chunk_pair_counts[c] * sizeof(JoinRowPair));
+        ctx->pair_count += job.chunk_pair_counts[c];
+    }
+
+    ctx->left = left;
+    ctx->right = right;
+    ctx->left_cols = left->ops->get_col_count(left->context);
+    ctx->right_cols = right->ops->get_col_count(right->context);
+    ds->context = ctx;
+    ds->ops = parallel ? &join_ops : &join_ops_no_cursors;
+    ds->type = DATA_SOURCE_COMPUTED;
+
+    LOG_INFO("Hash join: built on %zu %s rows, probed %zu rows, %zu matches",
+             job.build.count, job.build_is_left ? "left" : "right", job.probe.count, total);
+    *out = ds;
+    ctx = NULL;
+    ds = NULL;
+    result = DSV_OK;
+
+cleanup:
+    if (ctx) free(ctx->pairs);
+    free(ctx);
+    free(ds);
+    free_join_job(&job);
+    free(left_side.rows);
+    free(right_side.rows);
+    return result;
+}
+
+// --- Joining With Another File ---
+
+static bool find_column_by_name(DataSource *ds, const char *name, size_t *out_col) {
+    size_t col_count = ds->ops->get_col_count(ds->context);
+    char header[256];
+    for (size_t col = 0; col < col_count; col++) {
+        FieldDesc fd = ds->ops->get_header(ds->context, col);
+        if (!fd.start) continue;
+        render_field(&fd, header, sizeof(header));
+        if (strcasecmp(header, name) == 0) {
+            *out_col = col;
+            return true;
+        }
+    }
+    return false;
+}
+
+DSVResult join_view_with_file(struct DSVViewer *viewer, const View *view, size_t left_key,
+                              const char *filename, const char *right_key_name,
+                              DataSource **out, char *error, size_t error_size) {
+    if (error && error_size > 0) error[0] = '\0';
+    if (!viewer || !view || !view->data_source || !filename || !out) return DSV_ERROR_INVALID_ARGS;
+
+    DataSource *left = view->data_source;
+    char key_name[256];
+    if (!right_key_name || *right_key_name == '\0') {
+        FieldDesc fd = left->ops->get_header(left->context, left_key);
+        if (!fd.start) {
+            if (error) snprintf(error, error_size, "Current column has no header; name the key column");
+            return DSV_ERROR_INVALID_ARGS;
+        }
+        render_field(&fd, key_name, sizeof(key_name));
+        right_key_name = key_name;
+    }
+
+    DSVViewer *right_viewer = calloc(1, sizeof(DSVViewer));
+    if (!right_viewer) return DSV_ERROR_MEMORY;
+
+    DSVResult result = init_viewer(right_viewer, filename, 0, viewer->config);
+    DataSource *right = result == DSV_OK ? create_file_data_source(right_viewer) : NULL;
+    if (!right) {
+        if (error) snprintf(error, error_size, "Cannot open %s: %s", filename,
+                            dsv_result_to_string(result != DSV_OK ? result : DSV_ERROR_MEMORY));
+        cleanup_viewer(right_viewer);
+        free(right_viewer);
+        return result != DSV_OK ? result : DSV_ERROR_MEMORY;
+    }
+
+    size_t right_key;
+    if (!find_column_by_name(right, right_key_name, &right_key)) {
+        if (error) snprintf(error, error_size, "No column '%s' in %s", right_key_name, filename);
+        result = DSV_ERROR_INVALID_ARGS;
+    } else {
+        result = hash_join_data_sources(left, view, left_key, right, right_key, out);
+        if (result != DSV_OK && error) {
+            snprintf(error, error_size, "Join failed: %s", dsv_result_to_string(result));
+        }
+    }
+
+    if (result != DSV_OK) {
+        destroy_data_source(right);
+        cleanup_viewer(right_viewer);
+        free(right_viewer);
+        return result;
+    }
+
+    // The joined source keeps the other file open for as long as it lives.
+    ((JoinSourceContext *)(*out)->context)->right_viewer = right_viewer;
+    return DSV_OK;
+}
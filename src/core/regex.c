@@ -0,0 +1,778 @@
+#include "core/regex.h"
+#include "memory/arena.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdint.h>
+
+// Limits that keep hostile patterns from exhausting memory
+#define MAX_REGEX_DEPTH 256
+#define MAX_REGEX_REPEAT 1000
+#define MAX_NFA_STATES 20000
+
+// DFA states a matcher keeps before it starts over
+#define MAX_DFA_STATES 1024
+
+// Longest required literal that is tracked
+#define REGEX_LITERAL_MAX 64
+
+// --- Syntax Tree ---
+
+typedef enum {
+    RE_CLASS,     // One byte out of 'set'
+    RE_CONCAT,
+    RE_ALTERNATE,
+    RE_REPEAT,    // left{min,max}
+    RE_BOL,
+    RE_EOL,
+    RE_EMPTY
+} RegexNodeType;
+
+typedef struct RegexNode {
+    RegexNodeType type;
+    uint32_t set[8];
+    struct RegexNode *left, *right;
+    int min, max;  // max < 0 means unbounded
+} RegexNode;
+
+typedef struct {
+    const char *p;
+    Arena *arena;
+    int depth;
+    const char *error;
+} RegexParser;
+
+static RegexNode* new_node(RegexParser *parser, RegexNodeType type) {
+    RegexNode *node = arena_alloc(parser->arena, sizeof(RegexNode));
+    if (!node) {
+        parser->error = "out of memory";
+        return NULL;
+    }
+    memset(node, 0, sizeof(*node));
+    node->type = type;
+    return node;
+}
+
+static void set_add(uint32_t *set, unsigned char byte) {
+    set[byte >> 5] |= (uint32_t)1 << (byte & 31);
+}
+
+static bool set_has(const uint32_t *set, unsigned char byte) {
+    return (set[byte >> 5] >> (byte & 31)) & 1;
+}
+
+static void set_add_range(uint32_t *set, unsigned char low, unsigned char high) {
+    for (unsigned c = low; c <= high; c++) set_add(set, (unsigned char)c);
+}
+
+// Adds the bytes of a \d, \w or \s shorthand. Returns false for other letters.
+static bool set_add_shorthand(uint32_t *set, char letter) {
+    uint32_t shorthand[8] = {0};
+    switch (letter | 0x20) {
+        case 'd': set_add_range(shorthand, '0', '9'); break;
+        case 'w':
+            set_add_range(shorthand, '0', '9');
+            set_add_range(shorthand, 'a', 'z');
+            set_add_range(shorthand, 'A', 'Z');
+            set_add(shorthand, '_');
+            break;
+        case 's':
+            set_add(shorthand, ' ');
+            set_add_range(shorthand, '\t', '\r');
+            break;
+        default:
+            return false;
+    }
+    bool negated = letter >= 'A' && letter <= 'Z';
+    for (int i = 0; i < 8; i++) set[i] |= negated ? ~shorthand[i] : shorthand[i];
+    return true;
+}
+
+static unsigned char escaped_byte(char c) {
+    switch (c) {
+        case 't': return '\t';
+        case 'n': return '\n';
+        case 'r': return '\r';
+        default:  return (unsigned char)c;
+    }
+}
+
+static RegexNode* parse_alternation(RegexParser *parser);
+
+static RegexNode* parse_class(RegexParser *parser) {
+    RegexNode *node = new_node(parser, RE_CLASS);
+    if (!node) return NULL;
+    bool negated = *parser->p == '^';
+    if (negated) parser->p++;
+
+    // A ']' right after the opening bracket is a literal.
+    bool first = true;
+    while (*parser->p && (*parser->p != ']' || first)) {
+        first = false;
+        unsigned char low;
+        if (*parser->p == '\\' && parser->p[1]) {
+            if (set_add_shorthand(node->set, parser->p[1])) {
+                parser->p += 2;
+                continue;
+            }
+            low = escaped_byte(parser->p[1]);
+            parser->p += 2;
+        } else {
+            low = (unsigned char)*parser->p++;
+        }
+
+        if (*parser->p == '-' && parser->p[1] && parser->p[1] != ']') {
+            parser->p++;
+            unsigned char high;
+            if (*parser->p == '\\' && parser->p[1]) {
+                high = escaped_byte(parser->p[1]);
+                parser->p += 2;
+            } else {
+                high = (unsigned char)*parser->p++;
+            }
+            if (high < low) {
+                parser->error = "invalid range in character class";
+                return NULL;
+            }
+            set_add_range(node->set, low, high);
+        } else {
+            set_add(node->set, low);
+        }
+    }
+    if (*parser->p != ']') {
+        parser->error = "missing ]";
+        return NULL;
+    }
+    parser->p++;
+    if (negated) {
+        for (int i = 0; i < 8; i++) node->set[i] = ~node->set[i];
+    }
+    return node;
+}
+
+static RegexNode* parse_atom(RegexParser *parser) {
+    char c = *parser->p;
+    RegexNode *node;
+    switch (c) {
+        case '(':
+            parser->p++;
+            if (++parser->depth > MAX_REGEX_DEPTH) {
+                parser->error = "pattern nested too deeply";
+                return NULL;
+            }
+            node = parse_alternation(parser);
+            parser->depth--;
+            if (!node) return NULL;
+            if (*parser->p != ')') {
+                parser->error = "missing )";
+                return NULL;
+            }
+            parser->p++;
+            return node;
+        case '[':
+            parser->p++;
+            return parse_class(parser);
+        case '.':
+            parser->p++;
+            node = new_node(parser, RE_CLASS);
+            if (node) memset(node->set, 0xff, sizeof(node->set));
+            return node;
+        case '^':
+            parser->p++;
+            return new_node(parser, RE_BOL);
+        case '$':
+            parser->p++;
+            return new_node(parser, RE_EOL);
+        case '*':
+        case '+':
+        case '?':
+            parser->error = "nothing to repeat";
+            return NULL;
+        case '\\':
+            if (!parser->p[1]) {
+                parser->error = "trailing backslash";
+                return NULL;
+            }
+            node = new_node(parser, RE_CLASS);
+            if (node && !set_add_shorthand(node->set, parser->p[1])) {
+                set_add(node->set, escaped_byte(parser->p[1]));
+            }
+            parser->p += 2;
+            return node;
+        default:
+            parser->p++;
+            node = new_node(parser, RE_CLASS);
+            if (node) set_add(node->set, (unsigned char)c);
+            return node;
+    }
+}
+
+// Parses "{n}", "{n,}" or "{n,m}". Returns false, consuming nothing, if the
+// brace does not start a valid bound; it is then a literal.
+static bool parse_bounds(RegexParser *parser, int *min, int *max) {
+    const char *p = parser->p + 1;
+    char *end;
+    if (*p < '0' || *p > '9') return false;
+    long low = strtol(p, &end, 10), high = low;
+    p = end;
+    if (*p == ',') {
+        p++;
+        if (*p == '}') {
+            high = -1;
+        } else {
+            if (*p < '0' || *p > '9') return false;
+            high = strtol(p, &end, 10);
+            p = end;
+        }
+    }
+    if (*p != '}') return false;
+    if (low > MAX_REGEX_REPEAT || high > MAX_REGEX_REPEAT || (high >= 0 && high < low)) {
+        parser->error = "invalid repetition count";
+        return false;
+    }
+    *min = (int)low;
+    *max = (int)high;
+    parser->p = p + 1;
+    return true;
+}
+
+static RegexNode* parse_repeat(RegexParser *parser) {
+    RegexNode *node = parse_atom(parser);
+    while (node) {
+        int min, max;
+        char c = *parser->p;
+        if (c == '*') { min = 0; max = -1; parser->p++; }
+        else if (c == '+') { min = 1; max = -1; parser->p++; }
+        else if (c == '?') { min = 0; max = 1; parser->p++; }
+        else if (c == '{' && parse_bounds(parser, &min, &max)) { }
+        else break;
+
+        // Lazy quantifiers match the same cells.
+        if (*parser->p == '?') parser->p++;
+
+        RegexNode *repeat = new_node(parser, RE_REPEAT);
+        if (!repeat) return NULL;
+        repeat->left = node;
+        repeat->min = min;
+        repeat->max = max;
+        node = repeat;
+    }
+    return parser->error ? NULL : node;
+}
+
+static RegexNode* parse_concat(RegexParser *parser) {
+    RegexNode *node = NULL;
+    while (*parser->p && *parser->p != '|' && *parser->p != ')') {
+        RegexNode *next = parse_repeat(parser);
+        if (!next) return NULL;
+        if (!node) {
+            node = next;
+        } else {
+            RegexNode *concat = new_node(parser, RE_CONCAT);
+            if (!concat) return NULL;
+            concat->left = node;
+            concat->right = next;
+            node = concat;
+        }
+    }
+    return node ? node : new_node(parser, RE_EMPTY);
+}
+
+static RegexNode* parse_alternation(RegexParser *parser) {
+    RegexNode *node = parse_concat(parser);
+    while (node && *parser->p == '|') {
+        parser->p++;
+        RegexNode *right = parse_concat(parser);
+        if (!right) return NULL;
+        RegexNode *alternate = new_node(parser, RE_ALTERNATE);
+        if (!alternate) return NULL;
+        alternate->left = node;
+        alternate->right = right;
+        node = alternate;
+    }
+    return node;
+}
+
+// --- Required Literal ---
+
+// What is known about the strings a node matches: whether it matches just
+// one ('exact'), what every match starts and ends with, and the longest
+// string every match contains.
+typedef struct {
+    bool exact;
+    char prefix[REGEX_LITERAL_MAX + 1];
+    char suffix[REGEX_LITERAL_MAX + 1];
+    char required[REGEX_LITERAL_MAX + 1];
+} LiteralInfo;
+
+static void keep_longer(char *best, const char *candidate) {
+    if (strlen(candidate) > strlen(best)) strcpy(best, candidate);
+}
+
+// Joins a and b, keeping the first (or, with keep_end, the last) bytes if
+// the result is too long. Returns false if it had to truncate.
+static bool join_literals(char *out, const char *a, const char *b, bool keep_end) {
+    char joined[2 * REGEX_LITERAL_MAX + 1];
+    snprintf(joined, sizeof(joined), "%s%s", a, b);
+    size_t length = strlen(joined);
+    if (length <= REGEX_LITERAL_MAX) {
+        strcpy(out, joined);
+        return true;
+    }
+    memcpy(out, keep_end ? joined + length - REGEX_LITERAL_MAX : joined, REGEX_LITERAL_MAX);
+    out[REGEX_LITERAL_MAX] = '\0';
+    return false;
+}
+
+static void literal_info(const RegexNode *node, LiteralInfo *info) {
+    memset(info, 0, sizeof(*info));
+    switch (node->type) {
+        case RE_CLASS: {
+            int members = 0, byte = 0;
+            for (int c = 0; c < 256 && members < 2; c++) {
+                if (set_has(node->set, (unsigned char)c)) {
+                    members++;
+                    byte = c;
+                }
+            }
+            if (members == 1 && byte != 0) {
+                info->exact = true;
+                info->prefix[0] = info->suffix[0] = info->required[0] = (char)byte;
+            }
+            return;
+        }
+        case RE_BOL:
+        case RE_EOL:
+        case RE_EMPTY:
+            info->exact = true;
+            return;
+        case RE_CONCAT: {
+            LiteralInfo left, right;
+            literal_info(node->left, &left);
+            literal_info(node->right, &right);
+            char junction[REGEX_LITERAL_MAX + 1];
+            join_literals(junction, left.suffix, right.prefix, false);
+
+            info->exact = left.exact && right.exact && join_literals(info->prefix, left.prefix, right.prefix, false);
+            if (!info->exact) {
+                if (left.exact) join_literals(info->prefix, left.prefix, right.prefix, false);
+                else strcpy(info->prefix, left.prefix);
+            }
+            if (right.exact) join_literals(info->suffix, left.suffix, right.suffix, true);
+            else strcpy(info->suffix, right.suffix);
+
+            strcpy(info->required, left.required);
+            keep_longer(info->required, right.required);
+            keep_longer(info->required, junction);
+            break;
+        }
+        case RE_ALTERNATE: {
+            LiteralInfo left, right;
+            literal_info(node->left, &left);
+            literal_info(node->right, &right);
+            size_t n = 0;
+            while (left.prefix[n] && left.prefix[n] == right.prefix[n]) n++;
+            memcpy(info->prefix, left.prefix, n);
+            info->prefix[n] = '\0';
+            size_t left_length = strlen(left.suffix), right_length = strlen(right.suffix);
+            n = 0;
+            while (n < left_length && n < right_length &&
+                   left.suffix[left_length - 1 - n] == right.suffix[right_length - 1 - n]) n++;
+            strcpy(info->suffix, left.suffix + left_length - n);
+            info->exact = left.exact && right.exact && strcmp(left.prefix, right.prefix) == 0;
+            break;
+        }
+        case RE_REPEAT: {
+            if (node->min == 0) {
+                info->exact = node->max == 0;
+                return;
+            }
+            LiteralInfo child;
+            literal_info(node->left, &child);
+            strcpy(info->prefix, child.prefix);
+            strcpy(info->suffix, child.suffix);
+            strcpy(info->required, child.required);
+            if (child.exact && node->min == node->max) {
+                char repeated[REGEX_LITERAL_MAX + 1] = "";
+                info->exact = true;
+                for (int i = 0; i < node->min && info->exact; i++) {
+                    info->exact = join_literals(repeated, repeated, child.prefix, false);
+                }
+                if (info->exact) strcpy(info->prefix, repeated);
+                strcpy(info->suffix, info->prefix);
+            }
+            break;
+        }
+    }
+    keep_longer(info->required, info->prefix);
+    keep_longer(info->required, info->suffix);
+}
+
+// --- NFA ---
+
+typedef enum {
+    NFA_CLASS,
+    NFA_SPLIT,
+    NFA_BOL,
+    NFA_EOL,
+    NFA_MATCH
+} NfaOp;
+
+typedef struct {
+    NfaOp op;
+    int out, out1;
+    uint32_t set[8];
+} NfaState;
+
+struct CompiledRegex {
+    NfaState *states;
+    size_t state_count;
+    size_t capacity;
+    int start;
+    bool ignore_case;
+    char literal[REGEX_LITERAL_MAX + 1];
+};
+
+// Adds the other case of every ASCII letter in the set.
+static void fold_set_case(uint32_t *set) {
+    for (unsigned char c = 'a'; c <= 'z'; c++) {
+        unsigned char upper = (unsigned char)(c - ('a' - 'A'));
+        if (set_has(set, c) || set_has(set, upper)) {
+            set_add(set, c);
+            set_add(set, upper);
+        }
+    }
+}
+
+static int add_state(CompiledRegex *regex, NfaOp op, int out, int out1) {
+    if (regex->state_count == MAX_NFA_STATES) return -1;
+    if (regex->state_count == regex->capacity) {
+        size_t capacity = regex->capacity ? regex->capacity * 2 : 64;
+        NfaState *grown = realloc(regex->states, capacity * sizeof(NfaState));
+        if (!grown) return -1;
+        regex->states = grown;
+        regex->capacity = capacity;
+    }
+    NfaState *state = &regex->states[regex->state_count];
+    memset(state, 0, sizeof(*state));
+    state->op = op;
+    state->out = out;
+    state->out1 = out1;
+    return (int)regex->state_count++;
+}
+
+// Compiles 'node' so that it continues at state 'next'. Returns the entry
+// state, or -1 if the NFA grew too large.
+static int compile_node(CompiledRegex *regex, const RegexNode *node, int next) {
+    if (next < 0) return -1;
+    switch (node->type) {
+        case RE_CLASS: {
+            int state = add_state(regex, NFA_CLASS, next, -1);
+            if (state < 0) return -1;
+            memcpy(regex->states[state].set, node->set, sizeof(node->set));
+            if (regex->ignore_case) fold_set_case(regex->states[state].set);
+            return state;
+        }
+        case RE_BOL:
+            return add_state(regex, NFA_BOL, next, -1);
+        case RE_EOL:
+            return add_state(regex, NFA_EOL, next, -1);
+        case RE_EMPTY:
+            return next;
+        case RE_CONCAT:
+            return compile_node(regex, node->left, compile_node(regex, node->right, next));
+        case RE_ALTERNATE: {
+            int left = compile_node(regex, node->left, next);
+            int right = compile_node(regex, node->right, next);
+            return left < 0 || right < 0 ? -1 : add_state(regex, NFA_SPLIT, left, right);
+        }
+        case RE_REPEAT: {
+            int continuation = next;
+            if (node->max < 0) {
+                // A loop: the split either enters the body again or leaves.
+                int loop = add_state(regex, NFA_SPLIT, -1, next);
+                if (loop < 0) return -1;
+                int body = compile_node(regex, node->left, loop);
+                if (body < 0) return -1;
+                regex->states[loop].out = body;
+                continuation = loop;
+            } else {
+                // Optional copies, each of which may skip straight to 'next'.
+                for (int i = node->min; i < node->max; i++) {
+                    int body = compile_node(regex, node->left, continuation);
+                    if (body < 0) return -1;
+                    continuation = add_state(regex, NFA_SPLIT, body, next);
+                    if (continuation < 0) return -1;
+                }
+            }
+            for (int i = 0; i < node->min; i++) {
+                continuation = compile_node(regex, node->left, continuation);
+                if (continuation < 0) return -1;
+            }
+            return continuation;
+        }
+    }
+    return -1;
+}
+
+DSVResult regex_compile(const char *pattern, int flags, CompiledRegex **out, char *error, size_t error_size) {
+    if (!pattern || !out) return DSV_ERROR_INVALID_ARGS;
+    *out = NULL;
+
+    Arena arena;
+    arena_init(&arena, 0);
+    RegexParser parser = { .p = pattern, .arena = &arena };
+    RegexNode *root = parse_alternation(&parser);
+    if (root && *parser.p == ')') parser.error = "unmatched )";
+    if (!root || parser.error) {
+        if (error) snprintf(error, error_size, "%s at offset %zu", parser.error ? parser.error : "invalid pattern",
+                            (size_t)(parser.p - pattern));
+        arena_free(&arena);
+        return DSV_ERROR_PARSE;
+    }
+
+    CompiledRegex *regex = calloc(1, sizeof(CompiledRegex));
+    if (!regex) {
+        arena_free(&arena);
+        return DSV_ERROR_MEMORY;
+    }
+    regex->ignore_case = (flags & REGEX_IGNORE_CASE) != 0;
+    LiteralInfo info;
+    literal_info(root, &info);
+    strcpy(regex->literal, info.required);
+
+    int match = add_state(regex, NFA_MATCH, -1, -1);
+    regex->start = compile_node(regex, root, match);
+    arena_free(&arena);
+    if (regex->start < 0) {
+        if (error) snprintf(error, error_size, "pattern too large");
+        regex_free(regex);
+        return DSV_ERROR_PARSE;
+    }
+
+    *out = regex;
+    return DSV_OK;
+}
+
+void regex_free(CompiledRegex *regex) {
+    if (!regex) return;
+    free(regex->states);
+    free(regex);
+}
+
+const char* regex_required_literal(const CompiledRegex *regex) {
+    return regex ? regex->literal : "";
+}
+
+// --- Lazy DFA ---
+
+// A DFA state is the set of NFA states the search can be in. Transitions are
+// filled in the first time they are taken.
+typedef struct {
+    int *members;        // Sorted NFA state indices
+    size_t member_count;
+    int next[256];       // DFA state per input byte, -1 if not built yet
+    bool match;          // A match has been seen
+    bool match_at_end;   // The input may end here for a match ('$')
+} DfaState;
+
+struct RegexMatcher {
+    const CompiledRegex *regex;
+    DfaState *states;
+    size_t state_count;
+    int *table;          // Open addressing: DFA state index + 1, 0 if empty
+    size_t table_size;
+    int start;           // State at the start of a cell
+    // Scratch for building state sets
+    int *stack;
+    int *set;
+    unsigned *marks;
+    unsigned generation;
+};
+
+// Adds the states reachable from 'state' without consuming input. Assertions
+// pass only where they hold; the states themselves are kept in the set so
+// '$' can be tried when the input ends.
+static void add_closure(RegexMatcher *matcher, int state, bool at_start, size_t *count) {
+    const NfaState *states = matcher->regex->states;
+    size_t top = 0;
+    matcher->stack[top++] = state;
+    while (top > 0) {
+        int s = matcher->stack[--top];
+        if (s < 0 || matcher->marks[s] == matcher->generation) continue;
+        matcher->marks[s] = matcher->generation;
+        matcher->set[(*count)++] = s;
+        switch (states[s].op) {
+            case NFA_SPLIT:
+                matcher->stack[top++] = states[s].out1;
+                matcher->stack[top++] = states[s].out;
+                break;
+            case NFA_BOL:
+                if (at_start) matcher->stack[top++] = states[s].out;
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+static int compare_ints(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+static size_t hash_members(const int *members, size_t count) {
+    size_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < count; i++) {
+        hash ^= (size_t)members[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// True if a match is reachable from the set once the input has ended.
+static bool matches_at_end(RegexMatcher *matcher, const int *members, size_t count) {
+    const NfaState *states = matcher->regex->states;
+    matcher->generation++;
+    size_t top = 0;
+    for (size_t i = 0; i < count; i++) matcher->stack[top++] = members[i];
+    while (top > 0) {
+        int s = matcher->stack[--top];
+        if (s < 0 || matcher->marks[s] == matcher->generation) continue;
+        matcher->marks[s] = matcher->generation;
+        switch (states[s].op) {
+            case NFA_MATCH: return true;
+            case NFA_SPLIT:
+                matcher->stack[top++] = states[s].out;
+                matcher->stack[top++] = states[s].out1;
+                break;
+            case NFA_EOL: matcher->stack[top++] = states[s].out; break;
+            default: break;
+        }
+    }
+    return false;
+}
+
+static void reset_dfa(RegexMatcher *matcher) {
+    for (size_t i = 0; i < matcher->state_count; i++) free(matcher->states[i].members);
+    matcher->state_count = 0;
+    memset(matcher->table, 0, matcher->table_size * sizeof(int));
+}
+
+// Returns the DFA state for the set in matcher->set, adding it if needed.
+static int intern_state(RegexMatcher *matcher, size_t count) {
+    qsort(matcher->set, count, sizeof(int), compare_ints);
+    size_t mask = matcher->table_size - 1;
+    size_t slot = hash_members(matcher->set, count) & mask;
+    while (matcher->table[slot]) {
+        DfaState *existing = &matcher->states[matcher->table[slot] - 1];
+        if (existing->member_count == count && memcmp(existing->members, matcher->set, count * sizeof(int)) == 0) {
+            return matcher->table[slot] - 1;
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    DfaState *state = &matcher->states[matcher->state_count];
+    state->members = malloc((count ? count : 1) * sizeof(int));
+    if (!state->members) return -1;
+    memcpy(state->members, matcher->set, count * sizeof(int));
+    state->member_count = count;
+    for (int i = 0; i < 256; i++) state->next[i] = -1;
+    state->match = false;
+    for (size_t i = 0; i < count && !state->match; i++) {
+        state->match = matcher->regex->states[matcher->set[i]].op == NFA_MATCH;
+    }
+    state->match_at_end = state->match || matches_at_end(matcher, state->members, count);
+    matcher->table[slot] = (int)matcher->state_count + 1;
+    return (int)matcher->state_count++;
+}
+
+static int build_start_state(RegexMatcher *matcher) {
+    size_t count = 0;
+    matcher->generation++;
+    add_closure(matcher, matcher->regex->start, true, &count);
+    return intern_state(matcher, count);
+}
+
+// Builds the transition of 'from' on 'byte'. Every state also restarts the
+// pattern, which makes the DFA find matches anywhere in the text.
+static int build_transition(RegexMatcher *matcher, int from, unsigned char byte) {
+    if (matcher->state_count == MAX_DFA_STATES) {
+        // Start over, keeping only the state the search is in.
+        DfaState saved = matcher->states[from];
+        saved.members = malloc((saved.member_count ? saved.member_count : 1) * sizeof(int));
+        if (!saved.members) return -1;
+        memcpy(saved.members, matcher->states[from].members, saved.member_count * sizeof(int));
+        reset_dfa(matcher);
+        matcher->start = build_start_state(matcher);
+        memcpy(matcher->set, saved.members, saved.member_count * sizeof(int));
+        from = intern_state(matcher, saved.member_count);
+        free(saved.members);
+        if (from < 0 || matcher->start < 0) return -1;
+    }
+
+    const NfaState *states = matcher->regex->states;
+    const DfaState *source = &matcher->states[from];
+    size_t count = 0;
+    matcher->generation++;
+    for (size_t i = 0; i < source->member_count; i++) {
+        const NfaState *s = &states[source->members[i]];
+        if (s->op == NFA_CLASS && set_has(s->set, byte)) add_closure(matcher, s->out, false, &count);
+    }
+    add_closure(matcher, matcher->regex->start, false, &count);
+
+    int to = intern_state(matcher, count);
+    if (to >= 0) matcher->states[from].next[byte] = to;
+    return to;
+}
+
+RegexMatcher* regex_matcher_create(const CompiledRegex *regex) {
+    if (!regex) return NULL;
+    RegexMatcher *matcher = calloc(1, sizeof(RegexMatcher));
+    if (!matcher) return NULL;
+    matcher->regex = regex;
+    matcher->table_size = 2 * MAX_DFA_STATES;
+    matcher->states = malloc(MAX_DFA_STATES * sizeof(DfaState));
+    matcher->table = calloc(matcher->table_size, sizeof(int));
+    // A walk pushes its seeds plus at most two successors per state.
+    matcher->stack = malloc((3 * regex->state_count + 1) * sizeof(int));
+    matcher->set = malloc(regex->state_count * sizeof(int));
+    matcher->marks = calloc(regex->state_count, sizeof(unsigned));
+    if (!matcher->states || !matcher->table || !matcher->stack || !matcher->set || !matcher->marks) {
+        regex_matcher_free(matcher);
+        return NULL;
+    }
+    matcher->start = build_start_state(matcher);
+    if (matcher->start < 0) {
+        regex_matcher_free(matcher);
+        return NULL;
+    }
+    return matcher;
+}
+
+void regex_matcher_free(RegexMatcher *matcher) {
+    if (!matcher) return;
+    if (matcher->states) reset_dfa(matcher);
+    free(matcher->states);
+    free(matcher->table);
+    free(matcher->stack);
+    free(matcher->set);
+    free(matcher->marks);
+    free(matcher);
+}
+
+bool regex_matcher_search(RegexMatcher *matcher, const char *text, size_t length) {
+    int state = matcher->start;
+    if (matcher->states[state].match) return true;
+    for (size_t i = 0; i < length; i++) {
+        unsigned char byte = (unsigned char)text[i];
+        int next = matcher->states[state].next[byte];
+        if (next < 0) {
+            next = build_transition(matcher, state, byte);
+            if (next < 0) return false;
+        }
+        state = next;
+        if (matcher->states[state].match) return true;
+    }
+    return matcher->states[state].match_at_end;
+}
@@ -1,70 +1,681 @@
 #include "core/search.h"
 #include "core/data_source.h"
 #include "core/parser.h"
+#include "core/sorting.h"
+#include "core/regex.h"
 #include "util/logging.h"
+#include "util/parallel.h"
+#include "util/byte_search.h"
+#include "util/utils.h"
+#include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <pthread.h>
 
-SearchResult search_view(DSVViewer *viewer, View *view, const char* search_term, bool start_from_cursor) {
+// --- Hit List ---
+
+// Rows scanned per parallel chunk
+#define MIN_ROWS_PER_SEARCH_CHUNK 4096
+
+// Hits re-checked per parallel chunk when narrowing a hit list
+#define MIN_HITS_PER_NARROW_CHUNK 4096
+
+// Rows (or hits) between checks for cancellation of a background scan
+#define CANCEL_CHECK_ROWS 65536
+
+typedef struct {
+    size_t row;  // Display row
+    size_t col;
+} SearchHit;
+
+// Every match of one term in one display order of a view.
+struct SearchHits {
+    char term[256];
+    int flags;                 // SearchFlags the term was matched with
+    size_t order_version;      // view->order_version the rows refer to
+    size_t row_count;
+    size_t col_count;
+    SearchHit *hits;           // Sorted by (row, col); NULL unless complete
+    size_t count;
+    bool complete;             // False if there were too many matches to keep
+    size_t current;            // Match the cursor was moved to, SIZE_MAX if none
+};
+
+typedef struct {
+    SearchHit *hits;
+    size_t count;
+    size_t capacity;
+    size_t limit;        // Hits kept before further ones are only counted, 0 for no limit
+    size_t dropped;
+    bool failed;
+} HitBuffer;
+
+// Matching rows of one chunk, as ranges of data source rows.
+typedef struct {
+    RowRange *ranges;
+    size_t count;
+    size_t capacity;
+    size_t rows;
+    int column;          // Only matches in this column count, -1 for any
+    bool failed;
+} RangeBuffer;
+
+typedef struct {
+    View *view;
+    const char *term;
+    const CompiledRegex *regex; // Set for SEARCH_REGEX
+    const char *literal;        // Text every matching cell contains, may be ""
+    bool ignore_case;
+    size_t col_count;
+    size_t chunk_count;
+    size_t item_count;   // Display rows, or hits of 'base', to split into chunks
+    bool source_order;   // Rows being scanned are the source's rows, in order
+    const struct SearchHits *base; // Narrow these hits instead of scanning every cell
+    const int *cancel;   // Set by another thread to stop the scan early, may be NULL
+    HitBuffer *buffers;  // One per chunk, so the results stay in display order
+    RangeBuffer *ranges; // Set instead of 'buffers' when filtering rows
+    int failed;
+} SearchJob;
+
+static bool job_cancelled(const SearchJob *job) {
+    return job->cancel && __atomic_load_n(job->cancel, __ATOMIC_RELAXED);
+}
+
+static bool push_hit(HitBuffer *buffer, size_t row, size_t col) {
+    if (buffer->limit && buffer->count == buffer->limit) {
+        buffer->dropped++;
+        return true;
+    }
+    if (buffer->count == buffer->capacity) {
+        size_t capacity = buffer->capacity ? buffer->capacity * 2 : 64;
+        SearchHit *grown = realloc(buffer->hits, capacity * sizeof(SearchHit));
+        if (!grown) return false;
+        buffer->hits = grown;
+        buffer->capacity = capacity;
+    }
+    buffer->hits[buffer->count++] = (SearchHit){ .row = row, .col = col };
+    return true;
+}
+
+static bool collect_source_match(void *user, size_t row, size_t col) {
+    HitBuffer *buffer = (HitBuffer *)user;
+    if (!push_hit(buffer, row, col)) {
+        buffer->failed = true;
+        return false;
+    }
+    return true;
+}
+
+static bool push_range_row(RangeBuffer *buffer, size_t row) {
+    if (buffer->count > 0) {
+        RowRange *last = &buffer->ranges[buffer->count - 1];
+        if (row == last->end) return true;
+        if (row == last->end + 1) {
+            last->end = row;
+            buffer->rows++;
+            return true;
+        }
+    }
+    if (buffer->count == buffer->capacity) {
+        size_t capacity = buffer->capacity ? buffer->capacity * 2 : 64;
+        RowRange *grown = realloc(buffer->ranges, capacity * sizeof(RowRange));
+        if (!grown) return false;
+        buffer->ranges = grown;
+        buffer->capacity = capacity;
+    }
+    buffer->ranges[buffer->count++] = (RowRange){ .start = row, .end = row };
+    buffer->rows++;
+    return true;
+}
+
+static bool collect_source_row(void *user, size_t row, size_t col) {
+    RangeBuffer *buffer = (RangeBuffer *)user;
+    if (buffer->column >= 0 && col != (size_t)buffer->column) return true;
+    if (!push_range_row(buffer, row)) {
+        buffer->failed = true;
+        return false;
+    }
+    return true;
+}
+
+static bool regex_cell_matches(void *arg, const char *text) {
+    return regex_matcher_search((RegexMatcher *)arg, text, strlen(text));
+}
+
+// The required literal rules out most cells before the DFA runs.
+static bool cell_matches(const SearchJob *job, RegexMatcher *matcher, const char *text) {
+    if (job->literal[0] != '\0' && !text_contains(text, job->literal, job->ignore_case)) return false;
+    return !matcher || regex_matcher_search(matcher, text, strlen(text));
+}
+
+// Records every matching cell of display rows [begin, end).
+static bool collect_hits(const SearchJob *job, DataSourceCursor *cursor, RegexMatcher *matcher,
+                         HitBuffer *buffer, size_t begin, size_t end) {
+    char cell_buffer[4096];
+    for (size_t r = begin; r < end; r++) {
+        if ((r - begin) % CANCEL_CHECK_ROWS == 0 && job_cancelled(job)) return true;
+        size_t actual_row = view_get_displayed_row_index(job->view, r);
+        if (actual_row == SIZE_MAX) continue;
+        for (size_t c = 0; c < job->col_count; c++) {
+            FieldDesc fd = data_source_cursor_get_cell(cursor, actual_row, c);
+            if (fd.start == NULL || fd.length == 0) continue;
+            render_field(&fd, cell_buffer, sizeof(cell_buffer));
+            if (cell_matches(job, matcher, cell_buffer) && !push_hit(buffer, r, c)) return false;
+        }
+    }
+    return true;
+}
+
+// Re-checks the cells of hits [begin, end) of the base list. Used when the
+// term grew: every cell matching it also matched the shorter term.
+static bool narrow_hits(const SearchJob *job, DataSourceCursor *cursor, RegexMatcher *matcher,
+                        HitBuffer *buffer, size_t begin, size_t end) {
+    char cell_buffer[4096];
+    for (size_t i = begin; i < end; i++) {
+        if ((i - begin) % CANCEL_CHECK_ROWS == 0 && job_cancelled(job)) return true;
+        const SearchHit *hit = &job->base->hits[i];
+        size_t actual_row = view_get_displayed_row_index(job->view, hit->row);
+        if (actual_row == SIZE_MAX) continue;
+        FieldDesc fd = data_source_cursor_get_cell(cursor, actual_row, hit->col);
+        if (fd.start == NULL || fd.length == 0) continue;
+        render_field(&fd, cell_buffer, sizeof(cell_buffer));
+        if (cell_matches(job, matcher, cell_buffer) && !push_hit(buffer, hit->row, hit->col)) return false;
+    }
+    return true;
+}
+
+// Records the rows of visible-set entries [begin, end) with a matching cell.
+// The visible set is walked in source order, so the rows come out ascending.
+static bool filter_rows(const SearchJob *job, DataSourceCursor *cursor, RegexMatcher *matcher,
+                        RangeBuffer *buffer, size_t begin, size_t end) {
+    size_t first_col = buffer->column >= 0 ? (size_t)buffer->column : 0;
+    size_t end_col = buffer->column >= 0 ? first_col + 1 : job->col_count;
+    char cell_buffer[4096];
+    ViewRowIterator it;
+    view_row_iterator_init(&it, job->view, begin, end - begin);
+    for (size_t row = view_row_iterator_next(&it); row != SIZE_MAX; row = view_row_iterator_next(&it)) {
+        for (size_t c = first_col; c < end_col; c++) {
+            FieldDesc fd = data_source_cursor_get_cell(cursor, row, c);
+            if (fd.start == NULL || fd.length == 0) continue;
+            render_field(&fd, cell_buffer, sizeof(cell_buffer));
+            if (!cell_matches(job, matcher, cell_buffer)) continue;
+            if (!push_range_row(buffer, row)) return false;
+            break;
+        }
+    }
+    return true;
+}
+
+static void search_chunk(void *arg, size_t chunk) {
+    SearchJob *job = (SearchJob *)arg;
+    View *view = job->view;
+    size_t begin, end;
+    parallel_chunk_bounds(job->item_count, job->chunk_count, chunk, &begin, &end);
+
+    // DFA states are built as they are needed, so each chunk has its own.
+    RegexMatcher *matcher = NULL;
+    if (job->regex) {
+        matcher = regex_matcher_create(job->regex);
+        if (!matcher) {
+            __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+            return;
+        }
+    }
+
+    // Unfiltered, unsorted views can let the source scan its raw bytes.
+    CellQuery query = {
+        .literal = job->literal,
+        .ignore_case = job->ignore_case,
+        .matches = matcher ? regex_cell_matches : NULL,
+        .arg = matcher
+    };
+    if (job->source_order && !job->base && job->literal[0] != '\0') {
+        RowMatchFn collect = job->ranges ? collect_source_row : collect_source_match;
+        void *buffer = job->ranges ? (void *)&job->ranges[chunk] : (void *)&job->buffers[chunk];
+        // Scans that can be cancelled go a block of rows at a time.
+        size_t step = job->cancel ? CANCEL_CHECK_ROWS : end - begin;
+        bool handled = true;
+        for (size_t first = begin; handled && first < end && !job_cancelled(job); first += step) {
+            size_t count = end - first < step ? end - first : step;
+            handled = data_source_search_rows(view->data_source, &query, first, count, collect, buffer);
+        }
+        if (handled) {
+            bool failed = job->ranges ? job->ranges[chunk].failed : job->buffers[chunk].failed;
+            if (failed) __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+            regex_matcher_free(matcher);
+            return;
+        }
+    }
+
+    DataSourceCursor *cursor = data_source_open_cursor(view->data_source);
+    if (!cursor) {
+        __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+        regex_matcher_free(matcher);
+        return;
+    }
+
+    bool ok = job->ranges ? filter_rows(job, cursor, matcher, &job->ranges[chunk], begin, end)
+            : job->base   ? narrow_hits(job, cursor, matcher, &job->buffers[chunk], begin, end)
+                          : collect_hits(job, cursor, matcher, &job->buffers[chunk], begin, end);
+    if (!ok) __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+    data_source_close_cursor(cursor);
+    regex_matcher_free(matcher);
+}
+
+// Sets up a scan of the whole view for 'term'. Returns false, with a message
+// in 'error', if the term is not a valid pattern. The caller frees *regex.
+static bool prepare_job(SearchJob *job, View *view, const char *term, int flags, size_t col_count,
+                        CompiledRegex **regex, char *error, size_t error_size) {
+    *regex = NULL;
+    bool ignore_case = (flags & SEARCH_IGNORE_CASE) != 0;
+    if ((flags & SEARCH_REGEX) &&
+        regex_compile(term, ignore_case ? REGEX_IGNORE_CASE : REGEX_DEFAULT, regex, error, error_size) != DSV_OK) {
+        return false;
+    }
+
+    *job = (SearchJob){
+        .view = view,
+        .term = term,
+        .regex = *regex,
+        .literal = *regex ? regex_required_literal(*regex) : term,
+        .ignore_case = ignore_case,
+        .col_count = col_count,
+        .chunk_count = 1,
+        .item_count = view->visible_row_count,
+        .source_order = view->num_ranges == 0 && view->row_order_map == NULL,
+        .failed = 0
+    };
+    if (data_source_supports_cursors(view->data_source)) {
+        job->chunk_count = parallel_chunk_count(view->visible_row_count, MIN_ROWS_PER_SEARCH_CHUNK);
+    }
+    return true;
+}
+
+// Scans the whole view for 'term', or only the cells of 'base' if given.
+// Past 'hit_limit' matches (0 for none) only the count is kept. Returns NULL
+// on failure or cancellation, with a message in 'error' if the term is not a
+// valid pattern.
+static struct SearchHits* build_hit_list(View *view, const char *term, int flags, size_t col_count,
+                                         const struct SearchHits *base, const int *cancel, size_t hit_limit,
+                                         char *error, size_t error_size) {
+    SearchJob job;
+    CompiledRegex *regex;
+    if (!prepare_job(&job, view, term, flags, col_count, &regex, error, error_size)) return NULL;
+    job.cancel = cancel;
+    if (base) {
+        job.base = base;
+        job.item_count = base->count;
+        job.chunk_count = data_source_supports_cursors(view->data_source)
+            ? parallel_chunk_count(base->count, MIN_HITS_PER_NARROW_CHUNK) : 1;
+    }
+
+    struct SearchHits *result = calloc(1, sizeof(struct SearchHits));
+    if (!result) {
+        regex_free(regex);
+        return NULL;
+    }
+    strncpy(result->term, term, sizeof(result->term) - 1);
+    result->flags = flags;
+    result->order_version = view->order_version;
+    result->row_count = view->visible_row_count;
+    result->col_count = col_count;
+    result->current = SIZE_MAX;
+
+    job.buffers = calloc(job.chunk_count, sizeof(HitBuffer));
+    if (!job.buffers) {
+        regex_free(regex);
+        free(result);
+        return NULL;
+    }
+    for (size_t i = 0; i < job.chunk_count; i++) {
+        job.buffers[i].limit = hit_limit ? (hit_limit + job.chunk_count - 1) / job.chunk_count : 0;
+    }
+
+    parallel_for(job.chunk_count, search_chunk, &job);
+    regex_free(regex);
+
+    // A list with dropped hits cannot be stepped through; only its count is kept.
+    size_t total = 0, dropped = 0;
+    for (size_t i = 0; i < job.chunk_count; i++) {
+        total += job.buffers[i].count;
+        dropped += job.buffers[i].dropped;
+    }
+    result->complete = dropped == 0;
+    result->hits = total > 0 && result->complete ? malloc(total * sizeof(SearchHit)) : NULL;
+    if (total > 0 && result->complete && !result->hits) job.failed = 1;
+    for (size_t i = 0; i < job.chunk_count; i++) {
+        if (!job.failed && result->hits) {
+            memcpy(result->hits + result->count, job.buffers[i].hits, job.buffers[i].count * sizeof(SearchHit));
+        }
+        result->count += job.buffers[i].count + job.buffers[i].dropped;
+        free(job.buffers[i].hits);
+    }
+    free(job.buffers);
+
+    if (job_cancelled(&job)) {
+        free(result->hits);
+        free(result);
+        return NULL;
+    }
+    if (job.failed) {
+        LOG_ERROR("Search for '%s' failed", term);
+        free(result->hits);
+        free(result);
+        return NULL;
+    }
+    LOG_INFO("Search for '%s': %zu matches in %zu rows", term, result->count, result->row_count);
+    return result;
+}
+
+static void free_hits(struct SearchHits *hits) {
+    if (!hits) return;
+    free(hits->hits);
+    free(hits);
+}
+
+// True if 'hits' were built from the view's current rows and display order.
+static bool hits_are_current(const struct SearchHits *hits, const View *view, size_t col_count) {
+    return hits->order_version == view->order_version &&
+           hits->row_count == view->visible_row_count && hits->col_count == col_count;
+}
+
+static void stop_pending_search(View *view, bool wait);
+
+void search_clear(View *view) {
+    if (!view) return;
+    stop_pending_search(view, false);
+    free_hits(view->search_hits);
+    view->search_hits = NULL;
+}
+
+// Returns the view's hit list for 'term', rebuilding it if the term, the
+// rows or their display order changed since it was built.
+static struct SearchHits* hits_for_term(View *view, const char *term, int flags, size_t col_count,
+                                        char *error, size_t error_size) {
+    struct SearchHits *hits = view->search_hits;
+    if (hits && hits->complete && strcmp(hits->term, term) == 0 && hits->flags == flags &&
+        hits_are_current(hits, view, col_count)) {
+        return hits;
+    }
+    search_clear(view);
+    view->search_hits = build_hit_list(view, term, flags, col_count, NULL, NULL, 0, error, error_size);
+    return view->search_hits;
+}
+
+// Index of the first hit at or after (row, col).
+static size_t lower_bound_hit(const struct SearchHits *hits, size_t row, size_t col) {
+    size_t low = 0, high = hits->count;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        const SearchHit *hit = &hits->hits[mid];
+        if (hit->row < row || (hit->row == row && hit->col < col)) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+// --- Incremental Search ---
+
+// Hits a background scan keeps; past this it only counts them, since a list
+// that long is not worth narrowing.
+#define INCREMENTAL_HIT_LIMIT ((size_t)1 << 22)
+
+struct PendingSearch {
+    pthread_t thread;
+    View *view;
+    char term[256];
+    int flags;
+    size_t col_count;
+    struct SearchHits *base;    // Hits of a shorter term being narrowed, NULL for a full scan
+    struct SearchHits *result;  // Set by the worker, NULL if it failed or was cancelled
+    int cancel;                 // Set to stop the worker early
+    int done;                   // Set by the worker once 'result' is final
+};
+
+static void* incremental_search_worker(void *arg) {
+    struct PendingSearch *pending = (struct PendingSearch *)arg;
+    pending->result = build_hit_list(pending->view, pending->term, pending->flags, pending->col_count,
+                                     pending->base, &pending->cancel, INCREMENTAL_HIT_LIMIT, NULL, 0);
+    __atomic_store_n(&pending->done, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+// Ends the view's background scan, cancelling it unless 'wait' is set. A
+// result is installed as the view's hit list; without one, the list being
+// narrowed is put back so that the next scan can start from it.
+static void stop_pending_search(View *view, bool wait) {
+    struct PendingSearch *pending = view->pending_search;
+    if (!pending) return;
+    if (!wait) __atomic_store_n(&pending->cancel, 1, __ATOMIC_RELAXED);
+    pthread_join(pending->thread, NULL);
+    view->pending_search = NULL;
+
+    struct SearchHits *keep = pending->result ? pending->result : pending->base;
+    if (keep == pending->result) free_hits(pending->base);
+    if (keep) {
+        free_hits(view->search_hits);
+        view->search_hits = keep;
+    }
+    free(pending);
+}
+
+bool search_incremental_update(View *view, const char *search_term, int flags) {
+    if (!view) return false;
+    stop_pending_search(view, false);
+    if (!search_term || *search_term == '\0' || !view->data_source ||
+        !data_source_supports_cursors(view->data_source)) {
+        return false;
+    }
+
+    // The worker walks the displayed order, so it must be final.
+    sort_view_wait(view);
+    DataSource *ds = view->data_source;
+    size_t col_count = ds->ops->get_col_count(ds->context);
+    if (view->visible_row_count == 0 || col_count == 0) return false;
+
+    struct SearchHits *hits = view->search_hits;
+    bool current = hits && hits_are_current(hits, view, col_count);
+    if (current && strcmp(hits->term, search_term) == 0 && hits->flags == flags) return false;
+
+    struct PendingSearch *pending = calloc(1, sizeof(struct PendingSearch));
+    if (!pending) return false;
+    pending->view = view;
+    strncpy(pending->term, search_term, sizeof(pending->term) - 1);
+    pending->flags = flags;
+    pending->col_count = col_count;
+
+    // A literal that contains the previous one can only match cells that
+    // one matched, so only those are checked again.
+    if (current && hits->complete && !(flags & SEARCH_REGEX) && hits->flags == flags &&
+        strstr(search_term, hits->term) != NULL) {
+        pending->base = hits;
+        view->search_hits = NULL;
+    }
+
+    if (pthread_create(&pending->thread, NULL, incremental_search_worker, pending) != 0) {
+        LOG_WARN("Could not start incremental search");
+        if (pending->base) view->search_hits = pending->base;
+        free(pending);
+        return false;
+    }
+    view->pending_search = pending;
+    return true;
+}
+
+bool search_incremental_poll(View *view) {
+    if (!view || !view->pending_search) return false;
+    if (!__atomic_load_n(&view->pending_search->done, __ATOMIC_ACQUIRE)) return false;
+    stop_pending_search(view, true);
+    return true;
+}
+
+void search_incremental_cancel(View *view) {
+    if (view) stop_pending_search(view, false);
+}
+
+bool search_view_match_count(const View *view, const char *search_term, int flags, size_t *count) {
+    if (!view || !view->search_hits || !search_term) return false;
+    const struct SearchHits *hits = view->search_hits;
+    if (strcmp(hits->term, search_term) != 0 || hits->flags != flags) return false;
+    if (count) *count = hits->count;
+    return true;
+}
+
+// --- Navigation ---
+
+// Moves the cursor to the next match (step 1) or the previous one (step -1).
+static SearchResult step_search(DSVViewer *viewer, View *view, const char *search_term, int flags,
+                                int step, bool start_from_cursor) {
     if (!viewer || !view || !search_term || *search_term == '\0') {
         return SEARCH_NOT_FOUND;
     }
 
+    // Searching walks the displayed order, so it must be final.
+    sort_view_wait(view);
+
+    // A background scan for this very term is worth finishing; any other is not.
+    struct PendingSearch *pending = view->pending_search;
+    if (pending) stop_pending_search(view, strcmp(pending->term, search_term) == 0 && pending->flags == flags);
+
     DataSource* ds = view->data_source;
     if (!ds || view->visible_row_count == 0) return SEARCH_NOT_FOUND;
 
     size_t col_count = ds->ops->get_col_count(ds->context);
     if (col_count == 0) return SEARCH_NOT_FOUND;
 
-    size_t start_r = view->cursor_row;
-    size_t start_c = view->cursor_col;
-
-    if (!start_from_cursor) {
-        // Advance to the next cell for "find next"
-        start_c++;
-        if (start_c >= col_count) {
-            start_c = 0;
-            start_r++;
-            if (start_r >= view->visible_row_count) {
-                start_r = 0; // Wrap around
-            }
-        }
+    char error[128] = "";
+    struct SearchHits *hits = hits_for_term(view, search_term, flags, col_count, error, sizeof(error));
+    if (error[0] != '\0') {
+        set_error_message(viewer, "Invalid pattern: %s", error);
+        return SEARCH_NOT_FOUND;
+    }
+    if (!hits || hits->count == 0) {
+        set_error_message(viewer, "Search term not found: %s", search_term);
+        return SEARCH_NOT_FOUND;
     }
 
-    char cell_buffer[4096];
-    size_t current_r = start_r;
-    size_t current_c = start_c;
-    bool wrapped = false;
+    // Stepping from the match the cursor is on needs no lookup.
+    bool on_current = hits->current != SIZE_MAX &&
+                      hits->hits[hits->current].row == view->cursor_row &&
+                      hits->hits[hits->current].col == view->cursor_col;
+    size_t at_cursor = on_current ? hits->current
+                                  : lower_bound_hit(hits, view->cursor_row, view->cursor_col);
+    bool cursor_on_hit = on_current ||
+                         (at_cursor < hits->count && hits->hits[at_cursor].row == view->cursor_row &&
+                          hits->hits[at_cursor].col == view->cursor_col);
 
-    for (size_t i = 0; i < view->visible_row_count * col_count; i++) {
-        size_t actual_row = view_get_displayed_row_index(view, current_r);
-        if (actual_row != SIZE_MAX) {
-            FieldDesc fd = ds->ops->get_cell(ds->context, actual_row, current_c);
-            if (fd.start != NULL && fd.length > 0) {
-                render_field(&fd, cell_buffer, sizeof(cell_buffer));
-                if (strstr(cell_buffer, search_term) != NULL) {
-                    // Match found!
-                    view->cursor_row = current_r;
-                    view->cursor_col = current_c;
-                    LOG_INFO("Found '%s' at display row %zu, col %zu", search_term, current_r, current_c);
-                    return wrapped ? SEARCH_WRAPPED_AND_FOUND : SEARCH_FOUND;
-                }
-            }
+    size_t index;
+    bool wrapped = false;
+    if (step > 0) {
+        index = (start_from_cursor || !cursor_on_hit) ? at_cursor : at_cursor + 1;
+        if (index >= hits->count) {
+            index = 0;
+            wrapped = true;
         }
+    } else if (at_cursor == 0) {
+        index = hits->count - 1;
+        wrapped = true;
+    } else {
+        index = at_cursor - 1;
+    }
 
-        // Advance to the next cell, wrapping around rows and the whole view
-        current_c++;
-        if (current_c >= col_count) {
-            current_c = 0;
-            current_r++;
-            if (current_r >= view->visible_row_count) {
-                current_r = 0;
-                wrapped = true;
+    hits->current = index;
+    view->cursor_row = hits->hits[index].row;
+    view->cursor_col = hits->hits[index].col;
+    LOG_INFO("Found '%s' at display row %zu, col %zu (match %zu of %zu)",
+             search_term, view->cursor_row, view->cursor_col, index + 1, hits->count);
+    return wrapped ? SEARCH_WRAPPED_AND_FOUND : SEARCH_FOUND;
+}
+
+SearchResult search_view(DSVViewer *viewer, View *view, const char* search_term, int flags, bool start_from_cursor) {
+    return step_search(viewer, view, search_term, flags, 1, start_from_cursor);
+}
+
+SearchResult search_view_previous(DSVViewer *viewer, View *view, const char* search_term, int flags) {
+    return step_search(viewer, view, search_term, flags, -1, false);
+}
+
+bool search_view_match_position(const View *view, size_t *index, size_t *count) {
+    if (!view || !view->search_hits || view->search_hits->current == SIZE_MAX) return false;
+    if (index) *index = view->search_hits->current;
+    if (count) *count = view->search_hits->count;
+    return true;
+}
+
+// --- Filtering ---
+
+DSVResult search_filter_rows(View *view, const char *search_term, int flags, int column,
+                             RowRange **ranges, size_t *range_count, size_t *row_count,
+                             char *error, size_t error_size) {
+    if (!view || !view->data_source || !search_term || *search_term == '\0' ||
+        !ranges || !range_count || !row_count) {
+        return DSV_ERROR_INVALID_ARGS;
+    }
+    *ranges = NULL;
+    *range_count = 0;
+    *row_count = 0;
+
+    DataSource *ds = view->data_source;
+    size_t col_count = ds->ops->get_col_count(ds->context);
+    if (column >= 0 && (size_t)column >= col_count) return DSV_ERROR_INVALID_ARGS;
+    if (view->visible_row_count == 0 || col_count == 0) return DSV_OK;
+
+    SearchJob job;
+    CompiledRegex *regex;
+    if (!prepare_job(&job, view, search_term, flags, col_count, &regex, error, error_size)) {
+        return DSV_ERROR_PARSE;
+    }
+    // Filtering walks the visible set, not the display order, so only a
+    // filtered view rules out the raw scan.
+    job.source_order = view->num_ranges == 0;
+    job.ranges = calloc(job.chunk_count, sizeof(RangeBuffer));
+    if (!job.ranges) {
+        regex_free(regex);
+        return DSV_ERROR_MEMORY;
+    }
+    for (size_t i = 0; i < job.chunk_count; i++) job.ranges[i].column = column;
+
+    parallel_for(job.chunk_count, search_chunk, &job);
+    regex_free(regex);
+
+    // Chunks cover consecutive rows, so ranges only need joining where one
+    // chunk's last range runs into the next chunk's first.
+    size_t total = 0;
+    for (size_t i = 0; i < job.chunk_count; i++) total += job.ranges[i].count;
+    RowRange *merged = total > 0 ? malloc(total * sizeof(RowRange)) : NULL;
+    if (total > 0 && !merged) job.failed = 1;
+    size_t count = 0, rows = 0;
+    for (size_t i = 0; i < job.chunk_count; i++) {
+        const RangeBuffer *buffer = &job.ranges[i];
+        for (size_t k = 0; !job.failed && k < buffer->count; k++) {
+            RowRange range = buffer->ranges[k];
+            rows += range.end - range.start + 1;
+            if (count > 0 && range.start == merged[count - 1].end + 1) {
+                merged[count - 1].end = range.end;
+            } else {
+                merged[count++] = range;
             }
         }
+        free(buffer->ranges);
     }
+    free(job.ranges);
 
-    set_error_message(viewer, "Search term not found: %s", search_term);
-    return SEARCH_NOT_FOUND;
-} 
\ No newline at end of file
+    if (job.failed) {
+        LOG_ERROR("Filtering on '%s' failed", search_term);
+        free(merged);
+        return DSV_ERROR_MEMORY;
+    }
+    if (count > 0 && count < total) {
+        RowRange *shrunk = realloc(merged, count * sizeof(RowRange));
+        if (shrunk) merged = shrunk;
+    }
+    LOG_INFO("Filter on '%s': %zu rows in %zu ranges", search_term, rows, count);
+    *ranges = merged;
+    *range_count = count;
+    *row_count = rows;
+    return DSV_OK;
+}
@@ -0,0 +1,468 @@
+#include "core/sketch.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// --- HyperLogLog ---
+
+void hll_init(HyperLogLog *hll) {
+    memset(hll->registers, 0, sizeof(hll->registers));
+}
+
+void hll_add(HyperLogLog *hll, uint64_t hash) {
+    // The top bits pick the register, the position of the first set bit in
+    // the rest is its rank.
+    size_t index = (size_t)(hash >> (64 - HLL_PRECISION));
+    uint64_t rest = hash << HLL_PRECISION;
+    uint8_t rank = rest ? (uint8_t)(__builtin_clzll(rest) + 1) : (uint8_t)(64 - HLL_PRECISION + 1);
+    if (rank > hll->registers[index]) hll->registers[index] = rank;
+}
+
+void hll_merge(HyperLogLog *into, const HyperLogLog *from) {
+    for (size_t i = 0; i < HLL_REGISTERS; i++) {
+        if (from->registers[i] > into->registers[i]) into->registers[i] = from->registers[i];
+    }
+}
+
+double hll_estimate(const HyperLogLog *hll) {
+    double m = (double)HLL_REGISTERS;
+    double sum = 0.0;
+    size_t zeros = 0;
+    for (size_t i = 0; i < HLL_REGISTERS; i++) {
+        sum += 1.0 / (double)(1ULL << hll->registers[i]);
+        if (hll->registers[i] == 0) zeros++;
+    }
+    double estimate = (0.7213 / (1.0 + 1.079 / m)) * m * m / sum;
+
+    // Small cardinalities are estimated better by counting empty registers.
+    // A 64-bit hash needs no large range correction.
+    if (estimate <= 2.5 * m && zeros > 0) {
+        estimate = m * log(m / (double)zeros);
+    }
+    return estimate;
+}
+
+double hll_relative_error(void) {
+    return 1.04 / sqrt((double)HLL_REGISTERS);
+}
+
+// --- Space-Saving ---
+
+#define NO_COUNTER UINT32_MAX
+
+typedef struct {
+    uint64_t hash;
+    char *value;                // Reused when the counter changes hands
+    size_t length;
+    size_t value_capacity;
+    size_t count;
+    size_t error;
+    uint32_t heap_pos;
+} SpaceSavingCounter;
+
+// Counters sit in a min-heap by count, so the one to evict is always at the
+// root, and are found by value through a linear-probing table of counter
+// indices (deletions shift later entries back, leaving no tombstones).
+struct SpaceSaving {
+    SpaceSavingCounter *counters;
+    uint32_t *heap;             // Counter indices, smallest count first
+    uint32_t *slots;            // Counter index per slot, or NO_COUNTER
+    size_t slot_mask;
+    size_t capacity;
+    size_t size;
+    size_t total;
+};
+
+SpaceSaving* space_saving_create(size_t capacity) {
+    if (capacity == 0 || capacity >= NO_COUNTER) return NULL;
+    SpaceSaving *summary = calloc(1, sizeof(SpaceSaving));
+    if (!summary) return NULL;
+
+    size_t slot_count = 16;
+    while (slot_count < capacity * 2) slot_count *= 2;
+    summary->counters = calloc(capacity, sizeof(SpaceSavingCounter));
+    summary->heap = malloc(capacity * sizeof(uint32_t));
+    summary->slots = malloc(slot_count * sizeof(uint32_t));
+    if (!summary->counters || !summary->heap || !summary->slots) {
+        space_saving_free(summary);
+        return NULL;
+    }
+    memset(summary->slots, 0xFF, slot_count * sizeof(uint32_t));
+    summary->slot_mask = slot_count - 1;
+    summary->capacity = capacity;
+    return summary;
+}
+
+void space_saving_free(SpaceSaving *summary) {
+    if (!summary) return;
+    for (size_t i = 0; summary->counters && i < summary->size; i++) {
+        free(summary->counters[i].value);
+    }
+    free(summary->counters);
+    free(summary->heap);
+    free(summary->slots);
+    free(summary);
+}
+
+static uint32_t find_counter(const SpaceSaving *summary, uint64_t hash, const char *value, size_t length) {
+    for (size_t slot = hash & summary->slot_mask; ; slot = (slot + 1) & summary->slot_mask) {
+        uint32_t index = summary->slots[slot];
+        if (index == NO_COUNTER) return NO_COUNTER;
+        const SpaceSavingCounter *counter = &summary->counters[index];
+        if (counter->hash == hash && counter->length == length && memcmp(counter->value, value, length) == 0) {
+            return index;
+        }
+    }
+}
+
+static void insert_slot(SpaceSaving *summary, uint32_t index) {
+    size_t slot = summary->counters[index].hash & summary->slot_mask;
+    while (summary->slots[slot] != NO_COUNTER) slot = (slot + 1) & summary->slot_mask;
+    summary->slots[slot] = index;
+}
+
+static void remove_slot(SpaceSaving *summary, uint32_t index) {
+    size_t hole = summary->counters[index].hash & summary->slot_mask;
+    while (summary->slots[hole] != index) hole = (hole + 1) & summary->slot_mask;
+
+    // Pull back any later entry whose probe sequence passes the hole.
+    for (size_t slot = (hole + 1) & summary->slot_mask; summary->slots[slot] != NO_COUNTER;
+         slot = (slot + 1) & summary->slot_mask) {
+        size_t home = summary->counters[summary->slots[slot]].hash & summary->slot_mask;
+        if (((slot - home) & summary->slot_mask) >= ((slot - hole) & summary->slot_mask)) {
+            summary->slots[hole] = summary->slots[slot];
+            hole = slot;
+        }
+    }
+    summary->slots[hole] = NO_COUNTER;
+}
+
+static inline size_t heap_count(const SpaceSaving *summary, size_t pos) {
+    return summary->counters[summary->heap[pos]].count;
+}
+
+static void heap_swap(SpaceSaving *summary, size_t a, size_t b) {
+    uint32_t tmp = summary->heap[a];
+    summary->heap[a] = summary->heap[b];
+    summary->heap[b] = tmp;
+    summary->counters[summary->heap[a]].heap_pos = (uint32_t)a;
+    summary->counters[summary->heap[b]].heap_pos = (uint32_t)b;
+}
+
+static void sift_down(SpaceSaving *summary, size_t pos) {
+    for (;;) {
+        size_t smallest = pos, left = pos * 2 + 1, right = left + 1;
+        if (left < summary->size && heap_count(summary, left) < heap_count(summary, smallest)) smallest = left;
+        if (right < summary->size && heap_count(summary, right) < heap_count(summary, smallest)) smallest = right;
+        if (smallest == pos) return;
+        heap_swap(summary, pos, smallest);
+        pos = smallest;
+    }
+}
+
+static void sift_up(SpaceSaving *summary, size_t pos) {
+    while (pos > 0 && heap_count(summary, (pos - 1) / 2) > heap_count(summary, pos)) {
+        heap_swap(summary, pos, (pos - 1) / 2);
+        pos = (pos - 1) / 2;
+    }
+}
+
+static bool set_counter_value(SpaceSavingCounter *counter, uint64_t hash, const char *value, size_t length) {
+    if (length + 1 > counter->value_capacity) {
+        size_t capacity = length + 1 < 16 ? 16 : length + 1;
+        char *buffer = realloc(counter->value, capacity);
+        if (!buffer) return false;
+        counter->value = buffer;
+        counter->value_capacity = capacity;
+    }
+    memcpy(counter->value, value, length);
+    counter->value[length] = '\0';
+    counter->length = length;
+    counter->hash = hash;
+    return true;
+}
+
+// Gives a value a counter: a free one while there is room, otherwise the
+// smallest, which must be worth less than 'count'.
+static bool claim_counter(SpaceSaving *summary, uint64_t hash, const char *value, size_t length,
+                          size_t count, size_t error) {
+    uint32_t index;
+    if (summary->size < summary->capacity) {
+        index = (uint32_t)summary->size;
+        if (!set_counter_value(&summary->counters[index], hash, value, length)) return false;
+        summary->heap[summary->size] = index;
+        summary->counters[index].heap_pos = (uint32_t)summary->size;
+        summary->size++;
+    } else {
+        index = summary->heap[0];
+        remove_slot(summary, index);
+        if (!set_counter_value(&summary->counters[index], hash, value, length)) {
+            // Keep the table consistent; the counter still holds its old value.
+            insert_slot(summary, index);
+            return false;
+        }
+    }
+    summary->counters[index].count = count;
+    summary->counters[index].error = error;
+    insert_slot(summary, index);
+    sift_up(summary, summary->counters[index].heap_pos);
+    sift_down(summary, summary->counters[index].heap_pos);
+    return true;
+}
+
+bool space_saving_add(SpaceSaving *summary, uint64_t hash, const char *value, size_t length) {
+    summary->total++;
+    uint32_t index = find_counter(summary, hash, value, length);
+    if (index != NO_COUNTER) {
+        summary->counters[index].count++;
+        sift_down(summary, summary->counters[index].heap_pos);
+        return true;
+    }
+    if (summary->size < summary->capacity) {
+        return claim_counter(summary, hash, value, length, 1, 0);
+    }
+    size_t smallest = heap_count(summary, 0);
+    return claim_counter(summary, hash, value, length, smallest + 1, smallest);
+}
+
+bool space_saving_merge(SpaceSaving *into, const SpaceSaving *from) {
+    size_t into_floor = into->size == into->capacity ? heap_count(into, 0) : 0;
+    size_t from_floor = from->size == from->capacity ? heap_count(from, 0) : 0;
+    bool *matched = calloc(from->size ? from->size : 1, sizeof(bool));
+    if (!matched) return false;
+
+    for (size_t i = 0; i < into->size; i++) {
+        SpaceSavingCounter *counter = &into->counters[i];
+        uint32_t other = find_counter(from, counter->hash, counter->value, counter->length);
+        if (other != NO_COUNTER) {
+            counter->count += from->counters[other].count;
+            counter->error += from->counters[other].error;
+            matched[other] = true;
+        } else {
+            counter->count += from_floor;
+            counter->error += from_floor;
+        }
+    }
+    for (size_t pos = into->size / 2; pos-- > 0; ) sift_down(into, pos);
+
+    // The rest of from's values compete for the remaining (or smallest) counters.
+    bool ok = true;
+    for (size_t i = 0; ok && i < from->size; i++) {
+        if (matched[i]) continue;
+        const SpaceSavingCounter *counter = &from->counters[i];
+        size_t count = counter->count + into_floor;
+        if (into->size == into->capacity && count <= heap_count(into, 0)) continue;
+        ok = claim_counter(into, counter->hash, counter->value, counter->length, count, counter->error + into_floor);
+    }
+    free(matched);
+    into->total += from->total;
+    return ok;
+}
+
+size_t space_saving_total(const SpaceSaving *summary) {
+    return summary->total;
+}
+
+static int compare_items(const void *a, const void *b) {
+    const SpaceSavingItem *itemA = (const SpaceSavingItem *)a;
+    const SpaceSavingItem *itemB = (const SpaceSavingItem *)b;
+    if (itemA->count != itemB->count) return itemA->count < itemB->count ? 1 : -1;
+    if (itemA->error != itemB->error) return itemA->error < itemB->error ? -1 : 1;
+    return strcmp(itemA->value, itemB->value);
+}
+
+size_t space_saving_items(const SpaceSaving *summary, SpaceSavingItem *items, size_t max) {
+    SpaceSavingItem *all = malloc((summary->size ? summary->size : 1) * sizeof(SpaceSavingItem));
+    if (!all) return 0;
+    for (size_t i = 0; i < summary->size; i++) {
+        const SpaceSavingCounter *counter = &summary->counters[i];
+        all[i] = (SpaceSavingItem){ counter->value, counter->length, counter->count, counter->error };
+    }
+    qsort(all, summary->size, sizeof(SpaceSavingItem), compare_items);
+    size_t n = summary->size < max ? summary->size : max;
+    memcpy(items, all, n * sizeof(SpaceSavingItem));
+    free(all);
+    return n;
+}
+
+// --- KLL ---
+
+#define KLL_K 200                  // Width of the top level
+#define KLL_MIN_WIDTH 8            // Lower levels never get narrower than this
+#define KLL_MAX_LEVELS 64
+
+struct KllSketch {
+    double *items[KLL_MAX_LEVELS]; // Level h holds values of weight 2^h
+    size_t sizes[KLL_MAX_LEVELS];
+    size_t allocated[KLL_MAX_LEVELS];
+    size_t capacities[KLL_MAX_LEVELS];
+    size_t level_count;
+    size_t size_total;             // Values held over all levels
+    size_t capacity_total;
+    size_t count;                  // Values added
+    uint64_t random;               // xorshift state for the compaction offsets
+};
+
+// Level widths shrink by 2/3 per level below the top.
+static void kll_update_capacities(KllSketch *sketch) {
+    sketch->capacity_total = 0;
+    for (size_t level = 0; level < sketch->level_count; level++) {
+        double width = KLL_K;
+        for (size_t depth = sketch->level_count - 1 - level; depth > 0; depth--) width *= 2.0 / 3.0;
+        size_t capacity = (size_t)width + 1;
+        if (capacity < KLL_MIN_WIDTH) capacity = KLL_MIN_WIDTH;
+        sketch->capacities[level] = capacity;
+        sketch->capacity_total += capacity;
+    }
+}
+
+KllSketch* kll_create(void) {
+    KllSketch *sketch = calloc(1, sizeof(KllSketch));
+    if (!sketch) return NULL;
+    sketch->level_count = 1;
+    sketch->random = 0x9E3779B97F4A7C15ULL;
+    kll_update_capacities(sketch);
+    return sketch;
+}
+
+void kll_free(KllSketch *sketch) {
+    if (!sketch) return;
+    for (size_t level = 0; level < sketch->level_count; level++) free(sketch->items[level]);
+    free(sketch);
+}
+
+static bool kll_reserve(KllSketch *sketch, size_t level, size_t extra) {
+    size_t needed = sketch->sizes[level] + extra;
+    if (needed <= sketch->allocated[level]) return true;
+    size_t allocated = sketch->allocated[level] ? sketch->allocated[level] * 2 : 16;
+    while (allocated < needed) allocated *= 2;
+    double *items = realloc(sketch->items[level], allocated * sizeof(double));
+    if (!items) return false;
+    sketch->items[level] = items;
+    sketch->allocated[level] = allocated;
+    return true;
+}
+
+static int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+// Compacts the lowest full level into the one above it.
+static bool kll_compact(KllSketch *sketch) {
+    size_t level = 0;
+    while (level < sketch->level_count && sketch->sizes[level] < sketch->capacities[level]) level++;
+    if (level == sketch->level_count) return true;
+    if (level + 1 == sketch->level_count) {
+        if (sketch->level_count == KLL_MAX_LEVELS) return false;
+        sketch->level_count++;
+        kll_update_capacities(sketch);
+    }
+
+    size_t pairs = sketch->sizes[level] / 2;
+    if (!kll_reserve(sketch, level + 1, pairs)) return false;
+    double *items = sketch->items[level];
+    qsort(items, sketch->sizes[level], sizeof(double), compare_doubles);
+
+    sketch->random ^= sketch->random << 13;
+    sketch->random ^= sketch->random >> 7;
+    sketch->random ^= sketch->random << 17;
+    size_t offset = (size_t)(sketch->random & 1);
+
+    // An odd value out stays behind with its weight.
+    size_t kept = sketch->sizes[level] % 2;
+    double leftover = kept ? items[sketch->sizes[level] - 1] : 0.0;
+    double *above = sketch->items[level + 1] + sketch->sizes[level + 1];
+    for (size_t i = 0; i < pairs; i++) above[i] = items[2 * i + offset];
+    sketch->sizes[level + 1] += pairs;
+    if (kept) items[0] = leftover;
+    sketch->size_total -= sketch->sizes[level] - kept - pairs;
+    sketch->sizes[level] = kept;
+    return true;
+}
+
+bool kll_add(KllSketch *sketch, double value) {
+    if (!kll_reserve(sketch, 0, 1)) return false;
+    sketch->items[0][sketch->sizes[0]++] = value;
+    sketch->size_total++;
+    sketch->count++;
+    while (sketch->size_total >= sketch->capacity_total) {
+        if (!kll_compact(sketch)) return false;
+    }
+    return true;
+}
+
+bool kll_merge(KllSketch *into, const KllSketch *from) {
+    if (from->level_count > into->level_count) {
+        into->level_count = from->level_count;
+        kll_update_capacities(into);
+    }
+    for (size_t level = 0; level < from->level_count; level++) {
+        if (!kll_reserve(into, level, from->sizes[level])) return false;
+        memcpy(into->items[level] + into->sizes[level], from->items[level], from->sizes[level] * sizeof(double));
+        into->sizes[level] += from->sizes[level];
+        into->size_total += from->sizes[level];
+    }
+    into->count += from->count;
+    while (into->size_total >= into->capacity_total) {
+        if (!kll_compact(into)) return false;
+    }
+    return true;
+}
+
+size_t kll_count(const KllSketch *sketch) {
+    return sketch->count;
+}
+
+// A held value and the number of stream values it stands for.
+typedef struct {
+    double value;
+    uint64_t weight;
+} KllWeighted;
+
+static int compare_weighted(const void *a, const void *b) {
+    return compare_doubles(&((const KllWeighted *)a)->value, &((const KllWeighted *)b)->value);
+}
+
+double kll_quantile(const KllSketch *sketch, double fraction) {
+    if (sketch->size_total == 0) return 0.0;
+    KllWeighted *all = malloc(sketch->size_total * sizeof(KllWeighted));
+    if (!all) return 0.0;
+    size_t n = 0;
+    for (size_t level = 0; level < sketch->level_count; level++) {
+        for (size_t i = 0; i < sketch->sizes[level]; i++) {
+            all[n++] = (KllWeighted){ sketch->items[level][i], (uint64_t)1 << level };
+        }
+    }
+    qsort(all, n, sizeof(KllWeighted), compare_weighted);
+
+    if (fraction < 0.0) fraction = 0.0;
+    if (fraction > 1.0) fraction = 1.0;
+    double target = fraction * (double)sketch->count;
+    uint64_t seen = 0;
+    double result = all[n - 1].value;
+    for (size_t i = 0; i < n; i++) {
+        seen += all[i].weight;
+        if ((double)seen >= target) {
+            result = all[i].value;
+            break;
+        }
+    }
+    free(all);
+    return result;
+}
+
+double kll_rank(const KllSketch *sketch, double value) {
+    if (sketch->count == 0) return 0.0;
+    uint64_t below = 0;
+    for (size_t level = 0; level < sketch->level_count; level++) {
+        for (size_t i = 0; i < sketch->sizes[level]; i++) {
+            if (sketch->items[level][i] <= value) below += (uint64_t)1 << level;
+        }
+    }
+    return (double)below / (double)sketch->count;
+}
+
+double kll_rank_error(void) {
+    return 0.0133; // Empirical normalized rank error for KLL_K = 200
+}
@@ -4,148 +4,1264 @@
 #include "ui/view_manager.h"
 #include "util/utils.h"
 #include "util/logging.h"
+#include "util/parallel.h"
+#include "memory/arena.h"
 #include "app_init.h"
+#include "memory/constants.h"
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/mman.h>
 
 // --- Data Structures for Sorting ---
 
-// Represents a pre-computed sort key for a single row.
-// This is the "decorate" part of the Schwartzian Transform.
-typedef union {
-    long long numeric_key;
-    char* string_key;
-} SortKey;
-
-// Struct to hold the decorated row information
+// A pre-computed sort key for a single row: the "decorate" part of the
+// Schwartzian Transform. Every row's key tuple is encoded into one byte
+// string that compares correctly with memcmp (see encode_sort_key). Its first
+// 8 bytes are packed big-endian into 'key', so most comparisons never leave
+// the row itself and rows can be radix sorted; only the remainder lives in
+// an arena.
 typedef struct {
-    SortKey key;
-    bool is_numeric;
-    size_t original_index; // Original index within the visible set
+    uint64_t key;               // First 8 bytes of the normalized key, zero padded
+    const unsigned char *rest;  // uint32_t length + remaining key bytes, NULL if none
+    size_t original_index;      // Original index within the visible set
 } DecoratedRow;
 
+#define SORT_PREFIX_BYTES 8
+#define SORT_TEXT_KEY_MAX 4096
+
+// Room for one column's encoded key. Collation keys run several bytes per
+// character, so they get more space than the rendered text.
+#define SORT_COLUMN_KEY_MAX (4 * SORT_TEXT_KEY_MAX + 1)
+#define SORT_ROW_KEY_MAX(plan_count) ((plan_count) * SORT_COLUMN_KEY_MAX)
+
+// Set from the sort_collation config option; see sort_set_locale_collation.
+static bool g_locale_collation = false;
+
+void sort_set_locale_collation(bool enabled) {
+    g_locale_collation = enabled;
+}
+
+// How one column of the sort spec is encoded.
+typedef struct {
+    int column;
+    bool numeric;
+    bool collate;    // Text ordered by LC_COLLATE instead of folded bytes
+    bool descending; // Invert the encoded bytes
+} SortColumnPlan;
+
+// Writes the strxfrm collation key of 'text' to 'out', which holds
+// SORT_COLUMN_KEY_MAX bytes, and returns its length. Text whose key would
+// not fit is shortened until it does, so very long cells still order by
+// their leading characters.
+static size_t encode_collation_key(char *text, unsigned char *out) {
+    size_t text_length = strlen(text);
+    for (;;) {
+        size_t length = strxfrm((char *)out, text, SORT_COLUMN_KEY_MAX - 1);
+        if (length < SORT_COLUMN_KEY_MAX - 1) return length;
+        text_length /= 2;
+        text[text_length] = '\0';
+    }
+}
+
+// Appends the normalized key of one cell to 'out' and returns its length.
+// Numbers become 8 big-endian bytes with the sign bit flipped, so unsigned
+// byte order matches numeric order. Text is folded as strcasecmp folds it, or
+// replaced by its locale collation key, and terminated with a 0 byte, which
+// sorts a string before its extensions and keeps the encoding of the next
+// column aligned. Descending columns invert every byte.
+static size_t encode_sort_key(const SortColumnPlan *plan, char *text, unsigned char *out) {
+    size_t length = 0;
+    if (plan->numeric) {
+        uint64_t value = (uint64_t)strtoll(text, NULL, 10) ^ ((uint64_t)1 << 63);
+        for (int shift = 56; shift >= 0; shift -= 8) out[length++] = (unsigned char)(value >> shift);
+    } else if (plan->collate) {
+        length = encode_collation_key(text, out);
+        out[length++] = 0;
+    } else {
+        for (; text[length] != '\0'; length++) out[length] = (unsigned char)tolower((unsigned char)text[length]);
+        out[length++] = 0;
+    }
+    if (plan->descending) {
+        for (size_t i = 0; i < length; i++) out[i] = (unsigned char)~out[i];
+    }
+    return length;
+}
+
+static size_t rest_length(const unsigned char *rest) {
+    uint32_t length = 0;
+    if (rest) memcpy(&length, rest, sizeof(length));
+    return length;
+}
+
 
 // --- Sorting Helpers ---
 
-// Checks if a column is numeric by inspecting all of its visible rows.
-static bool is_column_numeric(View *view, int column_index) {
-    if (!view || view->visible_row_count == 0) return false;
+// Rows per chunk below which splitting a column scan across threads does not pay off.
+#define MIN_ROWS_PER_SCAN_CHUNK 4096
+
+typedef struct {
+    View *view;
+    int column_index;
+    size_t chunk_count;
+    int non_numeric_found; // Set by any chunk that sees a text value
+} NumericScanJob;
+
+static void scan_numeric_chunk(void *arg, size_t chunk) {
+    NumericScanJob *job = (NumericScanJob *)arg;
+    size_t begin, end;
+    parallel_chunk_bounds(job->view->visible_row_count, job->chunk_count, chunk, &begin, &end);
+
+    DataSourceCursor *cursor = data_source_open_cursor(job->view->data_source);
+    if (!cursor) {
+        __atomic_store_n(&job->non_numeric_found, 1, __ATOMIC_RELAXED);
+        return;
+    }
 
-    DataSource *ds = view->data_source;
-    // Check every visible row to make an accurate decision.
-    size_t num_rows_to_check = view->visible_row_count;
     char buffer[4096];
+    ViewRowIterator it;
+    view_row_iterator_init(&it, job->view, begin, end - begin);
+    size_t row;
+    size_t scanned = 0;
+    while ((row = view_row_iterator_next(&it)) != SIZE_MAX) {
+        // Another chunk already decided the answer.
+        if ((++scanned & 1023) == 0 && __atomic_load_n(&job->non_numeric_found, __ATOMIC_RELAXED)) break;
 
-    for (size_t i = 0; i < num_rows_to_check; i++) {
-        // We must check the actual row from the source, not the displayed/sorted one.
-        size_t actual_row_index = view_get_actual_row_index(view, i);
-        if (actual_row_index == SIZE_MAX) continue;
+        FieldDesc fd = data_source_cursor_get_cell(cursor, row, job->column_index);
 
-        FieldDesc fd = ds->ops->get_cell(ds->context, actual_row_index, column_index);
-        
         // Treat empty cells as neutral; they don't disqualify a numeric column.
         if (fd.start == NULL || fd.length == 0) continue;
 
         render_field(&fd, buffer, sizeof(buffer));
-        
+
         // If we find any value that isn't purely numeric (ignoring whitespace),
         // the entire column is treated as text.
         if (!is_string_numeric(buffer)) {
-            return false;
+            __atomic_store_n(&job->non_numeric_found, 1, __ATOMIC_RELAXED);
+            break;
         }
     }
-    
-    // All checked values were numeric.
-    return true;
+
+    data_source_close_cursor(cursor);
 }
 
+// Checks if a column is numeric by inspecting all of its visible rows.
+// Sources with cursor support are scanned in parallel chunks.
+static bool is_column_numeric(View *view, int column_index) {
+    if (!view || view->visible_row_count == 0) return false;
+
+    NumericScanJob job = {
+        .view = view,
+        .column_index = column_index,
+        .chunk_count = 1,
+        .non_numeric_found = 0
+    };
+    if (data_source_supports_cursors(view->data_source)) {
+        job.chunk_count = parallel_chunk_count(view->visible_row_count, MIN_ROWS_PER_SCAN_CHUNK);
+    }
+
+    parallel_for(job.chunk_count, scan_numeric_chunk, &job);
+    return !job.non_numeric_found;
+}
 
-// Global variable to hold the current sort direction for qsort_r emulation
-static SortDirection g_current_sort_direction = SORT_ASC;
 
-// Unified comparison function for qsort
+// Ascending comparison with the original index as tie-breaker, so keys form
+// a total order. Descending results are produced by reading the ascending
+// order backwards, which keeps the comparator free of global state.
+static inline int compare_decorated_rows_inline(const DecoratedRow *row_a, const DecoratedRow *row_b) {
+    if (row_a->key != row_b->key) return row_a->key < row_b->key ? -1 : 1;
+
+    // Equal prefixes: the rest of the normalized key decides.
+    if (row_a->rest || row_b->rest) {
+        size_t length_a = rest_length(row_a->rest);
+        size_t length_b = rest_length(row_b->rest);
+        size_t common = length_a < length_b ? length_a : length_b;
+        int result = common > 0 ? memcmp(row_a->rest + sizeof(uint32_t), row_b->rest + sizeof(uint32_t), common) : 0;
+        if (result != 0) return result;
+        if (length_a != length_b) return length_a < length_b ? -1 : 1;
+    }
+
+    if (row_a->original_index < row_b->original_index) return -1;
+    return row_a->original_index > row_b->original_index ? 1 : 0;
+}
+
 static int compare_decorated_rows(const void *a, const void *b) {
-    const DecoratedRow *row_a = (const DecoratedRow *)a;
-    const DecoratedRow *row_b = (const DecoratedRow *)b;
-    
-    int result = 0;
-    
-    if (row_a->is_numeric) {
-        // Numeric comparison
-        if (row_a->key.numeric_key < row_b->key.numeric_key) {
-            result = -1;
-        } else if (row_a->key.numeric_key > row_b->key.numeric_key) {
-            result = 1;
+    return compare_decorated_rows_inline((const DecoratedRow *)a, (const DecoratedRow *)b);
+}
+
+
+// --- Sort Kernels ---
+
+#define RADIX_BITS 8
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+#define RADIX_PASSES (64 / RADIX_BITS)
+
+// Below this many rows a comparison sort beats the radix passes.
+#define MIN_ROWS_FOR_RADIX 256
+
+// Stable LSD radix sort on the 64-bit key. Rows start in original index
+// order, so stability alone provides the tie-break for keys that fit in it. Passes
+// whose digit is the same for every row are skipped. The result always ends
+// up in 'rows'; 'scratch' must hold 'count' rows.
+static void radix_sort_rows(DecoratedRow *rows, DecoratedRow *scratch, size_t count) {
+    size_t (*histograms)[RADIX_BUCKETS] = calloc(RADIX_PASSES, sizeof(*histograms));
+    if (!histograms) {
+        qsort(rows, count, sizeof(DecoratedRow), compare_decorated_rows);
+        return;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        uint64_t key = rows[i].key;
+        for (int pass = 0; pass < RADIX_PASSES; pass++) {
+            histograms[pass][(key >> (pass * RADIX_BITS)) & (RADIX_BUCKETS - 1)]++;
+        }
+    }
+
+    DecoratedRow *src = rows, *dst = scratch;
+    for (int pass = 0; pass < RADIX_PASSES; pass++) {
+        size_t *histogram = histograms[pass];
+        int shift = pass * RADIX_BITS;
+        if (histogram[(src[0].key >> shift) & (RADIX_BUCKETS - 1)] == count) continue;
+
+        size_t offset = 0;
+        for (int bucket = 0; bucket < RADIX_BUCKETS; bucket++) {
+            size_t bucket_count = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += bucket_count;
+        }
+        for (size_t i = 0; i < count; i++) {
+            dst[histogram[(src[i].key >> shift) & (RADIX_BUCKETS - 1)]++] = src[i];
+        }
+
+        DecoratedRow *swap = src;
+        src = dst;
+        dst = swap;
+    }
+
+    if (src != rows) memcpy(rows, src, count * sizeof(DecoratedRow));
+    free(histograms);
+}
+
+// Sorts one run in place. Rows are radix sorted on the key prefix first;
+// only groups sharing the prefix with a longer key then need comparisons.
+static void sort_rows_kernel(DecoratedRow *rows, DecoratedRow *scratch, size_t count) {
+    if (count < MIN_ROWS_FOR_RADIX || !scratch) {
+        qsort(rows, count, sizeof(DecoratedRow), compare_decorated_rows);
+        return;
+    }
+
+    radix_sort_rows(rows, scratch, count);
+
+    for (size_t begin = 0; begin < count; ) {
+        bool has_rest = rows[begin].rest != NULL;
+        size_t end = begin + 1;
+        while (end < count && rows[end].key == rows[begin].key) {
+            has_rest |= rows[end].rest != NULL;
+            end++;
+        }
+        // Keys that fit entirely in the prefix are already in index order.
+        if (end - begin > 1 && has_rest) {
+            qsort(rows + begin, end - begin, sizeof(DecoratedRow), compare_decorated_rows);
+        }
+        begin = end;
+    }
+}
+
+
+// --- Parallel Decorate ---
+
+// Rows per chunk below which decorating or sorting in parallel does not pay off.
+#define MIN_ROWS_PER_SORT_CHUNK 4096
+
+typedef struct {
+    View *view;
+    const SortColumnPlan *plan;
+    size_t plan_count;
+    size_t first_row;    // Visible-set index of rows[0]
+    size_t row_count;
+    size_t chunk_count;
+    DecoratedRow *rows;
+    Arena *key_arenas;   // One per chunk; holds the key remainders
+    int failed;
+} DecorateJob;
+
+// Encodes the full normalized key of one row into 'key' and returns its length.
+// 'key' must hold SORT_ROW_KEY_MAX(plan_count) bytes.
+static size_t encode_row_key(const SortColumnPlan *plan, size_t plan_count, DataSourceCursor *cursor,
+                             size_t row, unsigned char *key, char *render_buffer) {
+    size_t length = 0;
+    for (size_t k = 0; k < plan_count; k++) {
+        FieldDesc fd = data_source_cursor_get_cell(cursor, row, plan[k].column);
+        render_field(&fd, render_buffer, SORT_TEXT_KEY_MAX);
+        length += encode_sort_key(&plan[k], render_buffer, key + length);
+    }
+    return length;
+}
+
+static void decorate_chunk(void *arg, size_t chunk) {
+    DecorateJob *job = (DecorateJob *)arg;
+    View *view = job->view;
+    size_t begin, end;
+    parallel_chunk_bounds(job->row_count, job->chunk_count, chunk, &begin, &end);
+
+    DataSourceCursor *cursor = data_source_open_cursor(view->data_source);
+    unsigned char *key = malloc(SORT_ROW_KEY_MAX(job->plan_count));
+    if (!cursor || !key) {
+        __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+        data_source_close_cursor(cursor);
+        free(key);
+        return;
+    }
+
+    char render_buffer[SORT_TEXT_KEY_MAX];
+    ViewRowIterator it;
+    view_row_iterator_init(&it, view, job->first_row + begin, end - begin);
+    size_t row;
+    for (size_t i = begin; (row = view_row_iterator_next(&it)) != SIZE_MAX; i++) {
+        DecoratedRow *decorated = &job->rows[i];
+        decorated->original_index = job->first_row + i;
+
+        size_t length = encode_row_key(job->plan, job->plan_count, cursor, row, key, render_buffer);
+
+        decorated->key = 0;
+        for (size_t b = 0; b < SORT_PREFIX_BYTES; b++) {
+            decorated->key = (decorated->key << 8) | (b < length ? key[b] : 0);
+        }
+
+        decorated->rest = NULL;
+        if (length > SORT_PREFIX_BYTES) {
+            uint32_t remaining = (uint32_t)(length - SORT_PREFIX_BYTES);
+            unsigned char *rest = arena_alloc(&job->key_arenas[chunk], sizeof(uint32_t) + remaining);
+            if (!rest) {
+                LOG_ERROR("Failed to allocate memory for sort key.");
+                continue; // Fallback: sort on the prefix only
+            }
+            memcpy(rest, &remaining, sizeof(remaining));
+            memcpy(rest + sizeof(remaining), key + SORT_PREFIX_BYTES, remaining);
+            decorated->rest = rest;
+        }
+    }
+
+    free(key);
+    data_source_close_cursor(cursor);
+}
+
+
+// --- Parallel Merge Sort ---
+
+// Runs are sorted independently, then merged pairwise. Each pairwise merge is
+// cut into pieces along the merge path so even the final merge of two huge
+// runs is spread over all workers.
+
+typedef struct {
+    const DecoratedRow *a;
+    size_t a_count;
+    const DecoratedRow *b;
+    size_t b_count;
+    DecoratedRow *out;
+    size_t out_begin;    // Slice of the merged output this task produces
+    size_t out_end;
+} MergeTask;
+
+typedef struct {
+    DecoratedRow *rows;
+    DecoratedRow *scratch;
+    size_t row_count;
+    size_t run_count;
+    MergeTask *tasks;
+} SortJob;
+
+static void sort_run(void *arg, size_t run) {
+    SortJob *job = (SortJob *)arg;
+    size_t begin, end;
+    parallel_chunk_bounds(job->row_count, job->run_count, run, &begin, &end);
+    sort_rows_kernel(job->rows + begin, job->scratch ? job->scratch + begin : NULL, end - begin);
+}
+
+// Returns how many elements of 'a' are among the first 'diagonal' elements of
+// the merge of 'a' and 'b'.
+static size_t merge_path_split(const DecoratedRow *a, size_t a_count,
+                               const DecoratedRow *b, size_t b_count, size_t diagonal) {
+    size_t lo = diagonal > b_count ? diagonal - b_count : 0;
+    size_t hi = diagonal < a_count ? diagonal : a_count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (compare_decorated_rows_inline(&a[mid], &b[diagonal - mid - 1]) < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+static void merge_slice(void *arg, size_t task_index) {
+    const MergeTask *task = &((SortJob *)arg)->tasks[task_index];
+    size_t i = merge_path_split(task->a, task->a_count, task->b, task->b_count, task->out_begin);
+    size_t j = task->out_begin - i;
+    size_t i_end = merge_path_split(task->a, task->a_count, task->b, task->b_count, task->out_end);
+    size_t j_end = task->out_end - i_end;
+
+    DecoratedRow *out = task->out + task->out_begin;
+    while (i < i_end && j < j_end) {
+        if (compare_decorated_rows_inline(&task->a[i], &task->b[j]) < 0) {
+            *out++ = task->a[i++];
+        } else {
+            *out++ = task->b[j++];
         }
+    }
+    while (i < i_end) *out++ = task->a[i++];
+    while (j < j_end) *out++ = task->b[j++];
+}
+
+// Sorts rows ascending. Returns the buffer holding the result, which is
+// either 'rows' or 'scratch'.
+static DecoratedRow* parallel_sort_rows(DecoratedRow *rows, DecoratedRow *scratch, size_t count) {
+    size_t run_count = scratch ? parallel_chunk_count(count, MIN_ROWS_PER_SORT_CHUNK) : 1;
+    SortJob job = { .rows = rows, .scratch = scratch, .row_count = count, .run_count = run_count, .tasks = NULL };
+    parallel_for(run_count, sort_run, &job);
+    if (run_count <= 1) return rows;
+
+    // Every round produces one merge slice per run.
+    job.tasks = malloc(run_count * sizeof(MergeTask));
+    if (!job.tasks) {
+        LOG_WARN("Falling back to a single-threaded sort");
+        qsort(rows, count, sizeof(DecoratedRow), compare_decorated_rows);
+        return rows;
+    }
+
+    DecoratedRow *src = rows, *dst = scratch;
+    for (size_t width = 1; width < run_count; width *= 2) {
+        size_t task_count = 0;
+        for (size_t first = 0; first < run_count; first += 2 * width) {
+            size_t mid_run = first + width < run_count ? first + width : run_count;
+            size_t last_run = first + 2 * width < run_count ? first + 2 * width : run_count;
+            size_t begin, mid, end, unused;
+            parallel_chunk_bounds(count, run_count, first, &begin, &unused);
+            parallel_chunk_bounds(count, run_count, mid_run - 1, &unused, &mid);
+            parallel_chunk_bounds(count, run_count, last_run - 1, &unused, &end);
+
+            // One slice per run covered, so every round keeps all workers busy.
+            size_t slices = last_run - first;
+            size_t length = end - begin;
+            for (size_t s = 0; s < slices; s++) {
+                MergeTask *task = &job.tasks[task_count++];
+                task->a = src + begin;
+                task->a_count = mid - begin;
+                task->b = src + mid;
+                task->b_count = end - mid;
+                task->out = dst + begin;
+                task->out_begin = length * s / slices;
+                task->out_end = length * (s + 1) / slices;
+            }
+        }
+        parallel_for(task_count, merge_slice, &job);
+
+        DecoratedRow *swap = src;
+        src = dst;
+        dst = swap;
+    }
+
+    free(job.tasks);
+    return src;
+}
+
+
+// --- Permutation Cache ---
+
+// Ascending permutations are kept for a few recent sort specs per view.
+#define MAX_CACHED_SORTS 4
+
+typedef struct {
+    SortKeySpec keys[MAX_SORT_KEYS]; // Single-key specs are stored as ASC
+    size_t key_count;
+    size_t *order;                   // Visible-set indices in ascending key order
+    size_t row_count;
+    unsigned long last_used;
+} CachedSort;
+
+struct SortCache {
+    CachedSort entries[MAX_CACHED_SORTS];
+    size_t count;
+    unsigned long clock;
+};
+
+// A single key is always sorted ascending and read backwards for DESC, so
+// that DESC stays the exact reverse of ASC; both directions share one entry.
+// Composite keys carry each column's direction in the encoding.
+static size_t cache_spec_for_view(const View *view, SortKeySpec *keys) {
+    memcpy(keys, view->sort_keys, view->sort_key_count * sizeof(SortKeySpec));
+    if (view->sort_key_count == 1) keys[0].direction = SORT_ASC;
+    return view->sort_key_count;
+}
+
+static CachedSort* find_cached_sort(View *view, const SortKeySpec *keys, size_t key_count) {
+    struct SortCache *cache = view->sort_cache;
+    if (!cache) return NULL;
+    for (size_t i = 0; i < cache->count; i++) {
+        CachedSort *entry = &cache->entries[i];
+        if (entry->key_count == key_count && entry->row_count == view->visible_row_count &&
+            memcmp(entry->keys, keys, key_count * sizeof(SortKeySpec)) == 0) {
+            entry->last_used = ++cache->clock;
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+// Takes ownership of 'order'; evicts the least recently used entry if full.
+static void store_cached_sort(View *view, const SortKeySpec *keys, size_t key_count, size_t *order) {
+    if (!view->sort_cache) {
+        view->sort_cache = calloc(1, sizeof(struct SortCache));
+        if (!view->sort_cache) {
+            free(order);
+            return;
+        }
+    }
+    struct SortCache *cache = view->sort_cache;
+    CachedSort *entry = &cache->entries[cache->count];
+    if (cache->count == MAX_CACHED_SORTS) {
+        entry = &cache->entries[0];
+        for (size_t i = 1; i < MAX_CACHED_SORTS; i++) {
+            if (cache->entries[i].last_used < entry->last_used) entry = &cache->entries[i];
+        }
+        free(entry->order);
     } else {
-        // Case-insensitive string comparison
-        result = strcasecmp(row_a->key.string_key, row_b->key.string_key);
+        cache->count++;
+    }
+
+    memcpy(entry->keys, keys, key_count * sizeof(SortKeySpec));
+    entry->key_count = key_count;
+    entry->order = order;
+    entry->row_count = view->visible_row_count;
+    entry->last_used = ++cache->clock;
+}
+
+static void discard_pending_sort(View *view);
+
+void sort_cache_clear(View *view) {
+    if (!view) return;
+    discard_pending_sort(view);
+    if (!view->sort_cache) return;
+    for (size_t i = 0; i < view->sort_cache->count; i++) {
+        free(view->sort_cache->entries[i].order);
     }
-    
-    // If primary keys are equal, use original_index as stable tie-breaker
-    if (result == 0) {
-        if (row_a->original_index < row_b->original_index) {
-            result = -1;
-        } else if (row_a->original_index > row_b->original_index) {
-            result = 1;
+    SAFE_FREE(view->sort_cache);
+}
+
+// Fills the view's row_order_map from an ascending permutation.
+static void apply_permutation(View *view, const size_t *order) {
+    size_t count = view->visible_row_count;
+    if (!view->row_order_map) {
+        view->row_order_map = malloc(count * sizeof(size_t));
+        if (!view->row_order_map) {
+            LOG_ERROR("Failed to allocate row_order_map for sorting.");
+            return;
         }
     }
-    
-    // Adjust for descending sort direction
-    if (g_current_sort_direction == SORT_DESC) {
-        result = -result;
+
+    if (view->sort_key_count == 1 && view->sort_keys[0].direction == SORT_DESC) {
+        for (size_t i = 0; i < count; i++) {
+            view->row_order_map[i] = order[count - 1 - i];
+        }
+    } else {
+        memcpy(view->row_order_map, order, count * sizeof(size_t));
     }
-    
-    return result;
+    view->order_version++;
+    view_build_reverse_map(view);
+}
+
+// Decorated rows of a view together with the arenas their keys live in.
+typedef struct {
+    DecoratedRow *rows;
+    size_t count;
+    Arena *key_arenas;
+    size_t arena_count;
+} DecoratedSet;
+
+static void free_decorated_set(DecoratedSet *set) {
+    for (size_t i = 0; i < set->arena_count; i++) arena_free(&set->key_arenas[i]);
+    free(set->key_arenas);
+    free(set->rows);
+    memset(set, 0, sizeof(*set));
 }
 
-bool is_column_sorted(View *view, int column_index, SortDirection direction) {
-    if (!view || view->visible_row_count <= 1) return true;
+// Resolves how each key column is encoded. Column types are decided once
+// for the whole view so every batch of an external sort agrees.
+static void build_sort_plan(View *view, const SortKeySpec *keys, size_t key_count, SortColumnPlan *plan) {
+    for (size_t k = 0; k < key_count; k++) {
+        plan[k].column = keys[k].column;
+        plan[k].descending = keys[k].direction == SORT_DESC;
+
+        // Every row of the column is about to be read.
+        data_source_prepare_column(view->data_source, plan[k].column);
+        plan[k].numeric = is_column_numeric(view, plan[k].column);
+        plan[k].collate = !plan[k].numeric && g_locale_collation;
+    }
+}
 
-    bool is_numeric = is_column_numeric(view, column_index);
-    char buffer_a[4096], buffer_b[4096];
-    DataSource *ds = view->data_source;
+// --- 1. DECORATE ---
+// Decorates 'count' visible rows starting at visible index 'first_row'.
+static bool decorate_rows(View *view, const SortColumnPlan *plan, size_t plan_count,
+                          size_t first_row, size_t count, DecoratedSet *set) {
+    memset(set, 0, sizeof(*set));
+    set->count = count;
+    set->rows = malloc(set->count * sizeof(DecoratedRow));
+    if (!set->rows) {
+        LOG_ERROR("Failed to allocate for decorated rows.");
+        return false;
+    }
 
-    for (size_t i = 0; i < view->visible_row_count - 1; i++) {
-        size_t actual_row_a = view_get_displayed_row_index(view, i);
-        size_t actual_row_b = view_get_displayed_row_index(view, i + 1);
+    DecorateJob job = {
+        .view = view,
+        .plan = plan,
+        .plan_count = plan_count,
+        .first_row = first_row,
+        .row_count = count,
+        .chunk_count = 1,
+        .rows = set->rows,
+        .failed = 0
+    };
+    if (data_source_supports_cursors(view->data_source)) {
+        job.chunk_count = parallel_chunk_count(set->count, MIN_ROWS_PER_SORT_CHUNK);
+    }
+    job.key_arenas = malloc(job.chunk_count * sizeof(Arena));
+    if (!job.key_arenas) {
+        LOG_ERROR("Failed to allocate sort key arenas.");
+        free_decorated_set(set);
+        return false;
+    }
+    for (size_t i = 0; i < job.chunk_count; i++) arena_init(&job.key_arenas[i], 0);
+    set->key_arenas = job.key_arenas;
+    set->arena_count = job.chunk_count;
 
-        FieldDesc fd_a = ds->ops->get_cell(ds->context, actual_row_a, column_index);
-        FieldDesc fd_b = ds->ops->get_cell(ds->context, actual_row_b, column_index);
+    parallel_for(job.chunk_count, decorate_chunk, &job);
+    if (job.failed) {
+        LOG_ERROR("Failed to sort view: could not read column");
+        free_decorated_set(set);
+        return false;
+    }
+    return true;
+}
 
-        render_field(&fd_a, buffer_a, sizeof(buffer_a));
-        render_field(&fd_b, buffer_b, sizeof(buffer_b));
+// --- 2. SORT and 3. UNDECORATE ---
+// Returns the ascending permutation of the decorated rows, or NULL.
+static size_t* sort_decorated_set(DecoratedSet *set) {
+    // The scratch buffer is optional; without it the sort runs on one thread
+    // and falls back to comparisons only.
+    DecoratedRow *scratch = set->count >= MIN_ROWS_FOR_RADIX ? malloc(set->count * sizeof(DecoratedRow)) : NULL;
+    DecoratedRow *sorted = parallel_sort_rows(set->rows, scratch, set->count);
 
-        int comparison_result;
-        if (is_numeric) {
-            long long val_a = strtoll(buffer_a, NULL, 10);
-            long long val_b = strtoll(buffer_b, NULL, 10);
-            if (val_a < val_b) comparison_result = -1;
-            else if (val_a > val_b) comparison_result = 1;
-            else comparison_result = 0;
+    size_t *order = malloc(set->count * sizeof(size_t));
+    if (!order) {
+        LOG_ERROR("Failed to sort view: out of memory");
+    } else {
+        for (size_t i = 0; i < set->count; i++) {
+            order[i] = sorted[i].original_index;
+        }
+    }
+    free(scratch);
+    return order;
+}
+
+
+// --- Progressive Sort ---
+
+// Views at least this large show their top rows first and finish sorting in
+// the background.
+#define PROGRESSIVE_SORT_MIN_ROWS 262144
+
+// Rows ordered up front: a screen plus a generous margin for scrolling.
+#define PROGRESSIVE_SORT_TOP_ROWS 1024
+
+struct PendingSort {
+    pthread_t thread;
+    SortKeySpec keys[MAX_SORT_KEYS]; // Cache spec being sorted
+    size_t key_count;
+    DecoratedSet set;
+    size_t *order;       // Ascending permutation, set by the worker
+    size_t ready_rows;   // Displayed rows already in their final position
+    int done;            // Set by the worker once 'order' is final
+};
+
+// Orders rows as they will be displayed: ascending, or descending for a
+// single DESC key (which is read backwards from the ascending order).
+static inline int compare_display_order(const DecoratedRow *a, const DecoratedRow *b, bool reverse) {
+    int result = compare_decorated_rows_inline(a, b);
+    return reverse ? -result : result;
+}
+
+static int compare_decorated_rows_reverse(const void *a, const void *b) {
+    return compare_decorated_rows_inline((const DecoratedRow *)b, (const DecoratedRow *)a);
+}
+
+typedef struct {
+    const DecoratedSet *set;
+    size_t chunk_count;
+    size_t k;
+    bool reverse;
+    DecoratedRow *candidates;   // k slots per chunk
+    size_t *candidate_counts;
+} TopRowsJob;
+
+static void heap_sift_down(DecoratedRow *heap, size_t size, size_t i, bool reverse) {
+    for (;;) {
+        size_t worst = i, left = 2 * i + 1, right = left + 1;
+        if (left < size && compare_display_order(&heap[left], &heap[worst], reverse) > 0) worst = left;
+        if (right < size && compare_display_order(&heap[right], &heap[worst], reverse) > 0) worst = right;
+        if (worst == i) return;
+        DecoratedRow tmp = heap[i];
+        heap[i] = heap[worst];
+        heap[worst] = tmp;
+        i = worst;
+    }
+}
+
+// Keeps the chunk's first k rows (in display order) in a bounded max-heap.
+static void select_top_chunk(void *arg, size_t chunk) {
+    TopRowsJob *job = (TopRowsJob *)arg;
+    size_t begin, end;
+    parallel_chunk_bounds(job->set->count, job->chunk_count, chunk, &begin, &end);
+
+    DecoratedRow *heap = job->candidates + chunk * job->k;
+    size_t size = 0;
+    for (size_t i = begin; i < end; i++) {
+        const DecoratedRow *row = &job->set->rows[i];
+        if (size < job->k) {
+            heap[size++] = *row;
+            if (size == job->k) {
+                for (size_t h = size / 2; h-- > 0; ) heap_sift_down(heap, size, h, job->reverse);
+            }
+        } else if (compare_display_order(row, &heap[0], job->reverse) < 0) {
+            heap[0] = *row;
+            heap_sift_down(heap, size, 0, job->reverse);
+        }
+    }
+    job->candidate_counts[chunk] = size;
+}
+
+// Returns the visible-set indices of the first k displayed rows, in order.
+static size_t* select_top_rows(const DecoratedSet *set, size_t k, bool reverse) {
+    TopRowsJob job = {
+        .set = set,
+        .chunk_count = parallel_chunk_count(set->count, MIN_ROWS_PER_SORT_CHUNK),
+        .k = k,
+        .reverse = reverse,
+    };
+    job.candidates = malloc(job.chunk_count * k * sizeof(DecoratedRow));
+    job.candidate_counts = calloc(job.chunk_count, sizeof(size_t));
+    size_t *top = malloc(k * sizeof(size_t));
+    if (!job.candidates || !job.candidate_counts || !top) {
+        free(job.candidates);
+        free(job.candidate_counts);
+        free(top);
+        return NULL;
+    }
+
+    parallel_for(job.chunk_count, select_top_chunk, &job);
+
+    // Compact the per-chunk winners and order them.
+    size_t total = 0;
+    for (size_t c = 0; c < job.chunk_count; c++) {
+        memmove(job.candidates + total, job.candidates + c * k, job.candidate_counts[c] * sizeof(DecoratedRow));
+        total += job.candidate_counts[c];
+    }
+    qsort(job.candidates, total, sizeof(DecoratedRow),
+          reverse ? compare_decorated_rows_reverse : compare_decorated_rows);
+    for (size_t i = 0; i < k; i++) top[i] = job.candidates[i].original_index;
+
+    free(job.candidates);
+    free(job.candidate_counts);
+    return top;
+}
+
+static void* progressive_sort_worker(void *arg) {
+    struct PendingSort *pending = (struct PendingSort *)arg;
+    pending->order = sort_decorated_set(&pending->set);
+    __atomic_store_n(&pending->done, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+// Installs the result of a background sort, waiting for it if 'wait' is
+// set. Returns true if no sort is pending afterwards.
+static bool finish_pending_sort(View *view, bool wait) {
+    struct PendingSort *pending = view->pending_sort;
+    if (!pending) return true;
+    if (!wait && !__atomic_load_n(&pending->done, __ATOMIC_ACQUIRE)) return false;
+
+    pthread_join(pending->thread, NULL);
+    view->pending_sort = NULL;
+    free_decorated_set(&pending->set);
+    if (pending->order) {
+        apply_permutation(view, pending->order);
+        store_cached_sort(view, pending->keys, pending->key_count, pending->order);
+    }
+    free(pending);
+    return true;
+}
+
+static void discard_pending_sort(View *view) {
+    struct PendingSort *pending = view->pending_sort;
+    if (!pending) return;
+    pthread_join(pending->thread, NULL);
+    view->pending_sort = NULL;
+    free_decorated_set(&pending->set);
+    free(pending->order);
+    free(pending);
+}
+
+// Shows the top rows right away and sorts the rest on a background thread.
+// Returns false if that could not be set up; 'set' is left untouched then.
+static bool start_progressive_sort(View *view, const SortKeySpec *keys, size_t key_count, DecoratedSet *set) {
+    size_t count = set->count;
+    bool reverse = view->sort_key_count == 1 && view->sort_keys[0].direction == SORT_DESC;
+    size_t k = count < PROGRESSIVE_SORT_TOP_ROWS ? count : PROGRESSIVE_SORT_TOP_ROWS;
+
+    struct PendingSort *pending = calloc(1, sizeof(struct PendingSort));
+    size_t *top = select_top_rows(set, k, reverse);
+    bool *placed = calloc(count, sizeof(bool));
+    if (!view->row_order_map) view->row_order_map = malloc(count * sizeof(size_t));
+    if (!pending || !top || !placed || !view->row_order_map) {
+        free(pending);
+        free(top);
+        free(placed);
+        return false;
+    }
+
+    // The top rows first, then everything else in its original order, so
+    // the map stays a full permutation while the rest is being sorted.
+    size_t next = 0;
+    for (size_t i = 0; i < k; i++) {
+        view->row_order_map[next++] = top[i];
+        placed[top[i]] = true;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (!placed[i]) view->row_order_map[next++] = i;
+    }
+    free(placed);
+    free(top);
+
+    memcpy(pending->keys, keys, key_count * sizeof(SortKeySpec));
+    pending->key_count = key_count;
+    pending->set = *set;
+    pending->ready_rows = k;
+    if (pthread_create(&pending->thread, NULL, progressive_sort_worker, pending) != 0) {
+        LOG_WARN("Could not start background sort; sorting in the foreground");
+        free(pending);
+        return false;
+    }
+
+    memset(set, 0, sizeof(*set)); // Now owned by the worker
+    view->pending_sort = pending;
+    view->order_version++;
+    view_build_reverse_map(view);
+    LOG_INFO("Progressive sort: top %zu of %zu rows ready", k, count);
+    return true;
+}
+
+bool sort_view_poll(View *view) {
+    if (!view || !view->pending_sort) return false;
+    return finish_pending_sort(view, false);
+}
+
+void sort_view_wait(View *view) {
+    if (view) finish_pending_sort(view, true);
+}
+
+size_t sort_view_ready_rows(const View *view) {
+    if (!view) return 0;
+    return view->pending_sort ? view->pending_sort->ready_rows : view->visible_row_count;
+}
+
+// --- External Sort ---
+
+// Views whose in-memory sort would exceed the budget are sorted in batches
+// that are spilled to a temporary file as sorted runs. Runs are k-way merged
+// a bounded number at a time, into longer runs while there are too many,
+// and finally straight into a file-backed row_order_map.
+
+static size_t g_sort_memory_budget = (size_t)DEFAULT_SORT_MEMORY_MB << 20;
+
+void sort_set_memory_budget(size_t bytes) {
+    g_sort_memory_budget = bytes > 0 ? bytes : (size_t)DEFAULT_SORT_MEMORY_MB << 20;
+}
+
+// Rows sampled to estimate the size of the key remainders
+#define SORT_ESTIMATE_SAMPLE_ROWS 1024
+#define MIN_ROWS_PER_SORT_RUN 4096
+// Runs merged at once. Longer runs are first merged in groups of this many,
+// so a merge never holds more read buffers or descriptors than that.
+#define MAX_SORT_MERGE_RUNS 16
+#define MIN_SORT_RUN_BUFFER (16 << 10)
+#define MAX_SORT_RUN_BUFFER (8 << 20)
+
+// Average bytes per row an in-memory sort needs beyond the fixed arrays:
+// the arena-held key remainder, sampled evenly across the view.
+static size_t estimate_rest_bytes_per_row(View *view, const SortColumnPlan *plan, size_t plan_count) {
+    size_t count = view->visible_row_count;
+    size_t samples = count < SORT_ESTIMATE_SAMPLE_ROWS ? count : SORT_ESTIMATE_SAMPLE_ROWS;
+    DataSourceCursor *cursor = data_source_open_cursor(view->data_source);
+    unsigned char *key = malloc(SORT_ROW_KEY_MAX(plan_count));
+    char render_buffer[SORT_TEXT_KEY_MAX];
+    size_t total = 0;
+
+    if (cursor && key) {
+        for (size_t i = 0; i < samples; i++) {
+            size_t row = view_get_actual_row_index(view, i * (count / samples));
+            size_t length = encode_row_key(plan, plan_count, cursor, row, key, render_buffer);
+            if (length > SORT_PREFIX_BYTES) total += sizeof(uint32_t) + length - SORT_PREFIX_BYTES;
+        }
+    }
+    free(key);
+    data_source_close_cursor(cursor);
+    return samples > 0 ? total / samples : 0;
+}
+
+// Decorated rows and sort scratch, plus the permutation, the row order map
+// and the reverse map built from it.
+static size_t in_memory_bytes_per_row(size_t rest_bytes) {
+    return 2 * sizeof(DecoratedRow) + 3 * sizeof(size_t) + rest_bytes;
+}
+
+// A sorted run's records within a spill file.
+typedef struct {
+    off_t begin;
+    off_t end;
+    size_t rows;
+} SortRun;
+
+// One run being read back during a merge. Runs share their spill file's
+// descriptor and are read with pread through their own buffer. 'current'
+// mirrors a DecoratedRow whose remainder points into 'rest'.
+typedef struct {
+    int fd;
+    off_t position;             // Next byte of the run not yet buffered
+    off_t end;
+    unsigned char *buffer;
+    size_t buffer_size;
+    size_t buffer_length;
+    size_t buffer_offset;
+    DecoratedRow current;
+    unsigned char *rest;        // uint32_t length + bytes, as in DecoratedRow
+    size_t rest_capacity;
+} SortRunReader;
+
+// Runs are appended to a spill file through stdio.
+typedef struct {
+    FILE *file;
+    char *buffer;               // stdio buffer, set right after the file is created
+} SpillFile;
+
+static bool spill_open(SpillFile *spill, size_t buffer_size) {
+    spill->file = tmpfile();
+    if (!spill->file) return false;
+    spill->buffer = malloc(buffer_size);
+    if (spill->buffer) setvbuf(spill->file, spill->buffer, _IOFBF, buffer_size);
+    return true;
+}
+
+static void spill_close(SpillFile *spill) {
+    if (spill->file) fclose(spill->file);
+    free(spill->buffer);
+    spill->file = NULL;
+    spill->buffer = NULL;
+}
+
+static bool write_run_record(FILE *file, const DecoratedRow *row) {
+    uint64_t index = row->original_index;
+    uint32_t rest_len = (uint32_t)rest_length(row->rest);
+    return fwrite(&row->key, sizeof(row->key), 1, file) == 1 &&
+           fwrite(&index, sizeof(index), 1, file) == 1 &&
+           fwrite(&rest_len, sizeof(rest_len), 1, file) == 1 &&
+           (rest_len == 0 || fwrite(row->rest + sizeof(uint32_t), rest_len, 1, file) == 1);
+}
+
+static bool write_sorted_run(FILE *file, const DecoratedRow *rows, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        if (!write_run_record(file, &rows[i])) return false;
+    }
+    return true;
+}
+
+// Copies the next 'length' bytes of the run, refilling the buffer as needed.
+static bool read_run_bytes(SortRunReader *reader, void *out, size_t length) {
+    unsigned char *dest = out;
+    while (length > 0) {
+        if (reader->buffer_offset == reader->buffer_length) {
+            off_t left = reader->end - reader->position;
+            size_t want = left < (off_t)reader->buffer_size ? (size_t)left : reader->buffer_size;
+            ssize_t got = want > 0 ? pread(reader->fd, reader->buffer, want, reader->position) : 0;
+            if (got <= 0) return false;
+            reader->position += got;
+            reader->buffer_length = (size_t)got;
+            reader->buffer_offset = 0;
+        }
+        size_t take = reader->buffer_length - reader->buffer_offset;
+        if (take > length) take = length;
+        memcpy(dest, reader->buffer + reader->buffer_offset, take);
+        reader->buffer_offset += take;
+        dest += take;
+        length -= take;
+    }
+    return true;
+}
+
+// Loads the next record of a run. Returns false at the end of the run.
+static bool read_run_record(SortRunReader *reader) {
+    uint64_t index;
+    uint32_t rest_len;
+    if (!read_run_bytes(reader, &reader->current.key, sizeof(reader->current.key)) ||
+        !read_run_bytes(reader, &index, sizeof(index)) ||
+        !read_run_bytes(reader, &rest_len, sizeof(rest_len))) {
+        return false;
+    }
+    reader->current.original_index = (size_t)index;
+    reader->current.rest = NULL;
+    if (rest_len == 0) return true;
+
+    if (sizeof(uint32_t) + rest_len > reader->rest_capacity) {
+        unsigned char *grown = realloc(reader->rest, sizeof(uint32_t) + rest_len);
+        if (!grown) return false;
+        reader->rest = grown;
+        reader->rest_capacity = sizeof(uint32_t) + rest_len;
+    }
+    memcpy(reader->rest, &rest_len, sizeof(rest_len));
+    if (!read_run_bytes(reader, reader->rest + sizeof(uint32_t), rest_len)) return false;
+    reader->current.rest = reader->rest;
+    return true;
+}
+
+static void merge_heap_sift_down(SortRunReader **heap, size_t size, size_t i) {
+    for (;;) {
+        size_t smallest = i, left = 2 * i + 1, right = left + 1;
+        if (left < size && compare_decorated_rows_inline(&heap[left]->current, &heap[smallest]->current) < 0) smallest = left;
+        if (right < size && compare_decorated_rows_inline(&heap[right]->current, &heap[smallest]->current) < 0) smallest = right;
+        if (smallest == i) return;
+        SortRunReader *tmp = heap[i];
+        heap[i] = heap[smallest];
+        heap[smallest] = tmp;
+        i = smallest;
+    }
+}
+
+// Maps a row order map of 'count' entries onto an unlinked temporary file.
+static size_t* map_row_order_file(size_t count) {
+    FILE *file = tmpfile();
+    if (!file) return NULL;
+    size_t bytes = count * sizeof(size_t);
+    size_t *map = NULL;
+    if (ftruncate(fileno(file), (off_t)bytes) == 0) {
+        map = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fileno(file), 0);
+        if (map == MAP_FAILED) map = NULL;
+    }
+    fclose(file); // The mapping keeps the file alive
+    return map;
+}
+
+// State shared by the merge passes of one external sort.
+typedef struct {
+    SortRunReader readers[MAX_SORT_MERGE_RUNS];
+    SortRunReader *heap[MAX_SORT_MERGE_RUNS];
+    size_t *map;                // Output of the final pass
+    size_t count;
+    bool reverse;
+} SortMerge;
+
+// Merges up to MAX_SORT_MERGE_RUNS runs of the spill file 'fd'. Records go
+// to 'out' as one longer run or, when 'out' is NULL, their row indexes go to
+// the row order map. Returns the number of records merged.
+static size_t merge_runs(SortMerge *merge, int fd, const SortRun *runs, size_t run_count, FILE *out) {
+    size_t heap_size = 0;
+    for (size_t i = 0; i < run_count; i++) {
+        SortRunReader *reader = &merge->readers[i];
+        reader->fd = fd;
+        reader->position = runs[i].begin;
+        reader->end = runs[i].end;
+        reader->buffer_length = reader->buffer_offset = 0;
+        if (read_run_record(reader)) merge->heap[heap_size++] = reader;
+    }
+    for (size_t h = heap_size / 2; h-- > 0; ) merge_heap_sift_down(merge->heap, heap_size, h);
+
+    size_t written = 0;
+    while (heap_size > 0) {
+        SortRunReader *reader = merge->heap[0];
+        if (out) {
+            if (!write_run_record(out, &reader->current)) break;
         } else {
-            comparison_result = strcasecmp(buffer_a, buffer_b);
+            if (written == merge->count) break;
+            merge->map[merge->reverse ? merge->count - 1 - written : written] = reader->current.original_index;
+        }
+        written++;
+        if (!read_run_record(reader)) merge->heap[0] = merge->heap[--heap_size];
+        merge_heap_sift_down(merge->heap, heap_size, 0);
+    }
+    return written;
+}
+
+// Sorts the view with bounded memory. Returns false if it could not; the
+// view is left unchanged then.
+static bool external_sort(View *view, const SortColumnPlan *plan, size_t plan_count, size_t rest_bytes) {
+    size_t count = view->visible_row_count;
+    size_t run_rows = g_sort_memory_budget / (2 * sizeof(DecoratedRow) + rest_bytes + 1);
+    if (run_rows < MIN_ROWS_PER_SORT_RUN) run_rows = MIN_ROWS_PER_SORT_RUN;
+    size_t run_count = (count + run_rows - 1) / run_rows;
+
+    // The merge's read buffers and the stdio buffers of the spill file being
+    // read and the one being written take at most half the budget.
+    size_t buffer_size = g_sort_memory_budget / (2 * (MAX_SORT_MERGE_RUNS + 2));
+    if (buffer_size < MIN_SORT_RUN_BUFFER) buffer_size = MIN_SORT_RUN_BUFFER;
+    if (buffer_size > MAX_SORT_RUN_BUFFER) buffer_size = MAX_SORT_RUN_BUFFER;
+
+    SortRun *runs = malloc(run_count * sizeof(SortRun));
+    SortMerge *merge = calloc(1, sizeof(SortMerge));
+    SpillFile input = {0}, output = {0};
+    bool ok = runs && merge && spill_open(&input, buffer_size);
+    for (size_t i = 0; ok && i < MAX_SORT_MERGE_RUNS; i++) {
+        merge->readers[i].buffer = malloc(buffer_size);
+        merge->readers[i].buffer_size = buffer_size;
+        ok = merge->readers[i].buffer != NULL;
+    }
+
+    // --- Spill sorted runs ---
+    for (size_t run = 0; ok && run < run_count; run++) {
+        size_t first = run * run_rows;
+        size_t rows = count - first < run_rows ? count - first : run_rows;
+        DecoratedSet set;
+        ok = decorate_rows(view, plan, plan_count, first, rows, &set);
+        if (!ok) break;
+
+        DecoratedRow *scratch = malloc(rows * sizeof(DecoratedRow));
+        DecoratedRow *sorted = parallel_sort_rows(set.rows, scratch, rows);
+        runs[run].begin = ftello(input.file);
+        ok = write_sorted_run(input.file, sorted, rows);
+        runs[run].end = ftello(input.file);
+        runs[run].rows = rows;
+        free(scratch);
+        free_decorated_set(&set);
+    }
+    ok = ok && fflush(input.file) == 0;
+    if (ok) LOG_INFO("External sort: %zu rows spilled as %zu runs", count, run_count);
+
+    // --- Merge groups of runs into longer ones until one merge takes them all ---
+    while (ok && run_count > MAX_SORT_MERGE_RUNS) {
+        ok = spill_open(&output, buffer_size);
+        size_t merged_count = 0;
+        for (size_t first = 0; ok && first < run_count; first += MAX_SORT_MERGE_RUNS) {
+            size_t group = run_count - first < MAX_SORT_MERGE_RUNS ? run_count - first : MAX_SORT_MERGE_RUNS;
+            SortRun merged = { .begin = ftello(output.file), .rows = 0 };
+            for (size_t i = 0; i < group; i++) merged.rows += runs[first + i].rows;
+            ok = merge_runs(merge, fileno(input.file), runs + first, group, output.file) == merged.rows;
+            merged.end = ftello(output.file);
+            runs[merged_count++] = merged; // Never ahead of the runs still to read
         }
+        ok = ok && fflush(output.file) == 0;
+        spill_close(&input);
+        input = output;
+        output = (SpillFile){0};
+        run_count = merged_count;
+        if (ok) LOG_INFO("External sort: merged into %zu runs", run_count);
+    }
+
+    // --- Final merge into the file-backed map ---
+    size_t *map = ok ? map_row_order_file(count) : NULL;
+    ok = map != NULL;
+    if (ok) {
+        merge->map = map;
+        merge->count = count;
+        // A single DESC key is read backwards, like the in-memory sort.
+        merge->reverse = view->sort_key_count == 1 && view->sort_keys[0].direction == SORT_DESC;
+        ok = merge_runs(merge, fileno(input.file), runs, run_count, NULL) == count;
+    }
+
+    spill_close(&input);
+    spill_close(&output);
+    for (size_t i = 0; merge && i < MAX_SORT_MERGE_RUNS; i++) {
+        free(merge->readers[i].buffer);
+        free(merge->readers[i].rest);
+    }
+    free(merge);
+    free(runs);
 
-        if (direction == SORT_ASC && comparison_result > 0) return false;
-        if (direction == SORT_DESC && comparison_result < 0) return false;
+    if (!ok) {
+        LOG_ERROR("External sort failed");
+        if (map) munmap(map, count * sizeof(size_t));
+        return false;
     }
 
+    view_free_row_order_map(view);
+    view->row_order_map = map;
+    view->row_order_map_mapped = count;
+    view->order_version++;
+
+    // The reverse map would cost another array in RAM; linked selection
+    // rebuilds it on demand.
+    SAFE_FREE(view->reverse_row_map);
+    view->reverse_row_map_size = 0;
     return true;
 }
 
+// Sorts the view by every key in view->sort_keys, re-using a cached
+// permutation when one exists.
+static void apply_sort(View *view) {
+    finish_pending_sort(view, true);
+    if (view->visible_row_count == 0 || view->sort_key_count == 0) return;
+
+    SortKeySpec keys[MAX_SORT_KEYS];
+    size_t key_count = cache_spec_for_view(view, keys);
+
+    CachedSort *cached = find_cached_sort(view, keys, key_count);
+    if (cached) {
+        apply_permutation(view, cached->order);
+        return;
+    }
+
+    SortColumnPlan plan[MAX_SORT_KEYS];
+    build_sort_plan(view, keys, key_count, plan);
+
+    size_t count = view->visible_row_count;
+    size_t rest_bytes = estimate_rest_bytes_per_row(view, plan, key_count);
+    if (count > g_sort_memory_budget / in_memory_bytes_per_row(rest_bytes)) {
+        // Spilled results are not cached: the map lives in a file, and a
+        // cached copy would defeat the budget.
+        if (external_sort(view, plan, key_count, rest_bytes)) return;
+        LOG_WARN("Falling back to an in-memory sort");
+    }
+
+    DecoratedSet set;
+    if (!decorate_rows(view, plan, key_count, 0, count, &set)) return;
+
+    if (set.count >= PROGRESSIVE_SORT_MIN_ROWS && start_progressive_sort(view, keys, key_count, &set)) {
+        return;
+    }
+
+    size_t *order = sort_decorated_set(&set);
+    free_decorated_set(&set);
+    if (!order) return;
+    apply_permutation(view, order);
+    store_cached_sort(view, keys, key_count, order);
+}
+
+// True if the view currently shows exactly this single-column sort.
+static bool is_sorted_by(const View *view, int column, SortDirection direction) {
+    return view->row_order_map && view->sort_key_count == 1 &&
+           view->sort_keys[0].column == column && view->sort_keys[0].direction == direction;
+}
 
 void sort_view(View *view) {
     if (!view || !view->data_source) return;
+    finish_pending_sort(view, true);
 
     // Determine the new sort direction for the current sort_column
     if (view->sort_column == view->last_sorted_column) {
-        // Same column as last sort, cycle through states based on actual sort
-        if (view->sort_direction == SORT_ASC && is_column_sorted(view, view->sort_column, SORT_ASC)) {
+        // Same column as last sort, cycle through states based on the recorded sort
+        if (view->sort_direction == SORT_ASC && is_sorted_by(view, view->sort_column, SORT_ASC)) {
             view->sort_direction = SORT_DESC;
-        } else if (view->sort_direction == SORT_DESC && is_column_sorted(view, view->sort_column, SORT_DESC)) {
+        } else if (view->sort_direction == SORT_DESC && is_sorted_by(view, view->sort_column, SORT_DESC)) {
             view->sort_direction = SORT_NONE;
             view->sort_column = -1; // Reset sort column when sorting is off
         } else {
@@ -162,74 +1278,46 @@ void sort_view(View *view) {
     view->last_sorted_column = view->sort_column;
 
     if (view->sort_direction == SORT_NONE) {
-        SAFE_FREE(view->row_order_map);
-        return;
-    }
-
-    if (view->visible_row_count == 0) return;
-
-    // --- 1. DECORATE ---
-    DecoratedRow *decorated_rows = malloc(view->visible_row_count * sizeof(DecoratedRow));
-    if (!decorated_rows) {
-        LOG_ERROR("Failed to allocate for decorated rows.");
+        view->sort_key_count = 0;
+        view_free_row_order_map(view);
         return;
     }
 
-    bool is_numeric = is_column_numeric(view, view->sort_column);
-    char render_buffer[4096];
-    DataSource *ds = view->data_source;
-
-    for (size_t i = 0; i < view->visible_row_count; i++) {
-        decorated_rows[i].original_index = i;
-        decorated_rows[i].is_numeric = is_numeric;
-        size_t actual_row = view_get_actual_row_index(view, i);
-
-        FieldDesc fd = ds->ops->get_cell(ds->context, actual_row, view->sort_column);
-        render_field(&fd, render_buffer, sizeof(render_buffer));
+    // Sorting on a single column replaces any composite spec.
+    view->sort_keys[0] = (SortKeySpec){ .column = view->sort_column, .direction = view->sort_direction };
+    view->sort_key_count = 1;
+    apply_sort(view);
+}
 
-        if (is_numeric) {
-            decorated_rows[i].key.numeric_key = strtoll(render_buffer, NULL, 10);
-        } else {
-            // Use strdup for safer, albeit potentially slower, memory allocation.
-            decorated_rows[i].key.string_key = strdup(render_buffer);
-            if (!decorated_rows[i].key.string_key) {
-                LOG_ERROR("Failed to allocate memory for sort key string.");
-                decorated_rows[i].key.string_key = ""; // Fallback to empty string
-            }
-        }
-    }
+bool sort_view_toggle_key(View *view, int column) {
+    if (!view || !view->data_source || column < 0) return false;
+    finish_pending_sort(view, true);
 
-    // --- 2. SORT ---
-    g_current_sort_direction = view->sort_direction;
-    qsort(decorated_rows, view->visible_row_count, sizeof(DecoratedRow), compare_decorated_rows);
+    size_t index = 0;
+    while (index < view->sort_key_count && view->sort_keys[index].column != column) index++;
 
-    // --- 3. UNDECORATE ---
-    if (!view->row_order_map) {
-        view->row_order_map = malloc(view->visible_row_count * sizeof(size_t));
-    }
-    if (!view->row_order_map) {
-        LOG_ERROR("Failed to allocate row_order_map for sorting.");
-        // Cleanup decorated rows before returning
-        if (!is_numeric) {
-            for (size_t i = 0; i < view->visible_row_count; i++) {
-                free(decorated_rows[i].key.string_key);
-            }
-        }
-        free(decorated_rows);
-        return;
+    if (index == view->sort_key_count) {
+        if (view->sort_key_count == MAX_SORT_KEYS) return false;
+        view->sort_keys[view->sort_key_count++] = (SortKeySpec){ .column = column, .direction = SORT_ASC };
+    } else if (view->sort_keys[index].direction == SORT_ASC) {
+        view->sort_keys[index].direction = SORT_DESC;
+    } else {
+        memmove(&view->sort_keys[index], &view->sort_keys[index + 1],
+                (view->sort_key_count - index - 1) * sizeof(SortKeySpec));
+        view->sort_key_count--;
     }
 
-    for (size_t i = 0; i < view->visible_row_count; i++) {
-        view->row_order_map[i] = decorated_rows[i].original_index;
-    }
-    
-    // --- Cleanup ---
-    if (!is_numeric) {
-        for (size_t i = 0; i < view->visible_row_count; i++) {
-            // strdup created a copy, so we need to free it.
-            free(decorated_rows[i].key.string_key);
-        }
+    // Keep the single-column state in step with the primary key.
+    if (view->sort_key_count == 0) {
+        view->sort_column = -1;
+        view->sort_direction = SORT_NONE;
+        view->last_sorted_column = -1;
+        view_free_row_order_map(view);
+        return true;
     }
-    free(decorated_rows);
-    view_build_reverse_map(view);
-} 
\ No newline at end of file
+    view->sort_column = view->sort_keys[0].column;
+    view->sort_direction = view->sort_keys[0].direction;
+    view->last_sorted_column = view->sort_column;
+    apply_sort(view);
+    return true;
+}
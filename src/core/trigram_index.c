@@ -0,0 +1,619 @@
+#include "core/trigram_index.h"
+#include "util/logging.h"
+#include "util/utils.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define DEFAULT_TRIGRAM_BLOCK_ROWS 256
+#define TRIGRAM_SKIP_INTERVAL 64     // Postings between skip entries
+#define TRIGRAM_SPACE (1u << 24)     // Distinct 3-byte values
+#define TRIGRAM_QUERY_MAX 32         // Rarest trigrams a query intersects
+#define CANCEL_CHECK_BLOCKS 64
+
+static const char TRIGRAM_MAGIC[8] = "DVTRI01";
+
+// --- On-Disk Layout ---
+// The header is followed by the entries (sorted by trigram), the skip
+// entries and the posting bytes. A built index holds the same arrays in
+// memory, so a loaded one is used straight from the mapping.
+
+typedef struct {
+    char magic[8];
+    uint64_t source_length;
+    int64_t source_modified;
+    uint64_t row_count;
+    uint64_t trigram_count;
+    uint64_t skip_count;
+    uint64_t posting_bytes;
+    uint32_t block_rows;
+    uint32_t delimiter;
+} TrigramFileHeader;
+
+typedef struct {
+    uint32_t trigram;
+    uint32_t count;          // Blocks in the posting list
+    uint64_t offset;         // Start of the list in the posting bytes
+    uint64_t first_skip;     // Index of the list's first skip entry
+} TrigramEntry;
+
+// Posting k * TRIGRAM_SKIP_INTERVAL of a list is stored as an absolute block
+// rather than a delta, so decoding can start at any skip entry.
+typedef struct {
+    uint32_t block;
+    uint32_t offset;         // Byte offset of the posting within its list
+} TrigramSkip;
+
+struct TrigramIndex {
+    TrigramFileHeader header;
+    const TrigramEntry *entries;
+    const TrigramSkip *skips;
+    const uint8_t *postings;
+    void *mapping;           // The whole file when loaded, NULL when built
+    size_t mapping_length;
+};
+
+static inline uint8_t fold_ascii(uint8_t c) {
+    return (c >= 'A' && c <= 'Z') ? (uint8_t)(c + ('a' - 'A')) : c;
+}
+
+static inline bool indexable(uint8_t c, uint8_t delimiter) {
+    return c != '\n' && c != '\r' && c != '"' && c != delimiter;
+}
+
+static void put_varint(uint8_t *out, size_t *length, uint32_t value) {
+    while (value >= 0x80) {
+        out[(*length)++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[(*length)++] = (uint8_t)value;
+}
+
+static uint32_t get_varint(const uint8_t *in, size_t *offset) {
+    uint32_t value = 0;
+    for (int shift = 0;; shift += 7) {
+        uint8_t byte = in[(*offset)++];
+        value |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return value;
+    }
+}
+
+// --- Build ---
+
+typedef struct {
+    uint32_t trigram;
+    uint32_t count;
+    uint32_t last_block;
+    uint8_t *bytes;
+    size_t length;
+    size_t capacity;
+    TrigramSkip *skips;
+    size_t skip_count;
+    size_t skip_capacity;
+} PostingBuilder;
+
+// Open-addressing map from trigram to its builder.
+typedef struct {
+    uint32_t *slots;         // Builder index + 1, 0 for an empty slot
+    size_t slot_count;       // Power of two
+    PostingBuilder *builders;
+    size_t builder_count;
+    size_t builder_capacity;
+} BuilderTable;
+
+static inline size_t slot_of(uint32_t trigram, size_t slot_count) {
+    return (size_t)((trigram * 2654435761u) & (uint32_t)(slot_count - 1));
+}
+
+static bool grow_slots(BuilderTable *table) {
+    size_t slot_count = table->slot_count ? table->slot_count * 2 : 4096;
+    uint32_t *slots = calloc(slot_count, sizeof(uint32_t));
+    if (!slots) return false;
+    for (size_t i = 0; i < table->builder_count; i++) {
+        size_t slot = slot_of(table->builders[i].trigram, slot_count);
+        while (slots[slot]) slot = (slot + 1) & (slot_count - 1);
+        slots[slot] = (uint32_t)(i + 1);
+    }
+    free(table->slots);
+    table->slots = slots;
+    table->slot_count = slot_count;
+    return true;
+}
+
+static PostingBuilder* find_builder(BuilderTable *table, uint32_t trigram) {
+    if ((table->builder_count + 1) * 2 > table->slot_count && !grow_slots(table)) return NULL;
+    size_t slot = slot_of(trigram, table->slot_count);
+    while (table->slots[slot]) {
+        PostingBuilder *builder = &table->builders[table->slots[slot] - 1];
+        if (builder->trigram == trigram) return builder;
+        slot = (slot + 1) & (table->slot_count - 1);
+    }
+    if (table->builder_count == table->builder_capacity) {
+        size_t capacity = table->builder_capacity ? table->builder_capacity * 2 : 1024;
+        PostingBuilder *builders = realloc(table->builders, capacity * sizeof(PostingBuilder));
+        if (!builders) return NULL;
+        table->builders = builders;
+        table->builder_capacity = capacity;
+    }
+    PostingBuilder *builder = &table->builders[table->builder_count];
+    memset(builder, 0, sizeof(*builder));
+    builder->trigram = trigram;
+    table->slots[slot] = (uint32_t)(++table->builder_count);
+    return builder;
+}
+
+static bool append_posting(PostingBuilder *builder, uint32_t block) {
+    uint32_t value = block - builder->last_block;
+    if (builder->count % TRIGRAM_SKIP_INTERVAL == 0) {
+        if (builder->skip_count == builder->skip_capacity) {
+            size_t capacity = builder->skip_capacity ? builder->skip_capacity * 2 : 1;
+            TrigramSkip *skips = realloc(builder->skips, capacity * sizeof(TrigramSkip));
+            if (!skips) return false;
+            builder->skips = skips;
+            builder->skip_capacity = capacity;
+        }
+        builder->skips[builder->skip_count++] = (TrigramSkip){ block, (uint32_t)builder->length };
+        value = block;
+    }
+    if (builder->length + 5 > builder->capacity) {
+        size_t capacity = builder->capacity ? builder->capacity * 2 : 8;
+        uint8_t *bytes = realloc(builder->bytes, capacity);
+        if (!bytes) return false;
+        builder->bytes = bytes;
+        builder->capacity = capacity;
+    }
+    put_varint(builder->bytes, &builder->length, value);
+    builder->last_block = block;
+    builder->count++;
+    return true;
+}
+
+static void free_builders(BuilderTable *table) {
+    for (size_t i = 0; i < table->builder_count; i++) {
+        free(table->builders[i].bytes);
+        free(table->builders[i].skips);
+    }
+    free(table->builders);
+    free(table->slots);
+}
+
+static int compare_builders(const void *a, const void *b) {
+    uint32_t x = ((const PostingBuilder *)a)->trigram;
+    uint32_t y = ((const PostingBuilder *)b)->trigram;
+    return (x > y) - (x < y);
+}
+
+// Lays the builders out as the entry, skip and posting arrays.
+static TrigramIndex* finish_index(BuilderTable *table, const TrigramIndexInput *input, size_t block_rows) {
+    qsort(table->builders, table->builder_count, sizeof(PostingBuilder), compare_builders);
+
+    size_t skip_count = 0, posting_bytes = 0;
+    for (size_t i = 0; i < table->builder_count; i++) {
+        skip_count += table->builders[i].skip_count;
+        posting_bytes += table->builders[i].length;
+    }
+
+    TrigramIndex *index = calloc(1, sizeof(TrigramIndex));
+    TrigramEntry *entries = malloc((table->builder_count ? table->builder_count : 1) * sizeof(TrigramEntry));
+    TrigramSkip *skips = malloc((skip_count ? skip_count : 1) * sizeof(TrigramSkip));
+    uint8_t *postings = malloc(posting_bytes ? posting_bytes : 1);
+    if (!index || !entries || !skips || !postings) {
+        free(index);
+        free(entries);
+        free(skips);
+        free(postings);
+        return NULL;
+    }
+
+    size_t skip = 0, offset = 0;
+    for (size_t i = 0; i < table->builder_count; i++) {
+        const PostingBuilder *builder = &table->builders[i];
+        entries[i] = (TrigramEntry){ builder->trigram, builder->count, offset, skip };
+        memcpy(skips + skip, builder->skips, builder->skip_count * sizeof(TrigramSkip));
+        memcpy(postings + offset, builder->bytes, builder->length);
+        skip += builder->skip_count;
+        offset += builder->length;
+    }
+
+    memcpy(index->header.magic, TRIGRAM_MAGIC, sizeof(TRIGRAM_MAGIC));
+    index->header.source_length = input->length;
+    index->header.source_modified = input->source_modified;
+    index->header.row_count = input->row_count;
+    index->header.trigram_count = table->builder_count;
+    index->header.skip_count = skip_count;
+    index->header.posting_bytes = posting_bytes;
+    index->header.block_rows = (uint32_t)block_rows;
+    index->header.delimiter = (uint8_t)input->delimiter;
+    index->entries = entries;
+    index->skips = skips;
+    index->postings = postings;
+    return index;
+}
+
+TrigramIndex* trigram_index_build(const TrigramIndexInput *input, const int *cancel) {
+    if (!input || (input->row_count > 0 && (!input->data || !input->row_offsets))) return NULL;
+
+    size_t block_rows = input->block_rows ? input->block_rows : DEFAULT_TRIGRAM_BLOCK_ROWS;
+    size_t block_count = (input->row_count + block_rows - 1) / block_rows;
+    if (block_count > UINT32_MAX) return NULL;
+
+    // A block's trigrams are deduplicated in a bitmap of every 3-byte value,
+    // and only the bits that were set are cleared for the next block.
+    uint8_t *seen = calloc(TRIGRAM_SPACE / 8, 1);
+    size_t touched_capacity = 4096, touched_count = 0;
+    uint32_t *touched = malloc(touched_capacity * sizeof(uint32_t));
+    BuilderTable table = {0};
+    bool ok = seen && touched;
+    uint8_t delimiter = (uint8_t)input->delimiter;
+
+    for (size_t block = 0; ok && block < block_count; block++) {
+        if (cancel && block % CANCEL_CHECK_BLOCKS == 0 && __atomic_load_n(cancel, __ATOMIC_RELAXED)) {
+            ok = false;
+            break;
+        }
+        size_t first = block * block_rows;
+        size_t end_row = first + block_rows;
+        size_t begin = input->row_offsets[first];
+        size_t end = end_row < input->row_count ? input->row_offsets[end_row] : input->length;
+
+        const uint8_t *bytes = (const uint8_t *)input->data;
+        uint32_t window = 0;
+        int run = 0;
+        for (size_t i = begin; i < end; i++) {
+            uint8_t c = bytes[i];
+            if (!indexable(c, delimiter)) {
+                run = 0;
+                continue;
+            }
+            window = ((window << 8) | fold_ascii(c)) & (TRIGRAM_SPACE - 1);
+            if (++run < 3) continue;
+            if (seen[window >> 3] & (1u << (window & 7))) continue;
+            seen[window >> 3] |= (uint8_t)(1u << (window & 7));
+            if (touched_count == touched_capacity) {
+                uint32_t *grown = realloc(touched, touched_capacity * 2 * sizeof(uint32_t));
+                if (!grown) {
+                    ok = false;
+                    break;
+                }
+                touched = grown;
+                touched_capacity *= 2;
+            }
+            touched[touched_count++] = window;
+        }
+
+        for (size_t i = 0; i < touched_count; i++) {
+            uint32_t trigram = touched[i];
+            seen[trigram >> 3] = 0;
+            PostingBuilder *builder = ok ? find_builder(&table, trigram) : NULL;
+            if (!builder || !append_posting(builder, (uint32_t)block)) ok = false;
+        }
+        touched_count = 0;
+    }
+
+    TrigramIndex *index = ok ? finish_index(&table, input, block_rows) : NULL;
+    free_builders(&table);
+    free(touched);
+    free(seen);
+    return index;
+}
+
+// --- Persistence ---
+
+DSVResult trigram_index_save(const TrigramIndex *index, const char *path) {
+    CHECK_NULL_RET(index, DSV_ERROR_INVALID_ARGS);
+    CHECK_NULL_RET(path, DSV_ERROR_INVALID_ARGS);
+
+    size_t path_length = strlen(path);
+    char *temp_path = malloc(path_length + 5);
+    if (!temp_path) return DSV_ERROR_MEMORY;
+    snprintf(temp_path, path_length + 5, "%s.tmp", path);
+
+    FILE *file = fopen(temp_path, "wb");
+    if (!file) {
+        LOG_WARN("Cannot write trigram index '%s': %s", temp_path, strerror(errno));
+        free(temp_path);
+        return DSV_ERROR_FILE_IO;
+    }
+    const TrigramFileHeader *header = &index->header;
+    bool ok = fwrite(header, sizeof(*header), 1, file) == 1 &&
+              fwrite(index->entries, sizeof(TrigramEntry), header->trigram_count, file) == header->trigram_count &&
+              fwrite(index->skips, sizeof(TrigramSkip), header->skip_count, file) == header->skip_count &&
+              fwrite(index->postings, 1, header->posting_bytes, file) == header->posting_bytes;
+    if (fclose(file) != 0) ok = false;
+    if (ok && rename(temp_path, path) != 0) ok = false;
+    if (!ok) {
+        LOG_WARN("Failed to save trigram index '%s': %s", path, strerror(errno));
+        unlink(temp_path);
+    }
+    free(temp_path);
+    return ok ? DSV_OK : DSV_ERROR_FILE_IO;
+}
+
+static bool header_matches(const TrigramFileHeader *header, size_t file_length, const TrigramIndexInput *input) {
+    size_t block_rows = input->block_rows ? input->block_rows : DEFAULT_TRIGRAM_BLOCK_ROWS;
+    if (memcmp(header->magic, TRIGRAM_MAGIC, sizeof(TRIGRAM_MAGIC)) != 0) return false;
+    if (header->source_length != input->length || header->source_modified != input->source_modified ||
+        header->row_count != input->row_count || header->block_rows != block_rows ||
+        header->delimiter != (uint8_t)input->delimiter) {
+        return false;
+    }
+    // The arrays must fill the rest of the file exactly.
+    uint64_t rest = file_length - sizeof(*header);
+    if (header->trigram_count > rest / sizeof(TrigramEntry)) return false;
+    rest -= header->trigram_count * sizeof(TrigramEntry);
+    if (header->skip_count > rest / sizeof(TrigramSkip)) return false;
+    rest -= header->skip_count * sizeof(TrigramSkip);
+    return header->posting_bytes == rest;
+}
+
+// Bounds-checked get_varint for data read from disk.
+static bool read_varint(const uint8_t *in, size_t end, size_t *offset, uint32_t *value) {
+    *value = 0;
+    for (int shift = 0; shift < 35 && *offset < end; shift += 7) {
+        uint8_t byte = in[(*offset)++];
+        *value |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+// Queries trust the arrays without bounds checks, so every entry, skip and
+// posting of a loaded file is checked to be laid out the way finish_index
+// writes them.
+static bool postings_valid(const TrigramIndex *index) {
+    const TrigramFileHeader *header = &index->header;
+    uint64_t block_count = (header->row_count + header->block_rows - 1) / header->block_rows;
+    uint64_t offset = 0, skip = 0;
+    for (uint64_t i = 0; i < header->trigram_count; i++) {
+        const TrigramEntry *entry = &index->entries[i];
+        if (entry->trigram >= TRIGRAM_SPACE || (i > 0 && entry->trigram <= index->entries[i - 1].trigram)) return false;
+        if (entry->count == 0 || entry->offset != offset || entry->first_skip != skip) return false;
+        uint64_t skip_count = (entry->count + TRIGRAM_SKIP_INTERVAL - 1) / TRIGRAM_SKIP_INTERVAL;
+        if (skip_count > header->skip_count - skip) return false;
+
+        const uint8_t *list = index->postings + offset;
+        size_t end = (size_t)((i + 1 < header->trigram_count ? index->entries[i + 1].offset : header->posting_bytes) - offset);
+        if (end > header->posting_bytes - offset) return false;
+        size_t position = 0;
+        uint64_t block = 0;
+        for (uint32_t k = 0; k < entry->count; k++) {
+            size_t start = position;
+            uint32_t value;
+            if (!read_varint(list, end, &position, &value)) return false;
+            if (k % TRIGRAM_SKIP_INTERVAL == 0) {
+                const TrigramSkip *entry_skip = &index->skips[skip + k / TRIGRAM_SKIP_INTERVAL];
+                if ((k > 0 && value <= block) || entry_skip->block != value || entry_skip->offset != start) return false;
+                block = value;
+            } else {
+                if (value == 0) return false;
+                block += value;
+            }
+            if (block >= block_count) return false;
+        }
+        if (position != end) return false;
+        offset += end;
+        skip += skip_count;
+    }
+    return offset == header->posting_bytes && skip == header->skip_count;
+}
+
+TrigramIndex* trigram_index_load(const char *path, const TrigramIndexInput *input) {
+    if (!path || !input) return NULL;
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) == -1 || (size_t)st.st_size < sizeof(TrigramFileHeader)) {
+        close(fd);
+        return NULL;
+    }
+    size_t length = (size_t)st.st_size;
+    void *mapping = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) return NULL;
+
+    TrigramIndex *index = calloc(1, sizeof(TrigramIndex));
+    if (!index) {
+        munmap(mapping, length);
+        return NULL;
+    }
+    memcpy(&index->header, mapping, sizeof(TrigramFileHeader));
+    if (!header_matches(&index->header, length, input)) {
+        LOG_INFO("Trigram index '%s' is out of date", path);
+        munmap(mapping, length);
+        free(index);
+        return NULL;
+    }
+    const uint8_t *base = (const uint8_t *)mapping + sizeof(TrigramFileHeader);
+    index->entries = (const TrigramEntry *)base;
+    index->skips = (const TrigramSkip *)(base + index->header.trigram_count * sizeof(TrigramEntry));
+    index->postings = (const uint8_t *)(index->skips + index->header.skip_count);
+    if (!postings_valid(index)) {
+        LOG_WARN("Trigram index '%s' is corrupt", path);
+        munmap(mapping, length);
+        free(index);
+        return NULL;
+    }
+    index->mapping = mapping;
+    index->mapping_length = length;
+    return index;
+}
+
+void trigram_index_free(TrigramIndex *index) {
+    if (!index) return;
+    if (index->mapping) {
+        munmap(index->mapping, index->mapping_length);
+    } else {
+        free((void *)index->entries);
+        free((void *)index->skips);
+        free((void *)index->postings);
+    }
+    free(index);
+}
+
+size_t trigram_index_block_rows(const TrigramIndex *index) {
+    return index ? index->header.block_rows : DEFAULT_TRIGRAM_BLOCK_ROWS;
+}
+
+// --- Queries ---
+
+typedef struct {
+    const TrigramEntry *entry;
+    const TrigramSkip *skips;     // The list's skip entries
+    size_t skip_count;
+    const uint8_t *list;          // The list's posting bytes
+    size_t index;                 // Position of 'block' in the list
+    size_t offset;                // Byte offset just past it
+    uint32_t block;
+    bool exhausted;
+} PostingCursor;
+
+struct TrigramQuery {
+    PostingCursor cursors[TRIGRAM_QUERY_MAX];
+    size_t cursor_count;
+    bool empty;                   // Some trigram occurs in no block
+};
+
+static const TrigramEntry* find_entry(const TrigramIndex *index, uint32_t trigram) {
+    size_t low = 0, high = index->header.trigram_count;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (index->entries[mid].trigram < trigram) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return (low < index->header.trigram_count && index->entries[low].trigram == trigram) ? &index->entries[low] : NULL;
+}
+
+static void cursor_enter(PostingCursor *cursor, size_t skip) {
+    cursor->index = skip * TRIGRAM_SKIP_INTERVAL;
+    cursor->offset = cursor->skips[skip].offset;
+    cursor->block = get_varint(cursor->list, &cursor->offset);
+}
+
+static bool cursor_next(PostingCursor *cursor) {
+    if (++cursor->index >= cursor->entry->count) {
+        cursor->exhausted = true;
+        return false;
+    }
+    uint32_t value = get_varint(cursor->list, &cursor->offset);
+    cursor->block = (cursor->index % TRIGRAM_SKIP_INTERVAL == 0) ? value : cursor->block + value;
+    return true;
+}
+
+// Moves to the first posting at or after 'target'.
+static bool cursor_seek(PostingCursor *cursor, uint32_t target) {
+    if (cursor->exhausted) return false;
+    if (cursor->block >= target) return true;
+
+    // Jump to the last skip entry at or before the target if it lies ahead.
+    size_t low = 0, high = cursor->skip_count;
+    while (high - low > 1) {
+        size_t mid = low + (high - low) / 2;
+        if (cursor->skips[mid].block <= target) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+    if (low * TRIGRAM_SKIP_INTERVAL > cursor->index) cursor_enter(cursor, low);
+
+    while (cursor->block < target) {
+        if (!cursor_next(cursor)) return false;
+    }
+    return true;
+}
+
+static int compare_cursors(const void *a, const void *b) {
+    uint32_t x = ((const PostingCursor *)a)->entry->count;
+    uint32_t y = ((const PostingCursor *)b)->entry->count;
+    return (x > y) - (x < y);
+}
+
+TrigramQuery* trigram_query_create(const TrigramIndex *index, const char *term, size_t length, bool ignore_case) {
+    if (!index || !term || length < 3) return NULL;
+
+    TrigramQuery *query = calloc(1, sizeof(TrigramQuery));
+    if (!query) return NULL;
+
+    uint8_t delimiter = (uint8_t)index->header.delimiter;
+    const uint8_t *bytes = (const uint8_t *)term;
+    bool usable = false;
+    for (size_t i = 0; i + 3 <= length && !query->empty; i++) {
+        uint8_t a = bytes[i], b = bytes[i + 1], c = bytes[i + 2];
+        if (!indexable(a, delimiter) || !indexable(b, delimiter) || !indexable(c, delimiter)) continue;
+        // Other case forms of non-ASCII letters are different bytes.
+        if (ignore_case && ((a | b | c) & 0x80)) continue;
+        uint32_t trigram = ((uint32_t)fold_ascii(a) << 16) | ((uint32_t)fold_ascii(b) << 8) | fold_ascii(c);
+        usable = true;
+
+        const TrigramEntry *entry = find_entry(index, trigram);
+        if (!entry) {
+            query->empty = true;
+            break;
+        }
+        bool duplicate = false;
+        for (size_t k = 0; k < query->cursor_count; k++) {
+            if (query->cursors[k].entry == entry) duplicate = true;
+        }
+        if (duplicate) continue;
+
+        PostingCursor cursor = {
+            .entry = entry,
+            .skips = index->skips + entry->first_skip,
+            .skip_count = (entry->count + TRIGRAM_SKIP_INTERVAL - 1) / TRIGRAM_SKIP_INTERVAL,
+            .list = index->postings + entry->offset,
+        };
+        cursor_enter(&cursor, 0);
+        if (query->cursor_count < TRIGRAM_QUERY_MAX) {
+            query->cursors[query->cursor_count++] = cursor;
+        } else {
+            // Keep the rarest lists; they narrow the most.
+            size_t common = 0;
+            for (size_t k = 1; k < query->cursor_count; k++) {
+                if (query->cursors[k].entry->count > query->cursors[common].entry->count) common = k;
+            }
+            if (entry->count < query->cursors[common].entry->count) query->cursors[common] = cursor;
+        }
+    }
+    if (!usable) {
+        free(query);
+        return NULL;
+    }
+    qsort(query->cursors, query->cursor_count, sizeof(PostingCursor), compare_cursors);
+    return query;
+}
+
+size_t trigram_query_next_block(TrigramQuery *query, size_t block) {
+    if (!query || query->empty || block > UINT32_MAX) return SIZE_MAX;
+    uint32_t target = (uint32_t)block;
+
+    // Leapfrog: every list is advanced to the highest block seen so far until
+    // they all agree.
+    size_t agreed = 0;
+    for (size_t k = 0; agreed < query->cursor_count; k = (k + 1) % query->cursor_count) {
+        PostingCursor *cursor = &query->cursors[k];
+        if (!cursor_seek(cursor, target)) {
+            query->empty = true;
+            return SIZE_MAX;
+        }
+        if (cursor->block == target) {
+            agreed++;
+        } else {
+            target = cursor->block;
+            agreed = 1;
+        }
+    }
+    return target;
+}
+
+void trigram_query_free(TrigramQuery *query) {
+    free(query);
+}
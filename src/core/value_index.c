@@ -12,51 +12,60 @@ ValueIndex* create_value_index(size_t size) {
         free(index);
         return NULL;
     }
+    index->refcount = 1;
+    arena_init(&index->arena, 0);
+    return index;
+}
+
+ValueIndex* value_index_retain(ValueIndex *index) {
+    if (index) index->refcount++;
     return index;
 }
 
 void free_value_index(ValueIndex *index) {
-    if (!index) return;
-    for (size_t i = 0; i < index->size; i++) {
-        ValueIndexEntry *entry = index->buckets[i];
-        while (entry) {
-            ValueIndexEntry *next = entry->next;
-            free(entry->value);
-            free(entry->rows.indices);
-            free(entry);
-            entry = next;
-        }
-    }
+    if (!index || --index->refcount > 0) return;
+    arena_free(&index->arena);
+    free(index->sorted);
     free(index->buckets);
     free(index);
 }
 
-void add_to_value_index(ValueIndex *index, const char *value, size_t *row_indices, size_t count) {
-    uint32_t hash = fnv1a_hash(value);
-    size_t i = hash % index->size;
-    
-    // Create new entry
-    ValueIndexEntry *entry = malloc(sizeof(ValueIndexEntry));
-    entry->value = strdup(value);
-    entry->rows.indices = malloc(count * sizeof(size_t));
-    memcpy(entry->rows.indices, row_indices, count * sizeof(size_t));
+ValueIndexEntry* value_index_add_entry(ValueIndex *index, const char *value, size_t length, size_t count) {
+    ValueIndexEntry *entry = arena_alloc(&index->arena, sizeof(ValueIndexEntry));
+    char *stored = entry ? arena_strndup(&index->arena, value, length) : NULL;
+    size_t *indices = stored ? arena_alloc(&index->arena, (count > 0 ? count : 1) * sizeof(size_t)) : NULL;
+    if (!indices) return NULL;
+
+    entry->value = stored;
+    entry->length = length;
+    entry->rows.indices = indices;
     entry->rows.count = count;
-    
+
     // Insert into bucket
+    size_t i = fnv1a_hash(stored) % index->size;
     entry->next = index->buckets[i];
     index->buckets[i] = entry;
     index->count++;
+    if (length > index->value_width) index->value_width = length;
+    if (count > index->max_count) index->max_count = count;
+    return entry;
+}
+
+ValueIndexEntry* add_to_value_index(ValueIndex *index, const char *value, size_t *row_indices, size_t count) {
+    ValueIndexEntry *entry = value_index_add_entry(index, value, strlen(value), count);
+    if (entry) memcpy(entry->rows.indices, row_indices, count * sizeof(size_t));
+    return entry;
 }
 
 const RowIndexArray* get_from_value_index(const ValueIndex *index, const char *value) {
     if (!index) return NULL;
     uint32_t hash = fnv1a_hash(value);
     size_t i = hash % index->size;
-    
+
     for (ValueIndexEntry *entry = index->buckets[i]; entry; entry = entry->next) {
         if (strcmp(entry->value, value) == 0) {
             return &entry->rows;
         }
     }
     return NULL;
-} 
\ No newline at end of file
+}
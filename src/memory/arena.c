@@ -0,0 +1,96 @@
+#include "arena.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define DEFAULT_ARENA_BLOCK_SIZE (64 * 1024)
+#define ARENA_ALIGNMENT 16
+
+struct ArenaBlock {
+    ArenaBlock *next;        // Previously filled block
+    size_t used;
+    size_t capacity;
+    // Block contents follow the header at an aligned offset (see block_data)
+};
+
+static size_t align_up(size_t size) {
+    return (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+}
+
+static char* block_data(ArenaBlock *block) {
+    return (char *)block + align_up(sizeof(ArenaBlock));
+}
+
+static ArenaBlock* new_block(size_t capacity) {
+    ArenaBlock *block = malloc(align_up(sizeof(ArenaBlock)) + capacity);
+    if (!block) return NULL;
+    block->next = NULL;
+    block->used = 0;
+    block->capacity = capacity;
+    return block;
+}
+
+void arena_init(Arena *arena, size_t block_size) {
+    arena->head = NULL;
+    arena->block_size = block_size > 0 ? block_size : DEFAULT_ARENA_BLOCK_SIZE;
+    arena->total_allocated = 0;
+}
+
+// Bump-allocates 'size' bytes at an offset that is a multiple of 'alignment'.
+static void* arena_alloc_aligned(Arena *arena, size_t size, size_t alignment) {
+    ArenaBlock *block = arena->head;
+    size_t offset = block ? (block->used + alignment - 1) & ~(alignment - 1) : 0;
+
+    if (!block || offset > block->capacity || block->capacity - offset < size) {
+        size_t capacity = size > arena->block_size ? size : arena->block_size;
+        ArenaBlock *fresh = new_block(capacity);
+        if (!fresh) return NULL;
+        fresh->next = block;
+        arena->head = block = fresh;
+        offset = 0;
+    }
+
+    void *ptr = block_data(block) + offset;
+    arena->total_allocated += offset - block->used + size;
+    block->used = offset + size;
+    return ptr;
+}
+
+void* arena_alloc(Arena *arena, size_t size) {
+    return arena_alloc_aligned(arena, size > 0 ? size : 1, ARENA_ALIGNMENT);
+}
+
+char* arena_strndup(Arena *arena, const char *str, size_t length) {
+    // Strings need no alignment, which keeps short values densely packed.
+    char *copy = arena_alloc_aligned(arena, length + 1, 1);
+    if (!copy) return NULL;
+    memcpy(copy, str, length);
+    copy[length] = '\0';
+    return copy;
+}
+
+void arena_reset(Arena *arena) {
+    ArenaBlock *block = arena->head;
+    if (!block) return;
+
+    if (block->next) {
+        // Several blocks were needed; replace them with one that fits the
+        // whole working set so the next round does not chain again.
+        size_t wanted = arena->total_allocated > arena->block_size ? arena->total_allocated : arena->block_size;
+        arena_free(arena);
+        arena->head = new_block(wanted);
+    } else {
+        block->used = 0;
+    }
+    arena->total_allocated = 0;
+}
+
+void arena_free(Arena *arena) {
+    ArenaBlock *block = arena->head;
+    while (block) {
+        ArenaBlock *next = block->next;
+        free(block);
+        block = next;
+    }
+    arena->head = NULL;
+    arena->total_allocated = 0;
+}
@@ -2,10 +2,138 @@
 #include "utils.h"
 #include <stdlib.h>
 #include <string.h>
+#include <stdio.h>
+#include <inttypes.h>
 
 #define INITIAL_TABLE_CAPACITY 16
+#define INITIAL_ARENA_CAPACITY 4096
 
-InMemoryTable* create_in_memory_table(const char *title, size_t col_count, const char **headers) {
+// --- Column Storage Helpers ---
+
+static void free_column(InMemoryColumn *column) {
+    free(column->arena);
+    free(column->offsets);
+    free(column->lengths);
+    free(column->i64);
+    free(column->f64);
+}
+
+// Grows (or initially allocates) the per-row arrays of a column.
+static int resize_column_rows(InMemoryColumn *column, size_t new_capacity) {
+    switch (column->type) {
+        case COLUMN_TYPE_STRING: {
+            size_t *offsets = realloc(column->offsets, new_capacity * sizeof(size_t));
+            if (!offsets) return -1;
+            column->offsets = offsets;
+            uint32_t *lengths = realloc(column->lengths, new_capacity * sizeof(uint32_t));
+            if (!lengths) return -1;
+            column->lengths = lengths;
+            return 0;
+        }
+        case COLUMN_TYPE_INT64: {
+            int64_t *values = realloc(column->i64, new_capacity * sizeof(int64_t));
+            if (!values) return -1;
+            column->i64 = values;
+            return 0;
+        }
+        case COLUMN_TYPE_DOUBLE: {
+            double *values = realloc(column->f64, new_capacity * sizeof(double));
+            if (!values) return -1;
+            column->f64 = values;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+// Makes room for 'needed' more bytes in a string column's arena.
+static int reserve_arena(InMemoryColumn *column, size_t needed) {
+    if (column->arena_size + needed <= column->arena_capacity) {
+        return 0;
+    }
+    size_t new_capacity = column->arena_capacity > 0 ? column->arena_capacity : INITIAL_ARENA_CAPACITY;
+    while (new_capacity < column->arena_size + needed) {
+        new_capacity *= 2;
+    }
+    char *arena = realloc(column->arena, new_capacity);
+    if (!arena) return -1;
+    column->arena = arena;
+    column->arena_capacity = new_capacity;
+    return 0;
+}
+
+static size_t format_number(const InMemoryColumn *column, size_t row, char *buffer, size_t buffer_size) {
+    int written;
+    if (column->type == COLUMN_TYPE_INT64) {
+        written = snprintf(buffer, buffer_size, "%" PRId64, column->i64[row]);
+    } else {
+        written = snprintf(buffer, buffer_size, "%.15g", column->f64[row]);
+    }
+    if (written < 0) {
+        if (buffer_size > 0) buffer[0] = '\0';
+        return 0;
+    }
+    return (size_t)written < buffer_size ? (size_t)written : buffer_size - 1;
+}
+
+// Writes one cell into the slot for table->row_count. The row counter is only
+// advanced by the caller once every column has been written.
+static int store_value(InMemoryTable *table, size_t col, const InMemoryValue *value) {
+    InMemoryColumn *column = &table->columns[col];
+    size_t row = table->row_count;
+    size_t length;
+
+    switch (column->type) {
+        case COLUMN_TYPE_STRING: {
+            const char *src = value->str.ptr ? value->str.ptr : "";
+            length = value->str.ptr ? value->str.len : 0;
+            if (length > UINT32_MAX) length = UINT32_MAX;
+            if (reserve_arena(column, length + 1) != 0) return -1;
+            memcpy(column->arena + column->arena_size, src, length);
+            column->arena[column->arena_size + length] = '\0';
+            column->offsets[row] = column->arena_size;
+            column->lengths[row] = (uint32_t)length;
+            column->arena_size += length + 1;
+            break;
+        }
+        case COLUMN_TYPE_INT64:
+        case COLUMN_TYPE_DOUBLE: {
+            char number_buffer[IN_MEMORY_NUMBER_BUFFER_SIZE];
+            if (column->type == COLUMN_TYPE_INT64) {
+                column->i64[row] = value->i64;
+            } else {
+                column->f64[row] = value->f64;
+            }
+            length = format_number(column, row, number_buffer, sizeof(number_buffer));
+            break;
+        }
+        default:
+            return -1;
+    }
+
+    if (length > column->max_length) {
+        column->max_length = length;
+    }
+    return 0;
+}
+
+static int ensure_row_capacity(InMemoryTable *table) {
+    if (table->row_count < table->capacity) {
+        return 0;
+    }
+    size_t new_capacity = table->capacity * 2;
+    for (size_t col = 0; col < table->col_count; col++) {
+        if (resize_column_rows(&table->columns[col], new_capacity) != 0) {
+            return -1; // Columns that did grow keep their larger buffers
+        }
+    }
+    table->capacity = new_capacity;
+    return 0;
+}
+
+// --- Public API ---
+
+InMemoryTable* create_typed_in_memory_table(const char *title, size_t col_count, const char **headers, const ColumnType *types) {
     if (col_count == 0 || !headers) {
         return NULL;
     }
@@ -21,77 +149,127 @@ InMemoryTable* create_in_memory_table(const char *title, size_t col_count, const
 
     table->col_count = col_count;
     table->headers = calloc(col_count, sizeof(char*));
-    if (!table->headers) {
-        free(table->title);
-        free(table);
+    table->columns = calloc(col_count, sizeof(InMemoryColumn));
+    if (!table->headers || !table->columns) {
+        free_in_memory_table(table);
         return NULL;
     }
 
+    table->capacity = INITIAL_TABLE_CAPACITY;
     for (size_t i = 0; i < col_count; i++) {
         table->headers[i] = strdup(headers[i]);
-        if (!table->headers[i]) {
-            // Rollback on failure
-            for (size_t j = 0; j < i; j++) {
-                free(table->headers[j]);
-            }
-            free(table->headers);
-            free(table->title);
-            free(table);
+        table->columns[i].type = types ? types[i] : COLUMN_TYPE_STRING;
+        if (!table->headers[i] || resize_column_rows(&table->columns[i], table->capacity) != 0) {
+            free_in_memory_table(table);
             return NULL;
         }
     }
 
-    table->capacity = INITIAL_TABLE_CAPACITY;
-    table->data = calloc(table->capacity, sizeof(char**));
-    if (!table->data) {
-        for (size_t i = 0; i < col_count; i++) {
-            free(table->headers[i]);
-        }
-        free(table->headers);
-        free(table->title);
-        free(table);
-        return NULL;
-    }
-
     return table;
 }
 
-int add_in_memory_table_row(InMemoryTable *table, const char **row_data) {
-    if (!table || !row_data) {
+InMemoryTable* create_in_memory_table(const char *title, size_t col_count, const char **headers) {
+    return create_typed_in_memory_table(title, col_count, headers, NULL);
+}
+
+int add_in_memory_table_row_values(InMemoryTable *table, const InMemoryValue *values) {
+    if (!table || !values) {
         return -1;
     }
+    if (ensure_row_capacity(table) != 0) {
+        return -1; // Allocation failure
+    }
 
-    if (table->row_count >= table->capacity) {
-        size_t new_capacity = table->capacity * 2;
-        char ***new_data = realloc(table->data, new_capacity * sizeof(char**));
-        if (!new_data) {
-            return -1; // Allocation failure
+    for (size_t col = 0; col < table->col_count; col++) {
+        if (store_value(table, col, &values[col]) != 0) {
+            // Arena bytes already written for earlier columns are simply
+            // left unused; the row itself is never published.
+            return -1;
         }
-        table->data = new_data;
-        table->capacity = new_capacity;
     }
 
-    char **new_row = calloc(table->col_count, sizeof(char*));
-    if (!new_row) {
+    table->row_count++;
+    return 0;
+}
+
+int add_in_memory_table_row(InMemoryTable *table, const char **row_data) {
+    if (!table || !row_data) {
+        return -1;
+    }
+    if (ensure_row_capacity(table) != 0) {
         return -1;
     }
 
-    for (size_t i = 0; i < table->col_count; i++) {
-        new_row[i] = strdup(row_data[i] ? row_data[i] : "");
-        if (!new_row[i]) {
-            // Rollback
-            for (size_t j = 0; j < i; j++) {
-                free(new_row[j]);
-            }
-            free(new_row);
+    for (size_t col = 0; col < table->col_count; col++) {
+        const char *text = row_data[col] ? row_data[col] : "";
+        InMemoryValue value;
+        switch (table->columns[col].type) {
+            case COLUMN_TYPE_INT64:
+                value.i64 = strtoll(text, NULL, 10);
+                break;
+            case COLUMN_TYPE_DOUBLE:
+                value.f64 = strtod(text, NULL);
+                break;
+            default:
+                value.str.ptr = text;
+                value.str.len = strlen(text);
+                break;
+        }
+        if (store_value(table, col, &value) != 0) {
             return -1;
         }
     }
 
-    table->data[table->row_count++] = new_row;
+    table->row_count++;
     return 0;
 }
 
+const char* in_memory_table_get_string(const InMemoryTable *table, size_t row, size_t col, size_t *out_length) {
+    if (!table || row >= table->row_count || col >= table->col_count) {
+        return NULL;
+    }
+    const InMemoryColumn *column = &table->columns[col];
+    if (column->type != COLUMN_TYPE_STRING) {
+        return NULL;
+    }
+    if (out_length) {
+        *out_length = column->lengths[row];
+    }
+    return column->arena + column->offsets[row];
+}
+
+size_t in_memory_table_format_cell(const InMemoryTable *table, size_t row, size_t col, char *buffer, size_t buffer_size) {
+    if (!buffer || buffer_size == 0) {
+        return 0;
+    }
+    if (!table || row >= table->row_count || col >= table->col_count) {
+        buffer[0] = '\0';
+        return 0;
+    }
+
+    const InMemoryColumn *column = &table->columns[col];
+    if (column->type != COLUMN_TYPE_STRING) {
+        return format_number(column, row, buffer, buffer_size);
+    }
+
+    size_t length = column->lengths[row];
+    if (length >= buffer_size) {
+        length = buffer_size - 1;
+    }
+    memcpy(buffer, column->arena + column->offsets[row], length);
+    buffer[length] = '\0';
+    return length;
+}
+
+size_t in_memory_table_column_width(const InMemoryTable *table, size_t col) {
+    if (!table || col >= table->col_count) {
+        return 0;
+    }
+    size_t header_length = table->headers[col] ? strlen(table->headers[col]) : 0;
+    size_t data_length = table->columns[col].max_length;
+    return header_length > data_length ? header_length : data_length;
+}
+
 void free_in_memory_table(InMemoryTable *table) {
     if (!table) {
         return;
@@ -106,17 +284,12 @@ void free_in_memory_table(InMemoryTable *table) {
         free(table->headers);
     }
 
-    if (table->data) {
-        for (size_t i = 0; i < table->row_count; i++) {
-            if (table->data[i]) {
-                for (size_t j = 0; j < table->col_count; j++) {
-                    free(table->data[i][j]);
-                }
-                free(table->data[i]);
-            }
+    if (table->columns) {
+        for (size_t i = 0; i < table->col_count; i++) {
+            free_column(&table->columns[i]);
         }
-        free(table->data);
+        free(table->columns);
     }
 
     free(table);
-} 
\ No newline at end of file
+}
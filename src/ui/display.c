@@ -7,6 +7,9 @@
 #include "navigation.h"
 #include "analysis.h"
 #include "core/parser.h"
+#include "core/sorting.h"
+#include "core/search.h"
+#include "core/column_stats.h"
 #include <ncurses.h>
 #include <wchar.h>
 #include <string.h>
@@ -51,12 +54,10 @@ static bool should_show_status(DSVViewer *viewer) {
 
 // Simple helper: get column width with fallback
 static int get_column_width(DSVViewer *viewer, const ViewState *state, size_t col) {
+    (void)viewer;
     DataSource *ds = state->current_view->data_source;
-    if (ds->type == DATA_SOURCE_MEMORY) {
-        return ds->ops->get_column_width(ds->context, col);
-    } else { // DATA_SOURCE_FILE
-        return analysis_get_column_width(viewer, col);
-    }
+    // File sources sample widths lazily; wrapping sources delegate to them.
+    return ds->ops->get_column_width(ds->context, col);
 }
 
 // Simple helper: add separator if conditions are met
@@ -281,6 +282,7 @@ static bool get_column_screen_position(DSVViewer *viewer, const ViewState *state
 
 static void display_table_view(DSVViewer *viewer, const ViewState *state);
 static void display_help_panel(void);
+static void display_column_stats_panel(DSVViewer *viewer, const ViewState *state);
 
 // Draw regular data row (keep simple, it works!)
 static int draw_data_row(int y, DSVViewer *viewer, const ViewState *state, size_t display_row, size_t start_col, const DSVConfig *config) {
@@ -378,6 +380,10 @@ void display_data(DSVViewer *viewer, const ViewState *state) {
         case PANEL_HELP:
             display_help_panel();
             break;
+        case PANEL_COLUMN_STATS:
+            display_table_view(viewer, state);
+            display_column_stats_panel(viewer, state);
+            break;
     }
 
     refresh();
@@ -518,9 +524,25 @@ static void display_table_view(DSVViewer *viewer, const ViewState *state) {
     
     // Check for special modes first, as they take priority
     if (state->input_mode == INPUT_MODE_SEARCH) {
-        mvprintw(rows - 1, 0, "/%s", state->search_term);
+        static const char *prompts[] = { "/", "re/", "i/", "re,i/" };
+        const char *prompt = prompts[state->search_flags & (SEARCH_REGEX | SEARCH_IGNORE_CASE)];
+        mvprintw(rows - 1, 0, "%s%s", prompt, state->search_term);
+        size_t matches;
+        if (state->current_view && state->current_view->pending_search) {
+            printw("   [searching...]");
+        } else if (search_view_match_count(state->current_view, state->search_term, state->search_flags, &matches)) {
+            printw("   [%zu match%s]", matches, matches == 1 ? "" : "es");
+        }
         // Place cursor at the end of the typed term
-        move(rows - 1, strlen(state->search_term) + 1);
+        move(rows - 1, strlen(state->search_term) + strlen(prompt));
+    }
+    else if (state->input_mode == INPUT_MODE_EXPRESSION) {
+        mvprintw(rows - 1, 0, "=%s", state->prompt_input);
+        move(rows - 1, strlen(state->prompt_input) + 1);
+    }
+    else if (state->input_mode == INPUT_MODE_JOIN) {
+        mvprintw(rows - 1, 0, "Join with: %s", state->prompt_input);
+        move(rows - 1, strlen(state->prompt_input) + 11);
     }
     else if (should_show_error(viewer)) {
         attron(COLOR_PAIR(COLOR_PAIR_ERROR));
@@ -548,15 +570,30 @@ static void display_table_view(DSVViewer *viewer, const ViewState *state) {
                  start_row + 1, viewing_end, current_view->visible_row_count,
                  current_view->selection_count);
         
-        // Append sort status if applicable
-        if (current_view->sort_direction != SORT_NONE) {
-            char sort_col_name[256];
-            char temp_buffer[256]; // Buffer for get_column_name
-            get_column_name(viewer, current_view->sort_column, temp_buffer, sizeof(temp_buffer));
-            snprintf(sort_col_name, sizeof(sort_col_name), " | Sorted by: %s (%s)",
-                     temp_buffer,
-                     current_view->sort_direction == SORT_ASC ? "ASC" : "DESC");
-            strncat(status_buffer, sort_col_name, sizeof(status_buffer) - strlen(status_buffer) - 1);
+        // Append the sort spec if applicable, e.g. "region ASC, revenue DESC"
+        if (current_view->sort_direction != SORT_NONE && current_view->sort_key_count > 0) {
+            char temp_buffer[256]; // Buffer for the column name
+            char sort_col_name[sizeof(temp_buffer) + 16]; // Plus separator and direction
+            DataSource *view_ds = current_view->data_source;
+            strncat(status_buffer, " | Sorted by: ", sizeof(status_buffer) - strlen(status_buffer) - 1);
+            for (size_t k = 0; k < current_view->sort_key_count; k++) {
+                const SortKeySpec *key = &current_view->sort_keys[k];
+                FieldDesc sort_header = view_ds->ops->get_header(view_ds->context, key->column);
+                if (sort_header.start) {
+                    render_field(&sort_header, temp_buffer, sizeof(temp_buffer));
+                } else {
+                    get_column_name(viewer, key->column, temp_buffer, sizeof(temp_buffer));
+                }
+                snprintf(sort_col_name, sizeof(sort_col_name), "%s%s %s",
+                         k > 0 ? ", " : "", temp_buffer,
+                         key->direction == SORT_ASC ? "ASC" : "DESC");
+                strncat(status_buffer, sort_col_name, sizeof(status_buffer) - strlen(status_buffer) - 1);
+            }
+            if (current_view->pending_sort) {
+                snprintf(sort_col_name, sizeof(sort_col_name), " (sorting, top %zu ready)",
+                         sort_view_ready_rows(current_view));
+                strncat(status_buffer, sort_col_name, sizeof(status_buffer) - strlen(status_buffer) - 1);
+            }
         }
 
         // Append search message if it exists
@@ -572,6 +609,72 @@ static void display_help_panel(void) {
     show_help();
 }
 
+#define STATS_PANEL_WIDTH 48
+#define STATS_PANEL_LABEL_WIDTH 10
+
+// Draws one "label  value" line of the statistics box.
+static void stats_panel_line(int y, int x, const char *label, const char *format, ...) {
+    char value[STATS_PANEL_WIDTH];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(value, sizeof(value), format, args);
+    va_end(args);
+    mvprintw(y, x, "| %-*s %-*.*s |", STATS_PANEL_LABEL_WIDTH, label,
+             STATS_PANEL_WIDTH - STATS_PANEL_LABEL_WIDTH - 5, STATS_PANEL_WIDTH - STATS_PANEL_LABEL_WIDTH - 5, value);
+}
+
+// Boxes the cursor column's cached statistics over the right of the table.
+static void display_column_stats_panel(DSVViewer *viewer, const ViewState *state) {
+    View *view = state->current_view;
+    if (!view || view->cursor_col >= view->column_stats_size || !view->column_stats[view->cursor_col]) return;
+    const ColumnStats *stats = view->column_stats[view->cursor_col];
+
+    int rows, cols;
+    getmaxyx(stdscr, rows, cols);
+    int x = cols > STATS_PANEL_WIDTH ? cols - STATS_PANEL_WIDTH - 1 : 0;
+    int y = 1;
+    (void)rows;
+
+    char name[STATS_PANEL_WIDTH];
+    DataSource *ds = view->data_source;
+    FieldDesc header = ds->ops->get_header(ds->context, view->cursor_col);
+    if (header.start) {
+        render_field(&header, name, sizeof(name));
+    } else {
+        get_column_name(viewer, (int)view->cursor_col, name, sizeof(name));
+    }
+
+    char border[STATS_PANEL_WIDTH + 1];
+    memset(border, '-', STATS_PANEL_WIDTH);
+    border[0] = border[STATS_PANEL_WIDTH - 1] = '+';
+    border[STATS_PANEL_WIDTH] = '\0';
+
+    attron(A_REVERSE);
+    mvprintw(y++, x, "%s", border);
+    stats_panel_line(y++, x, "Column", "%s", name);
+    stats_panel_line(y++, x, "Count", "%zu", stats->count);
+    stats_panel_line(y++, x, "Nulls", "%zu", stats->nulls);
+    stats_panel_line(y++, x, "Distinct", "~%.0f (+/-%.1f%%)", stats->distinct_estimate, stats->distinct_error * 100.0);
+    stats_panel_line(y++, x, "Numeric", "%zu of %zu", stats->numeric_count, stats->count);
+    if (stats->numeric_count > 0) {
+        stats_panel_line(y++, x, "Min", "%.10g", stats->min);
+        stats_panel_line(y++, x, "Max", "%.10g", stats->max);
+        stats_panel_line(y++, x, "Sum", "%.10g", stats->sum);
+        stats_panel_line(y++, x, "Mean", "%.10g", stats->mean);
+        stats_panel_line(y++, x, "Std dev", "%.10g", stats->stddev);
+        stats_panel_line(y++, x, "Median", "~%.10g", stats->median);
+        stats_panel_line(y++, x, "P90 / P99", "~%.6g / ~%.6g", stats->p90, stats->p99);
+    }
+    if (stats->numeric_count < stats->count) {
+        stats_panel_line(y++, x, "Min text", "%s", stats->min_text ? stats->min_text : "");
+        stats_panel_line(y++, x, "Max text", "%s", stats->max_text ? stats->max_text : "");
+    }
+    stats_panel_line(y++, x, "Length", "%zu - %zu chars", stats->min_length, stats->max_length);
+    stats_panel_line(y++, x, "", "Left/Right: other columns");
+    mvprintw(y, x, "%s", border);
+    attroff(A_REVERSE);
+}
+
 void show_help(void) {
     clear();
     mvprintw(1, HELP_INDENT_COL, "DSV (Delimiter-Separated Values) Viewer - Help");
@@ -588,13 +691,20 @@ void show_help(void) {
     mvprintw(13, HELP_ITEM_INDENT_COL, "v             - Create a new view from selected rows");
     mvprintw(14, HELP_ITEM_INDENT_COL, "Tab/Shift+Tab - Cycle through open views");
     mvprintw(15, HELP_ITEM_INDENT_COL, "x             - Close the current view (except Main)");
-
-    mvprintw(17, HELP_INDENT_COL, "General:");
-    mvprintw(18, HELP_ITEM_INDENT_COL, "y             - Copy current cell to clipboard");
-    mvprintw(19, HELP_ITEM_INDENT_COL, "h             - Show this help screen");
-    mvprintw(20, HELP_ITEM_INDENT_COL, "q             - Quit the application");
-
-    mvprintw(22, HELP_INDENT_COL, "Press any key to return...");
+    mvprintw(16, HELP_ITEM_INDENT_COL, "=             - Add a computed column (e.g. total = price*qty)");
+    mvprintw(17, HELP_ITEM_INDENT_COL, "J             - Join with another file on the current column");
+    mvprintw(18, HELP_ITEM_INDENT_COL, "] / }         - Sort by column / add it to a multi-column sort");
+    mvprintw(19, HELP_ITEM_INDENT_COL, "& / f         - New view of rows matching the search (any / this column)");
+    mvprintw(20, HELP_ITEM_INDENT_COL, "F / R         - Value counts of the column / count an approximate one exactly");
+    mvprintw(21, HELP_ITEM_INDENT_COL, "S / B         - Statistics of the column / histogram of its numbers");
+
+    mvprintw(23, HELP_INDENT_COL, "General:");
+    mvprintw(24, HELP_ITEM_INDENT_COL, "/ , n / N     - Search, next / previous match (Ctrl-R regex, Ctrl-T any case)");
+    mvprintw(25, HELP_ITEM_INDENT_COL, "y             - Copy current cell to clipboard");
+    mvprintw(26, HELP_ITEM_INDENT_COL, "h             - Show this help screen");
+    mvprintw(27, HELP_ITEM_INDENT_COL, "q             - Quit the application");
+
+    mvprintw(29, HELP_INDENT_COL, "Press any key to return...");
     refresh();
     getch();
 }
@@ -11,11 +11,28 @@
 #include "memory/in_memory_table.h"
 #include "core/sorting.h"
 #include "core/search.h"
+#include "core/computed_source.h"
+#include "core/join.h"
+#include "core/value_index.h"
+#include "core/frequency_source.h"
+#include "core/column_stats.h"
+#include "core/sketch.h"
+#include <sys/stat.h>
 
 // Forward declarations for copy functionality
 static char* get_field_at_cursor(const ViewState *state);
 static void copy_to_clipboard_with_status(DSVViewer *viewer, const char *text);
 static InputResult handle_search_input(int ch, struct DSVViewer *viewer, ViewState *state);
+static void report_search_result(ViewState *state, SearchResult result);
+static void filter_view_by_search(struct DSVViewer *viewer, ViewState *state, int column);
+static InputResult handle_prompt_input(int ch, struct DSVViewer *viewer, ViewState *state);
+static void analyze_column_frequency(struct DSVViewer *viewer, ViewState *state);
+static void refine_frequency_view(struct DSVViewer *viewer, ViewState *state);
+static InputResult handle_column_stats_input(int ch, struct DSVViewer *viewer, ViewState *state);
+static bool show_column_stats(struct DSVViewer *viewer, ViewState *state);
+static void open_histogram_view(struct DSVViewer *viewer, ViewState *state);
+static void frequency_view_name(const View *parent_view, size_t col_idx, const char *prefix,
+                                char *name, size_t name_size);
 
 // Helper function to get the field value at the current cursor position
 static char* get_field_at_cursor(const ViewState *state) {
@@ -149,100 +166,23 @@ InputResult handle_table_input(int ch, struct DSVViewer *viewer, ViewState *stat
             break;
         case 'F': // Shift+F
             if (state->current_view) {
-                char col_name[256];
-                DataSource *current_ds = state->current_view->data_source;
-                FieldDesc header_fd = current_ds->ops->get_header(current_ds->context, state->current_view->cursor_col);
-
-                if (header_fd.start) {
-                    render_field(&header_fd, col_name, sizeof(col_name));
-                } else {
-                    snprintf(col_name, sizeof(col_name), "Column %zu", state->current_view->cursor_col + 1);
-                }
-                
-                ValueIndex *value_index = NULL;
-                View *parent_view = state->current_view;
-                size_t col_idx = parent_view->cursor_col;
-
-                // Build the reverse map for the parent if it doesn't exist
-                if (!parent_view->reverse_row_map) {
-                    view_build_reverse_map(parent_view);
-                }
-
-                // Check cache first
-                if (col_idx < parent_view->analysis_cache_size && parent_view->analysis_cache[col_idx]) {
-                    value_index = parent_view->analysis_cache[col_idx];
-                }
-
-                InMemoryTable* table = NULL;
-                if (value_index) {
-                    // We need to recreate the table from the index, this is a future optimization
-                    // For now, we re-run the analysis to get the table. The index is still used for selection.
-                    table = perform_frequency_analysis(viewer, parent_view, col_idx, &value_index);
-                } else {
-                    table = perform_frequency_analysis(viewer, parent_view, col_idx, &value_index);
-                    // Store new index in cache
-                    if (value_index && col_idx < parent_view->analysis_cache_size) {
-                        parent_view->analysis_cache[col_idx] = value_index;
-                    }
-                }
-
-                if (table) {
-                    // Create data source for the table
-                    DataSource *ds = create_memory_data_source(table);
-                    if (!ds) {
-                        free_in_memory_table(table);
-                        set_error_message(viewer, "Failed to create data source for frequency analysis");
-                        return INPUT_CONSUMED;
-                    }
-                    
-                    // Create new view
-                    View *freq_view = calloc(1, sizeof(View));
-                    if (!freq_view) {
-                        destroy_data_source(ds);
-                        set_error_message(viewer, "Failed to allocate memory for frequency view");
-                        return INPUT_CONSUMED;
-                    }
-                    
-                    snprintf(freq_view->name, sizeof(freq_view->name), 
-                             "Freq: %s", col_name);
-                    freq_view->data_source = ds;
-                    freq_view->owns_data_source = true;
-                    freq_view->value_index = value_index; // Use the cached or new index
-                    freq_view->visible_rows = NULL;
-                    freq_view->visible_row_count = ds->ops->get_row_count(ds->context);
-                    
-                    // Establish parent-child relationship for linked selection
-                    freq_view->parent = state->current_view;
-                    freq_view->parent_source_column = state->current_view->cursor_col;
-                    
-                    // Initialize cursor position
-                    freq_view->cursor_row = 0;
-                    freq_view->cursor_col = 0;
-                    freq_view->start_row = 0;
-                    freq_view->start_col = 0;
-                    
-                    // Initialize selection state for frequency view
-                    init_row_selection(freq_view, freq_view->visible_row_count);
-                    
-                    // Add to view manager
-                    if (!add_view_to_manager(viewer->view_manager, freq_view)) {
-                        free(freq_view);
-                        destroy_data_source(ds);
-                        // Do not free the index, it's now owned by the parent's cache
-                        // free_value_index(value_index); 
-                        set_error_message(viewer, "Maximum number of views reached (%zu)", 
-                                        viewer->view_manager->max_views);
-                        return INPUT_CONSUMED;
-                    }
-                    
-                    // Switch to new view
-                    viewer->view_manager->current = freq_view;
-                    reset_view_state_for_new_view(state, freq_view);
-                    state->current_view = freq_view;
-                    state->needs_redraw = true;
-                } else {
-                    set_error_message(viewer, "Frequency analysis failed - column may be empty");
-                }
+                analyze_column_frequency(viewer, state);
+            }
+            return INPUT_CONSUMED;
+        case 'S': // Statistics of the current column
+            if (state->current_view && show_column_stats(viewer, state)) {
+                state->current_panel = PANEL_COLUMN_STATS;
+                state->needs_redraw = true;
+            }
+            return INPUT_CONSUMED;
+        case 'B': // Histogram of the current column
+            if (state->current_view) {
+                open_histogram_view(viewer, state);
+            }
+            return INPUT_CONSUMED;
+        case 'R': // Count an approximate frequency view's values exactly
+            if (state->current_view) {
+                refine_frequency_view(viewer, state);
             }
             return INPUT_CONSUMED;
         case ' ':
@@ -306,19 +246,41 @@ InputResult handle_table_input(int ch, struct DSVViewer *viewer, ViewState *stat
                 state->needs_redraw = true;
             }
             return INPUT_CONSUMED;
+        case '}': // Add the current column to a multi-column sort
+            if (state->current_view) {
+                if (!sort_view_toggle_key(state->current_view, (int)state->current_view->cursor_col)) {
+                    set_error_message(viewer, "At most %d sort columns", MAX_SORT_KEYS);
+                }
+                state->needs_redraw = true;
+            }
+            return INPUT_CONSUMED;
         case 'n': // Find next search result
+        case 'N': // Find previous search result
             if (state->search_term[0] != '\0') {
-                SearchResult result = search_view(viewer, state->current_view, state->search_term, false);
-                if (result == SEARCH_WRAPPED_AND_FOUND) {
-                    snprintf(state->search_message, sizeof(state->search_message), "| Found: %s - search wrapped", state->search_term);
-                } else if (result == SEARCH_FOUND) {
-                    snprintf(state->search_message, sizeof(state->search_message), "| Found: %s", state->search_term);
-                }
+                SearchResult result = ch == 'n'
+                    ? search_view(viewer, state->current_view, state->search_term, state->search_flags, false)
+                    : search_view_previous(viewer, state->current_view, state->search_term, state->search_flags);
+                report_search_result(state, result);
                 state->needs_redraw = true;
             } else {
                 set_error_message(viewer, "No active search term");
             }
             return INPUT_CONSUMED;
+        case '&': // New view of the rows matching the search term
+        case 'f': // ... in the current column only
+            if (state->current_view) {
+                filter_view_by_search(viewer, state, ch == 'f' ? (int)state->current_view->cursor_col : -1);
+                state->needs_redraw = true;
+            }
+            return INPUT_CONSUMED;
+        case '=': // Add a computed column
+            state->input_mode = INPUT_MODE_EXPRESSION;
+            state->needs_redraw = true;
+            return INPUT_CONSUMED;
+        case 'J': // Join the current view with another file
+            state->input_mode = INPUT_MODE_JOIN;
+            state->needs_redraw = true;
+            return INPUT_CONSUMED;
         case '/':
             state->input_mode = INPUT_MODE_SEARCH;
             // Don't clear the search term, so user can edit the previous one
@@ -363,6 +325,9 @@ InputResult route_input(int ch, struct DSVViewer *viewer, ViewState *state) {
     if (state->input_mode == INPUT_MODE_SEARCH) {
         return handle_search_input(ch, viewer, state);
     }
+    if (state->input_mode == INPUT_MODE_EXPRESSION || state->input_mode == INPUT_MODE_JOIN) {
+        return handle_prompt_input(ch, viewer, state);
+    }
 
     // First, check for global commands
     GlobalResult global_result = handle_global_input(ch, state);
@@ -382,6 +347,9 @@ InputResult route_input(int ch, struct DSVViewer *viewer, ViewState *state) {
             state->needs_redraw = true;
             return INPUT_CONSUMED;
 
+        case PANEL_COLUMN_STATS:
+            return handle_column_stats_input(ch, viewer, state);
+
         case PANEL_HELP:
             // Help panel would handle its own input here
             // For now, just return ignored
@@ -392,13 +360,142 @@ InputResult route_input(int ch, struct DSVViewer *viewer, ViewState *state) {
     }
 }
 
+// --- Column Statistics Panel ---
+
+// Computes (or fetches from the view's cache) the cursor column's statistics.
+static bool show_column_stats(struct DSVViewer *viewer, ViewState *state) {
+    View *view = state->current_view;
+    if (view->visible_row_count == 0) {
+        set_error_message(viewer, "No rows to summarize");
+        return false;
+    }
+    if (!view_column_stats(view, view->cursor_col, (size_t)viewer->config->max_field_len)) {
+        set_error_message(viewer, "Failed to compute column statistics");
+        return false;
+    }
+    return true;
+}
+
+#define HISTOGRAM_BINS 20
+
+// Opens a histogram of the cursor column's numbers, built from the quantile
+// sketch its statistics already hold.
+static void open_histogram_view(struct DSVViewer *viewer, ViewState *state) {
+    View *view = state->current_view;
+    if (!show_column_stats(viewer, state)) return;
+    const ColumnStats *stats = view_column_stats(view, view->cursor_col, (size_t)viewer->config->max_field_len);
+    if (stats->numeric_count == 0) {
+        set_error_message(viewer, "Column has no numbers to bin");
+        return;
+    }
+    if (viewer->view_manager->view_count >= viewer->view_manager->max_views) {
+        set_error_message(viewer, "Maximum number of views reached (%zu)",
+                          viewer->view_manager->max_views);
+        return;
+    }
+
+    InMemoryTable *table = column_stats_histogram(stats, HISTOGRAM_BINS);
+    DataSource *ds = table ? create_memory_data_source(table) : NULL;
+    if (!ds) {
+        if (table) free_in_memory_table(table);
+        set_error_message(viewer, "Failed to build histogram");
+        return;
+    }
+    View *hist_view = create_main_view(ds);
+    if (!hist_view) {
+        destroy_data_source(ds);
+        set_error_message(viewer, "Failed to allocate memory for histogram view");
+        return;
+    }
+    char name[sizeof(hist_view->name)];
+    frequency_view_name(view, view->cursor_col, "Hist", name, sizeof(name));
+    snprintf(hist_view->name, sizeof(hist_view->name), "%s", name);
+    hist_view->owns_data_source = true;
+    init_row_selection(hist_view, hist_view->visible_row_count);
+
+    if (!add_view_to_manager(viewer->view_manager, hist_view)) {
+        cleanup_row_selection(hist_view);
+        free(hist_view->analysis_cache);
+        free(hist_view);
+        destroy_data_source(ds);
+        set_error_message(viewer, "Failed to add histogram view");
+        return;
+    }
+
+    viewer->view_manager->current = hist_view;
+    reset_view_state_for_new_view(state, hist_view);
+    state->needs_redraw = true;
+    set_status_message(viewer, "%zu numbers, median ~%.6g; counts are estimates (+/-%.1f%% of rank)",
+                       stats->numeric_count, stats->median, kll_rank_error() * 100.0);
+}
+
+// Left and right move the panel to the neighbouring columns; any other key
+// closes it.
+static InputResult handle_column_stats_input(int ch, struct DSVViewer *viewer, ViewState *state) {
+    if ((ch == KEY_LEFT || ch == KEY_RIGHT) && state->current_view) {
+        handle_table_input(ch, viewer, state);
+        if (!show_column_stats(viewer, state)) state->current_panel = PANEL_TABLE_VIEW;
+    } else {
+        state->current_panel = PANEL_TABLE_VIEW;
+    }
+    state->needs_redraw = true;
+    return INPUT_CONSUMED;
+}
+
 // --- Search Input Handler ---
 
+// Shows the match the cursor landed on in the status bar.
+static void report_search_result(ViewState *state, SearchResult result) {
+    size_t index, count;
+    if (result == SEARCH_NOT_FOUND || !search_view_match_position(state->current_view, &index, &count)) {
+        return;
+    }
+    snprintf(state->search_message, sizeof(state->search_message), "| Found: %s - match %zu of %zu%s",
+             state->search_term, index + 1, count,
+             result == SEARCH_WRAPPED_AND_FOUND ? " - search wrapped" : "");
+}
+
+// Opens a view of the rows matching the search term, in 'column' or (-1) any column.
+static void filter_view_by_search(struct DSVViewer *viewer, ViewState *state, int column) {
+    View *view = state->current_view;
+    if (!view || state->search_term[0] == '\0') {
+        set_error_message(viewer, "No active search term - use / to enter one");
+        return;
+    }
+    if (viewer->view_manager->view_count >= viewer->view_manager->max_views) {
+        set_error_message(viewer, "Maximum number of views reached (%zu)", viewer->view_manager->max_views);
+        return;
+    }
+
+    RowRange *ranges;
+    size_t range_count, row_count;
+    char error[128] = "";
+    DSVResult result = search_filter_rows(view, state->search_term, state->search_flags, column,
+                                          &ranges, &range_count, &row_count, error, sizeof(error));
+    if (result == DSV_ERROR_PARSE) {
+        set_error_message(viewer, "Invalid pattern: %s", error);
+        return;
+    }
+    if (result != DSV_OK) {
+        set_error_message(viewer, "Filter failed: %s", dsv_result_to_string(result));
+        return;
+    }
+    if (row_count == 0) {
+        set_error_message(viewer, "No rows match: %s", state->search_term);
+        return;
+    }
+    if (!create_view_from_ranges(viewer->view_manager, state, ranges, range_count, row_count, view->data_source)) {
+        free(ranges);
+        set_error_message(viewer, "Failed to create view - out of memory");
+    }
+}
+
 static InputResult handle_search_input(int ch, struct DSVViewer *viewer, ViewState *state) {
     (void)viewer; // viewer might be used later for search execution
 
     switch(ch) {
         case 27: // ESC key
+            search_incremental_cancel(state->current_view);
             state->input_mode = INPUT_MODE_NORMAL;
             state->search_term[0] = '\0';
             state->needs_redraw = true;
@@ -408,15 +505,19 @@ static InputResult handle_search_input(int ch, struct DSVViewer *viewer, ViewSta
         case '\n':
         case '\r':
             state->input_mode = INPUT_MODE_NORMAL;
-            SearchResult result = search_view(viewer, state->current_view, state->search_term, true);
-            if (result == SEARCH_WRAPPED_AND_FOUND) {
-                snprintf(state->search_message, sizeof(state->search_message), "| Found: %s - search wrapped", state->search_term);
-            } else if (result == SEARCH_FOUND) {
-                snprintf(state->search_message, sizeof(state->search_message), "| Found: %s", state->search_term);
-            }
+            SearchResult result = search_view(viewer, state->current_view, state->search_term, state->search_flags, true);
+            report_search_result(state, result);
             state->needs_redraw = true;
             return INPUT_CONSUMED;
 
+        case 18: // Ctrl-R: toggle regular expression matching
+            state->search_flags ^= SEARCH_REGEX;
+            break;
+
+        case 20: // Ctrl-T: toggle case-insensitive matching
+            state->search_flags ^= SEARCH_IGNORE_CASE;
+            break;
+
         case KEY_BACKSPACE:
         case 127: // Handle backspace variations
         case 8:   // Handle backspace variations
@@ -426,8 +527,7 @@ static InputResult handle_search_input(int ch, struct DSVViewer *viewer, ViewSta
                     state->search_term[len - 1] = '\0';
                 }
             }
-            state->needs_redraw = true;
-            return INPUT_CONSUMED;
+            break;
 
         default:
             // Append printable characters to the search term
@@ -438,7 +538,344 @@ static InputResult handle_search_input(int ch, struct DSVViewer *viewer, ViewSta
                     state->search_term[len + 1] = '\0';
                 }
             }
+            break;
+    }
+
+    // Count the matches of the edited term while the user keeps typing.
+    search_incremental_update(state->current_view, state->search_term, state->search_flags);
+    state->needs_redraw = true;
+    return INPUT_CONSUMED;
+}
+
+// --- Computed Column Input Handler ---
+
+// Wraps the current view's data source in one that adds the typed column.
+static void apply_computed_column(struct DSVViewer *viewer, ViewState *state) {
+    View *view = state->current_view;
+    if (!view || !view->data_source) return;
+
+    // The analysis cache is indexed by column, so make room for one more
+    // slot first; growing it is harmless if the definition turns out invalid.
+    size_t col_count = view->data_source->ops->get_col_count(view->data_source->context) + 1;
+    if (view->analysis_cache && col_count > view->analysis_cache_size) {
+        ValueIndex **cache = realloc(view->analysis_cache, col_count * sizeof(ValueIndex*));
+        if (!cache) {
+            set_error_message(viewer, "Failed to allocate memory for computed column");
+            return;
+        }
+        for (size_t i = view->analysis_cache_size; i < col_count; i++) cache[i] = NULL;
+        view->analysis_cache = cache;
+        view->analysis_cache_size = col_count;
+    }
+
+    char error[256];
+    DataSource *computed = NULL;
+    DSVResult result = add_computed_column(view->data_source, view->owns_data_source, state->prompt_input,
+                                           viewer->config, &computed, error, sizeof(error));
+    if (result != DSV_OK) {
+        set_error_message(viewer, "%s", error[0] ? error : dsv_result_to_string(result));
+        return;
+    }
+
+    view->data_source = computed;
+    view->owns_data_source = true; // The wrapper owns the old source if the view did
+    view->cursor_col = col_count - 1;
+
+    FieldDesc header = computed->ops->get_header(computed->context, col_count - 1);
+    char name[256];
+    render_field(&header, name, sizeof(name));
+    set_status_message(viewer, "Added column: %s", name);
+}
+
+// --- Join Input Handler ---
+
+// Splits "file [key column]" typed at the join prompt. A name that exists as
+// typed is taken whole, so file names containing spaces keep working.
+static void split_join_input(char *input, const char **filename, const char **key_name) {
+    struct stat st;
+    *filename = input;
+    *key_name = NULL;
+    if (stat(input, &st) == 0) return;
+
+    char *space = strrchr(input, ' ');
+    if (space) {
+        *space = '\0';
+        *key_name = space + 1;
+    }
+}
+
+// Opens a child view of 'parent_view' over the frequency source 'ds', which it
+// takes over along with 'approx' (either may be freed on failure). A
+// 'value_index' links selections back to the parent.
+static void open_frequency_view(struct DSVViewer *viewer, ViewState *state, View *parent_view, size_t col_idx,
+                                DataSource *ds, ValueIndex *value_index, ApproxFrequency *approx,
+                                const char *name) {
+    View *freq_view = calloc(1, sizeof(View));
+    if (!freq_view) {
+        destroy_data_source(ds);
+        free_approximate_frequency(approx);
+        set_error_message(viewer, "Failed to allocate memory for frequency view");
+        return;
+    }
+
+    snprintf(freq_view->name, sizeof(freq_view->name), "%s", name);
+    freq_view->data_source = ds;
+    freq_view->owns_data_source = true;
+    freq_view->value_index = value_index_retain(value_index);
+    freq_view->approx_frequency = approx;
+    freq_view->visible_row_count = ds->ops->get_row_count(ds->context);
+
+    // Establish parent-child relationship for linked selection
+    freq_view->parent = parent_view;
+    freq_view->parent_source_column = (int)col_idx;
+    init_row_selection(freq_view, freq_view->visible_row_count);
+
+    if (!add_view_to_manager(viewer->view_manager, freq_view)) {
+        cleanup_row_selection(freq_view);
+        free_value_index(freq_view->value_index);
+        free(freq_view);
+        destroy_data_source(ds);
+        free_approximate_frequency(approx);
+        set_error_message(viewer, "Maximum number of views reached (%zu)",
+                          viewer->view_manager->max_views);
+        return;
+    }
+
+    viewer->view_manager->current = freq_view;
+    reset_view_state_for_new_view(state, freq_view);
+    state->current_view = freq_view;
+    state->needs_redraw = true;
+}
+
+// Names a frequency view after the analyzed column's header.
+static void frequency_view_name(const View *parent_view, size_t col_idx, const char *prefix,
+                                char *name, size_t name_size) {
+    char col_name[256];
+    DataSource *ds = parent_view->data_source;
+    FieldDesc header_fd = ds->ops->get_header(ds->context, col_idx);
+    if (header_fd.start) {
+        render_field(&header_fd, col_name, sizeof(col_name));
+    } else {
+        snprintf(col_name, sizeof(col_name), "Column %zu", col_idx + 1);
+    }
+    snprintf(name, name_size, "%s: %.*s", prefix, (int)(name_size - strlen(prefix) - 3), col_name);
+}
+
+// Opens a frequency view of the current column. Columns whose estimated
+// distinct count reaches approx_distinct_threshold get an approximate view
+// instead of an exact one, which 'R' can then refine.
+static void analyze_column_frequency(struct DSVViewer *viewer, ViewState *state) {
+    View *parent_view = state->current_view;
+    size_t col_idx = parent_view->cursor_col;
+    char name[sizeof(parent_view->name)];
+
+    // Row lists refer to displayed rows, so finish any background sort first
+    sort_view_wait(parent_view);
+
+    // Build the reverse map for the parent if it doesn't exist
+    if (!parent_view->reverse_row_map) {
+        view_build_reverse_map(parent_view);
+    }
+
+    // Reuse a cached analysis; it holds the counts and display order, so
+    // only the new view has to be built.
+    ValueIndex *value_index = NULL;
+    if (col_idx < parent_view->analysis_cache_size && parent_view->analysis_cache[col_idx]) {
+        value_index = parent_view->analysis_cache[col_idx];
+    } else {
+        // A column can't have more distinct values than rows, so small views
+        // skip the estimate. Cached statistics hold a full-pass estimate;
+        // otherwise a sample decides.
+        int threshold = viewer->config->approx_distinct_threshold;
+        if (threshold > 0 && parent_view->visible_row_count > (size_t)threshold) {
+            double distinct;
+            if (col_idx < parent_view->column_stats_size && parent_view->column_stats[col_idx]) {
+                distinct = parent_view->column_stats[col_idx]->distinct_estimate;
+            } else {
+                distinct = estimate_distinct_values(viewer, parent_view, (int)col_idx);
+            }
+            ApproxFrequency *approx = NULL;
+            if (distinct >= threshold) {
+                approx = perform_approximate_frequency_analysis(viewer, parent_view, (int)col_idx);
+            }
+            if (approx) {
+                DataSource *ds = create_approximate_frequency_data_source(approx);
+                if (!ds) {
+                    free_approximate_frequency(approx);
+                    set_error_message(viewer, "Failed to create data source for frequency analysis");
+                    return;
+                }
+                frequency_view_name(parent_view, col_idx, "Freq~", name, sizeof(name));
+                open_frequency_view(viewer, state, parent_view, col_idx, ds, NULL, approx, name);
+                set_status_message(viewer, "~%.0f distinct values (+/-%.1f%%), top %zu approximate - R to count exactly",
+                                   approx->distinct_estimate, approx->distinct_error * 100.0, approx->item_count);
+                return;
+            }
+        }
+
+        value_index = perform_frequency_analysis(viewer, parent_view, (int)col_idx);
+        if (!value_index) {
+            set_error_message(viewer, "Frequency analysis failed - column may be empty");
+            return;
+        }
+        // The cache keeps the reference the analysis returned
+        if (col_idx < parent_view->analysis_cache_size) {
+            parent_view->analysis_cache[col_idx] = value_index;
+        }
+    }
+
+    // The frequency view reads the index directly
+    DataSource *ds = create_frequency_data_source(value_index);
+    if (col_idx >= parent_view->analysis_cache_size) {
+        // Not cached, so the data source holds the only other reference
+        free_value_index(value_index);
+    }
+    if (!ds) {
+        set_error_message(viewer, "Failed to create data source for frequency analysis");
+        return;
+    }
+    frequency_view_name(parent_view, col_idx, "Freq", name, sizeof(name));
+    open_frequency_view(viewer, state, parent_view, col_idx, ds, value_index, NULL, name);
+}
+
+// Counts the values of an approximate frequency view exactly, opening the
+// result as a linked frequency view of the same column.
+static void refine_frequency_view(struct DSVViewer *viewer, ViewState *state) {
+    View *approx_view = state->current_view;
+    View *parent_view = approx_view->parent;
+    if (!approx_view->approx_frequency || !parent_view) {
+        set_error_message(viewer, "Not an approximate frequency view - use F on a large column");
+        return;
+    }
+    size_t col_idx = (size_t)approx_view->parent_source_column;
+
+    sort_view_wait(parent_view);
+    if (!parent_view->reverse_row_map) {
+        view_build_reverse_map(parent_view);
+    }
+
+    ValueIndex *value_index = refine_frequency_analysis(viewer, parent_view, (int)col_idx,
+                                                        approx_view->approx_frequency);
+    if (!value_index) {
+        set_error_message(viewer, "Frequency analysis failed - out of memory");
+        return;
+    }
+    DataSource *ds = create_frequency_data_source(value_index);
+    free_value_index(value_index);
+    if (!ds) {
+        set_error_message(viewer, "Failed to create data source for frequency analysis");
+        return;
+    }
+
+    char name[sizeof(approx_view->name)];
+    frequency_view_name(parent_view, col_idx, "Freq", name, sizeof(name));
+    open_frequency_view(viewer, state, parent_view, col_idx, ds, value_index, NULL, name);
+}
+
+// Joins the current view with another file and opens the result as a new view.
+static void apply_join(struct DSVViewer *viewer, ViewState *state) {
+    View *view = state->current_view;
+    if (!view || !view->data_source) return;
+
+    // The joined rows point into this view's source, which must outlive the
+    // new view; only the main view's source is guaranteed to.
+    if (view->owns_data_source && view != viewer->view_manager->views) {
+        set_error_message(viewer, "Join is only available on views of the loaded file");
+        return;
+    }
+    if (viewer->view_manager->view_count >= viewer->view_manager->max_views) {
+        set_error_message(viewer, "Maximum number of views reached (%zu)",
+                          viewer->view_manager->max_views);
+        return;
+    }
+
+    char input[sizeof(state->prompt_input)];
+    snprintf(input, sizeof(input), "%s", state->prompt_input);
+    const char *filename, *key_name;
+    split_join_input(input, &filename, &key_name);
+
+    char error[256];
+    DataSource *joined = NULL;
+    DSVResult result = join_view_with_file(viewer, view, view->cursor_col, filename, key_name,
+                                           &joined, error, sizeof(error));
+    if (result != DSV_OK) {
+        set_error_message(viewer, "%s", error[0] ? error : dsv_result_to_string(result));
+        return;
+    }
+
+    View *join_view = create_main_view(joined);
+    if (!join_view) {
+        destroy_data_source(joined);
+        set_error_message(viewer, "Failed to allocate memory for join view");
+        return;
+    }
+    const char *base = strrchr(filename, '/');
+    snprintf(join_view->name, sizeof(join_view->name), "Join: %s", base ? base + 1 : filename);
+    join_view->owns_data_source = true;
+    init_row_selection(join_view, join_view->visible_row_count);
+
+    if (!add_view_to_manager(viewer->view_manager, join_view)) {
+        cleanup_row_selection(join_view);
+        free(join_view->analysis_cache);
+        free(join_view);
+        destroy_data_source(joined);
+        set_error_message(viewer, "Failed to add join view");
+        return;
+    }
+
+    viewer->view_manager->current = join_view;
+    reset_view_state_for_new_view(state, join_view);
+    set_status_message(viewer, "Joined %zu rows", join_view->visible_row_count);
+}
+
+static InputResult handle_prompt_input(int ch, struct DSVViewer *viewer, ViewState *state) {
+    switch (ch) {
+        case 27: // ESC key
+            state->input_mode = INPUT_MODE_NORMAL;
+            state->prompt_input[0] = '\0';
+            state->needs_redraw = true;
+            return INPUT_CONSUMED;
+
+        case KEY_ENTER:
+        case '\n':
+        case '\r':
+            {
+                // Which prompt this was decides what to apply
+                InputMode mode = state->input_mode;
+                state->input_mode = INPUT_MODE_NORMAL;
+                if (state->prompt_input[0] != '\0') {
+                    if (mode == INPUT_MODE_JOIN) {
+                        apply_join(viewer, state);
+                    } else {
+                        apply_computed_column(viewer, state);
+                    }
+                    state->prompt_input[0] = '\0';
+                }
+            }
+            state->needs_redraw = true;
+            return INPUT_CONSUMED;
+
+        case KEY_BACKSPACE:
+        case 127:
+        case 8:
+            {
+                size_t len = strlen(state->prompt_input);
+                if (len > 0) {
+                    state->prompt_input[len - 1] = '\0';
+                }
+            }
+            state->needs_redraw = true;
+            return INPUT_CONSUMED;
+
+        default:
+            if (ch >= 32 && ch <= 126) {
+                size_t len = strlen(state->prompt_input);
+                if (len < (sizeof(state->prompt_input) - 1)) {
+                    state->prompt_input[len] = ch;
+                    state->prompt_input[len + 1] = '\0';
+                }
+            }
             state->needs_redraw = true;
             return INPUT_CONSUMED;
     }
-} 
\ No newline at end of file
+}
@@ -5,12 +5,16 @@
 #include "analysis.h"
 #include "core/data_source.h"  // For DataSource access
 #include "core/parser.h"
+#include "core/sorting.h"
+#include "core/search.h"
+#include "core/column_stats.h"
 #include "util/logging.h"
 #include <core/value_index.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <sys/mman.h>
 #include "util/utils.h"
 
 ViewManager* init_view_manager(void) {
@@ -22,6 +26,10 @@ ViewManager* init_view_manager(void) {
 
 static void free_view_resources(View *view) {
     if (!view) return;
+
+    // Stops any background search and sort before the rows they cover go away
+    search_clear(view);
+    sort_cache_clear(view);
     
     // Cleanup selection state
     cleanup_row_selection(view);
@@ -34,9 +42,10 @@ static void free_view_resources(View *view) {
     // Free other resources
     free(view->row_selected);
     free(view->ranges);
-    free(view->row_order_map);
+    view_free_row_order_map(view);
     free(view->visible_rows);  // For backward compatibility
     free_value_index(view->value_index);
+    free_approximate_frequency(view->approx_frequency);
     free(view->reverse_row_map);
 
     // Free the analysis cache
@@ -48,6 +57,10 @@ static void free_view_resources(View *view) {
         }
         free(view->analysis_cache);
     }
+    for (size_t i = 0; i < view->column_stats_size; i++) {
+        free_column_stats(view->column_stats[i]);
+    }
+    free(view->column_stats);
 }
 
 void cleanup_view_manager(ViewManager *manager) {
@@ -197,40 +210,46 @@ View* create_view_from_selection(ViewManager *manager,
         return NULL;
     }
 
-    View *new_view = calloc(1, sizeof(View));
-    if (!new_view) return NULL;
-
     // --- Range Compression Logic ---
     // This assumes selected_rows is sorted.
-    if (count > 0) {
-        // Over-allocate for simplicity, then realloc later if memory is a major concern.
-        new_view->ranges = malloc(sizeof(RowRange) * count);
-        if (!new_view->ranges) {
-            free(new_view);
-            return NULL;
-        }
-        
-        new_view->num_ranges = 1;
-        new_view->ranges[0].start = selected_rows[0];
-        new_view->ranges[0].end = selected_rows[0];
-
-        for (size_t i = 1; i < count; i++) {
-            if (selected_rows[i] == new_view->ranges[new_view->num_ranges - 1].end + 1) {
-                // Extend the current range
-                new_view->ranges[new_view->num_ranges - 1].end = selected_rows[i];
-            } else {
-                // Start a new range
-                new_view->num_ranges++;
-                new_view->ranges[new_view->num_ranges - 1].start = selected_rows[i];
-                new_view->ranges[new_view->num_ranges - 1].end = selected_rows[i];
-            }
+    // Over-allocate for simplicity, then realloc later if memory is a major concern.
+    RowRange *ranges = malloc(sizeof(RowRange) * count);
+    if (!ranges) return NULL;
+
+    size_t num_ranges = 1;
+    ranges[0].start = selected_rows[0];
+    ranges[0].end = selected_rows[0];
+
+    for (size_t i = 1; i < count; i++) {
+        if (selected_rows[i] == ranges[num_ranges - 1].end + 1) {
+            // Extend the current range
+            ranges[num_ranges - 1].end = selected_rows[i];
+        } else {
+            // Start a new range
+            num_ranges++;
+            ranges[num_ranges - 1].start = selected_rows[i];
+            ranges[num_ranges - 1].end = selected_rows[i];
         }
-    } else {
-        new_view->ranges = NULL;
-        new_view->num_ranges = 0;
     }
     // --- End Range Compression ---
 
+    View *new_view = create_view_from_ranges(manager, state, ranges, num_ranges, count, parent_data_source);
+    if (!new_view) free(ranges);
+    return new_view;
+}
+
+View* create_view_from_ranges(ViewManager *manager, ViewState *state,
+                              RowRange *ranges, size_t num_ranges, size_t count,
+                              DataSource *parent_data_source) {
+    if (!manager || manager->view_count >= manager->max_views || !ranges || num_ranges == 0) {
+        return NULL;
+    }
+
+    View *new_view = calloc(1, sizeof(View));
+    if (!new_view) return NULL;
+
+    new_view->ranges = ranges;
+    new_view->num_ranges = num_ranges;
     new_view->visible_row_count = count;
     new_view->data_source = parent_data_source;
     new_view->owns_data_source = false; // This view just filters the parent, doesn't own it.
@@ -368,6 +387,46 @@ size_t view_get_actual_row_index(const View *view, size_t display_row) {
     return SIZE_MAX; // display_row is out of bounds
 } 
 
+void view_row_iterator_init(ViewRowIterator *it, const View *view, size_t visible_index, size_t count) {
+    it->view = view;
+    it->range_index = 0;
+    it->next_row = visible_index;
+    it->remaining = 0;
+    if (!view || visible_index >= view->visible_row_count) return;
+
+    size_t available = view->visible_row_count - visible_index;
+    it->remaining = count < available ? count : available;
+    if (view->num_ranges == 0) return;
+
+    // Find the range holding visible_index and the offset into it.
+    size_t current_base = 0;
+    for (size_t i = 0; i < view->num_ranges; i++) {
+        size_t range_len = view->ranges[i].end - view->ranges[i].start + 1;
+        if (visible_index < current_base + range_len) {
+            it->range_index = i;
+            it->next_row = view->ranges[i].start + (visible_index - current_base);
+            return;
+        }
+        current_base += range_len;
+    }
+    it->remaining = 0;
+}
+
+size_t view_row_iterator_next(ViewRowIterator *it) {
+    if (it->remaining == 0) return SIZE_MAX;
+    it->remaining--;
+
+    size_t row = it->next_row++;
+    const View *view = it->view;
+    if (view->num_ranges > 0 && row == view->ranges[it->range_index].end) {
+        // Step into the next range for the following call
+        if (++it->range_index < view->num_ranges) {
+            it->next_row = view->ranges[it->range_index].start;
+        }
+    }
+    return row;
+}
+
 void view_build_reverse_map(View *view) {
     if (!view || !view->data_source) return;
 
@@ -399,6 +458,18 @@ void view_build_reverse_map(View *view) {
     }
 }
 
+void view_free_row_order_map(View *view) {
+    if (!view || !view->row_order_map) return;
+    if (view->row_order_map_mapped) {
+        munmap(view->row_order_map, view->row_order_map_mapped * sizeof(size_t));
+    } else {
+        free(view->row_order_map);
+    }
+    view->row_order_map = NULL;
+    view->row_order_map_mapped = 0;
+    view->order_version++;
+}
+
 void propagate_selection_to_parent(View *child_view) {
     if (!child_view || !child_view->parent || child_view->parent_source_column < 0) {
         return;
@@ -516,7 +587,12 @@ void update_parent_selection_from_child(View *child_view) {
     }
 
     View *parent_view = child_view->parent;
-    
+
+    // An external sort drops the parent's reverse map to save memory
+    if (!parent_view->reverse_row_map) {
+        view_build_reverse_map(parent_view);
+    }
+
     // 1. Get all selected values from the child view
     size_t *selected_child_rows = NULL;
     size_t selected_count = get_selected_rows(child_view, &selected_child_rows);
@@ -552,4 +628,4 @@ void update_parent_selection_from_child(View *child_view) {
     }
 
     free(selected_child_rows);
-} 
\ No newline at end of file
+}
@@ -0,0 +1,181 @@
+#include "byte_search.h"
+#include <string.h>
+#include <stdint.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+const char* find_bytes(const char *haystack, size_t haystack_length, const char *needle, size_t needle_length) {
+    if (needle_length == 0) return haystack;
+    if (needle_length > haystack_length) return NULL;
+    if (needle_length == 1) return memchr(haystack, needle[0], haystack_length);
+
+#ifdef __SSE2__
+    // A position is a candidate when both the needle's first and last byte
+    // line up; only candidates are compared in full.
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last = _mm_set1_epi8(needle[needle_length - 1]);
+    size_t i = 0;
+    for (; i + needle_length - 1 + 16 <= haystack_length; i += 16) {
+        __m128i block_first = _mm_loadu_si128((const __m128i *)(haystack + i));
+        __m128i block_last = _mm_loadu_si128((const __m128i *)(haystack + i + needle_length - 1));
+        unsigned mask = (unsigned)_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(first, block_first), _mm_cmpeq_epi8(last, block_last)));
+        while (mask) {
+            unsigned bit = (unsigned)__builtin_ctz(mask);
+            if (memcmp(haystack + i + bit + 1, needle + 1, needle_length - 2) == 0) {
+                return haystack + i + bit;
+            }
+            mask &= mask - 1;
+        }
+    }
+
+    // Fewer than 16 candidate positions remain.
+    for (; i + needle_length <= haystack_length; i++) {
+        if (haystack[i] == needle[0] && memcmp(haystack + i, needle, needle_length) == 0) {
+            return haystack + i;
+        }
+    }
+    return NULL;
+#else
+    return memmem(haystack, haystack_length, needle, needle_length);
+#endif
+}
+
+// --- Case-Insensitive Search ---
+
+static unsigned char ascii_lower(unsigned char c) {
+    return (c >= 'A' && c <= 'Z') ? (unsigned char)(c + ('a' - 'A')) : c;
+}
+
+static bool ascii_equal_ignore_case(const char *a, const char *b, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        if (ascii_lower((unsigned char)a[i]) != ascii_lower((unsigned char)b[i])) return false;
+    }
+    return true;
+}
+
+#ifdef __SSE2__
+// Lowercases the ASCII letters among 16 bytes. Bytes from 0x80 up compare as
+// negative, so they are never mistaken for letters.
+static inline __m128i fold_ascii(__m128i bytes) {
+    __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(bytes, _mm_set1_epi8('A' - 1)),
+                                  _mm_cmplt_epi8(bytes, _mm_set1_epi8('Z' + 1)));
+    return _mm_or_si128(bytes, _mm_and_si128(upper, _mm_set1_epi8('a' - 'A')));
+}
+#endif
+
+static const char* find_ascii_ignore_case(const char *haystack, size_t haystack_length,
+                                          const char *needle, size_t needle_length) {
+    size_t i = 0;
+#ifdef __SSE2__
+    // Same first/last byte filter as find_bytes, on folded bytes.
+    const __m128i first = _mm_set1_epi8((char)ascii_lower((unsigned char)needle[0]));
+    const __m128i last = _mm_set1_epi8((char)ascii_lower((unsigned char)needle[needle_length - 1]));
+    for (; i + needle_length - 1 + 16 <= haystack_length; i += 16) {
+        __m128i block_first = fold_ascii(_mm_loadu_si128((const __m128i *)(haystack + i)));
+        __m128i block_last = fold_ascii(_mm_loadu_si128((const __m128i *)(haystack + i + needle_length - 1)));
+        unsigned mask = (unsigned)_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(first, block_first), _mm_cmpeq_epi8(last, block_last)));
+        while (mask) {
+            unsigned bit = (unsigned)__builtin_ctz(mask);
+            if (ascii_equal_ignore_case(haystack + i + bit + 1, needle + 1, needle_length - 1)) {
+                return haystack + i + bit;
+            }
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+    unsigned char lead = ascii_lower((unsigned char)needle[0]);
+    for (; i + needle_length <= haystack_length; i++) {
+        if (ascii_lower((unsigned char)haystack[i]) == lead &&
+            ascii_equal_ignore_case(haystack + i + 1, needle + 1, needle_length - 1)) {
+            return haystack + i;
+        }
+    }
+    return NULL;
+}
+
+// Decodes one UTF-8 character. A byte that does not start a valid sequence
+// decodes on its own to a value no character folds to.
+static uint32_t decode_utf8(const unsigned char *s, size_t length, size_t *consumed) {
+    unsigned char lead = s[0];
+    size_t count = lead >= 0xF0 && lead < 0xF5 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC2 ? 2 : 1;
+    if (lead >= 0xF5) count = 1;
+    uint32_t cp = count == 4 ? lead & 0x07u : count == 3 ? lead & 0x0Fu : lead & 0x1Fu;
+    if (count == 1 || count > length) {
+        *consumed = 1;
+        return lead < 0x80 ? lead : 0x110000u + lead;
+    }
+    for (size_t i = 1; i < count; i++) {
+        if ((s[i] & 0xC0) != 0x80) {
+            *consumed = 1;
+            return 0x110000u + lead;
+        }
+        cp = (cp << 6) | (s[i] & 0x3Fu);
+    }
+    *consumed = count;
+    return cp;
+}
+
+// Simple case folding for the scripts where upper and lower case map one to
+// one: Latin-1, Latin Extended-A, Greek and Cyrillic.
+static uint32_t fold_code_point(uint32_t cp) {
+    if (cp < 0x80) return ascii_lower((unsigned char)cp);
+    if (cp >= 0xC0 && cp <= 0xDE && cp != 0xD7) return cp + 0x20;
+    if ((cp >= 0x100 && cp <= 0x12F) || (cp >= 0x132 && cp <= 0x137) || (cp >= 0x14A && cp <= 0x177)) {
+        return cp | 1;
+    }
+    if (((cp >= 0x139 && cp <= 0x148) || (cp >= 0x179 && cp <= 0x17E)) && (cp & 1)) return cp + 1;
+    if (cp == 0x178) return 0xFF;
+    if (cp >= 0x391 && cp <= 0x3AB && cp != 0x3A2) return cp + 0x20;
+    if (cp == 0x3C2) return 0x3C3; // Final sigma
+    if (cp >= 0x410 && cp <= 0x42F) return cp + 0x20;
+    if (cp >= 0x400 && cp <= 0x40F) return cp + 0x50;
+    return cp;
+}
+
+// Scalar fallback for needles with non-ASCII characters. Folded characters
+// can differ in encoded length, so both sides are decoded as they are walked.
+static const char* find_utf8_ignore_case(const char *haystack, size_t haystack_length,
+                                         const char *needle, size_t needle_length) {
+    const unsigned char *hay = (const unsigned char *)haystack;
+    const unsigned char *pattern = (const unsigned char *)needle;
+    size_t lead_length;
+    uint32_t lead = fold_code_point(decode_utf8(pattern, needle_length, &lead_length));
+
+    size_t step;
+    for (size_t i = 0; i < haystack_length; i += step) {
+        if (fold_code_point(decode_utf8(hay + i, haystack_length - i, &step)) != lead) continue;
+        size_t h = i + step, n = lead_length;
+        while (n < needle_length && h < haystack_length) {
+            size_t hay_step, needle_step;
+            uint32_t a = fold_code_point(decode_utf8(hay + h, haystack_length - h, &hay_step));
+            uint32_t b = fold_code_point(decode_utf8(pattern + n, needle_length - n, &needle_step));
+            if (a != b) break;
+            h += hay_step;
+            n += needle_step;
+        }
+        if (n == needle_length) return haystack + i;
+    }
+    return NULL;
+}
+
+const char* find_bytes_ignore_case(const char *haystack, size_t haystack_length,
+                                   const char *needle, size_t needle_length) {
+    if (needle_length == 0) return haystack;
+    for (size_t i = 0; i < needle_length; i++) {
+        if ((unsigned char)needle[i] >= 0x80) {
+            return find_utf8_ignore_case(haystack, haystack_length, needle, needle_length);
+        }
+    }
+    if (needle_length > haystack_length) return NULL;
+    return find_ascii_ignore_case(haystack, haystack_length, needle, needle_length);
+}
+
+bool text_contains(const char *text, const char *term, bool ignore_case) {
+    if (!ignore_case) return strstr(text, term) != NULL;
+    return find_bytes_ignore_case(text, strlen(text), term, strlen(term)) != NULL;
+}
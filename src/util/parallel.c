@@ -0,0 +1,90 @@
+#include "parallel.h"
+#include "logging.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define MAX_PARALLEL_WORKERS 64
+#define CHUNKS_PER_WORKER 4
+
+static int g_max_workers = 0; // 0 = one per online CPU
+
+typedef struct {
+    ParallelTaskFn fn;
+    void *arg;
+    size_t task_count;
+    size_t next_task; // Claimed with an atomic fetch-add
+} ParallelJob;
+
+void parallel_set_max_workers(int workers) {
+    g_max_workers = workers > 0 ? workers : 0;
+}
+
+size_t parallel_worker_count(void) {
+    long workers = g_max_workers;
+    if (workers <= 0) {
+        workers = sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    if (workers < 1) workers = 1;
+    if (workers > MAX_PARALLEL_WORKERS) workers = MAX_PARALLEL_WORKERS;
+    return (size_t)workers;
+}
+
+size_t parallel_chunk_count(size_t items, size_t min_items_per_chunk) {
+    if (items == 0) return 0;
+    if (min_items_per_chunk == 0) min_items_per_chunk = 1;
+
+    size_t chunks = parallel_worker_count() * CHUNKS_PER_WORKER;
+    size_t max_chunks = (items + min_items_per_chunk - 1) / min_items_per_chunk;
+    if (chunks > max_chunks) chunks = max_chunks;
+    return chunks > 0 ? chunks : 1;
+}
+
+void parallel_chunk_bounds(size_t items, size_t chunks, size_t chunk, size_t *begin, size_t *end) {
+    if (chunks == 0) {
+        *begin = *end = 0;
+        return;
+    }
+    size_t base = items / chunks;
+    size_t extra = items % chunks;
+    *begin = chunk * base + (chunk < extra ? chunk : extra);
+    *end = *begin + base + (chunk < extra ? 1 : 0);
+}
+
+static void* parallel_worker(void *arg) {
+    ParallelJob *job = (ParallelJob *)arg;
+    for (;;) {
+        size_t task = __atomic_fetch_add(&job->next_task, 1, __ATOMIC_RELAXED);
+        if (task >= job->task_count) break;
+        job->fn(job->arg, task);
+    }
+    return NULL;
+}
+
+DSVResult parallel_for(size_t task_count, ParallelTaskFn fn, void *arg) {
+    if (!fn) return DSV_ERROR_INVALID_ARGS;
+    if (task_count == 0) return DSV_OK;
+
+    ParallelJob job = { .fn = fn, .arg = arg, .task_count = task_count, .next_task = 0 };
+
+    size_t workers = parallel_worker_count();
+    if (workers > task_count) workers = task_count;
+
+    // The calling thread is one of the workers.
+    pthread_t threads[MAX_PARALLEL_WORKERS];
+    size_t started = 0;
+    for (size_t i = 1; i < workers; i++) {
+        if (pthread_create(&threads[started], NULL, parallel_worker, &job) != 0) {
+            LOG_WARN("Could not start worker thread %zu; continuing with %zu", i, started + 1);
+            break;
+        }
+        started++;
+    }
+
+    parallel_worker(&job);
+
+    for (size_t i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    return DSV_OK;
+}
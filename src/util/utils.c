@@ -75,4 +75,31 @@ uint32_t fnv1a_hash(const char *str) {
         hash *= FNV_PRIME;
     }
     return hash;
+}
+
+static inline uint64_t mix_word(uint64_t hash, uint64_t word) {
+    hash ^= word * 0x9E3779B97F4A7C15ULL;
+    hash = (hash << 31) | (hash >> 33);
+    return hash * 0xC2B2AE3D27D4EB4FULL;
+}
+
+// Multiply-rotate hash over whole words, for hash tables keyed by byte
+// strings of known length. Not stable across platforms with different
+// endianness, so never persist it.
+uint64_t hash_bytes(const char *data, size_t length) {
+    uint64_t hash = 0x27D4EB2F165667C5ULL ^ length;
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        uint64_t word;
+        memcpy(&word, data + i, 8);
+        hash = mix_word(hash, word);
+    }
+    if (i < length) {
+        uint64_t word = 0;
+        memcpy(&word, data + i, length - i);
+        hash = mix_word(hash, word);
+    }
+    hash ^= hash >> 29;
+    hash *= 0xBF58476D1CE4E5B9ULL;
+    return hash ^ (hash >> 32);
 } 
\ No newline at end of file
@@ -35,7 +35,7 @@ extern int foundation_suite_size;
 // --- Main Test Runner ---
 
 int main(void) {
-    init_logging("dsv_test.log"); // Initialize logging for the test runner
+    logging_init(); // Initialize logging for the test runner
     printf("========== Running Unit Test Suites ==========\n");
     
     // Run all the different test suites
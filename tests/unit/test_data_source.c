@@ -5,9 +5,21 @@
 #include "app_init.h"
 #include "config.h"
 #include "file_io.h"
+#include "core/computed_source.h"
+#include "core/join.h"
+#include "core/search.h"
+#include "core/regex.h"
+#include "core/trigram_index.h"
+#include "core/sorting.h"
+#include "ui/view_manager.h"
+#include "core/analysis.h"
+#include "ui/input_router.h"
+#include "ui/navigation.h"
 #include <string.h>
+#include <stdlib.h>
 #include <unistd.h>
 #include <stdio.h>
+#include <sys/stat.h>
 
 // --- Test Fixture for File-based DataSource ---
 
@@ -93,6 +105,64 @@ static void test_file_ds_get_header() {
     teardown_file_ds_test(&fixture);
 }
 
+static void test_file_ds_cursors() {
+    FileDSTestFixture fixture;
+    setup_file_ds_test(&fixture, "h1,h2\na,b\nc,d");
+
+    DataSource* ds = fixture.viewer.main_data_source;
+    TEST_ASSERT(data_source_supports_cursors(ds), "File source should support cursors");
+
+    DataSourceCursor* first = data_source_open_cursor(ds);
+    DataSourceCursor* second = data_source_open_cursor(ds);
+    ASSERT_NOT_NULL(first);
+    ASSERT_NOT_NULL(second);
+
+    // Interleaved reads on different rows must not disturb each other.
+    FieldDesc fd_a = data_source_cursor_get_cell(first, 0, 1);
+    FieldDesc fd_c = data_source_cursor_get_cell(second, 1, 0);
+    FieldDesc fd_shared = ds->ops->get_cell(ds->context, 1, 1);
+
+    char buffer[20];
+    render_field(&fd_a, buffer, sizeof(buffer));
+    ASSERT_EQ(strcmp(buffer, "b"), 0);
+    render_field(&fd_c, buffer, sizeof(buffer));
+    ASSERT_EQ(strcmp(buffer, "c"), 0);
+    render_field(&fd_shared, buffer, sizeof(buffer));
+    ASSERT_EQ(strcmp(buffer, "d"), 0);
+
+    data_source_close_cursor(first);
+    data_source_close_cursor(second);
+    teardown_file_ds_test(&fixture);
+}
+
+static void test_file_ds_column_widths() {
+    // Column b only gets long near the end of the file, past the lines
+    // measured for the first paint.
+    size_t capacity = 128 * 1024;
+    char *content = malloc(capacity);
+    size_t length = (size_t)snprintf(content, capacity, "a,b,c\n");
+    for (int i = 0; i < 3000; i++) {
+        length += (size_t)snprintf(content + length, capacity - length, "%d,%s,x\n", i,
+                                   i >= 2500 ? "a much longer value" : "short");
+    }
+    FileDSTestFixture fixture;
+    setup_file_ds_test(&fixture, content);
+    free(content);
+    DSVViewer *viewer = &fixture.viewer;
+
+    ASSERT_EQ(analysis_get_column_width(viewer, 0), fixture.config.min_column_width);
+    ASSERT_EQ(analysis_get_column_width(viewer, 1), (int)strlen("short"));
+
+    // The spread sample reaches the end of the file; widths only grow.
+    start_column_width_analysis(viewer);
+    while (!poll_column_width_analysis(viewer)) usleep(1000);
+    ASSERT_EQ(analysis_get_column_width(viewer, 0), fixture.config.min_column_width);
+    ASSERT_EQ(analysis_get_column_width(viewer, 1), fixture.config.max_column_width);
+    ASSERT_EQ(analysis_get_column_width(viewer, 2), fixture.config.min_column_width);
+    ASSERT_EQ(fixture.viewer.display_state->width_thread_running, false);
+
+    teardown_file_ds_test(&fixture);
+}
 
 // --- Test Cases for In-Memory DataSource ---
 
@@ -157,17 +227,897 @@ static void test_memory_ds_get_header() {
     destroy_data_source(ds);
 }
 
+static void test_memory_ds_typed_columns() {
+    const char *headers[] = {"Value", "Count"};
+    const ColumnType types[] = {COLUMN_TYPE_STRING, COLUMN_TYPE_INT64};
+    InMemoryTable* table = create_typed_in_memory_table("Typed", 2, headers, types);
+
+    InMemoryValue row1[2];
+    row1[0].str.ptr = "alpha";
+    row1[0].str.len = 5;
+    row1[1].i64 = 1234567;
+    ASSERT_EQ(add_in_memory_table_row_values(table, row1), 0);
+
+    const char *row2[] = {"b", "-42"};
+    ASSERT_EQ(add_in_memory_table_row(table, row2), 0);
+
+    ASSERT_EQ(table->columns[1].i64[0], 1234567);
+    ASSERT_EQ(table->columns[1].i64[1], -42);
+
+    DataSource* ds = create_memory_data_source(table);
+    char buffer[20];
+
+    FieldDesc count_fd = ds->ops->get_cell(ds->context, 0, 1);
+    render_field(&count_fd, buffer, sizeof(buffer));
+    ASSERT_EQ(strcmp(buffer, "1234567"), 0);
+
+    FieldDesc value_fd = ds->ops->get_cell(ds->context, 1, 0);
+    ASSERT_EQ(value_fd.length, 1);
+    render_field(&value_fd, buffer, sizeof(buffer));
+    ASSERT_EQ(strcmp(buffer, "b"), 0);
+
+    // Widths are the longest of the header and the formatted cells
+    ASSERT_EQ(ds->ops->get_column_width(ds->context, 0), 5);
+    ASSERT_EQ(ds->ops->get_column_width(ds->context, 1), 7);
+
+    destroy_data_source(ds);
+}
+
+static void test_memory_ds_many_rows() {
+    const char *headers[] = {"id"};
+    InMemoryTable* table = create_in_memory_table("Grow", 1, headers);
+
+    char cell[16];
+    for (int i = 0; i < 5000; i++) {
+        snprintf(cell, sizeof(cell), "%d", i);
+        const char *row[] = {cell};
+        add_in_memory_table_row(table, row);
+    }
+    ASSERT_EQ(table->row_count, 5000);
+
+    size_t length = 0;
+    const char *value = in_memory_table_get_string(table, 4321, 0, &length);
+    ASSERT_NOT_NULL(value);
+    ASSERT_EQ(length, 4);
+    ASSERT_EQ(strcmp(value, "4321"), 0);
+
+    free_in_memory_table(table);
+}
+
 // --- Test Suite Definition ---
 
+// --- Test Cases for Computed DataSource ---
+
+static void assert_cell_equals(DataSource* ds, size_t row, size_t col, const char* expected) {
+    char buffer[64];
+    FieldDesc fd = ds->ops->get_cell(ds->context, row, col);
+    render_field(&fd, buffer, sizeof(buffer));
+    ASSERT_EQ(strcmp(buffer, expected), 0);
+}
+
+static void test_computed_ds_arithmetic() {
+    DataSource* inner = create_memory_data_source(create_test_mem_table());
+    DataSource* ds = NULL;
+    char error[128];
+
+    ASSERT_EQ(add_computed_column(inner, true, "total = value * 2 + id", NULL, &ds, error, sizeof(error)), DSV_OK);
+    ASSERT_NOT_NULL(ds);
+    ASSERT_EQ(ds->type, DATA_SOURCE_COMPUTED);
+    ASSERT_EQ(ds->ops->get_col_count(ds->context), 4);
+    ASSERT_EQ(ds->ops->get_row_count(ds->context), 2);
+
+    char buffer[64];
+    FieldDesc header = ds->ops->get_header(ds->context, 3);
+    render_field(&header, buffer, sizeof(buffer));
+    ASSERT_EQ(strcmp(buffer, "total"), 0);
+
+    assert_cell_equals(ds, 0, 3, "201");
+    assert_cell_equals(ds, 1, 3, "402");
+    assert_cell_equals(ds, 1, 1, "beta"); // Inner columns pass through
+
+    destroy_data_source(ds); // Also destroys the owned inner source
+}
+
+static void test_computed_ds_string_functions() {
+    DataSource* inner = create_memory_data_source(create_test_mem_table());
+    DataSource* first = NULL;
+    DataSource* second = NULL;
+    char error[128];
+
+    ASSERT_EQ(add_computed_column(inner, true, "substr(upper(name), 0, 3)", NULL, &first, error, sizeof(error)), DSV_OK);
+    ASSERT_EQ(add_computed_column(first, true, "n = len(`name`) + $1", NULL, &second, error, sizeof(error)), DSV_OK);
+
+    assert_cell_equals(second, 0, 3, "ALP");
+    assert_cell_equals(second, 1, 3, "BET");
+    assert_cell_equals(second, 0, 4, "6");
+    assert_cell_equals(second, 1, 4, "6");
+
+    destroy_data_source(second);
+}
+
+static void test_computed_ds_errors() {
+    DataSource* inner = create_memory_data_source(create_test_mem_table());
+    DataSource* ds = NULL;
+    char error[128];
+
+    ASSERT_EQ(add_computed_column(inner, false, "price * qty", NULL, &ds, error, sizeof(error)), DSV_ERROR_PARSE);
+    ASSERT_NULL(ds);
+    ASSERT_NOT_NULL(strstr(error, "price"));
+    ASSERT_EQ(add_computed_column(inner, false, "value +", NULL, &ds, error, sizeof(error)), DSV_ERROR_PARSE);
+    ASSERT_EQ(add_computed_column(inner, false, "bogus(value)", NULL, &ds, error, sizeof(error)), DSV_ERROR_PARSE);
+
+    // Text in arithmetic and division by zero yield empty cells, not errors.
+    ASSERT_EQ(add_computed_column(inner, false, "name / (id - 1)", NULL, &ds, error, sizeof(error)), DSV_OK);
+    assert_cell_equals(ds, 0, 3, "");
+    assert_cell_equals(ds, 1, 3, "");
+
+    destroy_data_source(ds);
+    destroy_data_source(inner);
+}
+
+static void test_computed_ds_materialized_column() {
+    const char *headers[] = {"n"};
+    InMemoryTable* table = create_in_memory_table("Numbers", 1, headers);
+    char value[32];
+    const char *row[] = {value};
+    for (int i = 0; i < 5000; i++) {
+        snprintf(value, sizeof(value), "%d", i);
+        add_in_memory_table_row(table, row);
+    }
+
+    DataSource* ds = NULL;
+    char error[128];
+    ASSERT_EQ(add_computed_column(create_memory_data_source(table), true, "sq = n * n", NULL, &ds, error, sizeof(error)), DSV_OK);
+
+    assert_cell_equals(ds, 70, 1, "4900");
+    data_source_prepare_column(ds, 1);
+    assert_cell_equals(ds, 70, 1, "4900");
+    assert_cell_equals(ds, 4999, 1, "24990001");
+
+    DataSourceCursor* cursor = data_source_open_cursor(ds);
+    FieldDesc fd = data_source_cursor_get_cell(cursor, 3, 1);
+    char buffer[32];
+    render_field(&fd, buffer, sizeof(buffer));
+    ASSERT_EQ(strcmp(buffer, "9"), 0);
+    data_source_close_cursor(cursor);
+
+    destroy_data_source(ds);
+}
+
+static void test_computed_ds_sampled_width() {
+    // Only the second half holds long values; the configured sample is
+    // spread across every row and the width capped at the configured maximum.
+    const char *headers[] = {"name"};
+    InMemoryTable* table = create_in_memory_table("Names", 1, headers);
+    for (int i = 0; i < 1000; i++) {
+        const char *row[] = { i < 500 ? "a" : "a value thirty characters long" };
+        add_in_memory_table_row(table, row);
+    }
+    DSVConfig config;
+    config_init_defaults(&config);
+    config.column_analysis_sample_lines = 10;
+    config.max_column_width = 20;
+
+    DataSource* ds = NULL;
+    char error[128];
+    ASSERT_EQ(add_computed_column(create_memory_data_source(table), true, "w = name", &config, &ds, error, sizeof(error)), DSV_OK);
+    ASSERT_EQ(ds->ops->get_column_width(ds->context, 1), 20);
+    destroy_data_source(ds);
+}
+
+// --- Test Cases for Hash Join ---
+
+static void test_join_duplicate_and_missing_keys() {
+    const char *order_headers[] = {"order", "id"};
+    InMemoryTable* orders = create_in_memory_table("Orders", 2, order_headers);
+    const char *o1[] = {"A", "2"};
+    const char *o2[] = {"B", "9"};
+    const char *o3[] = {"C", "1"};
+    const char *o4[] = {"D", "2"};
+    const char *o5[] = {"E", ""};
+    add_in_memory_table_row(orders, o1);
+    add_in_memory_table_row(orders, o2);
+    add_in_memory_table_row(orders, o3);
+    add_in_memory_table_row(orders, o4);
+    add_in_memory_table_row(orders, o5);
+
+    DataSource* left = create_memory_data_source(create_test_mem_table());
+    DataSource* right = create_memory_data_source(orders);
+    DataSource* joined = NULL;
+
+    ASSERT_EQ(hash_join_data_sources(left, NULL, 0, right, 1, &joined), DSV_OK);
+    ASSERT_EQ(joined->ops->get_col_count(joined->context), 5);
+    ASSERT_EQ(joined->ops->get_row_count(joined->context), 3);
+
+    // Rows follow the larger (right) side; the unmatched and empty keys drop out.
+    assert_cell_equals(joined, 0, 1, "beta");
+    assert_cell_equals(joined, 0, 3, "A");
+    assert_cell_equals(joined, 1, 1, "alpha");
+    assert_cell_equals(joined, 1, 3, "C");
+    assert_cell_equals(joined, 2, 2, "200");
+    assert_cell_equals(joined, 2, 3, "D");
+
+    char buffer[64];
+    FieldDesc header = joined->ops->get_header(joined->context, 3);
+    render_field(&header, buffer, sizeof(buffer));
+    ASSERT_EQ(strcmp(buffer, "order"), 0);
+
+    ASSERT_EQ(hash_join_data_sources(left, NULL, 5, right, 1, &joined), DSV_ERROR_INVALID_ARGS);
+
+    destroy_data_source(joined);
+    destroy_data_source(right);
+    destroy_data_source(left);
+}
+
+static void test_join_from_prompt() {
+    FileDSTestFixture fixture;
+    setup_file_ds_test(&fixture, "id,name\n1,alpha\n2,beta\n3,gamma\n");
+    const char *right_file = "test_join_right.csv";
+    FILE *f = fopen(right_file, "w");
+    fputs("id,score\n2,20\n3,30\n", f);
+    fclose(f);
+
+    DSVViewer *viewer = &fixture.viewer;
+    View *main_view = create_main_view(viewer->main_data_source);
+    init_row_selection(main_view, 3);
+    viewer->view_manager->views = main_view;
+    viewer->view_manager->current = main_view;
+    viewer->view_manager->view_count = 1;
+    ViewState *state = &viewer->view_state;
+    state->current_view = main_view;
+
+    // J, then "file key" and Enter, as typed at the prompt.
+    route_input('J', viewer, state);
+    ASSERT_EQ(state->input_mode, INPUT_MODE_JOIN);
+    for (const char *c = "test_join_right.csv id"; *c; c++) route_input(*c, viewer, state);
+    route_input('\n', viewer, state);
+
+    ASSERT_EQ(state->input_mode, INPUT_MODE_NORMAL);
+    ASSERT_EQ(viewer->view_manager->view_count, 2);
+    View *join_view = viewer->view_manager->current;
+    ASSERT_EQ(strcmp(join_view->name, "Join: test_join_right.csv"), 0);
+    ASSERT_EQ(join_view->visible_row_count, 2);
+    DataSource *joined = join_view->data_source;
+    ASSERT_EQ(joined->ops->get_col_count(joined->context), 4);
+    assert_cell_equals(joined, 0, 1, "beta");
+    assert_cell_equals(joined, 1, 3, "30");
+
+    teardown_file_ds_test(&fixture);
+    unlink(right_file);
+}
+
+static void test_join_partitioned_build() {
+    const char *headers[] = {"key", "tag"};
+    InMemoryTable* big = create_in_memory_table("Big", 2, headers);
+    InMemoryTable* small = create_in_memory_table("Small", 2, headers);
+    char key[32], tag[32];
+    const char *row[] = {key, tag};
+    for (int i = 0; i < 20000; i++) {
+        snprintf(key, sizeof(key), "k%d", i);
+        snprintf(tag, sizeof(tag), "big%d", i);
+        add_in_memory_table_row(big, row);
+    }
+    // Every third key of the big table, twice over
+    for (int i = 0; i < 2 * 6000; i++) {
+        snprintf(key, sizeof(key), "k%d", (i % 6000) * 3);
+        snprintf(tag, sizeof(tag), "small%d", i);
+        add_in_memory_table_row(small, row);
+    }
+
+    DataSource* left = create_memory_data_source(small);
+    DataSource* right = create_memory_data_source(big);
+    DataSource* joined = NULL;
+
+    ASSERT_EQ(hash_join_data_sources(left, NULL, 0, right, 0, &joined), DSV_OK);
+    ASSERT_EQ(joined->ops->get_row_count(joined->context), 12000);
+
+    // Probe order is the big table's; duplicates appear in build order.
+    assert_cell_equals(joined, 0, 1, "small0");
+    assert_cell_equals(joined, 1, 1, "small6000");
+    assert_cell_equals(joined, 1, 3, "big0");
+    assert_cell_equals(joined, 11999, 3, "big17997");
+
+    DataSourceCursor* cursor = data_source_open_cursor(joined);
+    ASSERT_NOT_NULL(cursor);
+    FieldDesc fd = data_source_cursor_get_cell(cursor, 2, 2);
+    char buffer[32];
+    render_field(&fd, buffer, sizeof(buffer));
+    ASSERT_EQ(strcmp(buffer, "k3"), 0);
+    data_source_close_cursor(cursor);
+
+    destroy_data_source(joined);
+    destroy_data_source(right);
+    destroy_data_source(left);
+}
+
+static void test_search_hit_list() {
+    const char *headers[] = {"name", "note"};
+    InMemoryTable* table = create_in_memory_table("Hay", 2, headers);
+    char name[32], note[32];
+    const char *row[] = {name, note};
+    for (int i = 0; i < 20000; i++) {
+        snprintf(name, sizeof(name), "row%05d", i);
+        snprintf(note, sizeof(note), i % 1000 == 7 ? "needle%d" : "hay", i);
+        add_in_memory_table_row(table, row);
+    }
+    DataSource* ds = create_memory_data_source(table);
+    DSVViewer viewer;
+    memset(&viewer, 0, sizeof(viewer));
+    View view = { .data_source = ds, .visible_row_count = 20000, .sort_column = -1, .last_sorted_column = -1 };
+    size_t index, count;
+
+    ASSERT_EQ(search_view(&viewer, &view, "needle", SEARCH_LITERAL, true), SEARCH_FOUND);
+    ASSERT_EQ(view.cursor_row, 7);
+    ASSERT_EQ(view.cursor_col, 1);
+    TEST_ASSERT(search_view_match_position(&view, &index, &count), "no current match");
+    ASSERT_EQ(index, 0);
+    ASSERT_EQ(count, 20);
+
+    ASSERT_EQ(search_view(&viewer, &view, "needle", SEARCH_LITERAL, false), SEARCH_FOUND);
+    ASSERT_EQ(view.cursor_row, 1007);
+    ASSERT_EQ(search_view_previous(&viewer, &view, "needle", SEARCH_LITERAL), SEARCH_FOUND);
+    ASSERT_EQ(view.cursor_row, 7);
+    ASSERT_EQ(search_view_previous(&viewer, &view, "needle", SEARCH_LITERAL), SEARCH_WRAPPED_AND_FOUND);
+    ASSERT_EQ(view.cursor_row, 19007);
+    ASSERT_EQ(search_view(&viewer, &view, "needle", SEARCH_LITERAL, false), SEARCH_WRAPPED_AND_FOUND);
+    ASSERT_EQ(view.cursor_row, 7);
+
+    // Moving the cursor by hand resumes from there.
+    view.cursor_row = 5000;
+    ASSERT_EQ(search_view(&viewer, &view, "needle", SEARCH_LITERAL, false), SEARCH_FOUND);
+    ASSERT_EQ(view.cursor_row, 5007);
+
+    // Re-sorting invalidates the list; hits follow the new display order.
+    view.sort_column = 0;
+    view.sort_direction = SORT_DESC;
+    sort_view(&view);
+    view.cursor_row = 0;
+    view.cursor_col = 0;
+    ASSERT_EQ(search_view(&viewer, &view, "needle", SEARCH_LITERAL, true), SEARCH_FOUND);
+    ASSERT_EQ(view.cursor_row, 19999 - 19007);
+    ASSERT_EQ(search_view(&viewer, &view, "nothing like this", SEARCH_LITERAL, true), SEARCH_NOT_FOUND);
+    TEST_ASSERT(!search_view_match_position(&view, &index, &count), "stale match reported");
+
+    search_clear(&view);
+    sort_cache_clear(&view);
+    view_free_row_order_map(&view);
+    free(view.reverse_row_map);
+    destroy_data_source(ds);
+}
+
+typedef struct {
+    size_t rows[256];
+    size_t cols[256];
+    size_t count;
+} CollectedMatches;
+
+static bool collect_match(void *user, size_t row, size_t col) {
+    CollectedMatches *matches = (CollectedMatches *)user;
+    if (matches->count == 256) return false;
+    matches->rows[matches->count] = row;
+    matches->cols[matches->count++] = col;
+    return true;
+}
+
+static void test_search_raw_file_fast_path() {
+    // Rare matches in plain, quoted and escaped fields.
+    size_t capacity = 1 << 20, length = 0;
+    char *content = malloc(capacity);
+    length += snprintf(content + length, capacity - length, "id,name,note\n");
+    for (int i = 0; i < 9000; i++) {
+        const char *note = "plain";
+        if (i % 500 == 3) note = "\"quoted, needle here\"";
+        else if (i % 500 == 4) note = "\"escaped \"\"needle\"\"\"";
+        else if (i % 500 == 5) note = "needle";
+        length += snprintf(content + length, capacity - length, "%d,%s%d,%s\n",
+                           i, i % 1000 == 5 ? "needleman" : "name", i, note);
+    }
+    FileDSTestFixture fixture;
+    setup_file_ds_test(&fixture, content);
+    DataSource* ds = fixture.viewer.main_data_source;
+    size_t rows = ds->ops->get_row_count(ds->context);
+    ASSERT_EQ(rows, 9000);
+
+    // The raw scan finds exactly what reading every cell finds.
+    CollectedMatches raw = {0};
+    CellQuery needle = { .literal = "needle" };
+    TEST_ASSERT(data_source_search_rows(ds, &needle, 0, rows, collect_match, &raw), "fast path not taken");
+    size_t expected = 0;
+    char buffer[64];
+    for (size_t r = 0; r < rows; r++) {
+        for (size_t c = 0; c < 3; c++) {
+            FieldDesc fd = ds->ops->get_cell(ds->context, r, c);
+            render_field(&fd, buffer, sizeof(buffer));
+            if (strstr(buffer, "needle") == NULL) continue;
+            ASSERT_LT(expected, raw.count);
+            ASSERT_EQ(raw.rows[expected], r);
+            ASSERT_EQ(raw.cols[expected], c);
+            expected++;
+        }
+    }
+    ASSERT_EQ(raw.count, expected);
+    ASSERT_EQ(expected, 18 * 3 + 9);
+
+    // Terms that read differently in the file are left to the cell scan.
+    CollectedMatches quoted = {0};
+    CellQuery with_quote = { .literal = "\"needle" }, with_delimiter = { .literal = "a, b" };
+    TEST_ASSERT(!data_source_search_rows(ds, &with_quote, 0, rows, collect_match, &quoted), "quote handled raw");
+    TEST_ASSERT(!data_source_search_rows(ds, &with_delimiter, 0, rows, collect_match, &quoted), "delimiter handled raw");
+
+    // Through the view the fast path and the cell scan agree on the escaped field.
+    View view = { .data_source = ds, .visible_row_count = rows, .sort_column = -1, .last_sorted_column = -1 };
+    ASSERT_EQ(search_view(&fixture.viewer, &view, "\"needle\"", SEARCH_LITERAL, true), SEARCH_FOUND);
+    ASSERT_EQ(view.cursor_row, 4);
+    ASSERT_EQ(view.cursor_col, 2);
+    ASSERT_EQ(search_view(&fixture.viewer, &view, "needleman", SEARCH_LITERAL, false), SEARCH_FOUND);
+    ASSERT_EQ(view.cursor_row, 5);
+    ASSERT_EQ(view.cursor_col, 1);
+
+    search_clear(&view);
+    free(content);
+    teardown_file_ds_test(&fixture);
+}
+
+static bool regex_matches(const char *pattern, const char *text) {
+    CompiledRegex *regex = NULL;
+    if (regex_compile(pattern, REGEX_DEFAULT, &regex, NULL, 0) != DSV_OK) return false;
+    RegexMatcher *matcher = regex_matcher_create(regex);
+    bool matched = matcher && regex_matcher_search(matcher, text, strlen(text));
+    regex_matcher_free(matcher);
+    regex_free(regex);
+    return matched;
+}
+
+static void test_regex_matching() {
+    TEST_ASSERT(regex_matches("ERR[0-9]{4}", "code ERR1234 seen"), "bounded repeat");
+    TEST_ASSERT(!regex_matches("ERR[0-9]{4}", "code ERR123"), "too few digits");
+    TEST_ASSERT(regex_matches("^ab|cd$", "abx"), "start anchor");
+    TEST_ASSERT(regex_matches("^ab|cd$", "xcd"), "end anchor");
+    TEST_ASSERT(!regex_matches("^ab|cd$", "xabcdx"), "anchors ignored");
+    TEST_ASSERT(regex_matches("^\\d+(\\.\\d+)?$", "3.25"), "escape classes");
+    TEST_ASSERT(!regex_matches("^\\d+(\\.\\d+)?$", "3."), "optional group");
+    TEST_ASSERT(regex_matches("[^a-z_]", "abc_D"), "negated class");
+    TEST_ASSERT(!regex_matches("[^a-z_]", "abc_d"), "negated class matched");
+    TEST_ASSERT(regex_matches("a.c", "xxabcxx"), "dot");
+    TEST_ASSERT(regex_matches("colou?r", "color"), "question mark");
+    TEST_ASSERT(regex_matches("", "anything"), "empty pattern");
+
+    // Invalid patterns report where they went wrong.
+    const char *invalid[] = {"(", "a)", "a{3,1}", "*", "[a-", "x\\"};
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        CompiledRegex *regex = NULL;
+        char error[128] = "";
+        ASSERT_EQ(regex_compile(invalid[i], REGEX_DEFAULT, &regex, error, sizeof(error)), DSV_ERROR_PARSE);
+        ASSERT_NULL(regex);
+        TEST_ASSERT(strstr(error, "offset") != NULL, "error has no offset");
+    }
+
+    // Every match contains the required literal.
+    CompiledRegex *regex = NULL;
+    ASSERT_EQ(regex_compile("ERR[0-9]{4}", REGEX_DEFAULT, &regex, NULL, 0), DSV_OK);
+    ASSERT_EQ(strcmp(regex_required_literal(regex), "ERR"), 0);
+    regex_free(regex);
+    ASSERT_EQ(regex_compile("(foo|bar)baz", REGEX_DEFAULT, &regex, NULL, 0), DSV_OK);
+    ASSERT_EQ(strcmp(regex_required_literal(regex), "baz"), 0);
+    regex_free(regex);
+    ASSERT_EQ(regex_compile("a|b", REGEX_DEFAULT, &regex, NULL, 0), DSV_OK);
+    ASSERT_EQ(strcmp(regex_required_literal(regex), ""), 0);
+    regex_free(regex);
+
+    // A pattern with more DFA states than the cache holds still matches.
+    ASSERT_EQ(regex_compile("[ab]*a[ab]{11}$", REGEX_DEFAULT, &regex, NULL, 0), DSV_OK);
+    RegexMatcher *matcher = regex_matcher_create(regex);
+    ASSERT_NOT_NULL(matcher);
+    char text[4097];
+    unsigned int seed = 12345;
+    for (int round = 0; round < 50; round++) {
+        for (int i = 0; i < 4096; i++) {
+            seed = seed * 1103515245u + 12345u;
+            text[i] = (seed >> 16) & 1 ? 'a' : 'b';
+        }
+        text[4096] = '\0';
+        ASSERT_EQ(regex_matcher_search(matcher, text, 4096), text[4096 - 12] == 'a');
+    }
+    regex_matcher_free(matcher);
+    regex_free(regex);
+}
+
+static void test_search_regex() {
+    size_t capacity = 1 << 20, length = 0;
+    char *content = malloc(capacity);
+    length += snprintf(content + length, capacity - length, "id,code\n");
+    for (int i = 0; i < 9000; i++) {
+        length += snprintf(content + length, capacity - length, i % 700 == 9 ? "%d,ERR%04d\n" : "%d,ERR%d\n", i, i);
+    }
+    FileDSTestFixture fixture;
+    setup_file_ds_test(&fixture, content);
+    DataSource* ds = fixture.viewer.main_data_source;
+    size_t rows = ds->ops->get_row_count(ds->context);
+    View view = { .data_source = ds, .visible_row_count = rows, .sort_column = -1, .last_sorted_column = -1 };
+    size_t index, count;
+
+    // Four-digit codes only: zero-padded rows and rows 1000 and up.
+    ASSERT_EQ(search_view(&fixture.viewer, &view, "^ERR[0-9]{4}$", SEARCH_REGEX, true), SEARCH_FOUND);
+    ASSERT_EQ(view.cursor_row, 9);
+    ASSERT_EQ(view.cursor_col, 1);
+    TEST_ASSERT(search_view_match_position(&view, &index, &count), "no current match");
+    ASSERT_EQ(count, 2 + (9000 - 1000));
+
+    // The same term as a literal matches nothing.
+    ASSERT_EQ(search_view(&fixture.viewer, &view, "^ERR[0-9]{4}$", SEARCH_LITERAL, true), SEARCH_NOT_FOUND);
+
+    // Sorted views take the cell scan and agree with the raw scan.
+    view.sort_column = 0;
+    view.sort_direction = SORT_DESC;
+    sort_view(&view);
+    view.cursor_row = 0;
+    view.cursor_col = 0;
+    ASSERT_EQ(search_view(&fixture.viewer, &view, "^ERR[0-9]{4}$", SEARCH_REGEX, true), SEARCH_FOUND);
+    ASSERT_EQ(view.cursor_row, 0);
+    TEST_ASSERT(search_view_match_position(&view, &index, &count), "no current match");
+    ASSERT_EQ(count, 2 + (9000 - 1000));
+
+    ASSERT_EQ(search_view(&fixture.viewer, &view, "ERR(", SEARCH_REGEX, true), SEARCH_NOT_FOUND);
+    TEST_ASSERT(strstr(fixture.viewer.display_state->error_message, "Invalid pattern") != NULL,
+                "invalid pattern not reported");
+
+    search_clear(&view);
+    sort_cache_clear(&view);
+    view_free_row_order_map(&view);
+    free(view.reverse_row_map);
+    free(content);
+    teardown_file_ds_test(&fixture);
+}
+
+static void test_search_ignore_case() {
+    size_t capacity = 1 << 20, length = 0;
+    char *content = malloc(capacity);
+    length += snprintf(content + length, capacity - length, "id,note\n");
+    const char *notes[] = {"Needle", "NEEDLE", "\"a, nEeDlE\"", "\xc3\x84pfel"};
+    for (int i = 0; i < 9000; i++) {
+        length += snprintf(content + length, capacity - length, "%d,%s\n", i, i % 100 == 50 ? notes[(i / 100) % 4] : "hay");
+    }
+    FileDSTestFixture fixture;
+    setup_file_ds_test(&fixture, content);
+    DataSource* ds = fixture.viewer.main_data_source;
+    size_t rows = ds->ops->get_row_count(ds->context);
+    View view = { .data_source = ds, .visible_row_count = rows, .sort_column = -1, .last_sorted_column = -1 };
+    size_t index, count;
+
+    // The raw scan folds case too and agrees with the cell scan.
+    CollectedMatches raw = {0};
+    CellQuery needle = { .literal = "needle", .ignore_case = true };
+    TEST_ASSERT(data_source_search_rows(ds, &needle, 0, rows, collect_match, &raw), "fast path not taken");
+    ASSERT_EQ(raw.count, 23 + 23 + 22);
+    ASSERT_EQ(raw.rows[0], 50);
+    ASSERT_EQ(raw.rows[1], 150);
+    ASSERT_EQ(raw.rows[2], 250);
+
+    ASSERT_EQ(search_view(&fixture.viewer, &view, "needle", SEARCH_LITERAL, true), SEARCH_NOT_FOUND);
+    ASSERT_EQ(search_view(&fixture.viewer, &view, "needle", SEARCH_IGNORE_CASE, true), SEARCH_FOUND);
+    TEST_ASSERT(search_view_match_position(&view, &index, &count), "no current match");
+    ASSERT_EQ(count, raw.count);
+
+    ASSERT_EQ(search_view(&fixture.viewer, &view, "^needle$", SEARCH_REGEX | SEARCH_IGNORE_CASE, true), SEARCH_FOUND);
+    TEST_ASSERT(search_view_match_position(&view, &index, &count), "no current match");
+    ASSERT_EQ(count, 2 * 23);
+    ASSERT_EQ(search_view(&fixture.viewer, &view, "\xc3\xa4PFEL", SEARCH_IGNORE_CASE, true), SEARCH_FOUND);
+    ASSERT_EQ(view.cursor_row, 350);
+
+    search_clear(&view);
+    free(content);
+    teardown_file_ds_test(&fixture);
+}
+
+static void wait_for_incremental_search(View *view) {
+    while (!search_incremental_poll(view)) usleep(1000);
+}
+
+static void test_search_incremental() {
+    const char *headers[] = {"name", "note"};
+    InMemoryTable* table = create_in_memory_table("Hay", 2, headers);
+    char name[32], note[32];
+    const char *row[] = {name, note};
+    for (int i = 0; i < 20000; i++) {
+        snprintf(name, sizeof(name), "row%05d", i);
+        snprintf(note, sizeof(note), i % 1000 == 7 ? "needle%d" : i % 100 == 3 ? "net" : "hay", i);
+        add_in_memory_table_row(table, row);
+    }
+    DataSource* ds = create_memory_data_source(table);
+    DSVViewer viewer;
+    memset(&viewer, 0, sizeof(viewer));
+    View view = { .data_source = ds, .visible_row_count = 20000, .sort_column = -1, .last_sorted_column = -1 };
+    size_t count;
+
+    // Typing "ne" then "nee": the first scan is cancelled by the second keystroke.
+    TEST_ASSERT(search_incremental_update(&view, "n", SEARCH_LITERAL), "scan not started");
+    TEST_ASSERT(search_incremental_update(&view, "ne", SEARCH_LITERAL), "scan not started");
+    wait_for_incremental_search(&view);
+    TEST_ASSERT(search_view_match_count(&view, "ne", SEARCH_LITERAL, &count), "no count for ne");
+    ASSERT_EQ(count, 20 + 200);
+
+    // Changing a cell behind the scans' backs shows that "nee" only looks at
+    // the cells that matched "ne".
+    char *cell = (char *)in_memory_table_get_string(table, 0, 1, NULL);
+    memcpy(cell, "nee", 3);
+    TEST_ASSERT(search_incremental_update(&view, "nee", SEARCH_LITERAL), "scan not started");
+    wait_for_incremental_search(&view);
+    TEST_ASSERT(search_view_match_count(&view, "nee", SEARCH_LITERAL, &count), "no count for nee");
+    ASSERT_EQ(count, 20);
+    TEST_ASSERT(!search_view_match_count(&view, "ne", SEARCH_LITERAL, &count), "stale count reported");
+
+    // A shorter term, other flags or a regex scan everything again.
+    TEST_ASSERT(search_incremental_update(&view, "ee", SEARCH_LITERAL), "scan not started");
+    wait_for_incremental_search(&view);
+    TEST_ASSERT(search_view_match_count(&view, "ee", SEARCH_LITERAL, &count), "no count for ee");
+    ASSERT_EQ(count, 21);
+    TEST_ASSERT(search_incremental_update(&view, "NEE", SEARCH_IGNORE_CASE), "scan not started");
+    wait_for_incremental_search(&view);
+    TEST_ASSERT(search_view_match_count(&view, "NEE", SEARCH_IGNORE_CASE, &count), "no count for NEE");
+    ASSERT_EQ(count, 21);
+
+    // Enter finishes a scan of the same term and steps through its hits.
+    TEST_ASSERT(search_incremental_update(&view, "needle1", SEARCH_LITERAL), "scan not started");
+    ASSERT_EQ(search_view(&viewer, &view, "needle1", SEARCH_LITERAL, true), SEARCH_FOUND);
+    ASSERT_EQ(view.cursor_row, 1007);
+    TEST_ASSERT(search_view_match_count(&view, "needle1", SEARCH_LITERAL, &count), "no count for needle1");
+    ASSERT_EQ(count, 11);
+
+    // Invalid patterns and cancelled scans leave no hit list behind.
+    TEST_ASSERT(search_incremental_update(&view, "(", SEARCH_REGEX), "scan not started");
+    wait_for_incremental_search(&view);
+    TEST_ASSERT(!search_view_match_count(&view, "(", SEARCH_REGEX, &count), "invalid pattern counted");
+    TEST_ASSERT(search_incremental_update(&view, "hay", SEARCH_LITERAL), "scan not started");
+    search_incremental_cancel(&view);
+    TEST_ASSERT(view.pending_search == NULL, "scan still pending");
+
+    search_clear(&view);
+    destroy_data_source(ds);
+}
+
+// Checks that 'ranges' hold exactly the rows 'expected' accepts, joined into
+// as few ranges as possible.
+static void assert_ranges_cover(const RowRange *ranges, size_t count, size_t rows, bool (*expected)(size_t)) {
+    size_t k = 0;
+    for (size_t row = 0; row < rows; row++) {
+        bool covered = k < count && ranges[k].start <= row && row <= ranges[k].end;
+        ASSERT_EQ(covered, expected(row));
+        if (k < count && row == ranges[k].end) k++;
+    }
+    ASSERT_EQ(k, count);
+    for (k = 1; k < count; k++) ASSERT_GT(ranges[k].start, ranges[k - 1].end + 1);
+}
+
+static bool red_anywhere(size_t row) { return row % 3 == 0 || row % 5 == 0; }
+static bool red_in_note(size_t row) { return row % 5 == 0; }
+static bool red_and_green(size_t row) { return row % 3 == 0 && row % 5 != 0; }
+static bool in_long_run(size_t row) { return row >= 4000 && row < 12000; }
+
+static void test_search_filter_rows() {
+    size_t capacity = 1 << 20, length = 0;
+    char *content = malloc(capacity);
+    length += snprintf(content + length, capacity - length, "id,color,note\n");
+    for (int i = 0; i < 9000; i++) {
+        length += snprintf(content + length, capacity - length, "%d,%s,%s\n", i,
+                           i % 3 == 0 ? "red" : "blue", i % 5 == 0 ? "red" : "green");
+    }
+    FileDSTestFixture fixture;
+    setup_file_ds_test(&fixture, content);
+    DataSource* ds = fixture.viewer.main_data_source;
+    View view = { .data_source = ds, .visible_row_count = 9000, .sort_column = -1, .last_sorted_column = -1 };
+    RowRange *ranges;
+    size_t range_count, rows;
+
+    // Any column, through the raw scan.
+    ASSERT_EQ(search_filter_rows(&view, "red", SEARCH_LITERAL, -1, &ranges, &range_count, &rows, NULL, 0), DSV_OK);
+    ASSERT_EQ(rows, 3000 + 1800 - 600);
+    assert_ranges_cover(ranges, range_count, 9000, red_anywhere);
+    free(ranges);
+
+    // One column only, whatever the display order.
+    view.sort_column = 0;
+    view.sort_direction = SORT_DESC;
+    sort_view(&view);
+    ASSERT_EQ(search_filter_rows(&view, "RED", SEARCH_IGNORE_CASE, 2, &ranges, &range_count, &rows, NULL, 0), DSV_OK);
+    ASSERT_EQ(rows, 1800);
+    assert_ranges_cover(ranges, range_count, 9000, red_in_note);
+    free(ranges);
+
+    // Filtering a filtered view scans its ranges cell by cell.
+    ASSERT_EQ(search_filter_rows(&view, "^red$", SEARCH_REGEX, 1, &ranges, &range_count, &rows, NULL, 0), DSV_OK);
+    View red_view = { .data_source = ds, .ranges = ranges, .num_ranges = range_count, .visible_row_count = rows,
+                      .sort_column = -1, .last_sorted_column = -1 };
+    ASSERT_EQ(search_filter_rows(&red_view, "green", SEARCH_LITERAL, 2, &ranges, &range_count, &rows, NULL, 0), DSV_OK);
+    ASSERT_EQ(rows, 3000 - 600);
+    assert_ranges_cover(ranges, range_count, 9000, red_and_green);
+    free(ranges);
+    free(red_view.ranges);
+
+    ASSERT_EQ(search_filter_rows(&view, "nowhere", SEARCH_LITERAL, -1, &ranges, &range_count, &rows, NULL, 0), DSV_OK);
+    ASSERT_EQ(rows, 0);
+    ASSERT_NULL(ranges);
+    char error[128] = "";
+    ASSERT_EQ(search_filter_rows(&view, "(red", SEARCH_REGEX, -1, &ranges, &range_count, &rows, error, sizeof(error)),
+              DSV_ERROR_PARSE);
+    TEST_ASSERT(error[0] != '\0', "no pattern error");
+    ASSERT_EQ(search_filter_rows(&view, "red", SEARCH_LITERAL, 3, &ranges, &range_count, &rows, NULL, 0),
+              DSV_ERROR_INVALID_ARGS);
+
+    sort_cache_clear(&view);
+    view_free_row_order_map(&view);
+    free(view.reverse_row_map);
+    free(content);
+    teardown_file_ds_test(&fixture);
+
+    // A run of matches spanning every chunk comes out as one range.
+    const char *headers[] = {"value"};
+    InMemoryTable* table = create_in_memory_table("Runs", 1, headers);
+    for (size_t i = 0; i < 20000; i++) {
+        const char *row[] = { in_long_run(i) ? "match" : "other" };
+        add_in_memory_table_row(table, row);
+    }
+    DataSource* memory = create_memory_data_source(table);
+    View memory_view = { .data_source = memory, .visible_row_count = 20000, .sort_column = -1, .last_sorted_column = -1 };
+    ASSERT_EQ(search_filter_rows(&memory_view, "match", SEARCH_LITERAL, -1, &ranges, &range_count, &rows, NULL, 0), DSV_OK);
+    ASSERT_EQ(range_count, 1);
+    ASSERT_EQ(rows, 8000);
+    assert_ranges_cover(ranges, range_count, 20000, in_long_run);
+    free(ranges);
+    destroy_data_source(memory);
+}
+
+static bool same_matches(DataSource *a, DataSource *b, const CellQuery *query, size_t first_row, size_t row_count) {
+    CollectedMatches left = {0}, right = {0};
+    bool left_raw = data_source_search_rows(a, query, first_row, row_count, collect_match, &left);
+    bool right_raw = data_source_search_rows(b, query, first_row, row_count, collect_match, &right);
+    if (left_raw != right_raw || left.count != right.count) return false;
+    for (size_t i = 0; i < left.count; i++) {
+        if (left.rows[i] != right.rows[i] || left.cols[i] != right.cols[i]) return false;
+    }
+    return true;
+}
+
+static bool patch_file(const char *path, long offset, const void *bytes, size_t length) {
+    FILE *file = fopen(path, "r+b");
+    if (!file) return false;
+    bool ok = fseek(file, offset, SEEK_SET) == 0 && fwrite(bytes, 1, length, file) == length;
+    return fclose(file) == 0 && ok;
+}
+
+static void test_search_trigram_index() {
+    // Block-level postings round-trip through a saved index.
+    size_t offsets[1000];
+    char text[16000];
+    size_t length = 0;
+    for (size_t i = 0; i < 1000; i++) {
+        offsets[i] = length;
+        length += snprintf(text + length, sizeof(text) - length, "%s,%zu\n", i % 3 == 0 ? "xAbCx" : "plain", i);
+    }
+    TrigramIndexInput input = { .data = text, .length = length, .row_offsets = offsets,
+                                .row_count = 1000, .delimiter = ',', .source_modified = 42, .block_rows = 1 };
+    TrigramIndex *built = trigram_index_build(&input, NULL);
+    ASSERT_NOT_NULL(built);
+    ASSERT_EQ(trigram_index_save(built, "test_trigrams.tmp"), DSV_OK);
+    TrigramIndex *loaded = trigram_index_load("test_trigrams.tmp", &input);
+    ASSERT_NOT_NULL(loaded);
+    TrigramIndex *indexes[] = { built, loaded };
+    for (int k = 0; k < 2; k++) {
+        // Every third block, entered past the first skip entries.
+        TrigramQuery *query = trigram_query_create(indexes[k], "abc", 3, false);
+        ASSERT_NOT_NULL(query);
+        ASSERT_EQ(trigram_query_next_block(query, 0), 0);
+        ASSERT_EQ(trigram_query_next_block(query, 1), 3);
+        ASSERT_EQ(trigram_query_next_block(query, 700), 702);
+        ASSERT_EQ(trigram_query_next_block(query, 998), 999);
+        ASSERT_EQ(trigram_query_next_block(query, 1000), SIZE_MAX);
+        trigram_query_free(query);
+
+        query = trigram_query_create(indexes[k], "ABCX,9", 6, true);
+        ASSERT_NOT_NULL(query);
+        ASSERT_EQ(trigram_query_next_block(query, 0), 0);
+        trigram_query_free(query);
+        query = trigram_query_create(indexes[k], "bcq", 3, false);
+        ASSERT_EQ(trigram_query_next_block(query, 0), SIZE_MAX);
+        trigram_query_free(query);
+        ASSERT_NULL(trigram_query_create(indexes[k], "a,b", 3, false));
+    }
+    trigram_index_free(loaded);
+
+    // Damage that keeps the file sizes consistent is still rejected: the
+    // first entry's list offset (after the 64-byte header) and the final
+    // posting byte, which becomes a varint running off the end.
+    uint64_t bad_offset = 1;
+    TEST_ASSERT(patch_file("test_trigrams.tmp", 64 + 8, &bad_offset, sizeof(bad_offset)), "Failed to patch trigram index");
+    ASSERT_NULL(trigram_index_load("test_trigrams.tmp", &input));
+    ASSERT_EQ(trigram_index_save(built, "test_trigrams.tmp"), DSV_OK);
+    struct stat st;
+    ASSERT_EQ(stat("test_trigrams.tmp", &st), 0);
+    uint8_t bad_byte = 0x80;
+    TEST_ASSERT(patch_file("test_trigrams.tmp", st.st_size - 1, &bad_byte, 1), "Failed to patch trigram index");
+    ASSERT_NULL(trigram_index_load("test_trigrams.tmp", &input));
+
+    ASSERT_EQ(trigram_index_save(built, "test_trigrams.tmp"), DSV_OK);
+    loaded = trigram_index_load("test_trigrams.tmp", &input);
+    ASSERT_NOT_NULL(loaded);
+    input.source_modified = 43;
+    ASSERT_NULL(trigram_index_load("test_trigrams.tmp", &input));
+    trigram_index_free(built);
+    trigram_index_free(loaded);
+    unlink("test_trigrams.tmp");
+
+    // An indexed file source finds exactly what the plain raw scan finds.
+    size_t capacity = 1 << 20;
+    char *content = malloc(capacity);
+    length = snprintf(content, capacity, "id,name,note\n");
+    for (int i = 0; i < 9000; i++) {
+        const char *note = "plain";
+        if (i % 700 == 11) note = "\"quoted, Needle here\"";
+        else if (i % 700 == 12) note = "NEEDLE";
+        else if (i % 900 == 255) note = "needle";
+        length += snprintf(content + length, capacity - length, "%d,name%d,%s\n", i, i, note);
+    }
+    FileDSTestFixture fixture;
+    setup_file_ds_test(&fixture, content);
+    DataSource *plain = fixture.viewer.main_data_source;
+    fixture.config.trigram_index = 1;
+    DataSource *indexed = create_file_data_source(&fixture.viewer);
+    TEST_ASSERT(file_data_source_wait_for_index(indexed), "index not built");
+    TEST_ASSERT(!file_data_source_wait_for_index(plain), "index built while disabled");
+
+    CellQuery queries[] = {
+        { .literal = "needle" }, { .literal = "needle", .ignore_case = true },
+        { .literal = "NEEDLE" }, { .literal = "eedl", .ignore_case = true },
+        { .literal = "name8999" }, { .literal = "e8" }, { .literal = "zzq" },
+    };
+    for (size_t q = 0; q < sizeof(queries) / sizeof(queries[0]); q++) {
+        TEST_ASSERT(same_matches(plain, indexed, &queries[q], 0, 9000), "indexed search differs");
+        TEST_ASSERT(same_matches(plain, indexed, &queries[q], 250, 3000), "indexed range search differs");
+    }
+
+    // The saved index is picked up by the next source over the same file.
+    char index_path[256];
+    snprintf(index_path, sizeof(index_path), "%s%s", fixture.test_filename, TRIGRAM_INDEX_SUFFIX);
+    ASSERT_EQ(access(index_path, F_OK), 0);
+    DataSource *reloaded = create_file_data_source(&fixture.viewer);
+    TEST_ASSERT(file_data_source_wait_for_index(reloaded), "saved index not loaded");
+    TEST_ASSERT(same_matches(plain, reloaded, &queries[1], 0, 9000), "loaded index differs");
+
+    destroy_data_source(reloaded);
+    destroy_data_source(indexed);
+    unlink(index_path);
+    free(content);
+    teardown_file_ds_test(&fixture);
+}
+
 TestCase data_source_tests[] = {
     {"Memory DS | Creation", test_memory_ds_creation},
     {"Memory DS | Row/Col Counts", test_memory_ds_counts},
     {"Memory DS | Get Cell", test_memory_ds_get_cell},
     {"Memory DS | Get Header", test_memory_ds_get_header},
+    {"Memory DS | Typed Columns", test_memory_ds_typed_columns},
+    {"Memory DS | Many Rows", test_memory_ds_many_rows},
     {"File DS | Creation", test_file_ds_creation},
     {"File DS | Row/Col Counts", test_file_ds_counts},
     {"File DS | Get Cell", test_file_ds_get_cell},
     {"File DS | Get Header", test_file_ds_get_header},
+    {"File DS | Independent Cursors", test_file_ds_cursors},
+    {"File DS | Column Widths Sampled Across File", test_file_ds_column_widths},
+    {"Computed DS | Arithmetic", test_computed_ds_arithmetic},
+    {"Computed DS | String Functions", test_computed_ds_string_functions},
+    {"Computed DS | Errors", test_computed_ds_errors},
+    {"Computed DS | Materialized Column", test_computed_ds_materialized_column},
+    {"Computed DS | Sampled Width", test_computed_ds_sampled_width},
+    {"Join | Duplicate And Missing Keys", test_join_duplicate_and_missing_keys},
+    {"Join | Partitioned Build", test_join_partitioned_build},
+    {"Join | From Prompt", test_join_from_prompt},
+    {"Search | Parallel Hit List", test_search_hit_list},
+    {"Search | Raw File Fast Path", test_search_raw_file_fast_path},
+    {"Regex | Syntax And Matching", test_regex_matching},
+    {"Search | Regular Expressions", test_search_regex},
+    {"Search | Ignore Case", test_search_ignore_case},
+    {"Search | Filter Rows To Ranges", test_search_filter_rows},
+    {"Search | Incremental Narrowing", test_search_incremental},
+    {"Search | Trigram Index", test_search_trigram_index},
 };
 
 int data_source_suite_size = sizeof(data_source_tests) / sizeof(TestCase); 
\ No newline at end of file
@@ -2,8 +2,15 @@
 #include "core/sorting.h"
 #include "core/data_source.h"
 #include "ui/view_manager.h"
+#include "ui/navigation.h"
+#include "core/value_index.h"
+#include "memory/in_memory_table.h"
+#include "util/parallel.h"
+#include <stdio.h>
 #include <string.h>
+#include <strings.h>
 #include <stdlib.h>
+#include <locale.h>
 
 // Mock implementations for dependencies
 FieldDesc mock_get_cell(void *context, size_t row, size_t col) {
@@ -25,6 +32,14 @@ size_t mock_get_col_count(void *context) {
 // --- Test Cases ---
 void test_string_sorting_ascending(void);
 void test_string_sorting_descending(void);
+void test_parallel_sort_matches_serial(void);
+void test_sort_kernels_prefix_and_sign(void);
+void test_multi_column_sort(void);
+void test_sort_permutation_cache(void);
+void test_progressive_sort(void);
+void test_external_sort(void);
+void test_external_sort_many_runs(void);
+void test_locale_collation_sort(void);
 
 void test_string_sorting_ascending() {
     // Test data
@@ -64,6 +79,8 @@ void test_string_sorting_ascending() {
 
     // Cleanup
     free(view.row_order_map);
+    free(view.reverse_row_map);
+    sort_cache_clear(&view);
 }
 
 void test_string_sorting_descending() {
@@ -104,11 +121,493 @@ void test_string_sorting_descending() {
 
     // Cleanup
     free(view.row_order_map);
+    free(view.reverse_row_map);
+    sort_cache_clear(&view);
+}
+
+void test_parallel_sort_matches_serial() {
+    // Enough rows for several runs and merge rounds; keys repeat so the
+    // original-index tie-break is exercised.
+    const size_t row_count = 50000;
+    const char *headers[] = {"key"};
+    InMemoryTable *table = create_in_memory_table("Keys", 1, headers);
+    char value[32];
+    const char *row[] = {value};
+    for (size_t i = 0; i < row_count; i++) {
+        snprintf(value, sizeof(value), "k%03zu", (i * 7919) % 997);
+        add_in_memory_table_row(table, row);
+    }
+    DataSource *ds = create_memory_data_source(table);
+
+    View view = {
+        .data_source = ds,
+        .visible_row_count = row_count,
+        .sort_column = 0,
+        .sort_direction = SORT_ASC,
+        .last_sorted_column = -1,
+    };
+
+    parallel_set_max_workers(4);
+    sort_view(&view);
+    ASSERT_NOT_NULL(view.row_order_map);
+
+    size_t *ascending = malloc(row_count * sizeof(size_t));
+    memcpy(ascending, view.row_order_map, row_count * sizeof(size_t));
+    for (size_t i = 1; i < row_count; i++) {
+        size_t prev = ascending[i - 1], cur = ascending[i];
+        size_t prev_key = (prev * 7919) % 997, cur_key = (cur * 7919) % 997;
+        TEST_ASSERT(prev_key < cur_key || (prev_key == cur_key && prev < cur), "rows out of order");
+    }
+
+    // Descending is the exact reverse of ascending.
+    view.sort_direction = SORT_DESC;
+    view.last_sorted_column = -1;
+    sort_view(&view);
+    for (size_t i = 0; i < row_count; i++) {
+        ASSERT_EQ(view.row_order_map[i], ascending[row_count - 1 - i]);
+    }
+    parallel_set_max_workers(0);
+
+    free(ascending);
+    free(view.row_order_map);
+    free(view.reverse_row_map);
+    sort_cache_clear(&view);
+    destroy_data_source(ds);
+}
+
+static size_t* sort_memory_column(const char **values, size_t count, SortDirection direction) {
+    const char *headers[] = {"value"};
+    InMemoryTable *table = create_in_memory_table("Values", 1, headers);
+    for (size_t i = 0; i < count; i++) {
+        const char *row[] = {values[i]};
+        add_in_memory_table_row(table, row);
+    }
+    DataSource *ds = create_memory_data_source(table);
+    View view = {
+        .data_source = ds,
+        .visible_row_count = count,
+        .sort_column = 0,
+        .sort_direction = direction,
+        .last_sorted_column = -1,
+    };
+    sort_view(&view);
+    free(view.reverse_row_map);
+    sort_cache_clear(&view);
+    destroy_data_source(ds);
+    return view.row_order_map;
+}
+
+void test_sort_kernels_prefix_and_sign() {
+    // Repeated so the run is large enough for the radix kernels.
+    const char *text[] = {"Prefix-shared-B", "prefix-shared-a", "PREFIX-S", "prefix", "Prefix-shared-a", "apple"};
+    const char *numbers[] = {"10", "-3", "0", "-9223372036854775808", "7", "-3"};
+    const size_t base = 6, repeats = 100, count = base * repeats;
+    const char *text_values[600], *number_values[600];
+    for (size_t i = 0; i < count; i++) {
+        text_values[i] = text[i % base];
+        number_values[i] = numbers[i % base];
+    }
+
+    // apple < prefix < PREFIX-S < prefix-shared-a (x2, index order) < Prefix-shared-B
+    size_t *order = sort_memory_column(text_values, count, SORT_ASC);
+    ASSERT_NOT_NULL(order);
+    const size_t expected_text[] = {5, 3, 2, 1, 4, 0};
+    for (size_t group = 0; group < base; group++) {
+        for (size_t r = 0; r < repeats; r++) {
+            // Equal keys keep their original order; the two "prefix-shared-a"
+            // spellings compare equal and interleave by index.
+            size_t expected = expected_text[group] % base;
+            size_t actual = order[group * repeats + r] % base;
+            if (expected == 1 || expected == 4) {
+                TEST_ASSERT(actual == 1 || actual == 4, "case-insensitive ties grouped");
+            } else {
+                ASSERT_EQ(actual, expected);
+            }
+        }
+    }
+    for (size_t i = 1; i < count; i++) {
+        size_t a = order[i - 1], b = order[i];
+        if (strcasecmp(text_values[a], text_values[b]) == 0) {
+            TEST_ASSERT(a < b, "ties ordered by original index");
+        }
+    }
+    free(order);
+
+    order = sort_memory_column(number_values, count, SORT_ASC);
+    ASSERT_NOT_NULL(order);
+    ASSERT_EQ(order[0] % base, 3);            // INT64_MIN first
+    ASSERT_EQ(order[repeats] % base, 1);      // then -3, twice per repeat
+    ASSERT_EQ(order[3 * repeats] % base, 2);  // then 0
+    ASSERT_EQ(order[count - 1] % base, 0);    // 10 last
+    ASSERT_LT(order[repeats], order[repeats + 1]);
+    free(order);
+}
+
+void test_multi_column_sort() {
+    const char *headers[] = {"region", "revenue", "date"};
+    InMemoryTable *table = create_in_memory_table("Sales", 3, headers);
+    const char *rows[][3] = {
+        {"west", "10", "2024-02"},
+        {"East", "5",  "2024-01"},
+        {"west", "30", "2024-01"},
+        {"east", "5",  "2023-12"},
+        {"West", "10", "2023-11"},
+        {"east", "-2", "2024-03"},
+    };
+    for (size_t i = 0; i < 6; i++) add_in_memory_table_row(table, rows[i]);
+    DataSource *ds = create_memory_data_source(table);
+    View view = {
+        .data_source = ds,
+        .visible_row_count = 6,
+        .sort_column = -1,
+        .last_sorted_column = -1,
+    };
+
+    // region ASC, revenue DESC, date ASC
+    ASSERT_EQ(sort_view_toggle_key(&view, 0), true);
+    ASSERT_EQ(sort_view_toggle_key(&view, 1), true);
+    ASSERT_EQ(sort_view_toggle_key(&view, 1), true);
+    ASSERT_EQ(sort_view_toggle_key(&view, 2), true);
+    ASSERT_EQ(view.sort_key_count, 3);
+    ASSERT_EQ(view.sort_column, 0);
+    ASSERT_EQ(view.sort_keys[1].direction, SORT_DESC);
+
+    const size_t expected[] = {3, 1, 5, 2, 4, 0};
+    for (size_t i = 0; i < 6; i++) ASSERT_EQ(view.row_order_map[i], expected[i]);
+
+    // Dropping revenue leaves region ASC, date ASC.
+    ASSERT_EQ(sort_view_toggle_key(&view, 1), true);
+    ASSERT_EQ(view.sort_key_count, 2);
+    const size_t by_date[] = {3, 1, 5, 4, 2, 0};
+    for (size_t i = 0; i < 6; i++) ASSERT_EQ(view.row_order_map[i], by_date[i]);
+
+    // A single-column sort replaces the composite spec.
+    view.sort_column = 1;
+    view.sort_direction = SORT_NONE;
+    sort_view(&view);
+    ASSERT_EQ(view.sort_key_count, 1);
+    ASSERT_EQ(view.row_order_map[0], 5);
+
+    free(view.row_order_map);
+    free(view.reverse_row_map);
+    sort_cache_clear(&view);
+    destroy_data_source(ds);
+}
+
+// Two-column mock that counts cell reads, to tell cached sorts from real ones
+static size_t g_counted_reads = 0;
+static const char *g_counted_data[4][2] = {
+    {"b", "3"}, {"a", "1"}, {"c", "2"}, {"a", "0"},
+};
+
+static FieldDesc counting_get_cell(void *context, size_t row, size_t col) {
+    (void)context;
+    g_counted_reads++;
+    const char *value = g_counted_data[row][col];
+    return (FieldDesc){ .start = value, .length = strlen(value) };
+}
+
+static size_t counting_get_row_count(void *context) {
+    (void)context;
+    return 4;
+}
+
+static size_t counting_get_col_count(void *context) {
+    (void)context;
+    return 2;
+}
+
+void test_sort_permutation_cache() {
+    DataSource ds = {
+        .ops = &(DataSourceOps){
+            .get_cell = counting_get_cell,
+            .get_row_count = counting_get_row_count,
+            .get_col_count = counting_get_col_count
+        }
+    };
+    View view = {
+        .data_source = &ds,
+        .visible_row_count = 4,
+        .sort_column = 0,
+        .last_sorted_column = -1,
+    };
+
+    sort_view(&view); // column 0 ASC: a(1), a(3), b, c
+    ASSERT_EQ(view.sort_direction, SORT_ASC);
+    ASSERT_EQ(view.row_order_map[0], 1);
+    ASSERT_EQ(view.row_order_map[3], 2);
+    ASSERT_GT(g_counted_reads, 0);
+
+    // Flipping direction reverses the cached permutation without reading cells.
+    g_counted_reads = 0;
+    sort_view(&view);
+    ASSERT_EQ(view.sort_direction, SORT_DESC);
+    ASSERT_EQ(g_counted_reads, 0);
+    ASSERT_EQ(view.row_order_map[0], 2);
+    ASSERT_EQ(view.row_order_map[2], 3);
+    ASSERT_EQ(view.row_order_map[3], 1);
+
+    view.sort_column = 1;
+    view.sort_direction = SORT_NONE;
+    sort_view(&view);
+    ASSERT_EQ(view.row_order_map[0], 3);
+
+    // Returning to the first column is served from the cache as well.
+    g_counted_reads = 0;
+    view.sort_column = 0;
+    view.sort_direction = SORT_NONE;
+    sort_view(&view);
+    ASSERT_EQ(g_counted_reads, 0);
+    ASSERT_EQ(view.row_order_map[0], 1);
+
+    // Once dropped, the next sort reads the column again.
+    sort_cache_clear(&view);
+    ASSERT_NULL(view.sort_cache);
+    view.sort_column = 1;
+    view.last_sorted_column = -1;
+    view.sort_direction = SORT_NONE;
+    sort_view(&view);
+    ASSERT_GT(g_counted_reads, 0);
+
+    free(view.row_order_map);
+    free(view.reverse_row_map);
+    sort_cache_clear(&view);
+}
+
+void test_progressive_sort() {
+    // Large enough to take the progressive path; keys are a permutation.
+    const size_t row_count = 300000, prime = 299993;
+    const char *headers[] = {"key"};
+    InMemoryTable *table = create_in_memory_table("Keys", 1, headers);
+    char value[32];
+    const char *row[] = {value};
+    for (size_t i = 0; i < row_count; i++) {
+        snprintf(value, sizeof(value), "%zu", (i * 7919) % prime);
+        add_in_memory_table_row(table, row);
+    }
+    DataSource *ds = create_memory_data_source(table);
+    View view = {
+        .data_source = ds,
+        .visible_row_count = row_count,
+        .sort_column = 0,
+        .sort_direction = SORT_DESC,
+        .last_sorted_column = -1,
+    };
+
+    sort_view(&view);
+    ASSERT_NOT_NULL(view.pending_sort);
+    size_t ready = sort_view_ready_rows(&view);
+    ASSERT_GT(ready, 0);
+    ASSERT_LT(ready, row_count);
+
+    // The ready prefix is already final: the largest keys, descending.
+    size_t *prefix = malloc(ready * sizeof(size_t));
+    memcpy(prefix, view.row_order_map, ready * sizeof(size_t));
+    for (size_t i = 1; i < ready; i++) {
+        ASSERT_GT((prefix[i - 1] * 7919) % prime, (prefix[i] * 7919) % prime);
+    }
+
+    sort_view_wait(&view);
+    ASSERT_NULL(view.pending_sort);
+    ASSERT_EQ(sort_view_ready_rows(&view), row_count);
+    for (size_t i = 0; i < ready; i++) ASSERT_EQ(view.row_order_map[i], prefix[i]);
+    for (size_t i = 1; i < row_count; i++) {
+        size_t a = (view.row_order_map[i - 1] * 7919) % prime, b = (view.row_order_map[i] * 7919) % prime;
+        TEST_ASSERT(a > b || (a == b && view.row_order_map[i - 1] > view.row_order_map[i]), "rows out of order");
+    }
+
+    // The finished permutation was cached, so sorting again is immediate.
+    view.sort_direction = SORT_NONE;
+    view.last_sorted_column = -1;
+    sort_view(&view);
+    ASSERT_NULL(view.pending_sort);
+    ASSERT_EQ(view.sort_direction, SORT_ASC);
+    ASSERT_EQ(view.row_order_map[0], 0);  // Key 0 is on row 0
+    ASSERT_EQ(view.row_order_map[row_count - 1], prefix[0]);
+
+    // A view freed mid-sort discards the background work.
+    sort_cache_clear(&view);
+    view.sort_column = 0;
+    view.sort_direction = SORT_ASC;
+    view.last_sorted_column = -1;
+    sort_view(&view);
+    sort_cache_clear(&view);
+    ASSERT_NULL(view.pending_sort);
+
+    free(prefix);
+    free(view.row_order_map);
+    free(view.reverse_row_map);
+    destroy_data_source(ds);
+}
+
+void test_external_sort() {
+    // A tiny budget forces the view through spilled runs and a disk merge.
+    const size_t row_count = 20000, prime = 19997;
+    const char *headers[] = {"group", "value"};
+    InMemoryTable *table = create_in_memory_table("Spill", 2, headers);
+    char group[16], value[32];
+    const char *row[] = {group, value};
+    for (size_t i = 0; i < row_count; i++) {
+        snprintf(group, sizeof(group), "group-%zu", i % 7);
+        snprintf(value, sizeof(value), "%zu", (i * 7919) % prime);
+        add_in_memory_table_row(table, row);
+    }
+    DataSource *ds = create_memory_data_source(table);
+    View view = {
+        .data_source = ds,
+        .visible_row_count = row_count,
+        .sort_column = 1,
+        .sort_direction = SORT_DESC,
+        .last_sorted_column = -1,
+    };
+    sort_set_memory_budget(64 * 1024);
+
+    sort_view(&view);
+    ASSERT_NOT_NULL(view.row_order_map);
+    ASSERT_EQ(view.row_order_map_mapped, row_count);
+    for (size_t i = 1; i < row_count; i++) {
+        size_t a = (view.row_order_map[i - 1] * 7919) % prime, b = (view.row_order_map[i] * 7919) % prime;
+        TEST_ASSERT(a > b || (a == b && view.row_order_map[i - 1] > view.row_order_map[i]), "rows out of order");
+    }
+
+    // The reverse map is dropped, and linked selection rebuilds it.
+    ASSERT_NULL(view.reverse_row_map);
+    const char *value_header[] = {"Value"};
+    InMemoryTable *values = create_in_memory_table("Values", 1, value_header);
+    const char *value_row[] = {"v"};
+    add_in_memory_table_row(values, value_row);
+    ValueIndex *index = create_value_index(16);
+    size_t linked_rows[] = {5, 6};
+    add_to_value_index(index, "v", linked_rows, 2);
+    View child = { .data_source = create_memory_data_source(values), .visible_row_count = 1,
+                   .parent = &view, .parent_source_column = 1, .value_index = index };
+    init_row_selection(&view, row_count);
+    init_row_selection(&child, 1);
+    toggle_row_selection(&child, 0);
+    ASSERT_EQ(view.selection_count, 2);
+    for (size_t i = 0; i < row_count; i++) {
+        bool linked = view.row_order_map[i] == 5 || view.row_order_map[i] == 6;
+        ASSERT_EQ(view.row_selected[i], linked);
+    }
+    cleanup_row_selection(&child);
+    cleanup_row_selection(&view);
+    free_value_index(index);
+    destroy_data_source(child.data_source);
+
+    // Composite keys spill the same way: group ASC, then value DESC.
+    sort_view_toggle_key(&view, 1); // Drops the DESC key
+    sort_view_toggle_key(&view, 0);
+    sort_view_toggle_key(&view, 1);
+    sort_view_toggle_key(&view, 1);
+    ASSERT_EQ(view.sort_key_count, 2);
+    ASSERT_EQ(view.sort_keys[0].column, 0);
+    ASSERT_EQ(view.sort_keys[1].direction, SORT_DESC);
+    ASSERT_EQ(view.row_order_map_mapped, row_count);
+    for (size_t i = 1; i < row_count; i++) {
+        size_t ra = view.row_order_map[i - 1], rb = view.row_order_map[i];
+        TEST_ASSERT(ra % 7 < rb % 7 || (ra % 7 == rb % 7 && (ra * 7919) % prime >= (rb * 7919) % prime),
+                    "rows out of order");
+    }
+
+    sort_set_memory_budget(0);
+    view_free_row_order_map(&view);
+    ASSERT_NULL(view.row_order_map);
+    free(view.reverse_row_map);
+    sort_cache_clear(&view);
+    destroy_data_source(ds);
+}
+
+void test_external_sort_many_runs() {
+    // More runs than one merge takes are first merged into longer runs.
+    // Keys longer than the 8-byte prefix also carry their remainders through.
+    const size_t row_count = 100000, prime = 99991;
+    const char *headers[] = {"name"};
+    InMemoryTable *table = create_in_memory_table("Runs", 1, headers);
+    char name[32];
+    const char *row[] = {name};
+    for (size_t i = 0; i < row_count; i++) {
+        snprintf(name, sizeof(name), "item-%06zu", (i * 7919) % prime);
+        add_in_memory_table_row(table, row);
+    }
+    DataSource *ds = create_memory_data_source(table);
+    View view = {
+        .data_source = ds,
+        .visible_row_count = row_count,
+        .sort_column = 0,
+        .sort_direction = SORT_ASC,
+        .last_sorted_column = -1,
+    };
+    sort_set_memory_budget(64 * 1024);
+
+    sort_view(&view);
+    ASSERT_EQ(view.row_order_map_mapped, row_count);
+    for (size_t i = 1; i < row_count; i++) {
+        size_t a = (view.row_order_map[i - 1] * 7919) % prime, b = (view.row_order_map[i] * 7919) % prime;
+        TEST_ASSERT(a < b || (a == b && view.row_order_map[i - 1] < view.row_order_map[i]), "rows out of order");
+    }
+
+    sort_set_memory_budget(0);
+    view_free_row_order_map(&view);
+    free(view.reverse_row_map);
+    sort_cache_clear(&view);
+    destroy_data_source(ds);
+}
+
+static int compare_strcoll(const void *a, const void *b) {
+    return strcoll(*(const char * const *)a, *(const char * const *)b);
+}
+
+void test_locale_collation_sort() {
+    // Whatever locale is available, the sort must agree with strcoll on it.
+    const char *previous = setlocale(LC_COLLATE, NULL);
+    char *saved = previous ? strdup(previous) : NULL;
+    if (!setlocale(LC_COLLATE, "de_DE.UTF-8")) setlocale(LC_COLLATE, "C.UTF-8");
+
+    const char *names[] = {"Zoë", "Ärger", "apfel", "Äpfel", "zebra", "Öl", "oliven", "Müller", "Mueller", "", "Apfel"};
+    const size_t count = sizeof(names) / sizeof(names[0]);
+    const char *headers[] = {"name"};
+    InMemoryTable *table = create_in_memory_table("Names", 1, headers);
+    for (size_t i = 0; i < count; i++) add_in_memory_table_row(table, &names[i]);
+    DataSource *ds = create_memory_data_source(table);
+    View view = {
+        .data_source = ds,
+        .visible_row_count = count,
+        .sort_column = 0,
+        .sort_direction = SORT_ASC,
+        .last_sorted_column = -1,
+    };
+
+    const char *expected[sizeof(names) / sizeof(names[0])];
+    memcpy(expected, names, sizeof(names));
+    qsort(expected, count, sizeof(expected[0]), compare_strcoll);
+
+    sort_set_locale_collation(true);
+    sort_view(&view);
+    ASSERT_NOT_NULL(view.row_order_map);
+    for (size_t i = 0; i < count; i++) {
+        TEST_ASSERT(strcoll(names[view.row_order_map[i]], expected[i]) == 0, "row not in collation order");
+    }
+
+    sort_set_locale_collation(false);
+    if (saved) setlocale(LC_COLLATE, saved);
+    free(saved);
+    free(view.row_order_map);
+    free(view.reverse_row_map);
+    sort_cache_clear(&view);
+    destroy_data_source(ds);
 }
 
 // --- Test Suite Definition ---
 TestCase sorting_tests[] = {
     {"String Sorting (Ascending)", test_string_sorting_ascending},
     {"String Sorting (Descending)", test_string_sorting_descending},
+    {"Parallel Sort Matches Serial Order", test_parallel_sort_matches_serial},
+    {"Sort Kernels Handle Prefixes And Sign", test_sort_kernels_prefix_and_sign},
+    {"Multi-Column Sort", test_multi_column_sort},
+    {"Sort Permutation Cache", test_sort_permutation_cache},
+    {"Progressive Sort", test_progressive_sort},
+    {"External Merge Sort", test_external_sort},
+    {"External Merge Sort Over Many Runs", test_external_sort_many_runs},
+    {"Locale Collation Sort", test_locale_collation_sort},
 };
 int sorting_suite_size = sizeof(sorting_tests) / sizeof(TestCase);
\ No newline at end of file
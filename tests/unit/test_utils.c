@@ -1,5 +1,10 @@
 #include "../framework/test_runner.h"
 #include "util/utils.h"
+#include "util/byte_search.h"
+#include "util/parallel.h"
+#include "util/error_context.h"
+#include <string.h>
+#include <strings.h>
 
 // --- Test Cases ---
 
@@ -18,11 +23,120 @@ void test_is_string_numeric_negative(void) {
     ASSERT_EQ(is_string_numeric("  "), false);
 }
 
+void test_find_bytes_matches_memmem(void) {
+    // A small alphabet makes partial matches, and so false candidates, common.
+    char haystack[300];
+    unsigned seed = 12345;
+    for (size_t i = 0; i < sizeof(haystack); i++) {
+        seed = seed * 1103515245 + 12345;
+        haystack[i] = "abc"[(seed >> 16) % 3];
+    }
+
+    for (size_t length = 1; length <= 8; length++) {
+        for (size_t start = 0; start + length <= sizeof(haystack); start += 7) {
+            const char *needle = haystack + start;
+            for (size_t window = 0; window <= sizeof(haystack); window += 37) {
+                const char *expected = memmem(haystack, window, needle, length);
+                ASSERT_EQ(find_bytes(haystack, window, needle, length), expected);
+            }
+        }
+    }
+    ASSERT_NULL(find_bytes(haystack, sizeof(haystack), "abcabcabcabcabcabcx", 19));
+    ASSERT_EQ(find_bytes(haystack, sizeof(haystack), "", 0), haystack);
+}
+
+static const char* naive_find_ignore_case(const char *haystack, size_t haystack_length,
+                                          const char *needle, size_t needle_length) {
+    for (size_t i = 0; i + needle_length <= haystack_length; i++) {
+        if (strncasecmp(haystack + i, needle, needle_length) == 0) return haystack + i;
+    }
+    return NULL;
+}
+
+void test_find_bytes_ignore_case(void) {
+    // Mixed case, a non-letter neighbour of each case range, and high bytes.
+    char haystack[300];
+    unsigned seed = 54321;
+    for (size_t i = 0; i < sizeof(haystack); i++) {
+        seed = seed * 1103515245 + 12345;
+        haystack[i] = "aAbB@[`{\xc1"[(seed >> 16) % 9];
+    }
+
+    char needle[8];
+    for (size_t length = 1; length <= 8; length++) {
+        for (size_t start = 0; start + length <= sizeof(haystack); start += 5) {
+            // Flip the case of the needle so exact matches are not enough.
+            for (size_t k = 0; k < length; k++) {
+                char c = haystack[start + k];
+                needle[k] = (c >= 'a' && c <= 'z') ? c - 32 : (c >= 'A' && c <= 'Z') ? c + 32 : c;
+            }
+            for (size_t window = 0; window <= sizeof(haystack); window += 37) {
+                const char *expected = naive_find_ignore_case(haystack, window, needle, length);
+                ASSERT_EQ(find_bytes_ignore_case(haystack, window, needle, length), expected);
+            }
+        }
+    }
+    const char *text = "Looking for NeEdLe in a haystack";
+    ASSERT_EQ(find_bytes_ignore_case(text, strlen(text), "needle", 6), text + 12);
+    ASSERT_NULL(find_bytes_ignore_case(text, strlen(text), "needles", 7));
+
+    // Non-ASCII needles fold through UTF-8.
+    const char *latin = "Ein gro\xc3\x9f\xc3\xa9r \xc3\x84PFEL";          // "Ein großér ÄPFEL"
+    ASSERT_EQ(find_bytes_ignore_case(latin, strlen(latin), "\xc3\xa4pfel", 6), latin + 13);
+    ASSERT_EQ(find_bytes_ignore_case(latin, strlen(latin), "GRO\xc3\x9f\xc3\x89R", 8), latin + 4);
+    const char *greek = "\xce\xa3\xce\x9f\xce\xa6\xce\x99\xce\x91";   // "ΣΟΦΙΑ"
+    ASSERT_EQ(find_bytes_ignore_case(greek, strlen(greek), "\xcf\x83\xce\xbf\xcf\x86", 6), greek);
+    const char *cyrillic = "x \xd0\x9f\xd0\xa0\xd0\x98\xd0\x81\xd0\x9c";  // "x ПРИЁМ"
+    ASSERT_EQ(find_bytes_ignore_case(cyrillic, strlen(cyrillic), "\xd1\x91\xd0\xbc", 4), cyrillic + 8);
+    ASSERT_NULL(find_bytes_ignore_case(cyrillic, strlen(cyrillic), "\xd0\xbf\xd0\xb0", 4));
+
+    // Stray bytes that are not UTF-8 only match themselves.
+    const char *broken = "ab\xc3(\xe9";
+    ASSERT_EQ(find_bytes_ignore_case(broken, strlen(broken), "\xe9", 1), broken + 4);
+    ASSERT_NULL(find_bytes_ignore_case(broken, strlen(broken), "\xc9", 1));
+
+    ASSERT_EQ(text_contains("Hay NEEDLE hay", "needle", true), true);
+    ASSERT_EQ(text_contains("Hay NEEDLE hay", "needle", false), false);
+}
+
+typedef struct {
+    size_t hits[64];
+} ParallelCoverage;
+
+static void count_task(void *arg, size_t task_index) {
+    ParallelCoverage *coverage = (ParallelCoverage *)arg;
+    __atomic_fetch_add(&coverage->hits[task_index], 1, __ATOMIC_RELAXED);
+}
+
+void test_parallel_for_runs_every_task(void) {
+    ParallelCoverage coverage;
+    memset(&coverage, 0, sizeof(coverage));
+
+    ASSERT_EQ(parallel_for(64, count_task, &coverage), DSV_OK);
+    for (size_t i = 0; i < 64; i++) {
+        ASSERT_EQ(coverage.hits[i], 1);
+    }
+
+    // Chunks must tile the item range exactly.
+    size_t chunks = parallel_chunk_count(1000, 10);
+    size_t expected_begin = 0;
+    for (size_t i = 0; i < chunks; i++) {
+        size_t begin, end;
+        parallel_chunk_bounds(1000, chunks, i, &begin, &end);
+        ASSERT_EQ(begin, expected_begin);
+        expected_begin = end;
+    }
+    ASSERT_EQ(expected_begin, 1000);
+}
+
 // --- Test Suite ---
 
 TestCase utils_tests[] = {
     {"Is String Numeric (Positive)", test_is_string_numeric_positive},
     {"Is String Numeric (Negative)", test_is_string_numeric_negative},
+    {"Find Bytes Matches memmem", test_find_bytes_matches_memmem},
+    {"Find Bytes Ignoring Case", test_find_bytes_ignore_case},
+    {"Parallel For Covers Every Task", test_parallel_for_runs_every_task},
 };
 
 int utils_suite_size = sizeof(utils_tests) / sizeof(TestCase);
@@ -3,14 +3,21 @@
 #include "core/data_source.h"
 #include "memory/in_memory_table.h"
 #include "ui/navigation.h"
+#include "core/analysis.h"
+#include "core/value_index.h"
+#include "core/frequency_source.h"
+#include "core/column_stats.h"
+#include "util/parallel.h"
+#include "app_init.h"
+#include "config.h"
 #include <string.h>
 #include <stdlib.h>
 
 // Helper to create a basic view from an in-memory table
-static View* create_test_view(const char* name, const char** headers, const char*** data, int rows, int cols) {
+static View* create_test_view(const char* name, const char** headers, const char** data, int rows, int cols) {
     InMemoryTable* table = create_in_memory_table(name, cols, headers);
     for (int i = 0; i < rows; i++) {
-        add_in_memory_table_row(table, data[i]);
+        add_in_memory_table_row(table, data + (size_t)i * cols); // data is row-major
     }
 
     DataSource* ds = create_memory_data_source(table);
@@ -66,7 +73,7 @@ void propagate_selection(void) {
         {"4", "Green", "A"},
         {"5", "Blue", "D"}
     };
-    View* parent_view = create_test_view("Parent", parent_headers, (const char***)parent_data, 5, 3);
+    View* parent_view = create_test_view("Parent", parent_headers, &parent_data[0][0], 5, 3);
 
     // 2. Create Child View (e.g., frequency of "Color" column)
     const char* child_headers[] = {"Value", "Count"};
@@ -75,7 +82,7 @@ void propagate_selection(void) {
         {"Blue", "2"},
         {"Green", "1"}
     };
-    View* child_view = create_test_view("Child", child_headers, (const char***)child_data, 3, 2);
+    View* child_view = create_test_view("Child", child_headers, &child_data[0][0], 3, 2);
 
     // 3. Link them
     child_view->parent = parent_view;
@@ -114,11 +121,306 @@ void propagate_selection_null_case(void) {
     TEST_ASSERT(true, "Executing with NULL should not crash");
 }
 
+void frequency_analysis_parallel(void) {
+    // Enough rows for many chunks; value k occurs at rows k, k + 997, ...
+    const char *headers[] = {"ID", "Key"};
+    InMemoryTable *table = create_in_memory_table("Keys", 2, headers);
+    char id[32], key[32];
+    for (int i = 0; i < 60000; i++) {
+        snprintf(id, sizeof(id), "%d", i);
+        snprintf(key, sizeof(key), "k%d", i % 997);
+        const char *row[] = {id, key};
+        add_in_memory_table_row(table, row);
+    }
+    DataSource *ds = create_memory_data_source(table);
+    View view = { .data_source = ds, .visible_row_count = 60000, .total_rows = 60000 };
+
+    DSVConfig config;
+    config_init_defaults(&config);
+    DSVViewer viewer = { .config = &config };
+
+    parallel_set_max_workers(1);
+    ValueIndex *serial = perform_frequency_analysis(&viewer, &view, 1);
+    parallel_set_max_workers(4);
+    ValueIndex *parallel = perform_frequency_analysis(&viewer, &view, 1);
+    parallel_set_max_workers(0);
+    TEST_ASSERT(serial && parallel, "analysis failed");
+    ASSERT_EQ(serial->count, 997);
+    ASSERT_EQ(parallel->count, 997);
+
+    // Same order, most frequent first (the first 181 keys occur once more).
+    for (size_t r = 0; r < serial->count; r++) {
+        ASSERT_EQ(strcmp(serial->sorted[r]->value, parallel->sorted[r]->value), 0);
+        ASSERT_EQ(serial->sorted[r]->rows.count, parallel->sorted[r]->rows.count);
+    }
+    ASSERT_EQ(parallel->sorted[0]->rows.count, 61);
+    ASSERT_EQ(parallel->sorted[996]->rows.count, 60);
+
+    // Row lists come out whole and in display order.
+    for (int k = 0; k < 997; k += 37) {
+        snprintf(key, sizeof(key), "k%d", k);
+        const RowIndexArray *rows = get_from_value_index(parallel, key);
+        TEST_ASSERT(rows != NULL, "value missing from index");
+        ASSERT_EQ(rows->count, (size_t)(k < 181 ? 61 : 60));
+        for (size_t i = 0; i < rows->count; i++) ASSERT_EQ(rows->indices[i], (size_t)k + i * 997);
+    }
+
+    free_value_index(serial);
+    free_value_index(parallel);
+    destroy_data_source(ds);
+}
+
+void frequency_source_reads_index(void) {
+    const char *headers[] = {"Key"};
+    InMemoryTable *table = create_in_memory_table("Keys", 1, headers);
+    const char *keys[] = {"b", "a", "b", "long value", "b", "a"};
+    for (size_t i = 0; i < 6; i++) {
+        const char *row[] = {keys[i]};
+        add_in_memory_table_row(table, row);
+    }
+    DataSource *ds = create_memory_data_source(table);
+    View view = { .data_source = ds, .visible_row_count = 6, .total_rows = 6 };
+
+    DSVConfig config;
+    config_init_defaults(&config);
+    DSVViewer viewer = { .config = &config };
+
+    ValueIndex *index = perform_frequency_analysis(&viewer, &view, 0);
+    TEST_ASSERT(index != NULL, "analysis failed");
+    DataSource *freq = create_frequency_data_source(index);
+    TEST_ASSERT(freq != NULL, "frequency source failed");
+
+    // The source keeps the index alive once the caller lets go of it.
+    free_value_index(index);
+    ASSERT_EQ(freq->ops->get_row_count(freq->context), 3);
+    ASSERT_EQ(freq->ops->get_col_count(freq->context), 2);
+
+    const char *values[] = {"b", "a", "long value"};
+    const char *counts[] = {"3", "2", "1"};
+    char buffer[32];
+    for (size_t r = 0; r < 3; r++) {
+        FieldDesc fd = freq->ops->get_cell(freq->context, r, 0);
+        render_field(&fd, buffer, sizeof(buffer));
+        ASSERT_EQ(strcmp(buffer, values[r]), 0);
+        fd = freq->ops->get_cell(freq->context, r, 1);
+        render_field(&fd, buffer, sizeof(buffer));
+        ASSERT_EQ(strcmp(buffer, counts[r]), 0);
+    }
+    FieldDesc header = freq->ops->get_header(freq->context, 1);
+    render_field(&header, buffer, sizeof(buffer));
+    ASSERT_EQ(strcmp(buffer, "Count"), 0);
+    ASSERT_EQ(freq->ops->get_column_width(freq->context, 0), 10);
+    ASSERT_EQ(freq->ops->get_column_width(freq->context, 1), 5);
+
+    destroy_data_source(freq);
+    destroy_data_source(ds);
+}
+
+void frequency_analysis_approximate(void) {
+    // Five values take every tenth row; the rest are unique IDs.
+    const char *headers[] = {"Key"};
+    InMemoryTable *table = create_in_memory_table("Keys", 1, headers);
+    char key[32];
+    for (int i = 0; i < 60000; i++) {
+        if (i % 10 == 0) {
+            snprintf(key, sizeof(key), "hot%d", (i / 10) % 5);
+        } else {
+            snprintf(key, sizeof(key), "id%d", i);
+        }
+        const char *row[] = {key};
+        add_in_memory_table_row(table, row);
+    }
+    DataSource *ds = create_memory_data_source(table);
+    View view = { .data_source = ds, .visible_row_count = 60000, .total_rows = 60000 };
+
+    DSVConfig config;
+    config_init_defaults(&config);
+    DSVViewer viewer = { .config = &config };
+
+    parallel_set_max_workers(4);
+    ApproxFrequency *approx = perform_approximate_frequency_analysis(&viewer, &view, 0);
+    TEST_ASSERT(approx != NULL, "approximate analysis failed");
+    ASSERT_EQ(approx->rows, 60000);
+    double distinct = 54005.0;
+    TEST_ASSERT(approx->distinct_estimate > distinct * 0.95 && approx->distinct_estimate < distinct * 1.05,
+                "distinct estimate out of range");
+
+    // The heavy hitters lead, and every count brackets the true one.
+    for (size_t i = 0; i < approx->item_count; i++) {
+        const ApproxFrequencyItem *item = &approx->items[i];
+        size_t exact = strncmp(item->value, "hot", 3) == 0 ? 1200 : 1;
+        TEST_ASSERT(i >= 5 || exact == 1200, "heavy hitter missing from the top");
+        TEST_ASSERT(item->count >= exact && item->count - item->error <= exact, "count bounds violated");
+    }
+
+    DataSource *freq = create_approximate_frequency_data_source(approx);
+    TEST_ASSERT(freq != NULL, "approximate source failed");
+    ASSERT_EQ(freq->ops->get_col_count(freq->context), 3);
+    ASSERT_EQ(freq->ops->get_row_count(freq->context), approx->item_count);
+    char buffer[32];
+    FieldDesc fd = freq->ops->get_cell(freq->context, 0, 0);
+    render_field(&fd, buffer, sizeof(buffer));
+    ASSERT_EQ(strncmp(buffer, "hot", 3), 0);
+
+    // Refining counts the reported values exactly, with their rows.
+    ValueIndex *exact = refine_frequency_analysis(&viewer, &view, 0, approx);
+    parallel_set_max_workers(0);
+    TEST_ASSERT(exact != NULL, "refinement failed");
+    ASSERT_EQ(exact->count, approx->item_count);
+    for (size_t i = 0; i < exact->count; i++) {
+        ASSERT_EQ(exact->sorted[i]->rows.count, (size_t)(i < 5 ? 1200 : 1));
+    }
+    const RowIndexArray *rows = get_from_value_index(exact, "hot3");
+    TEST_ASSERT(rows != NULL, "heavy hitter missing from refinement");
+    for (size_t i = 0; i < rows->count; i++) ASSERT_EQ(rows->indices[i], 30 + i * 50);
+
+    free_value_index(exact);
+    destroy_data_source(freq);
+    free_approximate_frequency(approx);
+    destroy_data_source(ds);
+}
+
+void frequency_distinct_sample(void) {
+    // Columns with 1000, 50000 and 200000 distinct values over 200000 rows.
+    const size_t rows = 200000;
+    const char *headers[] = {"Few", "Many", "Unique"};
+    InMemoryTable *table = create_in_memory_table("Distinct", 3, headers);
+    char few[16], many[16], unique[16];
+    const char *row[] = {few, many, unique};
+    for (size_t i = 0; i < rows; i++) {
+        snprintf(few, sizeof(few), "f%zu", i % 1000);
+        snprintf(many, sizeof(many), "m%zu", i * 7919 % 50000);
+        snprintf(unique, sizeof(unique), "u%zu", i);
+        add_in_memory_table_row(table, row);
+    }
+    DataSource *ds = create_memory_data_source(table);
+    View view = { .data_source = ds, .visible_row_count = rows, .total_rows = rows };
+    DSVConfig config;
+    config_init_defaults(&config);
+    DSVViewer viewer = { .config = &config };
+
+    double few_estimate = estimate_distinct_values(&viewer, &view, 0);
+    double many_estimate = estimate_distinct_values(&viewer, &view, 1);
+    double unique_estimate = estimate_distinct_values(&viewer, &view, 2);
+    TEST_ASSERT(few_estimate > 990 && few_estimate < 1010, "low cardinality estimate out of range");
+    TEST_ASSERT(many_estimate > 45000 && many_estimate < 55000, "mid cardinality estimate out of range");
+    TEST_ASSERT(unique_estimate > 180000 && unique_estimate <= 200000, "unique estimate out of range");
+
+    destroy_data_source(ds);
+}
+
+void column_stats_one_pass(void) {
+    // Numbers up to 49999.5, with every 100th cell empty and "n/a" in some.
+    const char *headers[] = {"Value"};
+    InMemoryTable *table = create_in_memory_table("Values", 1, headers);
+    char cell[32];
+    double sum = 0.0, sum_sq = 0.0;
+    size_t numbers = 0;
+    for (int i = 0; i < 50000; i++) {
+        if (i % 100 == 0) {
+            cell[0] = '\0';
+        } else if (i % 1000 == 1) {
+            snprintf(cell, sizeof(cell), "n/a");
+        } else {
+            snprintf(cell, sizeof(cell), "%d.5", i);
+            sum += i + 0.5;
+            sum_sq += (i + 0.5) * (i + 0.5);
+            numbers++;
+        }
+        const char *row[] = {cell};
+        add_in_memory_table_row(table, row);
+    }
+    DataSource *ds = create_memory_data_source(table);
+    View view = { .data_source = ds, .visible_row_count = 50000, .total_rows = 50000 };
+
+    parallel_set_max_workers(4);
+    const ColumnStats *stats = view_column_stats(&view, 0, 256);
+    parallel_set_max_workers(0);
+    TEST_ASSERT(stats != NULL, "statistics failed");
+    ASSERT_EQ(stats->nulls, 500);
+    ASSERT_EQ(stats->count, 49500);
+    ASSERT_EQ(stats->numeric_count, numbers);
+    ASSERT_EQ(stats->min, 2.5);
+    ASSERT_EQ(stats->max, 49999.5);
+
+    // Sums are reduced in a different order, so allow for rounding.
+    double diff = stats->sum - sum;
+    TEST_ASSERT(diff < sum * 1e-12 && diff > -sum * 1e-12, "sum differs");
+    double mean = sum / (double)numbers;
+    double variance = (sum_sq - sum * mean) / (double)(numbers - 1);
+    diff = stats->mean - mean;
+    TEST_ASSERT(diff < 1e-9 && diff > -1e-9, "mean differs");
+    diff = stats->stddev * stats->stddev - variance;
+    TEST_ASSERT(diff < variance * 1e-9 && diff > -variance * 1e-9, "variance differs");
+
+    // Distinct values: the numbers plus "n/a".
+    double distinct = (double)numbers + 1.0;
+    TEST_ASSERT(stats->distinct_estimate > distinct * 0.95 && stats->distinct_estimate < distinct * 1.05,
+                "distinct estimate out of range");
+    ASSERT_EQ(strcmp(stats->min_text, "10.5"), 0);
+    ASSERT_EQ(strcmp(stats->max_text, "n/a"), 0);
+    ASSERT_EQ(stats->min_length, 3);
+    ASSERT_EQ(stats->max_length, 7);
+
+    // The second request is served from the view's cache.
+    TEST_ASSERT(view_column_stats(&view, 0, 256) == stats, "statistics not cached");
+
+    free_column_stats(view.column_stats[0]);
+    free(view.column_stats);
+    destroy_data_source(ds);
+}
+
+void column_stats_quantiles(void) {
+    // 1..100000 in shuffled order (7919 is coprime to 100000).
+    const char *headers[] = {"Value"};
+    InMemoryTable *table = create_in_memory_table("Values", 1, headers);
+    char cell[32];
+    for (size_t i = 0; i < 100000; i++) {
+        snprintf(cell, sizeof(cell), "%zu", i * 7919 % 100000 + 1);
+        const char *row[] = {cell};
+        add_in_memory_table_row(table, row);
+    }
+    DataSource *ds = create_memory_data_source(table);
+    View view = { .data_source = ds, .visible_row_count = 100000, .total_rows = 100000 };
+
+    // Several chunks, so the per-chunk sketches are merged.
+    parallel_set_max_workers(4);
+    const ColumnStats *stats = view_column_stats(&view, 0, 256);
+    parallel_set_max_workers(0);
+    TEST_ASSERT(stats != NULL, "statistics failed");
+    TEST_ASSERT(stats->median > 48000 && stats->median < 52000, "median out of range");
+    TEST_ASSERT(stats->p90 > 88000 && stats->p90 < 92000, "p90 out of range");
+    TEST_ASSERT(stats->p99 > 97000 && stats->p99 <= 100000, "p99 out of range");
+
+    // Ten equal bins of about 10000 each, adding up exactly.
+    InMemoryTable *histogram = column_stats_histogram(stats, 10);
+    TEST_ASSERT(histogram != NULL, "histogram failed");
+    ASSERT_EQ(histogram->row_count, 10);
+    size_t total = 0;
+    for (size_t bin = 0; bin < histogram->row_count; bin++) {
+        size_t count = (size_t)strtoull(in_memory_table_get_string(histogram, bin, 2, NULL), NULL, 10);
+        TEST_ASSERT(count > 8000 && count < 12000, "bin count out of range");
+        total += count;
+    }
+    ASSERT_EQ(total, 100000);
+
+    free_in_memory_table(histogram);
+    free_column_stats(view.column_stats[0]);
+    free(view.column_stats);
+    destroy_data_source(ds);
+}
+
 // --- Test Suite ---
 
 TestCase view_manager_tests[] = {
     {"Propagate Selection", propagate_selection},
     {"Propagate Selection with NULL", propagate_selection_null_case},
+    {"Frequency Analysis | Parallel Matches Serial", frequency_analysis_parallel},
+    {"Frequency Analysis | Data Source Reads Index", frequency_source_reads_index},
+    {"Frequency Analysis | Approximate", frequency_analysis_approximate},
+    {"Frequency Analysis | Sampled Distinct Estimate", frequency_distinct_sample},
+    {"Column Stats | One Pass", column_stats_one_pass},
+    {"Column Stats | Quantiles And Histogram", column_stats_quantiles},
 };
 
 int view_manager_suite_size = sizeof(view_manager_tests) / sizeof(TestCase); 
\ No newline at end of file